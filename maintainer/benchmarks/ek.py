@@ -0,0 +1,157 @@
+#
+# Copyright (C) 2020 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+import os
+import sys
+import numpy as np
+from time import time
+import argparse
+
+parser = argparse.ArgumentParser(description="Benchmark electrokinetics "
+                                 "simulations. Save the results to a CSV "
+                                 "file.")
+parser.add_argument("--nodes_per_core", metavar="N", action="store",
+                    type=int, default=16**3, required=False,
+                    help="Number of lattice nodes per MPI rank")
+parser.add_argument("--gpu", action="store_true",
+                    help="Run the GPU implementation as reference")
+parser.add_argument("--profile", metavar="FILEPATH", action="store",
+                    type=str, required=False, default=None,
+                    help="Save the final density profile of the first "
+                    "species along x to a text file, to compare the CPU and "
+                    "GPU implementations")
+parser.add_argument("--output", metavar="FILEPATH", action="store",
+                    type=str, required=False, default="benchmarks.csv",
+                    help="Output file (default: benchmarks.csv)")
+
+args = parser.parse_args()
+
+# process and check arguments
+measurement_steps = max(int(np.round(2e5 / args.nodes_per_core, -1)), 10)
+n_iterations = 30
+assert args.nodes_per_core >= 8, "nodes_per_core must be at least 8"
+
+
+import espressomd
+import espressomd.electrokinetics
+
+if args.gpu:
+    required_features = ["ELECTROKINETICS"]
+else:
+    required_features = ["ELECTROKINETICS_CPU"]
+espressomd.assert_features(required_features)
+
+print(espressomd.features())
+
+# System
+#############################################################
+system = espressomd.System(box_l=[1, 1, 1])
+
+n_proc = system.cell_system.get_state()['n_nodes']
+if args.gpu:
+    assert n_proc == 1, "the GPU reference runs on a single MPI rank"
+n_nodes = n_proc * args.nodes_per_core
+box_l = int(np.round(n_nodes**(1. / 3.)))
+box_l += box_l % 2
+
+system.box_l = 3 * (box_l,)
+system.time_step = 0.1
+system.cell_system.skin = 0.4
+system.thermostat.turn_off()
+
+# Electrokinetics setup
+#############################################################
+
+agrid = 1.
+ions = [{"density": 0.1, "D": 0.3, "valency": 1.,
+         "ext_force_density": [0.01, 0., 0.]},
+        {"density": 0.1, "D": 0.2, "valency": -1.,
+         "ext_force_density": [0., 0., 0.]}]
+
+if args.gpu:
+    ek = espressomd.electrokinetics.Electrokinetics(
+        agrid=agrid, lb_density=1., viscosity=1., friction=1., T=1.,
+        prefactor=0.7, fluid_coupling="friction")
+    species = [espressomd.electrokinetics.Species(**ion) for ion in ions]
+    for s in species:
+        ek.add_species(s)
+    system.actors.add(ek)
+
+    def set_density(node, density):
+        species[0][node].density = density
+
+    def get_density(node):
+        return species[0][node].density
+else:
+    ek = espressomd.electrokinetics.ElectrokineticsCPU(
+        agrid=agrid, dens=1., visc=1., tau=system.time_step, T=1.,
+        prefactor=0.7, fluid_coupling="friction", species=ions)
+    system.actors.add(ek)
+
+    def set_density(node, density):
+        ek.set_density(0, density, node)
+
+    def get_density(node):
+        return ek.get_density(0, node)
+
+# a charged slab relaxes and drifts along x
+for j in range(box_l):
+    for k in range(box_l):
+        set_density([0, j, k], 2. * ions[0]["density"])
+
+#############################################################
+#  Integration                                              #
+#############################################################
+
+system.integrator.run(measurement_steps)
+
+# time integration loop
+print("Timing every {} steps".format(measurement_steps))
+main_tick = time()
+all_t = []
+for i in range(n_iterations):
+    tick = time()
+    system.integrator.run(measurement_steps)
+    tock = time()
+    t = (tock - tick) / measurement_steps
+    print("step {}, time = {:.2e}".format(i, t))
+    all_t.append(t)
+main_tock = time()
+# average time
+all_t = np.array(all_t)
+avg = np.average(all_t)
+ci = 1.96 * np.std(all_t) / np.sqrt(len(all_t) - 1)
+print("average: {:.3e} +/- {:.3e} (95% C.I.)".format(avg, ci))
+
+if args.profile:
+    profile = [get_density([i, box_l // 2, box_l // 2])
+               for i in range(box_l)]
+    np.savetxt(args.profile, profile)
+
+# write report
+cmd = " ".join(x for x in sys.argv[1:] if not x.startswith("--output"))
+report = ('"{script}","{arguments}",{cores},{mean:.3e},'
+          '{ci:.3e},{n},{dur:.1f}\n'.format(
+              script=os.path.basename(sys.argv[0]), arguments=cmd,
+              cores=n_proc, dur=main_tock - main_tick, n=measurement_steps,
+              mean=avg, ci=ci))
+if not os.path.isfile(args.output):
+    report = ('"script","arguments","cores","mean","ci",'
+              '"nsteps","duration"\n' + report)
+with open(args.output, "a") as f:
+    f.write(report)
@@ -34,7 +34,7 @@ cp ../maintainer/configs/maxset.hpp .
 # process configuration files
 for config in ${configs}; do
   # add minimal features for the benchmarks to run
-  sed -i '1 i\#define ELECTROSTATICS\n#define LENNARD_JONES\n#define MASS\n' "${config}"
+  sed -i '1 i\#define ELECTROSTATICS\n#define LENNARD_JONES\n#define MASS\n#define ELECTROKINETICS_CPU\n' "${config}"
   # remove checks
   sed -ri "s/#define\s+ADDITIONAL_CHECKS//" "${config}"
 done
@@ -44,6 +44,10 @@
 
 #define ENGINE
 
+#ifdef FFTW
+#define ELECTROKINETICS_CPU
+#endif
+
 #ifdef CUDA
 #define LB_BOUNDARIES_GPU
 #define ELECTROKINETICS
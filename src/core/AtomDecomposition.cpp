@@ -92,6 +92,7 @@ void AtomDecomposition::mark_cells() {
       m_ghost_cells.push_back(std::addressof(cells.at(n)));
     }
   }
+  m_cell_colors.assign(1, m_local_cells);
 }
 void AtomDecomposition::resort(bool global_flag,
                                std::vector<ParticleChange> &diff) {
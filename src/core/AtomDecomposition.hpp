@@ -48,6 +48,7 @@ class AtomDecomposition : public ParticleDecomposition {
 
   std::vector<Cell *> m_local_cells;
   std::vector<Cell *> m_ghost_cells;
+  std::vector<std::vector<Cell *>> m_cell_colors;
 
   GhostCommunicator m_exchange_ghosts_comm;
   GhostCommunicator m_collect_ghost_force_comm;
@@ -74,6 +75,10 @@ public:
   Utils::Span<Cell *> ghost_cells() override {
     return Utils::make_span(m_ghost_cells);
   }
+  Utils::Span<Cell *> interacting_ghost_cells() override { return {}; }
+  std::vector<std::vector<Cell *>> const &cell_colors() const override {
+    return m_cell_colors;
+  }
 
   /**
    * @brief Determine which cell a particle id belongs to.
@@ -21,6 +21,7 @@
 
 #include "Particle.hpp"
 #include "ParticleList.hpp"
+#include "ParticleSoA.hpp"
 
 #include <utils/Span.hpp>
 
@@ -94,21 +95,48 @@ private:
   iterator m_red_black_divider;
 };
 
+class Cell;
+
+/**
+ * @brief Pair of clusters of consecutive particles, see
+ *        @ref Algorithm::verlet_ia_clustered.
+ *
+ * The first cluster consists of the particles [i_first, i_last)
+ * of the cell owning the pair, the second one of the particles
+ * [j_first, j_last) of @c partner.
+ */
+struct ClusterPair {
+  int i_first;
+  int i_last;
+  Cell *partner;
+  int j_first;
+  int j_last;
+};
+
 class Cell {
   using neighbors_type = Neighbors<Cell *>;
 
   ParticleList m_particles;
+  ParticleSoA m_soa;
 
 public:
   /** Particles */
   auto &particles() { return m_particles; }
   auto const &particles() const { return m_particles; }
 
+  /** Structure-of-arrays copy of the particles,
+   *  only kept up to date if enabled in the cell structure. */
+  auto &soa() { return m_soa; }
+  auto const &soa() const { return m_soa; }
+
   neighbors_type m_neighbors;
 
   /** Interaction pairs */
   std::vector<std::pair<Particle *, Particle *>> m_verlet_list;
 
+  /** Interacting clusters, used with the structure-of-arrays copies */
+  std::vector<ClusterPair> m_cluster_pairs;
+
   /**
    * @brief All neighbors of the cell.
    */
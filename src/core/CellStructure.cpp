@@ -25,6 +25,12 @@
 #include "DomainDecomposition.hpp"
 
 #include <utils/contains.hpp>
+#include <utils/morton.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
 
 Cell *CellStructure::particle_to_cell(const Particle &p) {
   return decomposition().particle_to_cell(p);
@@ -112,19 +118,116 @@ static unsigned map_data_parts(unsigned data_parts) {
   /* clang-format on */
 }
 
+/* Do a ghost communication, via the persistent requests if possible. */
+static void ghost_communication(AsyncGhostCommunicator &async_comm,
+                                GhostCommunicator const &gcr,
+                                unsigned data_parts) {
+  if (AsyncGhostCommunicator::is_supported(gcr, data_parts)) {
+    async_comm.begin(gcr, data_parts);
+    async_comm.wait();
+  } else {
+    ghost_communicator(gcr, data_parts);
+  }
+}
+
 void CellStructure::ghosts_update(unsigned data_parts) {
-  ghost_communicator(decomposition().exchange_ghosts_comm(),
-                     map_data_parts(data_parts));
+  ghosts_update_wait();
+  ghost_communication(m_async_ghosts, decomposition().exchange_ghosts_comm(),
+                      map_data_parts(data_parts));
+}
+void CellStructure::ghosts_update_begin(unsigned data_parts) {
+  ghosts_update_wait();
+
+  auto const &gcr = decomposition().exchange_ghosts_comm();
+  auto const parts = map_data_parts(data_parts);
+
+  if (use_async_ghosts and AsyncGhostCommunicator::is_supported(gcr, parts)) {
+    m_async_ghosts.begin(gcr, parts);
+    m_ghost_soa_outdated = use_soa;
+  } else {
+    ghost_communication(m_async_ghosts, gcr, parts);
+  }
+}
+bool CellStructure::ghosts_update_test() { return m_async_ghosts.test(); }
+void CellStructure::ghosts_update_wait() {
+  m_async_ghosts.wait();
+
+  if (m_ghost_soa_outdated) {
+    for (auto c : decomposition().ghost_cells())
+      c->soa().gather_positions(c->particles());
+    m_ghost_soa_outdated = false;
+  }
 }
 void CellStructure::ghosts_reduce_forces() {
-  ghost_communicator(decomposition().collect_ghost_force_comm(),
-                     GHOSTTRANS_FORCE);
+  ghosts_update_wait();
+  ghost_communication(m_async_ghost_forces,
+                      decomposition().collect_ghost_force_comm(),
+                      GHOSTTRANS_FORCE);
+}
+
+void CellStructure::update_soa(bool properties) {
+  auto update = [this, properties](Cell *c) {
+    auto &soa = c->soa();
+    if (properties or (soa.size() != c->particles().size())) {
+      soa.gather(c->particles());
+      rebuild_cluster_pairs = true;
+    } else {
+      soa.gather_positions(c->particles());
+    }
+  };
+
+  for (auto c : decomposition().local_cells())
+    update(c);
+  for (auto c : decomposition().ghost_cells())
+    update(c);
+}
+
+void CellStructure::update_local_soa_positions() {
+  for (auto c : decomposition().local_cells())
+    c->soa().gather_positions(c->particles());
+}
+
+std::vector<Cell *> CellStructure::border_cells() {
+  auto const ghosts = decomposition().ghost_cells();
+  std::vector<Cell *> ghost_cells(ghosts.begin(), ghosts.end());
+  std::sort(ghost_cells.begin(), ghost_cells.end());
+
+  std::vector<Cell *> cells;
+  for (auto c : decomposition().local_cells()) {
+    auto const red = c->neighbors().red();
+    if (std::any_of(red.begin(), red.end(), [&ghost_cells](Cell *n) {
+          return std::binary_search(ghost_cells.begin(), ghost_cells.end(), n);
+        })) {
+      cells.push_back(c);
+    }
+  }
+  std::sort(cells.begin(), cells.end());
+
+  return cells;
+}
+
+void CellStructure::soa_reset_forces() {
+  for (auto c : decomposition().local_cells())
+    c->soa().reset_forces();
+  for (auto c : decomposition().ghost_cells())
+    c->soa().reset_forces();
+}
+
+void CellStructure::soa_add_forces() {
+  for (auto c : decomposition().local_cells())
+    c->soa().add_forces_to(c->particles());
+  for (auto c : decomposition().ghost_cells())
+    c->soa().add_forces_to(c->particles());
 }
 
 Utils::Span<Cell *> CellStructure::local_cells() {
   return decomposition().local_cells();
 }
 
+Utils::Span<Cell *> CellStructure::interacting_ghost_cells() {
+  return decomposition().interacting_ghost_cells();
+}
+
 ParticleRange CellStructure::local_particles() {
   return Cells::particles(decomposition().local_cells());
 }
@@ -151,7 +254,63 @@ struct UpdateParticleIndexVisitor {
 };
 } // namespace
 
+namespace {
+/**
+ * @brief Order the particles of a list along the Morton curve of their
+ *        positions within the bounding box of the list.
+ *
+ * @return If the order has changed.
+ */
+bool sort_particles_morton(ParticleList &pl) {
+  if (pl.size() < 2)
+    return false;
+
+  Utils::Vector3d lower = pl.begin()->r.p;
+  Utils::Vector3d upper = lower;
+  for (auto const &p : pl) {
+    for (int i = 0; i < 3; i++) {
+      lower[i] = std::min(lower[i], p.r.p[i]);
+      upper[i] = std::max(upper[i], p.r.p[i]);
+    }
+  }
+
+  /* 10 bits per direction are plenty for the particles of a cell. */
+  auto constexpr levels = 1023.;
+  Utils::Vector3d scale;
+  for (int i = 0; i < 3; i++) {
+    scale[i] = (upper[i] > lower[i]) ? levels / (upper[i] - lower[i]) : 0.;
+  }
+
+  static std::vector<std::pair<uint64_t, int>> keys;
+  keys.clear();
+  for (auto const &p : pl) {
+    auto const q = hadamard_product(p.r.p - lower, scale);
+    keys.emplace_back(Utils::morton_code(static_cast<uint32_t>(q[0]),
+                                         static_cast<uint32_t>(q[1]),
+                                         static_cast<uint32_t>(q[2])),
+                      static_cast<int>(keys.size()));
+  }
+
+  if (std::is_sorted(keys.begin(), keys.end()))
+    return false;
+
+  std::sort(keys.begin(), keys.end());
+
+  static std::vector<Particle> sorted;
+  sorted.clear();
+  sorted.reserve(pl.size());
+  for (auto const &key : keys) {
+    sorted.emplace_back(std::move(pl.begin()[key.second]));
+  }
+  std::move(sorted.begin(), sorted.end(), pl.begin());
+  sorted.clear();
+
+  return true;
+}
+} // namespace
+
 void CellStructure::resort_particles(int global_flag) {
+  ghosts_update_wait();
   invalidate_ghosts();
 
   static std::vector<ParticleChange> diff;
@@ -159,6 +318,13 @@ void CellStructure::resort_particles(int global_flag) {
 
   m_decomposition->resort(global_flag, diff);
 
+  if (use_spatial_sort) {
+    for (auto c : m_decomposition->local_cells()) {
+      if (sort_particles_morton(c->particles()))
+        diff.emplace_back(ModifiedList{c->particles()});
+    }
+  }
+
   /* Communication step: number of ghosts and ghost information */
   ghost_communicator(m_decomposition->exchange_ghosts_comm(),
                      GHOSTTRANS_PARTNUM);
@@ -178,6 +344,8 @@ void CellStructure::set_domain_decomposition(
     boost::mpi::communicator const &comm, double range, BoxGeometry const &box,
     LocalBox<double> const &local_geo) {
   set_particle_decomposition(
-      std::make_unique<DomainDecomposition>(comm, range, box, local_geo));
+      std::make_unique<DomainDecomposition>(comm, range, box, local_geo,
+                                            use_spatial_sort,
+                                            use_eighth_shell));
   m_type = CELL_STRUCTURE_DOMDEC;
 }
\ No newline at end of file
@@ -96,12 +96,36 @@ private:
       std::make_unique<AtomDecomposition>();
   /** Active type in m_decomposition */
   int m_type = CELL_STRUCTURE_NSQUARE;
+  /** Ghost updates between resorts, and the ghost update in progress,
+   *  see @ref ghosts_update_begin */
+  AsyncGhostCommunicator m_async_ghosts;
+  /** Ghost force reduction */
+  AsyncGhostCommunicator m_async_ghost_forces;
+  /** The structure-of-arrays copies of the ghost cells have to be
+   *  updated once @ref m_async_ghosts is complete. */
+  bool m_ghost_soa_outdated = false;
   /** One of @ref Cells::Resort, announces the level of resort needed.
    */
   unsigned m_resort_particles = Cells::RESORT_NONE;
 
 public:
   bool use_verlet_list = true;
+  /** Keep a structure-of-arrays copy of the particles in every cell,
+   *  which is used by the non-bonded force loop. */
+  bool use_soa = false;
+  /** The cluster pair lists of the cells have to be rebuilt, which is
+   *  the case after every full update of the structure-of-arrays copies.
+   */
+  bool rebuild_cluster_pairs = true;
+  /** Overlap the update of the ghost positions with the force
+   *  calculation, see @ref ghosts_update_begin. */
+  bool use_async_ghosts = false;
+  /** Order the particles in the cells and the cells themselves along
+   *  a space-filling curve on every resort, see @ref resort_particles. */
+  bool use_spatial_sort = false;
+  /** Only import ghosts from the upper neighbors and use the
+   *  eighth-shell cell interactions in the domain decomposition. */
+  bool use_eighth_shell = false;
 
   /**
    * @brief Update local particle index.
@@ -214,6 +238,15 @@ public:
 
   /** Return the global local_cells */
   Utils::Span<Cell *> local_cells();
+  /** Local cells in independent groups, see
+   *  @ref ParticleDecomposition::cell_colors. */
+  std::vector<std::vector<Cell *>> const &cell_colors() const {
+    return decomposition().cell_colors();
+  }
+  /** Ghost cells whose pairs with their red neighbors are calculated
+   *  on this node, see
+   *  @ref ParticleDecomposition::interacting_ghost_cells. */
+  Utils::Span<Cell *> interacting_ghost_cells();
   ParticleRange local_particles();
   ParticleRange ghost_particles();
 
@@ -321,17 +354,83 @@ public:
    * @brief Update ghost particles.
    *
    * This function updates the ghost particles with data
-   * from the real particles.
+   * from the real particles. Updates of data with a fixed size
+   * per particle use the persistent buffers and requests of
+   * @ref AsyncGhostCommunicator.
    *
    * @param data_parts Particle parts to update, combination of @ref
    * Cells::DataPart
    */
   void ghosts_update(unsigned data_parts);
+  /**
+   * @brief Start a ghost update without blocking.
+   *
+   * If @ref use_async_ghosts is set and the update is supported by
+   * @ref AsyncGhostCommunicator, the update is only started, and has to
+   * be completed by @ref ghosts_update_wait before the ghosts are
+   * accessed. Otherwise this is equivalent to @ref ghosts_update.
+   * The particles must not be resorted or reallocated in the meantime.
+   *
+   * @param data_parts Particle parts to update, combination of @ref
+   * Cells::DataPart
+   */
+  void ghosts_update_begin(unsigned data_parts);
+  /**
+   * @brief Make progress on a ghost update started by
+   *        @ref ghosts_update_begin without blocking.
+   *
+   * @return Whether the update is complete.
+   */
+  bool ghosts_update_test();
+  /**
+   * @brief Complete a ghost update started by @ref ghosts_update_begin,
+   *        including the positions of the structure-of-arrays copies
+   *        of the ghost cells.
+   */
+  void ghosts_update_wait();
+  /** Whether a ghost update started by @ref ghosts_update_begin
+   *  still needs @ref ghosts_update_wait. */
+  bool ghosts_update_pending() const {
+    return m_async_ghosts.pending() or m_ghost_soa_outdated;
+  }
   /**
    * @brief Add forces from ghost particles to real particles.
    */
   void ghosts_reduce_forces();
 
+  /**
+   * @brief Update the structure-of-arrays copies of local and
+   *        ghost cells.
+   *
+   * @param properties If false, only the positions are updated,
+   *        which requires that the particles are unchanged otherwise
+   *        since the last full update. A full update invalidates
+   *        the cluster pair lists.
+   */
+  void update_soa(bool properties);
+  /**
+   * @brief Update the positions in the structure-of-arrays copies of
+   *        the local cells only, see @ref update_soa.
+   */
+  void update_local_soa_positions();
+
+  /**
+   * @brief Local cells that have ghost cells among their red neighbors,
+   *        and hence need the ghosts in the pair loop.
+   *
+   * @return The cells, sorted by address.
+   */
+  std::vector<Cell *> border_cells();
+  /**
+   * @brief Set the forces in the structure-of-arrays copies to zero.
+   */
+  void soa_reset_forces();
+  /**
+   * @brief Add the forces from the structure-of-arrays copies
+   *        to the particles.
+   */
+  void soa_add_forces();
+
 private:
   /**
    * @brief Resolve ids to particles.
@@ -401,6 +500,10 @@ private:
 public:
   /**
    * @brief Resort particles.
+   *
+   * With @ref use_spatial_sort, the particles of every local cell are
+   * ordered along the Morton curve afterwards, so that particles close
+   * in space are also close in memory.
    */
   void resort_particles(int global_flag);
 
@@ -408,6 +511,7 @@ private:
   /** @brief Set the particle decomposition, keeping the particles. */
   void set_particle_decomposition(
       std::unique_ptr<ParticleDecomposition> &&decomposition) {
+    ghosts_update_wait();
     clear_particle_index();
 
     auto local_parts = local_particles();
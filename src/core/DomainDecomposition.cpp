@@ -24,13 +24,17 @@
 #include "errorhandling.hpp"
 
 #include <utils/index.hpp>
+#include <utils/morton.hpp>
 #include <utils/mpi/cart_comm.hpp>
 #include <utils/mpi/sendrecv.hpp>
 
 #include <boost/mpi/collectives.hpp>
+#include <boost/mpi/operations.hpp>
 #include <boost/range/algorithm/reverse.hpp>
 #include <boost/range/numeric.hpp>
 
+#include <algorithm>
+
 /** Returns pointer to the cell which corresponds to the position if the
  *  position is in the nodes spatial domain otherwise a nullptr pointer.
  */
@@ -38,8 +42,19 @@ Cell *DomainDecomposition::position_to_cell(const Utils::Vector3d &pos) {
   Utils::Vector3i cpos;
 
   for (int i = 0; i < 3; i++) {
-    cpos[i] = static_cast<int>(std::floor(pos[i] * inv_cell_size[i])) + 1 -
-              cell_offset[i];
+    /* The local box decides which node owns the particle,
+     * consistent with the exchange in move_left_or_right. */
+    if (pos[i] < m_local_box.my_left()[i]) {
+      cpos[i] = 0;
+    } else if (pos[i] >= m_local_box.my_right()[i]) {
+      cpos[i] = cell_grid[i] + 1;
+    } else {
+      cpos[i] = std::min(
+          static_cast<int>(std::floor((pos[i] - m_local_box.my_left()[i]) *
+                                      inv_cell_size[i])) +
+              1,
+          cell_grid[i]);
+    }
 
     /* particles outside our box. Still take them if
        nonperiodic boundary. We also accept the particle if we are at
@@ -86,15 +101,23 @@ void DomainDecomposition::move_left_or_right(ParticleList &src,
                                              ParticleList &left,
                                              ParticleList &right,
                                              int dir) const {
+  auto const my_left = m_local_box.my_left()[dir];
+  auto const my_right = m_local_box.my_right()[dir];
+  /* Local boxes may be larger than half the box if the node boundaries
+   * were shifted, so the side is decided relative to the center. */
+  auto const center = 0.5 * (my_left + my_right);
+
   for (auto it = src.begin(); it != src.end();) {
-    if ((get_mi_coord(it->r.p[dir], m_local_box.my_left()[dir],
-                      m_box.length()[dir], m_box.periodic(dir)) < 0.0) and
+    auto const pos = it->r.p[dir];
+    auto const outside = (pos < my_left) or (pos >= my_right);
+    auto const to_left = get_mi_coord(pos, center, m_box.length()[dir],
+                                      m_box.periodic(dir)) < 0.0;
+
+    if (outside and to_left and
         (m_box.periodic(dir) || (m_local_box.boundary()[2 * dir] == 0))) {
       left.insert(std::move(*it));
       it = src.erase(it);
-    } else if ((get_mi_coord(it->r.p[dir], m_local_box.my_right()[dir],
-                             m_box.length()[dir],
-                             m_box.periodic(dir)) >= 0.0) and
+    } else if (outside and not to_left and
                (m_box.periodic(dir) ||
                 (m_local_box.boundary()[2 * dir + 1] == 0))) {
       right.insert(std::move(*it));
@@ -233,12 +256,48 @@ void DomainDecomposition::mark_cells() {
   for (int o = 0; o < ghost_cell_grid[2]; o++)
     for (int n = 0; n < ghost_cell_grid[1]; n++)
       for (int m = 0; m < ghost_cell_grid[0]; m++) {
+        auto cell = &cells.at(cnt_c++);
         if ((m > 0 && m < ghost_cell_grid[0] - 1 && n > 0 &&
              n < ghost_cell_grid[1] - 1 && o > 0 && o < ghost_cell_grid[2] - 1))
-          m_local_cells.push_back(&cells.at(cnt_c++));
-        else
-          m_ghost_cells.push_back(&cells.at(cnt_c++));
+          m_local_cells.push_back(cell);
+        else if (not m_eighth_shell or (m > 0 && n > 0 && o > 0))
+          m_ghost_cells.push_back(cell);
+      }
+}
+void DomainDecomposition::color_cells() {
+  m_cell_colors.clear();
+  m_cell_colors.resize(27);
+
+  for (int o = 1; o < cell_grid[2] + 1; o++)
+    for (int n = 1; n < cell_grid[1] + 1; n++)
+      for (int m = 1; m < cell_grid[0] + 1; m++) {
+        auto const color = (m % 3) + 3 * (n % 3) + 9 * (o % 3);
+        auto const ind = get_linear_index(m, n, o, ghost_cell_grid);
+        m_cell_colors[color].push_back(&cells.at(ind));
       }
+
+  m_cell_colors.erase(
+      std::remove_if(m_cell_colors.begin(), m_cell_colors.end(),
+                     [](auto const &color) { return color.empty(); }),
+      m_cell_colors.end());
+}
+void DomainDecomposition::sort_cells_morton() {
+  auto const key = [this](Cell const *c) {
+    /* Inverse of get_linear_index */
+    auto const ind = static_cast<int>(c - cells.data());
+    auto const m = ind % ghost_cell_grid[0];
+    auto const n = (ind / ghost_cell_grid[0]) % ghost_cell_grid[1];
+    auto const o = ind / (ghost_cell_grid[0] * ghost_cell_grid[1]);
+    return Utils::morton_code(m, n, o);
+  };
+  auto const by_key = [&key](Cell const *a, Cell const *b) {
+    return key(a) < key(b);
+  };
+
+  std::sort(m_local_cells.begin(), m_local_cells.end(), by_key);
+  for (auto &color : m_cell_colors) {
+    std::sort(color.begin(), color.end(), by_key);
+  }
 }
 void DomainDecomposition::fill_comm_cell_lists(ParticleList **part_lists,
                                                const Utils::Vector3i &lc,
@@ -251,13 +310,7 @@ void DomainDecomposition::fill_comm_cell_lists(ParticleList **part_lists,
         *part_lists++ = &(cells.at(i).particles());
       }
 }
-Utils::Vector3d DomainDecomposition::max_range() const {
-  auto dir_max_range = [this](int i) {
-    return std::min(0.5 * m_box.length()[i], m_local_box.length()[i]);
-  };
-
-  return {dir_max_range(0), dir_max_range(1), dir_max_range(2)};
-}
+Utils::Vector3d DomainDecomposition::max_range() const { return m_max_range; }
 int DomainDecomposition::calc_processor_min_num_cells() const {
   /* the minimal number of cells can be lower if there are at least two nodes
      serving a direction,
@@ -350,13 +403,27 @@ void DomainDecomposition::create_cell_grid(double range) {
     }
   }
 
+  /* The nodes in a plane of the node grid exchange ghost planes, so
+   * they have to agree on the number of cells in that plane. This is
+   * always the case for equally sized local boxes, otherwise the smallest
+   * number of cells of all nodes in a layer of the node grid is used. */
+  {
+    std::vector<Utils::Vector3i> grids;
+    boost::mpi::all_gather(m_comm, cell_grid, grids);
+    for (i = 0; i < 3; i++) {
+      for (int rank = 0; rank < m_comm.size(); rank++) {
+        if (Utils::Mpi::cart_coords<3>(m_comm, rank)[i] == cart_info.coords[i])
+          cell_grid[i] = std::min(cell_grid[i], grids[rank][i]);
+      }
+    }
+    n_local_cells = cell_grid[0] * cell_grid[1] * cell_grid[2];
+  }
+
   /* quit program if unsuccessful */
   if (n_local_cells > DomainDecomposition::max_num_cells) {
     runtimeErrorMsg() << "no suitable cell grid found ";
   }
 
-  auto const node_pos = cart_info.coords;
-
   /* now set all dependent variables */
   new_cells = 1;
   for (i = 0; i < 3; i++) {
@@ -364,7 +431,12 @@ void DomainDecomposition::create_cell_grid(double range) {
     new_cells *= ghost_cell_grid[i];
     cell_size[i] = m_local_box.length()[i] / (double)cell_grid[i];
     inv_cell_size[i] = 1.0 / cell_size[i];
-    cell_offset[i] = node_pos[i] * cell_grid[i];
+
+    /* The local boxes may differ in size, the
+     * range has to fit into the smallest one. */
+    m_max_range[i] = boost::mpi::all_reduce(
+        m_comm, std::min(0.5 * m_box.length()[i], m_local_box.length()[i]),
+        boost::mpi::minimum<double>());
   }
 
   /* allocate cell array and cell pointer arrays */
@@ -404,6 +476,77 @@ void DomainDecomposition::init_cell_interactions() {
       }
 }
 
+void DomainDecomposition::init_eighth_shell_interactions() {
+  auto const is_local = [this](Utils::Vector3i const &c) {
+    for (int i = 0; i < 3; i++) {
+      if (c[i] < 1 or c[i] > cell_grid[i])
+        return false;
+    }
+    return true;
+  };
+  auto const index = [this](Utils::Vector3i const &c) {
+    return get_linear_index(c[0], c[1], c[2], ghost_cell_grid);
+  };
+  auto const corner = [](int bits) {
+    return Utils::Vector3i{bits & 1, (bits >> 1) & 1, (bits >> 2) & 1};
+  };
+
+  std::vector<std::vector<Cell *>> red_neighbors(cells.size());
+
+  /* loop all local cells */
+  for (int o = 1; o < cell_grid[2] + 1; o++)
+    for (int n = 1; n < cell_grid[1] + 1; n++)
+      for (int m = 1; m < cell_grid[0] + 1; m++) {
+        auto const lower = Utils::Vector3i{m, n, o};
+
+        /* The pairs with lower corner m are between the corners a and b
+         * of the 2x2x2 block starting at m that have no common non-zero
+         * component, 13 pairs in total. */
+        for (int a = 0; a < 8; a++)
+          for (int b = a + 1; b < 8; b++) {
+            if (a & b)
+              continue;
+
+            auto c1 = lower + corner(a);
+            auto c2 = lower + corner(b);
+            if (is_local(c2) and not is_local(c1))
+              std::swap(c1, c2);
+
+            red_neighbors[index(c1)].push_back(&cells.at(index(c2)));
+          }
+      }
+
+  m_interacting_ghost_cells.clear();
+  for (int o = 1; o < ghost_cell_grid[2]; o++)
+    for (int n = 1; n < ghost_cell_grid[1]; n++)
+      for (int m = 1; m < ghost_cell_grid[0]; m++) {
+        auto const c = Utils::Vector3i{m, n, o};
+        auto const ind1 = index(c);
+        auto const &red = red_neighbors[ind1];
+
+        if (not is_local(c)) {
+          if (not red.empty()) {
+            cells.at(ind1).m_neighbors = Neighbors<Cell *>(red, {});
+            m_interacting_ghost_cells.push_back(&cells.at(ind1));
+          }
+          continue;
+        }
+
+        /* the other cells of the full shell are black */
+        std::vector<Cell *> black_neighbors;
+        for (int p = o - 1; p <= o + 1; p++)
+          for (int q = n - 1; q <= n + 1; q++)
+            for (int r = m - 1; r <= m + 1; r++) {
+              auto const neighbor = &cells.at(index({r, q, p}));
+              if (neighbor != &cells.at(ind1) and
+                  std::find(red.begin(), red.end(), neighbor) == red.end()) {
+                black_neighbors.push_back(neighbor);
+              }
+            }
+        cells.at(ind1).m_neighbors = Neighbors<Cell *>(red, black_neighbors);
+      }
+}
+
 namespace {
 /** Revert the order of a communicator: After calling this the
  *  communicator is working in reverted order with exchanged
@@ -454,16 +597,19 @@ Utils::Vector3d shift(BoxGeometry const &box, LocalBox<double> const &local_box,
 } // namespace
 
 GhostCommunicator DomainDecomposition::prepare_comm() {
-  int dir, lr, i, cnt, n_comm_cells[3];
+  int dir, lr, i, cnt, n_comm_cells;
   Utils::Vector3i lc{}, hc{}, done{};
 
   auto const comm_info = Utils::Mpi::cart_get<3>(m_comm);
   auto const node_neighbors = Utils::Mpi::cart_neighbors<3>(m_comm);
 
+  /* single sided communication only fills the upper ghost layers */
+  auto const n_lr = m_eighth_shell ? 1 : 2;
+
   /* calculate number of communications */
   size_t num = 0;
   for (dir = 0; dir < 3; dir++) {
-    for (lr = 0; lr < 2; lr++) {
+    for (lr = 0; lr < n_lr; lr++) {
       /* No communication for border of non periodic direction */
       if (comm_info.dims[dir] == 1)
         num++;
@@ -475,30 +621,28 @@ GhostCommunicator DomainDecomposition::prepare_comm() {
   /* prepare communicator */
   auto ghost_comm = GhostCommunicator{m_comm, num};
 
-  /* number of cells to communicate in a direction */
-  n_comm_cells[0] = cell_grid[1] * cell_grid[2];
-  n_comm_cells[1] = cell_grid[2] * ghost_cell_grid[0];
-  n_comm_cells[2] = ghost_cell_grid[0] * ghost_cell_grid[1];
-
   cnt = 0;
   /* direction loop: x, y, z */
   for (dir = 0; dir < 3; dir++) {
-    lc[(dir + 1) % 3] = 1 - done[(dir + 1) % 3];
-    lc[(dir + 2) % 3] = 1 - done[(dir + 2) % 3];
-    hc[(dir + 1) % 3] = cell_grid[(dir + 1) % 3] + done[(dir + 1) % 3];
-    hc[(dir + 2) % 3] = cell_grid[(dir + 2) % 3] + done[(dir + 2) % 3];
-    /* lr loop: left right */
-    /* here we could in principle build in a one sided ghost
-       communication, simply by taking the lr loop only over one
-       value */
-    for (lr = 0; lr < 2; lr++) {
+    for (auto const d : {(dir + 1) % 3, (dir + 2) % 3}) {
+      lc[d] = m_eighth_shell ? 1 : 1 - done[d];
+      hc[d] = cell_grid[d] + done[d];
+    }
+
+    /* number of cells to communicate in this direction */
+    n_comm_cells = (hc[(dir + 1) % 3] - lc[(dir + 1) % 3] + 1) *
+                   (hc[(dir + 2) % 3] - lc[(dir + 2) % 3] + 1);
+
+    /* lr loop: left right, with single sided communication
+       only the lower layer is sent to the left neighbor */
+    for (lr = 0; lr < n_lr; lr++) {
       if (comm_info.dims[dir] == 1) {
         /* just copy cells on a single node */
         ghost_comm.communications[cnt].type = GHOST_LOCL;
         ghost_comm.communications[cnt].node = m_comm.rank();
 
         /* Buffer has to contain Send and Recv cells -> factor 2 */
-        ghost_comm.communications[cnt].part_lists.resize(2 * n_comm_cells[dir]);
+        ghost_comm.communications[cnt].part_lists.resize(2 * n_comm_cells);
         /* prepare folding of ghost positions */
         ghost_comm.communications[cnt].shift =
             shift(m_box, m_local_box, dir, lr);
@@ -514,7 +658,7 @@ GhostCommunicator DomainDecomposition::prepare_comm() {
 
         /* place receive cells after send cells */
         fill_comm_cell_lists(
-            &ghost_comm.communications[cnt].part_lists[n_comm_cells[dir]], lc,
+            &ghost_comm.communications[cnt].part_lists[n_comm_cells], lc,
             hc);
 
         cnt++;
@@ -524,7 +668,7 @@ GhostCommunicator DomainDecomposition::prepare_comm() {
           if ((comm_info.coords[dir] + i) % 2 == 0) {
             ghost_comm.communications[cnt].type = GHOST_SEND;
             ghost_comm.communications[cnt].node = node_neighbors[2 * dir + lr];
-            ghost_comm.communications[cnt].part_lists.resize(n_comm_cells[dir]);
+            ghost_comm.communications[cnt].part_lists.resize(n_comm_cells);
             /* prepare folding of ghost positions */
             ghost_comm.communications[cnt].shift =
                 shift(m_box, m_local_box, dir, lr);
@@ -539,7 +683,7 @@ GhostCommunicator DomainDecomposition::prepare_comm() {
             ghost_comm.communications[cnt].type = GHOST_RECV;
             ghost_comm.communications[cnt].node =
                 node_neighbors[2 * dir + (1 - lr)];
-            ghost_comm.communications[cnt].part_lists.resize(n_comm_cells[dir]);
+            ghost_comm.communications[cnt].part_lists.resize(n_comm_cells);
 
             lc[dir] = hc[dir] = (1 - lr) * (cell_grid[dir] + 1);
 
@@ -559,16 +703,24 @@ GhostCommunicator DomainDecomposition::prepare_comm() {
 DomainDecomposition::DomainDecomposition(boost::mpi::communicator comm,
                                          double range,
                                          const BoxGeometry &box_geo,
-                                         const LocalBox<double> &local_geo)
-    : m_comm(std::move(comm)), m_box(box_geo), m_local_box(local_geo) {
+                                         const LocalBox<double> &local_geo,
+                                         bool morton_order, bool eighth_shell)
+    : m_comm(std::move(comm)), m_box(box_geo), m_local_box(local_geo),
+      m_eighth_shell(eighth_shell) {
   /* set up new domain decomposition cell structure */
   create_cell_grid(range);
 
   /* setup cell neighbors */
-  init_cell_interactions();
+  if (m_eighth_shell)
+    init_eighth_shell_interactions();
+  else
+    init_cell_interactions();
 
   /* mark local and ghost cells */
   mark_cells();
+  color_cells();
+  if (morton_order)
+    sort_cells_morton();
 
   /* create communicators */
   m_exchange_ghosts_comm = prepare_comm();
@@ -577,6 +729,10 @@ DomainDecomposition::DomainDecomposition(boost::mpi::communicator comm,
   /* collect forces has to be done in reverted order! */
   revert_comm_order(m_collect_ghost_force_comm);
 
-  assign_prefetches(m_exchange_ghosts_comm);
-  assign_prefetches(m_collect_ghost_force_comm);
+  /* the prefetches pair the send and receive of the same direction,
+   * which only holds for the double sided communication */
+  if (not m_eighth_shell) {
+    assign_prefetches(m_exchange_ghosts_comm);
+    assign_prefetches(m_collect_ghost_force_comm);
+  }
 }
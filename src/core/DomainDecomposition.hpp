@@ -52,6 +52,14 @@
  * communication! For single sided ghost communication one would need
  * some ghost-ghost cell interaction as well, which we do not need!
  *
+ * Alternatively, the eighth-shell scheme uses single sided ghost
+ * communication: ghosts are only imported from the neighbors in the
+ * upper directions, which halves the ghost volume and the number of
+ * messages. A pair of neighboring cells is then handled by the node
+ * that owns the componentwise lower corner of the two cells, which
+ * includes pairs of two ghost cells (see
+ * @ref ParticleDecomposition::interacting_ghost_cells).
+ *
  */
 struct DomainDecomposition : public ParticleDecomposition {
   /** Grind dimensions per node. */
@@ -60,12 +68,12 @@ struct DomainDecomposition : public ParticleDecomposition {
   Utils::Vector3d cell_size = {};
 
 private:
-  /** Offset in global grid */
-  Utils::Vector3i cell_offset = {};
   /** linked cell grid with ghost frame. */
   Utils::Vector3i ghost_cell_grid = {};
   /** inverse cell size = \see DomainDecomposition::cell_size ^ -1. */
   Utils::Vector3d inv_cell_size = {};
+  /** Largest interaction range that fits into all local boxes. */
+  Utils::Vector3d m_max_range = {};
 
   boost::mpi::communicator m_comm;
   BoxGeometry m_box;
@@ -73,13 +81,28 @@ private:
   std::vector<Cell> cells;
   std::vector<Cell *> m_local_cells;
   std::vector<Cell *> m_ghost_cells;
+  std::vector<Cell *> m_interacting_ghost_cells;
+  std::vector<std::vector<Cell *>> m_cell_colors;
+  /** Use the eighth-shell scheme with single sided ghost communication. */
+  bool m_eighth_shell;
   GhostCommunicator m_exchange_ghosts_comm;
   GhostCommunicator m_collect_ghost_force_comm;
 
 public:
+  /**
+   * @param comm Cartesian communicator to use.
+   * @param range Required interacting range.
+   * @param box_geo Box geometry.
+   * @param local_geo Geometry of the local box.
+   * @param morton_order Iterate the cells along the Morton curve instead
+   *        of row by row.
+   * @param eighth_shell Only import ghosts from the upper neighbors,
+   *        and use the eighth-shell cell interactions.
+   */
   DomainDecomposition(boost::mpi::communicator comm, double range,
                       const BoxGeometry &box_geo,
-                      const LocalBox<double> &local_geo);
+                      const LocalBox<double> &local_geo,
+                      bool morton_order = false, bool eighth_shell = false);
 
 public:
   GhostCommunicator const &exchange_ghosts_comm() const override {
@@ -95,6 +118,12 @@ public:
   Utils::Span<Cell *> ghost_cells() override {
     return Utils::make_span(m_ghost_cells);
   }
+  Utils::Span<Cell *> interacting_ghost_cells() override {
+    return Utils::make_span(m_interacting_ghost_cells);
+  }
+  std::vector<std::vector<Cell *>> const &cell_colors() const override {
+    return m_cell_colors;
+  }
 
   Cell *particle_to_cell(Particle const &p) override {
     return position_to_cell(p.r.p);
@@ -106,10 +135,17 @@ public:
 
 private:
   /** Fill local_cells list and ghost_cells list for use with domain
-   *  decomposition.
+   *  decomposition. With single sided ghost communication, the ghost
+   *  layers below the local cells are not used.
    */
   void mark_cells();
 
+  /** Sort the local cells into 27 groups by their grid position
+   *  modulo 3. Cells of the same group are at least three cells apart
+   *  in one direction, so their neighborhoods do not overlap.
+   */
+  void color_cells();
+
   /** Fill a communication cell pointer list. Fill the cell pointers of
    *  all cells which are inside a rectangular subgrid of the 3D cell
    *  grid starting from the
@@ -183,6 +219,12 @@ private:
    */
   void create_cell_grid(double range);
 
+  /** @brief Order the local cells and the cells of every color along the
+   *  Morton curve of their grid positions, so that cells which are
+   *  visited one after the other are also close in space.
+   */
+  void sort_cells_morton();
+
   /** Init cell interactions for cell system domain decomposition.
    *  Initializes the interacting neighbor cell list of a cell.
    *  This list of interacting neighbor cells is used by the Verlet
@@ -190,6 +232,13 @@ private:
    */
   void init_cell_interactions();
 
+  /** Init cell interactions for the eighth-shell scheme. Every pair
+   *  of neighboring cells whose componentwise lower corner is a local
+   *  cell is added to the red neighbors of one of the two cells,
+   *  preferably a local one. Fills the list of interacting ghost cells.
+   */
+  void init_eighth_shell_interactions();
+
   /** Create communicators for cell structure domain decomposition. (see \ref
    *  GhostCommunicator)
    */
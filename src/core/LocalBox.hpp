@@ -36,6 +36,23 @@ public:
         m_upper_corner(lower_corner + local_box_length),
         m_boundaries(boundaries) {}
 
+  /** @brief Local box from its corners.
+   *
+   * Unlike the construction from the length, the upper corner is
+   * exactly the one given, so that neighboring boxes share their faces.
+   */
+  static LocalBox from_corners(Utils::Vector<T, 3> const &lower_corner,
+                               Utils::Vector<T, 3> const &upper_corner,
+                               Utils::Array<int, 6> const &boundaries) {
+    LocalBox box;
+    box.m_local_box_l = upper_corner - lower_corner;
+    box.m_lower_corner = lower_corner;
+    box.m_upper_corner = upper_corner;
+    box.m_boundaries = boundaries;
+
+    return box;
+  }
+
   /** Left (bottom, front) corner of this nodes local box. */
   Utils::Vector<T, 3> const &my_left() const { return m_lower_corner; }
   /** Right (top, back) corner of this nodes local box. */
@@ -101,6 +101,30 @@ public:
    */
   virtual Utils::Span<Cell *> ghost_cells() = 0;
 
+  /**
+   * @brief Ghost cells that have red neighbors.
+   *
+   * If ghosts are only imported from some of the neighboring
+   * nodes, some pairs are between two ghost cells. These pairs are
+   * found from the red neighbors of the cells returned here, the
+   * pairs within these cells are handled by their owners.
+   *
+   * @return List of ghost cells with red neighbors.
+   */
+  virtual Utils::Span<Cell *> interacting_ghost_cells() = 0;
+
+  /**
+   * @brief Partition of the local cells into independent groups.
+   *
+   * The neighborhoods of the cells within one group
+   * are disjoint, so that pair kernels can be run
+   * concurrently on all cells of a group. Every local
+   * cell is in exactly one group.
+   *
+   * @return List of cell groups.
+   */
+  virtual std::vector<std::vector<Cell *>> const &cell_colors() const = 0;
+
   /**
    * @brief Determine which cell a particle id belongs to.
    *
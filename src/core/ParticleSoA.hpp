@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2020 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_PARTICLE_SOA_HPP
+#define CORE_PARTICLE_SOA_HPP
+
+#include "config.hpp"
+
+#include "Particle.hpp"
+#include "ParticleList.hpp"
+
+#include <utils/Vector.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Structure-of-arrays copy of the particle data needed by
+ *        the non-bonded pair forces.
+ *
+ * This mirrors a @ref ParticleList: the i-th entry of every array
+ * belongs to the i-th particle of the list. Positions, types and
+ * charges are gathered from the particles, forces are accumulated
+ * in the arrays and have to be added to the particles afterwards.
+ */
+struct ParticleSoA {
+  std::vector<double> x, y, z;
+  std::vector<int> type;
+  std::vector<double> q;
+  /** Non-zero if the particle has exclusions, in which case
+   *  the pair force needs the full particle. */
+  std::vector<char> has_exclusions;
+  std::vector<double> fx, fy, fz;
+
+  std::size_t size() const { return x.size(); }
+
+  /**
+   * @brief Copy positions, types and charges from the particles.
+   */
+  void gather(ParticleList const &particles) {
+    auto const n = particles.size();
+    x.resize(n);
+    y.resize(n);
+    z.resize(n);
+    type.resize(n);
+    q.resize(n);
+    has_exclusions.resize(n);
+    fx.resize(n);
+    fy.resize(n);
+    fz.resize(n);
+
+    std::size_t i = 0;
+    for (auto const &p : particles) {
+      type[i] = p.p.type;
+#ifdef ELECTROSTATICS
+      q[i] = p.p.q;
+#else
+      q[i] = 0.;
+#endif
+#ifdef EXCLUSIONS
+      has_exclusions[i] = not p.exclusions().empty();
+#else
+      has_exclusions[i] = false;
+#endif
+      ++i;
+    }
+
+    gather_positions(particles);
+  }
+
+  /**
+   * @brief Copy the positions from the particles.
+   *
+   * The particle list has to be unchanged since the last
+   * call to @ref gather.
+   */
+  void gather_positions(ParticleList const &particles) {
+    assert(particles.size() == size());
+
+    std::size_t i = 0;
+    for (auto const &p : particles) {
+      x[i] = p.r.p[0];
+      y[i] = p.r.p[1];
+      z[i] = p.r.p[2];
+      ++i;
+    }
+  }
+
+  /**
+   * @brief Axis-aligned bounding box of the particles [first, last).
+   *
+   * @return Lower and upper corner of the box.
+   */
+  std::pair<Utils::Vector3d, Utils::Vector3d> bounding_box(int first,
+                                                           int last) const {
+    assert(first < last);
+
+    Utils::Vector3d lower{x[first], y[first], z[first]};
+    auto upper = lower;
+    for (int i = first + 1; i < last; i++) {
+      lower = {std::min(lower[0], x[i]), std::min(lower[1], y[i]),
+               std::min(lower[2], z[i])};
+      upper = {std::max(upper[0], x[i]), std::max(upper[1], y[i]),
+               std::max(upper[2], z[i])};
+    }
+
+    return {lower, upper};
+  }
+
+  void reset_forces() {
+    std::fill(fx.begin(), fx.end(), 0.);
+    std::fill(fy.begin(), fy.end(), 0.);
+    std::fill(fz.begin(), fz.end(), 0.);
+  }
+
+  /**
+   * @brief Add the accumulated forces to the particles.
+   */
+  void add_forces_to(ParticleList &particles) const {
+    assert(particles.size() == size());
+
+    std::size_t i = 0;
+    for (auto &p : particles) {
+      p.f.f += Utils::Vector3d{fx[i], fy[i], fz[i]};
+      ++i;
+    }
+  }
+};
+
+#endif
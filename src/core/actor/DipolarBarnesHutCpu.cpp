@@ -0,0 +1,372 @@
+/*
+ * Copyright (C) 2020 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DipolarBarnesHutCpu.hpp"
+
+#ifdef DIPOLES
+
+#include "cells.hpp"
+#include "communication.hpp"
+#include "electrostatics_magnetostatics/dipole.hpp"
+#include "electrostatics_magnetostatics/gather_dipoles.hpp"
+#include "errorhandling.hpp"
+#include "forces.hpp"
+#include "grid.hpp"
+
+#include <utils/Vector.hpp>
+
+#include <boost/mpi/collectives/broadcast.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+std::unique_ptr<DipolarBarnesHutCpu> dipolarBarnesHutCpu;
+
+namespace {
+/** Opening angle set on the master node, broadcast on activation. */
+double bh_cpu_opening_angle = 0.5;
+
+/** Maximal number of dipoles in a leaf. */
+constexpr int leaf_size = 8;
+/** Maximal depth of the tree, stops the subdivision of coincident dipoles. */
+constexpr int max_depth = 32;
+
+struct OctreeNode {
+  /** geometric center of the cube */
+  Utils::Vector3d center;
+  /** half the edge length of the cube */
+  double half_size;
+  /** center of the dipoles, weighted by their magnitude */
+  Utils::Vector3d dip_center;
+  /** total dipole moment */
+  Utils::Vector3d dip;
+  /** distance of the farthest corner of the cube from @ref dip_center */
+  double radius;
+  /** range of the dipoles of this node in @ref Octree::order */
+  int begin;
+  int end;
+  /** indices of the child nodes, -1 for empty octants */
+  std::array<int, 8> children;
+  bool leaf;
+};
+
+/** Octree over all gathered dipoles. */
+class Octree {
+public:
+  explicit Octree(GatheredDipoles const &dipoles) : m_dipoles(dipoles) {
+    auto const n_dipoles = static_cast<int>(dipoles.x.size());
+    order.resize(n_dipoles);
+    slot.resize(n_dipoles);
+    for (int i = 0; i < n_dipoles; i++) {
+      order[i] = i;
+    }
+    if (n_dipoles == 0)
+      return;
+
+    auto const lower = Utils::Vector3d{
+        *std::min_element(dipoles.x.begin(), dipoles.x.end()),
+        *std::min_element(dipoles.y.begin(), dipoles.y.end()),
+        *std::min_element(dipoles.z.begin(), dipoles.z.end())};
+    auto const upper = Utils::Vector3d{
+        *std::max_element(dipoles.x.begin(), dipoles.x.end()),
+        *std::max_element(dipoles.y.begin(), dipoles.y.end()),
+        *std::max_element(dipoles.z.begin(), dipoles.z.end())};
+    auto const extent = upper - lower;
+
+    m_buffer.resize(n_dipoles);
+    nodes.push_back(make_node(0.5 * (lower + upper),
+                              0.5 * *std::max_element(extent.begin(),
+                                                      extent.end()),
+                              0, n_dipoles));
+    subdivide(0, 0);
+
+    for (int k = 0; k < n_dipoles; k++) {
+      slot[order[k]] = k;
+    }
+  }
+
+  Utils::Vector3d position(int i) const {
+    return {m_dipoles.x[i], m_dipoles.y[i], m_dipoles.z[i]};
+  }
+  Utils::Vector3d moment(int i) const {
+    return {m_dipoles.mx[i], m_dipoles.my[i], m_dipoles.mz[i]};
+  }
+
+  std::vector<OctreeNode> nodes;
+  /** dipole indices, the dipoles of every node are contiguous */
+  std::vector<int> order;
+  /** position of every dipole in @ref order */
+  std::vector<int> slot;
+
+private:
+  OctreeNode make_node(Utils::Vector3d const &center, double half_size,
+                       int begin, int end) const {
+    OctreeNode node;
+    node.center = center;
+    node.half_size = half_size;
+    node.begin = begin;
+    node.end = end;
+    node.children.fill(-1);
+    node.leaf = true;
+
+    double weight = 0.;
+    Utils::Vector3d weighted_pos{};
+    Utils::Vector3d dip{};
+    for (int k = begin; k < end; k++) {
+      auto const m = moment(order[k]);
+      auto const w = m.norm();
+      weight += w;
+      weighted_pos += w * position(order[k]);
+      dip += m;
+    }
+    node.dip = dip;
+    node.dip_center = (weight > 0.) ? weighted_pos / weight : center;
+    auto const offset = node.dip_center - center;
+    node.radius = Utils::Vector3d{std::abs(offset[0]) + half_size,
+                                  std::abs(offset[1]) + half_size,
+                                  std::abs(offset[2]) + half_size}
+                      .norm();
+    return node;
+  }
+
+  int octant(int i, Utils::Vector3d const &center) const {
+    auto const pos = position(i);
+    return static_cast<int>(pos[0] >= center[0]) +
+           2 * static_cast<int>(pos[1] >= center[1]) +
+           4 * static_cast<int>(pos[2] >= center[2]);
+  }
+
+  void subdivide(int node_id, int depth) {
+    auto const begin = nodes[node_id].begin;
+    auto const end = nodes[node_id].end;
+    if (end - begin <= leaf_size or depth >= max_depth)
+      return;
+
+    auto const center = nodes[node_id].center;
+    auto const half_size = nodes[node_id].half_size;
+
+    /* counting sort of the dipoles by octant */
+    std::array<int, 9> bounds{};
+    for (int k = begin; k < end; k++) {
+      bounds[octant(order[k], center) + 1]++;
+    }
+    for (int o = 0; o < 8; o++) {
+      bounds[o + 1] += bounds[o];
+    }
+    auto fill = bounds;
+    for (int k = begin; k < end; k++) {
+      m_buffer[begin + fill[octant(order[k], center)]++] = order[k];
+    }
+    std::copy(m_buffer.begin() + begin, m_buffer.begin() + end,
+              order.begin() + begin);
+
+    nodes[node_id].leaf = false;
+    for (int o = 0; o < 8; o++) {
+      if (bounds[o] == bounds[o + 1])
+        continue;
+      auto const child_center =
+          center + 0.5 * half_size *
+                       Utils::Vector3d{(o & 1) ? 1. : -1., (o & 2) ? 1. : -1.,
+                                       (o & 4) ? 1. : -1.};
+      auto const child_id = static_cast<int>(nodes.size());
+      nodes.push_back(make_node(child_center, 0.5 * half_size,
+                                begin + bounds[o], begin + bounds[o + 1]));
+      nodes[node_id].children[o] = child_id;
+      subdivide(child_id, depth + 1);
+    }
+  }
+
+  GatheredDipoles const &m_dipoles;
+  std::vector<int> m_buffer;
+};
+
+/** Energy, force and torque acting on one dipole, without prefactor. */
+struct DipoleSum {
+  double u = 0.;
+  Utils::Vector3d f{};
+  Utils::Vector3d t{};
+};
+
+/** Add the interaction of dipole @p m1 with dipole @p m2 at distance
+ *  vector @p r, same expressions as in @ref dawaanr_calculations.
+ */
+void add_pair(bool force_flag, Utils::Vector3d const &m1,
+              Utils::Vector3d const &m2, Utils::Vector3d const &r,
+              DipoleSum &sum) {
+  auto const r2 = r.norm2();
+  auto const r1 = std::sqrt(r2);
+  auto const r3 = r2 * r1;
+  auto const r5 = r3 * r2;
+
+  auto const pe1 = m1 * m2;
+  auto const pe2 = m1 * r;
+  auto const pe3 = m2 * r;
+
+  sum.u += pe1 / r3 - 3.0 * pe2 * pe3 / r5;
+
+  if (force_flag) {
+    auto const r7 = r5 * r2;
+    auto const ab = 3.0 * pe1 / r5 - 15.0 * pe2 * pe3 / r7;
+    auto const c = 3.0 * pe3 / r5;
+    auto const d = 3.0 * pe2 / r5;
+
+    sum.f += ab * r + c * m1 + d * m2;
+#ifdef ROTATION
+    sum.t += -vector_product(m1, m2) / r3 + c * vector_product(m1, r);
+#endif
+  }
+}
+} // namespace
+
+double DipolarBarnesHutCpu::calculations(bool force_flag,
+                                         ParticleRange const &particles) const {
+  auto const local = dipolar_particles(particles);
+  auto const dipoles = gather_dipoles(local);
+  auto const n_local = static_cast<int>(local.size());
+  Octree const tree(dipoles);
+
+  Utils::Vector3d mi_length{}, mi_length_i{};
+  for (int d = 0; d < 3; d++) {
+    if (box_geo.periodic(d)) {
+      mi_length[d] = box_geo.length()[d];
+      mi_length_i[d] = 1. / box_geo.length()[d];
+    }
+  }
+  auto const minimum_image = [&](Utils::Vector3d r) {
+    for (int d = 0; d < 3; d++) {
+      r[d] -= std::round(r[d] * mi_length_i[d]) * mi_length[d];
+    }
+    return r;
+  };
+  /* whether all points of a node lie within the minimum image region */
+  auto const in_minimum_image = [&](Utils::Vector3d const &r,
+                                    double half_size) {
+    for (int d = 0; d < 3; d++) {
+      if (mi_length[d] > 0. and
+          std::abs(r[d]) + half_size >= 0.5 * mi_length[d])
+        return false;
+    }
+    return true;
+  };
+
+  auto const theta = m_opening_angle;
+  double u = 0.;
+#ifdef OPENMP
+#pragma omp parallel reduction(+ : u)
+#endif
+  {
+    std::vector<int> stack;
+#ifdef OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+    for (int k = 0; k < n_local; k++) {
+      auto const i = dipoles.offset + k;
+      auto const pos_i = tree.position(i);
+      auto const dip_i = tree.moment(i);
+      auto const slot_i = tree.slot[i];
+      DipoleSum sum;
+
+      stack.assign(1, 0);
+      while (not stack.empty()) {
+        auto const &node = tree.nodes[stack.back()];
+        stack.pop_back();
+
+        if (slot_i < node.begin or slot_i >= node.end) {
+          auto const r = minimum_image(pos_i - node.dip_center);
+          if (node.radius < theta * r.norm() and
+              in_minimum_image(minimum_image(pos_i - node.center),
+                               node.half_size)) {
+            add_pair(force_flag, dip_i, node.dip, r, sum);
+            continue;
+          }
+        }
+
+        if (node.leaf) {
+          for (int s = node.begin; s < node.end; s++) {
+            auto const j = tree.order[s];
+            if (j != i) {
+              add_pair(force_flag, dip_i, tree.moment(j),
+                       minimum_image(pos_i - tree.position(j)), sum);
+            }
+          }
+        } else {
+          for (auto const child : node.children) {
+            if (child >= 0)
+              stack.push_back(child);
+          }
+        }
+      }
+      u += sum.u;
+
+      /* every thread only writes the forces of its own particles */
+      if (force_flag) {
+        local[k]->f.f += dipole.prefactor * sum.f;
+#ifdef ROTATION
+        local[k]->f.torque += dipole.prefactor * sum.t;
+#endif
+      }
+    }
+  }
+
+  /* every pair was visited from both sides */
+  return 0.5 * dipole.prefactor * u;
+}
+
+void DipolarBarnesHutCpu::computeForces(SystemInterface &) {
+  calculations(true, cell_structure.local_particles());
+}
+
+double DipolarBarnesHutCpu::energy(ParticleRange const &particles) const {
+  return calculations(false, particles);
+}
+
+int activate_dipolar_barnes_hut_cpu(double opening_angle) {
+  if (opening_angle < 0.) {
+    runtimeErrorMsg() << "Barnes-Hut opening angle has to be >= 0";
+    return ES_ERROR;
+  }
+  bh_cpu_opening_angle = opening_angle;
+  Dipole::set_method_local(DIPOLAR_BH_CPU);
+  // also necessary on 1 CPU, does more than just broadcasting
+  mpi_bcast_coulomb_params();
+
+  return ES_OK;
+}
+
+void deactivate_dipolar_barnes_hut_cpu() {
+  if (dipolarBarnesHutCpu) {
+    forceActors.remove(dipolarBarnesHutCpu.get());
+    dipolarBarnesHutCpu.reset();
+  }
+}
+
+void dipolar_barnes_hut_cpu_bcast_params(boost::mpi::communicator const &comm) {
+  boost::mpi::broadcast(comm, bh_cpu_opening_angle, 0);
+
+  deactivate_dipolar_barnes_hut_cpu();
+  dipolarBarnesHutCpu =
+      std::make_unique<DipolarBarnesHutCpu>(bh_cpu_opening_angle);
+  forceActors.push_back(dipolarBarnesHutCpu.get());
+}
+
+double dipolar_barnes_hut_cpu_opening_angle() { return bh_cpu_opening_angle; }
+
+#endif // DIPOLES
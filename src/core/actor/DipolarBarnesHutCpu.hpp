@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2020 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef ACTOR_DIPOLARBARNESHUTCPU_HPP
+#define ACTOR_DIPOLARBARNESHUTCPU_HPP
+/** \file
+ *  Barnes-Hut octree approximation of the dipolar all-with-all sum on
+ *  the CPU.
+ *
+ *  The dipoles of all ranks are gathered on every rank and sorted into an
+ *  octree. For every local dipole, the tree is traversed from the root:
+ *  a node is replaced by its total dipole moment placed at the dipole
+ *  center of the node if the distance from the dipole center to the
+ *  farthest corner of the node is smaller than the opening angle times the
+ *  distance to the particle, otherwise its children are visited. Leaves are summed
+ *  directly. In periodic directions, the minimum image convention is
+ *  applied, like in @ref dawaanr_calculations. An opening angle of zero
+ *  reproduces the direct sum.
+ *
+ *  The local dipoles are distributed over the OpenMP threads.
+ *
+ *  Implementation in DipolarBarnesHutCpu.cpp.
+ */
+
+#include "config.hpp"
+
+#ifdef DIPOLES
+
+#include "Actor.hpp"
+#include "SystemInterface.hpp"
+
+#include <ParticleRange.hpp>
+
+#include <boost/mpi/communicator.hpp>
+
+#include <memory>
+
+class DipolarBarnesHutCpu : public Actor {
+public:
+  explicit DipolarBarnesHutCpu(double opening_angle)
+      : m_opening_angle(opening_angle) {}
+
+  void computeForces(SystemInterface &s) override;
+
+  /** Dipolar energy of the local particles. */
+  double energy(ParticleRange const &particles) const;
+
+  double opening_angle() const { return m_opening_angle; }
+
+private:
+  double calculations(bool force_flag, ParticleRange const &particles) const;
+
+  /** Ratio of node radius and distance below which a node is not opened. */
+  double m_opening_angle;
+};
+
+/** Activate the CPU Barnes-Hut method.
+ *
+ *  @param opening_angle  opening angle of the tree traversal, has to be
+ *                        non-negative
+ *  @retval ES_OK
+ *  @retval ES_ERROR
+ */
+int activate_dipolar_barnes_hut_cpu(double opening_angle);
+
+/** Remove the actor of this rank. */
+void deactivate_dipolar_barnes_hut_cpu();
+
+/** Broadcast the parameters and create the actor on all ranks.
+ *  Called from @ref Dipole::bcast_params.
+ */
+void dipolar_barnes_hut_cpu_bcast_params(boost::mpi::communicator const &comm);
+
+/** Opening angle of the active CPU Barnes-Hut method. */
+double dipolar_barnes_hut_cpu_opening_angle();
+
+extern std::unique_ptr<DipolarBarnesHutCpu> dipolarBarnesHutCpu;
+
+#endif // DIPOLES
+#endif
@@ -46,6 +46,9 @@ namespace Algorithm {
  * verlet_criterion(p1, p2, distance_function(p1, p2)) has to be valid and
  * convertible to bool.
  *
+ * If @p self_pairs is false, only the pairs with the neighbors are visited,
+ * not the pairs within the cells.
+ *
  * ParticleKernel has to provide an %operator() member that can be called
  * with a particle reference.
  * PairKernel has to provide an %operator() member that can be called
@@ -57,16 +60,17 @@ void for_each_pair(CellIterator first, CellIterator last,
                    ParticleKernel &&particle_kernel, PairKernel &&pair_kernel,
                    DistanceFunction &&distance_function,
                    VerletCriterion &&verlet_criterion, bool use_verlet_list,
-                   bool rebuild) {
+                   bool rebuild, bool self_pairs = true) {
   if (use_verlet_list) {
     verlet_ia(first, last, std::forward<ParticleKernel>(particle_kernel),
               std::forward<PairKernel>(pair_kernel),
               std::forward<DistanceFunction>(distance_function),
-              std::forward<VerletCriterion>(verlet_criterion), rebuild);
+              std::forward<VerletCriterion>(verlet_criterion), rebuild,
+              self_pairs);
   } else {
     link_cell(first, last, std::forward<ParticleKernel>(particle_kernel),
               std::forward<PairKernel>(pair_kernel),
-              std::forward<DistanceFunction>(distance_function));
+              std::forward<DistanceFunction>(distance_function), self_pairs);
   }
 }
 } // namespace Algorithm
@@ -25,12 +25,16 @@ namespace Algorithm {
  * @brief Iterates over all particles in the cell range,
  *        and over all pairs within the cells and with
  *        their neighbors.
+ *
+ * If @p self_pairs is false, the pairs within the cells are skipped,
+ * which is used for ghost cells whose own pairs are handled by the
+ * node owning them.
  */
 template <typename CellIterator, typename ParticleKernel, typename PairKernel,
           typename DistanceFunction>
 void link_cell(CellIterator first, CellIterator last,
                ParticleKernel &&particle_kernel, PairKernel &&pair_kernel,
-               DistanceFunction &&distance_function) {
+               DistanceFunction &&distance_function, bool self_pairs = true) {
   for (; first != last; ++first) {
     for (auto it = first->particles().begin(); it != first->particles().end();
          ++it) {
@@ -39,9 +43,11 @@ void link_cell(CellIterator first, CellIterator last,
       particle_kernel(p1);
 
       /* Pairs in this cell */
-      for (auto jt = std::next(it); jt != first->particles().end(); ++jt) {
-        auto const dist = distance_function(p1, *jt);
-        pair_kernel(p1, *jt, dist);
+      if (self_pairs) {
+        for (auto jt = std::next(it); jt != first->particles().end(); ++jt) {
+          auto const dist = distance_function(p1, *jt);
+          pair_kernel(p1, *jt, dist);
+        }
       }
 
       /* Pairs with neighbors */
@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2020 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef ALGORITHM_LINK_CELL_BATCHED_HPP
+#define ALGORITHM_LINK_CELL_BATCHED_HPP
+
+namespace Algorithm {
+
+/**
+ * @brief Iterates over all particles in the cell range,
+ *        and hands each particle together with the range of
+ *        its partners within the cell and in the neighbor cells
+ *        to the kernel.
+ *
+ * The kernel is called with (cell, i, partner_cell, j_first, j_last)
+ * where i is the index of the particle in cell, and the partners are
+ * the particles with indices [j_first, j_last) in partner_cell.
+ * Every pair is visited exactly once. If @p self_pairs is false, the
+ * pairs within the cells are skipped.
+ */
+template <typename CellIterator, typename BatchKernel>
+void link_cell_batched(CellIterator first, CellIterator last,
+                       BatchKernel &&batch_kernel, bool self_pairs = true) {
+  for (; first != last; ++first) {
+    auto &cell = *first;
+    auto const n_part = static_cast<int>(cell.particles().size());
+
+    for (int i = 0; i < n_part; i++) {
+      /* Pairs in this cell */
+      if (self_pairs)
+        batch_kernel(cell, i, cell, i + 1, n_part);
+
+      /* Pairs with neighbors */
+      for (auto &neighbor : cell.neighbors().red()) {
+        batch_kernel(cell, i, *neighbor, 0,
+                     static_cast<int>(neighbor->particles().size()));
+      }
+    }
+  }
+}
+} // namespace Algorithm
+
+#endif
@@ -19,6 +19,7 @@
 #ifndef CORE_ALGORITHM_VERLET_IA_HPP
 #define CORE_ALGORITHM_VERLET_IA_HPP
 
+#include <algorithm>
 #include <utility>
 
 namespace Algorithm {
@@ -30,7 +31,7 @@ void update_and_kernel(CellIterator first, CellIterator last,
                        ParticleKernel &&particle_kernel,
                        PairKernel &&pair_kernel,
                        DistanceFunction &&distance_function,
-                       VerletCriterion &&verlet_criterion) {
+                       VerletCriterion &&verlet_criterion, bool self_pairs) {
   for (; first != last; ++first) {
     /* Clear the VL */
     first->m_verlet_list.clear();
@@ -42,11 +43,13 @@ void update_and_kernel(CellIterator first, CellIterator last,
       particle_kernel(p1);
 
       /* Pairs in this cell */
-      for (auto jt = std::next(it); jt != first->particles().end(); ++jt) {
-        auto const dist = distance_function(p1, *jt);
-        if (verlet_criterion(p1, *jt, dist)) {
-          pair_kernel(p1, *jt, dist);
-          first->m_verlet_list.emplace_back(&p1, &(*jt));
+      if (self_pairs) {
+        for (auto jt = std::next(it); jt != first->particles().end(); ++jt) {
+          auto const dist = distance_function(p1, *jt);
+          if (verlet_criterion(p1, *jt, dist)) {
+            pair_kernel(p1, *jt, dist);
+            first->m_verlet_list.emplace_back(&p1, &(*jt));
+          }
         }
       }
 
@@ -87,25 +90,113 @@ void kernel(CellIterator first, CellIterator last,
  *        and all pairs in the Verlet list of the cells.
  *        If rebuild is true, all neighbor cells are iterated
  *        and the Verlet lists are updated with the so found pairs.
+ *        If @p self_pairs is false, the pairs within the cells
+ *        are not added to the lists.
  */
 template <typename CellIterator, typename ParticleKernel, typename PairKernel,
           typename DistanceFunction, typename VerletCriterion>
 void verlet_ia(CellIterator first, CellIterator last,
                ParticleKernel &&particle_kernel, PairKernel &&pair_kernel,
                DistanceFunction &&distance_function,
-               VerletCriterion &&verlet_criterion, bool rebuild) {
+               VerletCriterion &&verlet_criterion, bool rebuild,
+               bool self_pairs = true) {
   if (rebuild) {
     detail::update_and_kernel(first, last,
                               std::forward<ParticleKernel>(particle_kernel),
                               std::forward<PairKernel>(pair_kernel),
                               std::forward<DistanceFunction>(distance_function),
-                              std::forward<VerletCriterion>(verlet_criterion));
+                              std::forward<VerletCriterion>(verlet_criterion),
+                              self_pairs);
   } else {
     detail::kernel(first, last, std::forward<ParticleKernel>(particle_kernel),
                    std::forward<PairKernel>(pair_kernel),
                    std::forward<DistanceFunction>(distance_function));
   }
 }
+
+namespace detail {
+/**
+ * @brief Add all pairs of clusters of two cells that fulfill the
+ *        criterion to the cluster pair list of the first cell.
+ */
+template <typename Cell, typename ClusterCriterion>
+void add_cluster_pairs(Cell &cell1, Cell &cell2, int cluster_size,
+                       ClusterCriterion &cluster_criterion) {
+  auto const n1 = static_cast<int>(cell1.particles().size());
+  auto const n2 = static_cast<int>(cell2.particles().size());
+  auto const same_cell = (&cell1 == &cell2);
+
+  for (int i_first = 0; i_first < n1; i_first += cluster_size) {
+    auto const i_last = std::min(i_first + cluster_size, n1);
+
+    /* Within a cell, every pair of clusters is only added once. */
+    for (int j_first = same_cell ? i_first : 0; j_first < n2;
+         j_first += cluster_size) {
+      auto const j_last = std::min(j_first + cluster_size, n2);
+
+      if (cluster_criterion(cell1, i_first, i_last, cell2, j_first, j_last)) {
+        cell1.m_cluster_pairs.push_back(
+            {i_first, i_last, &cell2, j_first, j_last});
+      }
+    }
+  }
+}
+} // namespace detail
+
+/**
+ * @brief Iterates over all pairs in the cluster pair lists of the cells.
+ *
+ * The particles of each cell are split into clusters of
+ * @p cluster_size consecutive particles, and instead of particle
+ * pairs, pairs of clusters that may interact are stored in the
+ * %m_cluster_pairs list of the cell. This reduces the size of the
+ * lists, and the inner loop runs over contiguous particles.
+ * If rebuild is true, the clusters of the cell and its red
+ * neighbors are checked with the criterion and the lists are
+ * updated before they are used.
+ *
+ * The cluster criterion is called with
+ * (cell1, i_first, i_last, cell2, j_first, j_last) and has to return
+ * true if any particle of the first cluster may interact with any
+ * particle of the second cluster. The batch kernel is called with
+ * (cell1, i, cell2, j_first, j_last) for every particle i of the first
+ * cluster of a pair, and the range of its partners. Every pair of
+ * particles within the cluster pairs is visited exactly once, pairs
+ * beyond the interaction range have to be masked out by the kernel.
+ * If @p self_pairs is false, the pairs within the cells are skipped.
+ */
+template <typename CellIterator, typename BatchKernel,
+          typename ClusterCriterion>
+void verlet_ia_clustered(CellIterator first, CellIterator last,
+                         int cluster_size, BatchKernel &&batch_kernel,
+                         ClusterCriterion &&cluster_criterion, bool rebuild,
+                         bool self_pairs = true) {
+  for (; first != last; ++first) {
+    auto &cell = *first;
+
+    if (rebuild) {
+      cell.m_cluster_pairs.clear();
+
+      if (self_pairs)
+        detail::add_cluster_pairs(cell, cell, cluster_size,
+                                  cluster_criterion);
+      for (auto &neighbor : cell.neighbors().red()) {
+        detail::add_cluster_pairs(cell, *neighbor, cluster_size,
+                                  cluster_criterion);
+      }
+    }
+
+    for (auto const &pair : cell.m_cluster_pairs) {
+      auto const self_pair =
+          (pair.partner == &cell) and (pair.j_first == pair.i_first);
+
+      for (int i = pair.i_first; i < pair.i_last; i++) {
+        batch_kernel(cell, i, *pair.partner, self_pair ? i + 1 : pair.j_first,
+                     pair.j_last);
+      }
+    }
+  }
+}
 } // namespace Algorithm
 
 #endif
@@ -26,11 +26,13 @@
  */
 #include "cells.hpp"
 #include "Particle.hpp"
+#include "collision.hpp"
 #include "communication.hpp"
 #include "debug.hpp"
 #include "errorhandling.hpp"
 #include "event.hpp"
 #include "grid.hpp"
+#include "grid_based_algorithms/lb_interface.hpp"
 #include "integrate.hpp"
 #include "nonbonded_interactions/nonbonded_interaction_data.hpp"
 #include "short_range_loop.hpp"
@@ -41,16 +43,22 @@
 #include <utils/NoOp.hpp>
 #include <utils/mpi/gather_buffer.hpp>
 
+#include <boost/mpi/collectives/gather.hpp>
 #include <boost/range/adaptor/uniqued.hpp>
 #include <boost/range/algorithm/sort.hpp>
+#include <boost/serialization/vector.hpp>
 
 #include <cstdio>
+#include <iterator>
 
 /** Type of cell structure in use */
 CellStructure cell_structure;
 
 bool rebuild_verletlist = true;
 
+/** Maximal interaction cutoff at the last re-init */
+static double max_cutoff = INACTIVE_CUTOFF;
+
 /**
  * @brief Get pairs closer than distance from the cells.
  *
@@ -110,6 +118,32 @@ std::vector<std::pair<int, int>> mpi_get_pairs(double distance) {
   return pairs;
 }
 
+static std::vector<std::vector<int>> get_cell_particle_ids() {
+  std::vector<std::vector<int>> local_ids;
+  for (auto const cell : cell_structure.local_cells()) {
+    local_ids.emplace_back();
+    for (auto const &p : cell->particles()) {
+      local_ids.back().push_back(p.identity());
+    }
+  }
+
+  std::vector<std::vector<std::vector<int>>> node_ids;
+  boost::mpi::gather(comm_cart, local_ids, node_ids, 0);
+
+  std::vector<std::vector<int>> ids;
+  for (auto &cells : node_ids) {
+    std::move(cells.begin(), cells.end(), std::back_inserter(ids));
+  }
+
+  return ids;
+}
+
+REGISTER_CALLBACK_MASTER_RANK(get_cell_particle_ids)
+
+std::vector<std::vector<int>> mpi_get_cell_particle_ids() {
+  return mpi_call(Communication::Result::master_rank, get_cell_particle_ids);
+}
+
 /************************************************************
  *            Exported Functions                            *
  ************************************************************/
@@ -117,6 +151,8 @@ std::vector<std::pair<int, int>> mpi_get_pairs(double distance) {
 /************************************************************/
 
 void cells_re_init(int new_cs) {
+  max_cutoff = maximal_cutoff();
+
   switch (new_cs) {
   case CELL_STRUCTURE_DOMDEC:
     cell_structure.set_domain_decomposition(comm_cart, interaction_range(),
@@ -132,6 +168,8 @@ void cells_re_init(int new_cs) {
   on_cell_structure_change();
 }
 
+double cells_max_cutoff() { return max_cutoff; }
+
 /*************************************************/
 
 void cells_resort_particles(int global_flag) {
@@ -165,7 +203,14 @@ void check_resort_particles() {
 }
 
 /*************************************************/
-void cells_update_ghosts(unsigned data_parts) {
+/**
+ * @brief Update ghost information, and resort the particles if needed.
+ *
+ * @param data_parts Particle parts to update.
+ * @param async If true, the update of the ghosts may only be started,
+ *        see @ref CellStructure::ghosts_update_begin.
+ */
+static void update_ghosts(unsigned data_parts, bool async) {
   /* data parts that are only updated on resort */
   auto constexpr resort_only_parts =
       Cells::DATA_PART_PROPERTIES | Cells::DATA_PART_BONDS;
@@ -194,10 +239,31 @@ void cells_update_ghosts(unsigned data_parts) {
 
     /* Particles are now sorted */
     cell_structure.clear_resort_particles();
+  } else if (async) {
+    /* Communication step: ghost information, completed later */
+    cell_structure.ghosts_update_begin(data_parts & ~resort_only_parts);
   } else {
     /* Communication step: ghost information */
     cell_structure.ghosts_update(data_parts & ~resort_only_parts);
   }
+
+  if (cell_structure.use_soa) {
+    if (cell_structure.ghosts_update_pending()) {
+      /* The ghost copies are updated once the ghosts have arrived. */
+      cell_structure.update_local_soa_positions();
+    } else {
+      /* Properties can only change together with a resort. */
+      cell_structure.update_soa(global_resort != Cells::RESORT_NONE);
+    }
+  }
+}
+
+void cells_update_ghosts(unsigned data_parts) {
+  update_ghosts(data_parts, false);
+}
+
+void cells_update_ghosts_begin(unsigned data_parts) {
+  update_ghosts(data_parts, true);
 }
 
 Cell *find_current_cell(const Particle &p) {
@@ -217,4 +283,59 @@ const DomainDecomposition *get_domain_decomposition() {
 
 void cells_set_use_verlet_lists(bool use_verlet_lists) {
   cell_structure.use_verlet_list = use_verlet_lists;
+}
+
+void cells_set_use_async_ghosts(bool use_async_ghosts) {
+  cell_structure.ghosts_update_wait();
+  cell_structure.use_async_ghosts = use_async_ghosts;
+}
+
+void cells_set_use_spatial_sort(bool use_spatial_sort) {
+  cell_structure.use_spatial_sort = use_spatial_sort;
+  cell_structure.set_resort_particles(Cells::RESORT_LOCAL);
+}
+
+void cells_set_use_eighth_shell(bool use_eighth_shell) {
+  cell_structure.use_eighth_shell = use_eighth_shell;
+}
+
+void cells_sanity_checks() {
+  if (cell_structure.decomposition_type() != CELL_STRUCTURE_DOMDEC or
+      not cell_structure.use_eighth_shell)
+    return;
+
+  /* Without the ghosts of the lower neighbors, only pairs of
+   * particles can be handled, and the pairs between two ghosts
+   * have no access to the exclusions. */
+  if (lattice_switch != ActiveLB::NONE) {
+    runtimeErrorMsg() << "The eighth-shell scheme does not support "
+                         "lattice-Boltzmann";
+  }
+#ifdef COLLISION_DETECTION
+  if (collision_params.mode != COLLISION_MODE_OFF) {
+    runtimeErrorMsg() << "The eighth-shell scheme does not support "
+                         "collision detection";
+  }
+#endif
+
+  for (auto const &p : cell_structure.local_particles()) {
+    auto unsupported = not p.bonds().empty();
+#ifdef EXCLUSIONS
+    unsupported |= not p.exclusions().empty();
+#endif
+#ifdef VIRTUAL_SITES
+    unsupported |= p.p.is_virtual;
+#endif
+    if (unsupported) {
+      runtimeErrorMsg() << "The eighth-shell scheme does not support "
+                           "bonds, exclusions or virtual sites";
+      break;
+    }
+  }
+}
+
+void cells_set_use_soa(bool use_soa) {
+  cell_structure.use_soa = use_soa;
+  /* Trigger a full update of the copies on the next ghost update. */
+  cell_structure.set_resort_particles(Cells::RESORT_LOCAL);
 }
\ No newline at end of file
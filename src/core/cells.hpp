@@ -84,6 +84,12 @@ extern bool rebuild_verletlist;
  */
 void cells_re_init(int new_cs);
 
+/** Maximal interaction cutoff (without the skin) at the last call
+ *  to @ref cells_re_init. All cutoff changes trigger a re-init, so
+ *  this is the cutoff the current cell system was built for.
+ */
+double cells_max_cutoff();
+
 /**
  * @brief Set use_verlet_lists
  *
@@ -91,6 +97,49 @@ void cells_re_init(int new_cs);
  */
 void cells_set_use_verlet_lists(bool use_verlet_lists);
 
+/**
+ * @brief Set use_soa
+ *
+ * @param use_soa Should structure-of-arrays copies of the
+ *        particles be used for the non-bonded forces?
+ */
+void cells_set_use_soa(bool use_soa);
+
+/**
+ * @brief Set use_async_ghosts
+ *
+ * @param use_async_ghosts Should the update of the ghost positions
+ *        overlap with the force calculation?
+ */
+void cells_set_use_async_ghosts(bool use_async_ghosts);
+
+/**
+ * @brief Set use_spatial_sort
+ *
+ * The particles are sorted on the next resort, the order of the
+ * cells changes on the next @ref cells_re_init.
+ *
+ * @param use_spatial_sort Should the particles and cells be ordered
+ *        along a space-filling curve?
+ */
+void cells_set_use_spatial_sort(bool use_spatial_sort);
+
+/**
+ * @brief Set use_eighth_shell
+ *
+ * Takes effect on the next @ref cells_re_init.
+ *
+ * @param use_eighth_shell Should the domain decomposition only import
+ *        ghosts from the upper neighbors?
+ */
+void cells_set_use_eighth_shell(bool use_eighth_shell);
+
+/** Check that the active features are compatible with the cell system,
+ *  called by @ref on_observable_calc before every evaluation of the
+ *  short-range interactions outside of the integration loop.
+ */
+void cells_sanity_checks();
+
 /** Sort the particles into the cells and initialize the ghost particle
  *  structures.
  */
@@ -101,6 +150,14 @@ void cells_resort_particles(int global_flag);
  */
 void cells_update_ghosts(unsigned data_parts);
 
+/** Like @ref cells_update_ghosts, but if no resort is needed and
+ *  @ref CellStructure::use_async_ghosts is set, the ghost update is only
+ *  started. It is completed by the force calculation, or has to be
+ *  completed by @ref CellStructure::ghosts_update_wait before the ghosts
+ *  are accessed otherwise.
+ */
+void cells_update_ghosts_begin(unsigned data_parts);
+
 /**
  * @brief Get pairs closer than @p distance from the cells.
  *
@@ -108,6 +165,14 @@ void cells_update_ghosts(unsigned data_parts);
  */
 std::vector<std::pair<int, int>> mpi_get_pairs(double distance);
 
+/**
+ * @brief Get the ids of the particles of all local cells, in the order
+ *        in which the particles are stored in the cells.
+ *
+ * This is mostly for testing purposes.
+ */
+std::vector<std::vector<int>> mpi_get_cell_particle_ids();
+
 /** Check if a particle resorting is required. */
 void check_resort_particles();
 
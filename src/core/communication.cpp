@@ -312,6 +312,8 @@ int mpi_integrate(int n_steps, int reuse_forces) {
 /*************** BCAST IA ************/
 static void mpi_bcast_all_ia_params_slave() {
   boost::mpi::broadcast(comm_cart, ia_params, 0);
+
+  on_short_range_ia_change();
 }
 
 REGISTER_CALLBACK(mpi_bcast_all_ia_params_slave)
@@ -505,6 +507,28 @@ void mpi_set_use_verlet_lists(bool use_verlet_lists) {
   mpi_call_all(cells_set_use_verlet_lists, use_verlet_lists);
 }
 
+REGISTER_CALLBACK(cells_set_use_soa)
+
+void mpi_set_use_soa(bool use_soa) { mpi_call_all(cells_set_use_soa, use_soa); }
+
+REGISTER_CALLBACK(cells_set_use_async_ghosts)
+
+void mpi_set_use_async_ghosts(bool use_async_ghosts) {
+  mpi_call_all(cells_set_use_async_ghosts, use_async_ghosts);
+}
+
+REGISTER_CALLBACK(cells_set_use_spatial_sort)
+
+void mpi_set_use_spatial_sort(bool use_spatial_sort) {
+  mpi_call_all(cells_set_use_spatial_sort, use_spatial_sort);
+}
+
+REGISTER_CALLBACK(cells_set_use_eighth_shell)
+
+void mpi_set_use_eighth_shell(bool use_eighth_shell) {
+  mpi_call_all(cells_set_use_eighth_shell, use_eighth_shell);
+}
+
 /*************** BCAST NPTISO GEOM *****************/
 
 void mpi_bcast_nptiso_geom() {
@@ -556,6 +580,7 @@ void mpi_send_exclusion(int part1, int part2, int _delete) {
 #ifdef ELECTROSTATICS
 void mpi_iccp3m_init_slave(const iccp3m_struct &iccp3m_cfg_) {
   iccp3m_cfg = iccp3m_cfg_;
+  iccp3m_reset_history();
 
   on_particle_charge_change();
   check_runtime_errors(comm_cart);
@@ -565,6 +590,7 @@ REGISTER_CALLBACK(mpi_iccp3m_init_slave)
 
 int mpi_iccp3m_init() {
   mpi_call(mpi_iccp3m_init_slave, iccp3m_cfg);
+  iccp3m_reset_history();
 
   on_particle_charge_change();
   return check_runtime_errors(comm_cart);
@@ -244,6 +244,22 @@ void mpi_bcast_cell_structure(int cs);
 
 void mpi_set_use_verlet_lists(bool use_verlet_lists);
 
+/** Enable or disable the structure-of-arrays particle copies
+ *  on all nodes. */
+void mpi_set_use_soa(bool use_soa);
+
+/** Enable or disable the overlap of the ghost position update
+ *  with the force calculation on all nodes. */
+void mpi_set_use_async_ghosts(bool use_async_ghosts);
+
+/** Enable or disable the ordering of the particles and cells
+ *  along a space-filling curve on all nodes. */
+void mpi_set_use_spatial_sort(bool use_spatial_sort);
+
+/** Enable or disable the eighth-shell scheme of the domain
+ *  decomposition on all nodes. */
+void mpi_set_use_eighth_shell(bool use_eighth_shell);
+
 /** Broadcast nptiso geometry parameter to all nodes. */
 void mpi_bcast_nptiso_geom();
 
@@ -22,6 +22,7 @@
 #ifdef DIPOLES
 
 #include "actor/DipolarBarnesHut.hpp"
+#include "actor/DipolarBarnesHutCpu.hpp"
 #include "actor/DipolarDirectSum.hpp"
 #include "electrostatics_magnetostatics/magnetic_non_p3m_methods.hpp"
 #include "electrostatics_magnetostatics/mdlc_correction.hpp"
@@ -63,7 +64,7 @@ void nonbonded_sanity_check(int &state) {
     if (mdlc_sanity_checks())
       state = 0; // fall through
   case DIPOLAR_P3M:
-    if (dp3m_sanity_checks(node_grid))
+    if (dp3m_sanity_checks())
       state = 0;
     break;
   case DIPOLAR_MDLC_DS:
@@ -192,6 +193,9 @@ void calc_long_range_force(const ParticleRange &particles) {
     // do nothing: it's an actor
     break;
 #endif
+  case DIPOLAR_BH_CPU:
+    // do nothing: it's an actor
+    break;
 #ifdef SCAFACOS_DIPOLES
   case DIPOLAR_SCAFACOS:
     assert(Scafacos::dipolar());
@@ -239,6 +243,10 @@ double calc_energy_long_range(const ParticleRange &particles) {
     // do nothing: it's an actor.
     break;
 #endif
+  case DIPOLAR_BH_CPU:
+    // only a force actor: the energy actors run before this function
+    energy = dipolarBarnesHutCpu->energy(particles);
+    break;
 #ifdef SCAFACOS_DIPOLES
   case DIPOLAR_SCAFACOS:
     assert(Scafacos::dipolar());
@@ -274,6 +282,10 @@ int set_mesh() {
 void bcast_params(const boost::mpi::communicator &comm) {
   namespace mpi = boost::mpi;
 
+  if (dipole.method != DIPOLAR_BH_CPU) {
+    deactivate_dipolar_barnes_hut_cpu();
+  }
+
   switch (dipole.method) {
 #ifdef DP3M
   case DIPOLAR_MDLC_P3M:
@@ -282,7 +294,16 @@ void bcast_params(const boost::mpi::communicator &comm) {
   case DIPOLAR_P3M:
     mpi::broadcast(comm, dp3m.params, 0);
     break;
+  case DIPOLAR_MDLC_DS:
+    mpi::broadcast(comm, dlc_params, 0);
+    // fall through
 #endif
+  case DIPOLAR_DS:
+    mpi::broadcast(comm, Ncut_off_magnetic_dipolar_direct_sum, 0);
+    break;
+  case DIPOLAR_BH_CPU:
+    dipolar_barnes_hut_cpu_bcast_params(comm);
+    break;
   default:
     break;
   }
@@ -51,6 +51,8 @@ enum DipolarInteraction {
   /** Dipolar method is direct summation on GPU by Barnes-Hut algorithm. */
   DIPOLAR_BH_GPU,
 #endif
+  /** Dipolar method is the Barnes-Hut octree approximation on CPU. */
+  DIPOLAR_BH_CPU,
   /** Dipolar method is ScaFaCoS. */
   DIPOLAR_SCAFACOS
 };
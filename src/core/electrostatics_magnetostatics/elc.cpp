@@ -27,8 +27,10 @@
 #include "grid.hpp"
 #include "mmm-common.hpp"
 
+#include <algorithm>
 #include <cmath>
 #include <mpi.h>
+#include <vector>
 
 #include "electrostatics_magnetostatics/coulomb.hpp"
 #include "electrostatics_magnetostatics/elc.hpp"
@@ -43,6 +45,9 @@
 /** Largest reasonable cutoff for far formula */
 #define MAXIMAL_FAR_CUT 50
 
+/** Default of @ref ELC_struct::max_block_size */
+#define MAX_PARTBLK_SIZE (1 << 21)
+
 /****************************************
  * LOCAL VARIABLES
  ****************************************/
@@ -52,8 +57,8 @@
 static double ux, uy, uz, height_inverse;
 /*@}*/
 
-ELC_struct elc_params = {1e100, 10,    1, 0, true, true, false, 1,
-                         1,     false, 0, 0, 0,    0,    0.0};
+ELC_struct elc_params = {1e100, 10, 1, 0, true, true, false, 1, 1, false,
+                         0,     0,  0, 0, 0.0,  MAX_PARTBLK_SIZE};
 
 /****************************************
  * LOCAL ARRAYS
@@ -79,11 +84,30 @@ ELC_struct elc_params = {1e100, 10,    1, 0, true, true, false, 1,
 #define PQECCM 7
 /*@}*/
 
-/** temporary buffers for product decomposition */
+/** Particle blocks of a batch of frequency modes. The blocks of a mode are
+ *  stored contiguously, starting at the mode offset times the number of
+ *  charged particles.
+ */
 static std::vector<double> partblk;
+/** Sums of the particle blocks of a batch of modes over all nodes */
+static std::vector<double> modesums;
 /** collected data from the other cells */
 static double gblcblk[8];
 
+/** Frequency mode of the exponential sum */
+struct FarMode {
+  /** frequency index in x, 0 for the q-only modes */
+  int p;
+  /** frequency index in y, 0 for the p-only modes */
+  int q;
+  double omega;
+  /** position of the mode sums in @ref modesums within the batch */
+  int offset;
+
+  /** number of components of the mode blocks */
+  int size() const { return (p != 0 and q != 0) ? 8 : 4; }
+};
+
 /** structure for caching sin and cos values */
 typedef struct {
   double s, c;
@@ -102,23 +126,30 @@ static std::vector<SCCache> scycache;
 static void distribute(int size);
 /** \name p=0 per frequency code */
 /*@{*/
-static void setup_P(int p, double omega, const ParticleRange &particles);
-static void add_P_force(const ParticleRange &particles);
-static double P_energy(double omega, int n_part);
+static void setup_P(int p, double omega,
+                    const std::vector<Particle *> &particles, double *blk,
+                    double *sums);
+static void add_P_force(double const *blk, double const *sums,
+                        Utils::Vector3d &force);
+static double P_energy(double omega, double const *blk, double const *sums);
 /*@}*/
 /** \name q=0 per frequency code */
 /*@{*/
-static void setup_Q(int q, double omega, const ParticleRange &particles);
-static void add_Q_force(const ParticleRange &particles);
-static double Q_energy(double omega, int n_part);
+static void setup_Q(int q, double omega,
+                    const std::vector<Particle *> &particles, double *blk,
+                    double *sums);
+static void add_Q_force(double const *blk, double const *sums,
+                        Utils::Vector3d &force);
+static double Q_energy(double omega, double const *blk, double const *sums);
 /*@}*/
 /** \name p,q <> 0 per frequency code */
 /*@{*/
 static void setup_PQ(int p, int q, double omega,
-                     const ParticleRange &particles);
-static void add_PQ_force(int p, int q, double omega,
-                         const ParticleRange &particles);
-static double PQ_energy(double omega, int n_part);
+                     const std::vector<Particle *> &particles, double *blk,
+                     double *sums);
+static void add_PQ_force(int p, int q, double omega, double const *blk,
+                         double const *sums, Utils::Vector3d &force);
+static double PQ_energy(double omega, double const *blk, double const *sums);
 /*@}*/
 static void add_dipole_force(const ParticleRange &particles);
 static double dipole_energy(const ParticleRange &particles);
@@ -144,17 +175,20 @@ void ELC_setup_constants() {
  * @return Calculated values.
  */
 template <size_t dir>
-static std::vector<SCCache> sc_cache(const ParticleRange &particles, int n_freq,
-                                     double u) {
+static std::vector<SCCache> sc_cache(const std::vector<Particle *> &particles,
+                                     int n_freq, double u) {
   auto const n_part = particles.size();
   std::vector<SCCache> ret(n_freq * n_part);
 
-  for (size_t freq = 1; freq <= n_freq; freq++) {
+#ifdef OPENMP
+#pragma omp parallel for
+#endif
+  for (int freq = 1; freq <= n_freq; freq++) {
     double pref = C_2PI * u * freq;
 
     size_t o = (freq - 1) * n_part;
-    for (auto const &part : particles) {
-      auto const arg = pref * part.r.p[dir];
+    for (auto const *part : particles) {
+      auto const arg = pref * part->r.p[dir];
       ret[o++] = {sin(arg), cos(arg)};
     }
   }
@@ -162,8 +196,9 @@ static std::vector<SCCache> sc_cache(const ParticleRange &particles, int n_freq,
   return ret;
 }
 
-static void prepare_sc_cache(const ParticleRange &particles, int n_freq_x,
-                             double u_x, int n_freq_y, double u_y) {
+static void prepare_sc_cache(const std::vector<Particle *> &particles,
+                             int n_freq_x, double u_x, int n_freq_y,
+                             double u_y) {
   scxcache = sc_cache<0>(particles, n_freq_x, u_x);
   scycache = sc_cache<1>(particles, n_freq_y, u_y);
 }
@@ -505,7 +540,9 @@ static void add_z_force(const ParticleRange &particles) {
 /* PoQ exp sum */
 /*****************************************************************/
 
-static void setup_P(int p, double omega, const ParticleRange &particles) {
+static void setup_P(int p, double omega,
+                    const std::vector<Particle *> &particles, double *blk,
+                    double *sums) {
   double const pref = -coulomb.prefactor * 4 * M_PI * ux * uy /
                       (expm1(omega * box_geo.length()[2]));
   double const pref_di = coulomb.prefactor * 4 * M_PI * ux * uy;
@@ -523,19 +560,20 @@ static void setup_P(int p, double omega, const ParticleRange &particles) {
   }
 
   clear_vec(lclimge, size);
-  clear_vec(gblcblk, size);
+  clear_vec(sums, size);
 
   int ic = 0;
   auto const o = static_cast<int>((p - 1) * particles.size());
-  for (auto &p : particles) {
+  for (auto const *part : particles) {
+    auto const &p = *part;
     double e = exp(omega * p.r.p[2]);
 
-    partblk[size * ic + POQESM] = p.p.q * scxcache[o + ic].s / e;
-    partblk[size * ic + POQESP] = p.p.q * scxcache[o + ic].s * e;
-    partblk[size * ic + POQECM] = p.p.q * scxcache[o + ic].c / e;
-    partblk[size * ic + POQECP] = p.p.q * scxcache[o + ic].c * e;
+    blk[size * ic + POQESM] = p.p.q * scxcache[o + ic].s / e;
+    blk[size * ic + POQESP] = p.p.q * scxcache[o + ic].s * e;
+    blk[size * ic + POQECM] = p.p.q * scxcache[o + ic].c / e;
+    blk[size * ic + POQECP] = p.p.q * scxcache[o + ic].c * e;
 
-    add_vec(gblcblk, gblcblk, block(partblk.data(), ic, size), size);
+    add_vec(sums, sums, block(blk, ic, size), size);
 
     if (elc_params.dielectric_contrast_on) {
       if (p.r.p[2] < elc_params.space_layer) { // handle the lower case first
@@ -550,7 +588,7 @@ static void setup_P(int p, double omega, const ParticleRange &particles) {
         lclimgebot[POQECM] = scxcache[o + ic].c / e;
         lclimgebot[POQECP] = scxcache[o + ic].c * e;
 
-        addscale_vec(gblcblk, scale, lclimgebot, gblcblk, size);
+        addscale_vec(sums, scale, lclimgebot, sums, size);
 
         e = (exp(omega * (-p.r.p[2] - 2 * elc_params.h)) *
                  elc_params.delta_mid_bot +
@@ -580,7 +618,7 @@ static void setup_P(int p, double omega, const ParticleRange &particles) {
         lclimgetop[POQECM] = scxcache[o + ic].c / e;
         lclimgetop[POQECP] = scxcache[o + ic].c * e;
 
-        addscale_vec(gblcblk, scale, lclimgetop, gblcblk, size);
+        addscale_vec(sums, scale, lclimgetop, sums, size);
 
         e = (exp(omega * (p.r.p[2] - 4 * elc_params.h)) *
                  elc_params.delta_mid_top +
@@ -602,15 +640,17 @@ static void setup_P(int p, double omega, const ParticleRange &particles) {
     ic++;
   }
 
-  scale_vec(pref, gblcblk, size);
+  scale_vec(pref, sums, size);
 
   if (elc_params.dielectric_contrast_on) {
     scale_vec(pref_di, lclimge, size);
-    add_vec(gblcblk, gblcblk, lclimge, size);
+    add_vec(sums, sums, lclimge, size);
   }
 }
 
-static void setup_Q(int q, double omega, const ParticleRange &particles) {
+static void setup_Q(int q, double omega,
+                    const std::vector<Particle *> &particles, double *blk,
+                    double *sums) {
   double const pref = -coulomb.prefactor * 4 * M_PI * ux * uy /
                       (expm1(omega * box_geo.length()[2]));
   double const pref_di = coulomb.prefactor * 4 * M_PI * ux * uy;
@@ -628,19 +668,20 @@ static void setup_Q(int q, double omega, const ParticleRange &particles) {
   }
 
   clear_vec(lclimge, size);
-  clear_vec(gblcblk, size);
+  clear_vec(sums, size);
 
   int ic = 0;
   auto const o = static_cast<int>((q - 1) * particles.size());
-  for (auto &p : particles) {
+  for (auto const *part : particles) {
+    auto const &p = *part;
     double e = exp(omega * p.r.p[2]);
 
-    partblk[size * ic + POQESM] = p.p.q * scycache[o + ic].s / e;
-    partblk[size * ic + POQESP] = p.p.q * scycache[o + ic].s * e;
-    partblk[size * ic + POQECM] = p.p.q * scycache[o + ic].c / e;
-    partblk[size * ic + POQECP] = p.p.q * scycache[o + ic].c * e;
+    blk[size * ic + POQESM] = p.p.q * scycache[o + ic].s / e;
+    blk[size * ic + POQESP] = p.p.q * scycache[o + ic].s * e;
+    blk[size * ic + POQECM] = p.p.q * scycache[o + ic].c / e;
+    blk[size * ic + POQECP] = p.p.q * scycache[o + ic].c * e;
 
-    add_vec(gblcblk, gblcblk, block(partblk.data(), ic, size), size);
+    add_vec(sums, sums, block(blk, ic, size), size);
 
     if (elc_params.dielectric_contrast_on) {
       if (p.r.p[2] < elc_params.space_layer) { // handle the lower case first
@@ -656,7 +697,7 @@ static void setup_Q(int q, double omega, const ParticleRange &particles) {
         lclimgebot[POQECM] = scycache[o + ic].c / e;
         lclimgebot[POQECP] = scycache[o + ic].c * e;
 
-        addscale_vec(gblcblk, scale, lclimgebot, gblcblk, size);
+        addscale_vec(sums, scale, lclimgebot, sums, size);
 
         e = (exp(omega * (-p.r.p[2] - 2 * elc_params.h)) *
                  elc_params.delta_mid_bot +
@@ -686,7 +727,7 @@ static void setup_Q(int q, double omega, const ParticleRange &particles) {
         lclimgetop[POQECM] = scycache[o + ic].c / e;
         lclimgetop[POQECP] = scycache[o + ic].c * e;
 
-        addscale_vec(gblcblk, scale, lclimgetop, gblcblk, size);
+        addscale_vec(sums, scale, lclimgetop, sums, size);
 
         e = (exp(omega * (p.r.p[2] - 4 * elc_params.h)) *
                  elc_params.delta_mid_top +
@@ -708,77 +749,42 @@ static void setup_Q(int q, double omega, const ParticleRange &particles) {
     ic++;
   }
 
-  scale_vec(pref, gblcblk, size);
+  scale_vec(pref, sums, size);
 
   if (elc_params.dielectric_contrast_on) {
     scale_vec(pref_di, lclimge, size);
-    add_vec(gblcblk, gblcblk, lclimge, size);
+    add_vec(sums, sums, lclimge, size);
   }
 }
 
-static void add_P_force(const ParticleRange &particles) {
-  int ic;
-  int size = 4;
-
-  ic = 0;
-  for (auto &p : particles) {
-    p.f.f[0] += partblk[size * ic + POQESM] * gblcblk[POQECP] -
-                partblk[size * ic + POQECM] * gblcblk[POQESP] +
-                partblk[size * ic + POQESP] * gblcblk[POQECM] -
-                partblk[size * ic + POQECP] * gblcblk[POQESM];
-    p.f.f[2] += partblk[size * ic + POQECM] * gblcblk[POQECP] +
-                partblk[size * ic + POQESM] * gblcblk[POQESP] -
-                partblk[size * ic + POQECP] * gblcblk[POQECM] -
-                partblk[size * ic + POQESP] * gblcblk[POQESM];
-    ic++;
-  }
+static void add_P_force(double const *blk, double const *sums,
+                        Utils::Vector3d &force) {
+  force[0] += blk[POQESM] * sums[POQECP] - blk[POQECM] * sums[POQESP] +
+              blk[POQESP] * sums[POQECM] - blk[POQECP] * sums[POQESM];
+  force[2] += blk[POQECM] * sums[POQECP] + blk[POQESM] * sums[POQESP] -
+              blk[POQECP] * sums[POQECM] - blk[POQESP] * sums[POQESM];
 }
 
-static double P_energy(double omega, int n_part) {
-  int size = 4;
-  double eng = 0;
+static double P_energy(double omega, double const *blk, double const *sums) {
   double pref = 1 / omega;
 
-  for (unsigned ic = 0; ic < n_part; ic++) {
-    eng += pref * (partblk[size * ic + POQECM] * gblcblk[POQECP] +
-                   partblk[size * ic + POQESM] * gblcblk[POQESP] +
-                   partblk[size * ic + POQECP] * gblcblk[POQECM] +
-                   partblk[size * ic + POQESP] * gblcblk[POQESM]);
-  }
-
-  return eng;
+  return pref * (blk[POQECM] * sums[POQECP] + blk[POQESM] * sums[POQESP] +
+                 blk[POQECP] * sums[POQECM] + blk[POQESP] * sums[POQESM]);
 }
 
-static void add_Q_force(const ParticleRange &particles) {
-  int ic;
-  int size = 4;
-
-  ic = 0;
-  for (auto &p : particles) {
-    p.f.f[1] += partblk[size * ic + POQESM] * gblcblk[POQECP] -
-                partblk[size * ic + POQECM] * gblcblk[POQESP] +
-                partblk[size * ic + POQESP] * gblcblk[POQECM] -
-                partblk[size * ic + POQECP] * gblcblk[POQESM];
-    p.f.f[2] += partblk[size * ic + POQECM] * gblcblk[POQECP] +
-                partblk[size * ic + POQESM] * gblcblk[POQESP] -
-                partblk[size * ic + POQECP] * gblcblk[POQECM] -
-                partblk[size * ic + POQESP] * gblcblk[POQESM];
-    ic++;
-  }
+static void add_Q_force(double const *blk, double const *sums,
+                        Utils::Vector3d &force) {
+  force[1] += blk[POQESM] * sums[POQECP] - blk[POQECM] * sums[POQESP] +
+              blk[POQESP] * sums[POQECM] - blk[POQECP] * sums[POQESM];
+  force[2] += blk[POQECM] * sums[POQECP] + blk[POQESM] * sums[POQESP] -
+              blk[POQECP] * sums[POQECM] - blk[POQESP] * sums[POQESM];
 }
 
-static double Q_energy(double omega, int n_part) {
-  int size = 4;
-  double eng = 0;
+static double Q_energy(double omega, double const *blk, double const *sums) {
   double pref = 1 / omega;
 
-  for (unsigned ic = 0; ic < n_part; ic++) {
-    eng += pref * (partblk[size * ic + POQECM] * gblcblk[POQECP] +
-                   partblk[size * ic + POQESM] * gblcblk[POQESP] +
-                   partblk[size * ic + POQECP] * gblcblk[POQECM] +
-                   partblk[size * ic + POQESP] * gblcblk[POQESM]);
-  }
-  return eng;
+  return pref * (blk[POQECM] * sums[POQECP] + blk[POQESM] * sums[POQESP] +
+                 blk[POQECP] * sums[POQECM] + blk[POQESP] * sums[POQESM]);
 }
 
 /*****************************************************************/
@@ -786,7 +792,8 @@ static double Q_energy(double omega, int n_part) {
 /*****************************************************************/
 
 static void setup_PQ(int p, int q, double omega,
-                     const ParticleRange &particles) {
+                     const std::vector<Particle *> &particles, double *blk,
+                     double *sums) {
   double const pref = -coulomb.prefactor * 8 * M_PI * ux * uy /
                       (expm1(omega * box_geo.length()[2]));
   double const pref_di = coulomb.prefactor * 8 * M_PI * ux * uy;
@@ -803,33 +810,34 @@ static void setup_PQ(int p, int q, double omega,
   }
 
   clear_vec(lclimge, size);
-  clear_vec(gblcblk, size);
+  clear_vec(sums, size);
 
   int ic = 0;
   auto const ox = static_cast<int>((p - 1) * particles.size());
   auto const oy = static_cast<int>((q - 1) * particles.size());
-  for (auto const &p : particles) {
+  for (auto const *part : particles) {
+    auto const &p = *part;
     double e = exp(omega * p.r.p[2]);
 
-    partblk[size * ic + PQESSM] =
+    blk[size * ic + PQESSM] =
         scxcache[ox + ic].s * scycache[oy + ic].s * p.p.q / e;
-    partblk[size * ic + PQESCM] =
+    blk[size * ic + PQESCM] =
         scxcache[ox + ic].s * scycache[oy + ic].c * p.p.q / e;
-    partblk[size * ic + PQECSM] =
+    blk[size * ic + PQECSM] =
         scxcache[ox + ic].c * scycache[oy + ic].s * p.p.q / e;
-    partblk[size * ic + PQECCM] =
+    blk[size * ic + PQECCM] =
         scxcache[ox + ic].c * scycache[oy + ic].c * p.p.q / e;
 
-    partblk[size * ic + PQESSP] =
+    blk[size * ic + PQESSP] =
         scxcache[ox + ic].s * scycache[oy + ic].s * p.p.q * e;
-    partblk[size * ic + PQESCP] =
+    blk[size * ic + PQESCP] =
         scxcache[ox + ic].s * scycache[oy + ic].c * p.p.q * e;
-    partblk[size * ic + PQECSP] =
+    blk[size * ic + PQECSP] =
         scxcache[ox + ic].c * scycache[oy + ic].s * p.p.q * e;
-    partblk[size * ic + PQECCP] =
+    blk[size * ic + PQECCP] =
         scxcache[ox + ic].c * scycache[oy + ic].c * p.p.q * e;
 
-    add_vec(gblcblk, gblcblk, block(partblk.data(), ic, size), size);
+    add_vec(sums, sums, block(blk, ic, size), size);
 
     if (elc_params.dielectric_contrast_on) {
       if (p.r.p[2] < elc_params.space_layer) { // handle the lower case first
@@ -848,7 +856,7 @@ static void setup_PQ(int p, int q, double omega,
         lclimgebot[PQECSP] = scxcache[ox + ic].c * scycache[oy + ic].s * e;
         lclimgebot[PQECCP] = scxcache[ox + ic].c * scycache[oy + ic].c * e;
 
-        addscale_vec(gblcblk, scale, lclimgebot, gblcblk, size);
+        addscale_vec(sums, scale, lclimgebot, sums, size);
 
         e = (exp(omega * (-p.r.p[2] - 2 * elc_params.h)) *
                  elc_params.delta_mid_bot +
@@ -884,7 +892,7 @@ static void setup_PQ(int p, int q, double omega,
         lclimgetop[PQECSP] = scxcache[ox + ic].c * scycache[oy + ic].s * e;
         lclimgetop[PQECCP] = scxcache[ox + ic].c * scycache[oy + ic].c * e;
 
-        addscale_vec(gblcblk, scale, lclimgetop, gblcblk, size);
+        addscale_vec(sums, scale, lclimgetop, sums, size);
 
         e = (exp(omega * (p.r.p[2] - 4 * elc_params.h)) *
                  elc_params.delta_mid_top +
@@ -908,107 +916,188 @@ static void setup_PQ(int p, int q, double omega,
     ic++;
   }
 
-  scale_vec(pref, gblcblk, size);
+  scale_vec(pref, sums, size);
   if (elc_params.dielectric_contrast_on) {
     scale_vec(pref_di, lclimge, size);
-    add_vec(gblcblk, gblcblk, lclimge, size);
+    add_vec(sums, sums, lclimge, size);
   }
 }
 
-static void add_PQ_force(int p, int q, double omega,
-                         const ParticleRange &particles) {
-  int ic;
-
+static void add_PQ_force(int p, int q, double omega, double const *blk,
+                         double const *sums, Utils::Vector3d &force) {
   double pref_x = C_2PI * ux * p / omega;
   double pref_y = C_2PI * uy * q / omega;
-  int size = 8;
 
-  ic = 0;
-  for (auto &p : particles) {
-    p.f.f[0] += pref_x * (partblk[size * ic + PQESCM] * gblcblk[PQECCP] +
-                          partblk[size * ic + PQESSM] * gblcblk[PQECSP] -
-                          partblk[size * ic + PQECCM] * gblcblk[PQESCP] -
-                          partblk[size * ic + PQECSM] * gblcblk[PQESSP] +
-                          partblk[size * ic + PQESCP] * gblcblk[PQECCM] +
-                          partblk[size * ic + PQESSP] * gblcblk[PQECSM] -
-                          partblk[size * ic + PQECCP] * gblcblk[PQESCM] -
-                          partblk[size * ic + PQECSP] * gblcblk[PQESSM]);
-    p.f.f[1] += pref_y * (partblk[size * ic + PQECSM] * gblcblk[PQECCP] +
-                          partblk[size * ic + PQESSM] * gblcblk[PQESCP] -
-                          partblk[size * ic + PQECCM] * gblcblk[PQECSP] -
-                          partblk[size * ic + PQESCM] * gblcblk[PQESSP] +
-                          partblk[size * ic + PQECSP] * gblcblk[PQECCM] +
-                          partblk[size * ic + PQESSP] * gblcblk[PQESCM] -
-                          partblk[size * ic + PQECCP] * gblcblk[PQECSM] -
-                          partblk[size * ic + PQESCP] * gblcblk[PQESSM]);
-    p.f.f[2] += (partblk[size * ic + PQECCM] * gblcblk[PQECCP] +
-                 partblk[size * ic + PQECSM] * gblcblk[PQECSP] +
-                 partblk[size * ic + PQESCM] * gblcblk[PQESCP] +
-                 partblk[size * ic + PQESSM] * gblcblk[PQESSP] -
-                 partblk[size * ic + PQECCP] * gblcblk[PQECCM] -
-                 partblk[size * ic + PQECSP] * gblcblk[PQECSM] -
-                 partblk[size * ic + PQESCP] * gblcblk[PQESCM] -
-                 partblk[size * ic + PQESSP] * gblcblk[PQESSM]);
-    ic++;
-  }
+  force[0] += pref_x * (blk[PQESCM] * sums[PQECCP] +
+                        blk[PQESSM] * sums[PQECSP] -
+                        blk[PQECCM] * sums[PQESCP] -
+                        blk[PQECSM] * sums[PQESSP] +
+                        blk[PQESCP] * sums[PQECCM] +
+                        blk[PQESSP] * sums[PQECSM] -
+                        blk[PQECCP] * sums[PQESCM] -
+                        blk[PQECSP] * sums[PQESSM]);
+  force[1] += pref_y * (blk[PQECSM] * sums[PQECCP] +
+                        blk[PQESSM] * sums[PQESCP] -
+                        blk[PQECCM] * sums[PQECSP] -
+                        blk[PQESCM] * sums[PQESSP] +
+                        blk[PQECSP] * sums[PQECCM] +
+                        blk[PQESSP] * sums[PQESCM] -
+                        blk[PQECCP] * sums[PQECSM] -
+                        blk[PQESCP] * sums[PQESSM]);
+  force[2] += (blk[PQECCM] * sums[PQECCP] + blk[PQECSM] * sums[PQECSP] +
+               blk[PQESCM] * sums[PQESCP] + blk[PQESSM] * sums[PQESSP] -
+               blk[PQECCP] * sums[PQECCM] - blk[PQECSP] * sums[PQECSM] -
+               blk[PQESCP] * sums[PQESCM] - blk[PQESSP] * sums[PQESSM]);
 }
 
-static double PQ_energy(double omega, int n_part) {
-  int size = 8;
-  double eng = 0;
+static double PQ_energy(double omega, double const *blk, double const *sums) {
   double pref = 1 / omega;
 
-  for (unsigned ic = 0; ic < n_part; ic++) {
-    eng += pref * (partblk[size * ic + PQECCM] * gblcblk[PQECCP] +
-                   partblk[size * ic + PQECSM] * gblcblk[PQECSP] +
-                   partblk[size * ic + PQESCM] * gblcblk[PQESCP] +
-                   partblk[size * ic + PQESSM] * gblcblk[PQESSP] +
-                   partblk[size * ic + PQECCP] * gblcblk[PQECCM] +
-                   partblk[size * ic + PQECSP] * gblcblk[PQECSM] +
-                   partblk[size * ic + PQESCP] * gblcblk[PQESCM] +
-                   partblk[size * ic + PQESSP] * gblcblk[PQESSM]);
-  }
-  return eng;
+  return pref * (blk[PQECCM] * sums[PQECCP] + blk[PQECSM] * sums[PQECSP] +
+                 blk[PQESCM] * sums[PQESCP] + blk[PQESSM] * sums[PQESSP] +
+                 blk[PQECCP] * sums[PQECCM] + blk[PQECSP] * sums[PQECSM] +
+                 blk[PQESCP] * sums[PQESCM] + blk[PQESSP] * sums[PQESSM]);
 }
 
 /*****************************************************************/
 /* main loops */
 /*****************************************************************/
 
-void ELC_add_force(const ParticleRange &particles) {
-  auto const n_scxcache = int(ceil(elc_params.far_cut / ux) + 1);
-  auto const n_scycache = int(ceil(elc_params.far_cut / uy) + 1);
-
-  prepare_sc_cache(particles, n_scxcache, ux, n_scycache, uy);
-  partblk.resize(particles.size() * 8);
+namespace {
+/** Charged particles of a range, in the order of the range. */
+std::vector<Particle *> charged_particles(const ParticleRange &particles) {
+  std::vector<Particle *> charged;
+  for (auto &p : particles) {
+    if (p.p.q != 0.0) {
+      charged.push_back(&p);
+    }
+  }
+  return charged;
+}
 
-  add_dipole_force(particles);
-  add_z_force(particles);
+/** Frequency modes within the cutoff, first the p-only modes, then the
+ *  q-only modes and then the mixed ones.
+ */
+std::vector<FarMode> far_modes(int n_scxcache, int n_scycache) {
+  std::vector<FarMode> modes;
 
   /* the second condition is just for the case of numerical accident */
   for (int p = 1; ux * (p - 1) < elc_params.far_cut && p <= n_scxcache; p++) {
-    auto const omega = C_2PI * ux * p;
-    setup_P(p, omega, particles);
-    distribute(4);
-    add_P_force(particles);
+    modes.push_back({p, 0, C_2PI * ux * p, 0});
   }
-
   for (int q = 1; uy * (q - 1) < elc_params.far_cut && q <= n_scycache; q++) {
-    auto const omega = C_2PI * uy * q;
-    setup_Q(q, omega, particles);
-    distribute(4);
-    add_Q_force(particles);
+    modes.push_back({0, q, C_2PI * uy * q, 0});
   }
-
   for (int p = 1; ux * (p - 1) < elc_params.far_cut && p <= n_scxcache; p++) {
     for (int q = 1; Utils::sqr(ux * (p - 1)) + Utils::sqr(uy * (q - 1)) <
                         elc_params.far_cut2 &&
                     q <= n_scycache;
          q++) {
-      auto const omega = C_2PI * sqrt(Utils::sqr(ux * p) + Utils::sqr(uy * q));
-      setup_PQ(p, q, omega, particles);
-      distribute(8);
-      add_PQ_force(p, q, omega, particles);
+      modes.push_back(
+          {p, q, C_2PI * sqrt(Utils::sqr(ux * p) + Utils::sqr(uy * q)), 0});
+    }
+  }
+  return modes;
+}
+
+/** Split the modes into batches whose particle blocks fit into
+ *  @ref ELC_struct::max_block_size doubles on every node, and set the
+ *  offsets of the modes within their batch. All nodes get the same batches.
+ */
+std::vector<std::vector<FarMode>> mode_batches(std::vector<FarMode> modes,
+                                               int n_part) {
+  int max_n_part = 0;
+  MPI_Allreduce(&n_part, &max_n_part, 1, MPI_INT, MPI_MAX, comm_cart);
+  auto const max_n_sums =
+      elc_params.max_block_size / std::max(max_n_part, 1);
+
+  std::vector<std::vector<FarMode>> batches;
+  int offset = 0;
+  for (auto &mode : modes) {
+    if (batches.empty() or offset + mode.size() > max_n_sums) {
+      batches.emplace_back();
+      offset = 0;
+    }
+    mode.offset = offset;
+    offset += mode.size();
+    batches.back().push_back(mode);
+  }
+  return batches;
+}
+
+/** Set up the particle blocks of a batch of modes and sum them up over all
+ *  nodes in a single reduction.
+ */
+void setup_far_modes(std::vector<FarMode> const &modes,
+                     std::vector<Particle *> const &particles) {
+  auto const n_part = particles.size();
+  auto const n_modes = static_cast<int>(modes.size());
+  auto const n_sums = modes.back().offset + modes.back().size();
+
+  partblk.resize(n_part * n_sums);
+  modesums.resize(n_sums);
+
+  /* every mode only writes its own blocks and sums */
+#ifdef OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+  for (int m = 0; m < n_modes; m++) {
+    auto const &mode = modes[m];
+    auto blk = partblk.data() + n_part * mode.offset;
+    auto sums = modesums.data() + mode.offset;
+    if (mode.q == 0) {
+      setup_P(mode.p, mode.omega, particles, blk, sums);
+    } else if (mode.p == 0) {
+      setup_Q(mode.q, mode.omega, particles, blk, sums);
+    } else {
+      setup_PQ(mode.p, mode.q, mode.omega, particles, blk, sums);
+    }
+  }
+
+  MPI_Allreduce(MPI_IN_PLACE, modesums.data(), n_sums, MPI_DOUBLE, MPI_SUM,
+                comm_cart);
+}
+
+/** Particle block of mode @p mode of the @p ic-th charged particle. */
+double const *mode_block(FarMode const &mode, int ic, size_t n_part) {
+  return partblk.data() + n_part * mode.offset + mode.size() * ic;
+}
+} // namespace
+
+void ELC_add_force(const ParticleRange &particles) {
+  auto const n_scxcache = int(ceil(elc_params.far_cut / ux) + 1);
+  auto const n_scycache = int(ceil(elc_params.far_cut / uy) + 1);
+
+  auto const charged = charged_particles(particles);
+  auto const n_part = static_cast<int>(charged.size());
+  prepare_sc_cache(charged, n_scxcache, ux, n_scycache, uy);
+
+  add_dipole_force(particles);
+  add_z_force(particles);
+
+  for (auto const &modes :
+       mode_batches(far_modes(n_scxcache, n_scycache), n_part)) {
+    setup_far_modes(modes, charged);
+
+    /* all modes of the batch in one pass over the particles, every thread
+       only writes the forces of its own particles */
+#ifdef OPENMP
+#pragma omp parallel for
+#endif
+    for (int ic = 0; ic < n_part; ic++) {
+      Utils::Vector3d force{};
+      for (auto const &mode : modes) {
+        auto const blk = mode_block(mode, ic, charged.size());
+        auto const sums = modesums.data() + mode.offset;
+        if (mode.q == 0) {
+          add_P_force(blk, sums, force);
+        } else if (mode.p == 0) {
+          add_Q_force(blk, sums, force);
+        } else {
+          add_PQ_force(mode.p, mode.q, mode.omega, blk, sums, force);
+        }
+      }
+      charged[ic]->f.f += force;
     }
   }
 }
@@ -1019,35 +1108,35 @@ double ELC_energy(const ParticleRange &particles) {
 
   auto const n_scxcache = int(ceil(elc_params.far_cut / ux) + 1);
   auto const n_scycache = int(ceil(elc_params.far_cut / uy) + 1);
-  prepare_sc_cache(particles, n_scxcache, ux, n_scycache, uy);
 
-  auto const n_localpart = particles.size();
-  partblk.resize(n_localpart * 8);
+  auto const charged = charged_particles(particles);
+  auto const n_part = static_cast<int>(charged.size());
+  prepare_sc_cache(charged, n_scxcache, ux, n_scycache, uy);
 
-  /* the second condition is just for the case of numerical accident */
-  for (int p = 1; ux * (p - 1) < elc_params.far_cut && p <= n_scxcache; p++) {
-    auto const omega = C_2PI * ux * p;
-    setup_P(p, omega, particles);
-    distribute(4);
-    eng += P_energy(omega, n_localpart);
-  }
-  for (int q = 1; uy * (q - 1) < elc_params.far_cut && q <= n_scycache; q++) {
-    auto const omega = C_2PI * uy * q;
-    setup_Q(q, omega, particles);
-    distribute(4);
-    eng += Q_energy(omega, n_localpart);
-  }
-  for (int p = 1; ux * (p - 1) < elc_params.far_cut && p <= n_scxcache; p++) {
-    for (int q = 1; Utils::sqr(ux * (p - 1)) + Utils::sqr(uy * (q - 1)) <
-                        elc_params.far_cut2 &&
-                    q <= n_scycache;
-         q++) {
-      auto const omega = C_2PI * sqrt(Utils::sqr(ux * p) + Utils::sqr(uy * q));
-      setup_PQ(p, q, omega, particles);
-      distribute(8);
-      eng += PQ_energy(omega, n_localpart);
+  for (auto const &modes :
+       mode_batches(far_modes(n_scxcache, n_scycache), n_part)) {
+    setup_far_modes(modes, charged);
+
+    double far_eng = 0.;
+#ifdef OPENMP
+#pragma omp parallel for reduction(+ : far_eng)
+#endif
+    for (int ic = 0; ic < n_part; ic++) {
+      for (auto const &mode : modes) {
+        auto const blk = mode_block(mode, ic, charged.size());
+        auto const sums = modesums.data() + mode.offset;
+        if (mode.q == 0) {
+          far_eng += P_energy(mode.omega, blk, sums);
+        } else if (mode.p == 0) {
+          far_eng += Q_energy(mode.omega, blk, sums);
+        } else {
+          far_eng += PQ_energy(mode.omega, blk, sums);
+        }
+      }
     }
+    eng += far_eng;
   }
+
   /* we count both i<->j and j<->i, so return just half of it */
   return 0.5 * eng;
 }
@@ -1180,8 +1269,10 @@ void ELC_init() {
 
 int ELC_set_params(double maxPWerror, double gap_size, double far_cut,
                    bool neutralize, double delta_top, double delta_bot,
-                   bool const_pot, double pot_diff) {
+                   bool const_pot, double pot_diff, int max_block_size) {
   elc_params.maxPWerror = maxPWerror;
+  elc_params.max_block_size =
+      (max_block_size > 0) ? max_block_size : MAX_PARTBLK_SIZE;
   elc_params.gap_size = gap_size;
   elc_params.h = box_geo.length()[2] - gap_size;
 
@@ -83,6 +83,10 @@ typedef struct {
   double space_box;
   /** Up to where particles can be found. */
   double h;
+  /** Largest number of doubles in the particle blocks of a batch of far
+   *  formula modes. The modes are split into batches that fit.
+   */
+  int max_block_size;
 
 } ELC_struct;
 extern ELC_struct elc_params;
@@ -103,11 +107,13 @@ extern ELC_struct elc_params;
  *  @param delta_mid_bot @copybrief ELC_struct::delta_mid_bot
  *  @param const_pot     @copybrief ELC_struct::const_pot
  *  @param pot_diff      @copybrief ELC_struct::pot_diff
+ *  @param max_block_size @copybrief ELC_struct::max_block_size
+ *                       If -1, a budget of 2^21 doubles is used.
  *  @retval ES_OK
  */
 int ELC_set_params(double maxPWerror, double min_dist, double far_cut,
                    bool neutralize, double delta_mid_top, double delta_mid_bot,
-                   bool const_pot, double pot_diff);
+                   bool const_pot, double pot_diff, int max_block_size = -1);
 
 /// the force calculation
 void ELC_add_force(const ParticleRange &particles);
@@ -37,8 +37,12 @@ using Utils::get_linear_index;
 #include <fftw3.h>
 #include <mpi.h>
 
-#include <cstdio>
+#include <algorithm>
+#include <cmath>
 #include <cstring>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
 
 #include <utils/Span.hpp>
 
@@ -360,67 +364,128 @@ void pack_block_permute2(double const *const in, double *const out,
   }
 }
 
-/** Communicate the grid data according to the given forward FFT plan.
- *  \param plan   FFT communication plan.
+/** Specification of the grid communication of one redistribution step.
+ *  The same blocks are used in both directions, see
+ *  @ref forw_grid_comm and @ref back_grid_comm.
+ */
+struct GridComm {
+  /** packing function for the send blocks. */
+  void (*pack_function)(double const *const, double *const, int const *,
+                        int const *, int const *, int);
+  /** group of nodes which have to communicate with each other. */
+  std::vector<int> const &group;
+  /** Send block specification, see @ref fft_forw_plan::send_block. */
+  std::vector<int> const &send_block;
+  /** Send block communication sizes. */
+  std::vector<int> const &send_size;
+  /** Mesh the send blocks are packed from. */
+  int const *send_mesh;
+  /** Recv block specification, see @ref fft_forw_plan::recv_block. */
+  std::vector<int> const &recv_block;
+  /** Recv block communication sizes. */
+  std::vector<int> const &recv_size;
+  /** Mesh the recv blocks are unpacked into. */
+  int const *recv_mesh;
+  /** size of block elements. */
+  int element;
+  /** MPI tag. */
+  int tag;
+};
+
+/** Grid communication of a forward FFT plan. */
+GridComm forw_grid_comm(fft_forw_plan const &plan) {
+  return {plan.pack_function, plan.group,    plan.send_block,
+          plan.send_size,     plan.old_mesh, plan.recv_block,
+          plan.recv_size,     plan.new_mesh, plan.element,
+          REQ_FFT_FORW};
+}
+
+/** Grid communication of a backward FFT plan.
+ *  Back means: Use the send/receive stuff from the forward plan but
+ *  replace the receive blocks by the send blocks and vice
+ *  versa. Attention then also new_mesh and old_mesh are exchanged.
+ */
+GridComm back_grid_comm(fft_forw_plan const &plan_f,
+                        fft_back_plan const &plan_b) {
+  return {plan_b.pack_function, plan_f.group,    plan_f.recv_block,
+          plan_f.recv_size,     plan_f.new_mesh, plan_f.send_block,
+          plan_f.send_size,     plan_f.old_mesh, plan_f.element,
+          REQ_FFT_BACK};
+}
+
+/** Offsets of consecutive blocks in a communication buffer. */
+std::vector<int> block_offsets(std::vector<int> const &sizes) {
+  std::vector<int> offsets(sizes.size() + 1, 0);
+  std::partial_sum(sizes.begin(), sizes.end(), offsets.begin() + 1);
+  return offsets;
+}
+
+/** Start the grid communication of a mesh. All receives are posted
+ *  first, then each block is sent as soon as it is packed. The input
+ *  mesh may be overwritten when this function returns.
+ *  \param gc     Grid communication.
  *  \param in     input mesh.
- *  \param out    output mesh.
- *  \param fft    FFT communication plan.
+ *  \param buf    Buffers of the mesh.
  *  \param comm   MPI communicator.
  */
-void forw_grid_comm(fft_forw_plan plan, const double *in, double *out,
-                    fft_data_struct &fft,
-                    const boost::mpi::communicator &comm) {
-  for (int i = 0; i < plan.group.size(); i++) {
-    plan.pack_function(in, fft.send_buf.data(), &(plan.send_block[6 * i]),
-                       &(plan.send_block[6 * i + 3]), plan.old_mesh,
-                       plan.element);
-
-    if (plan.group[i] != comm.rank()) {
-      MPI_Sendrecv(fft.send_buf.data(), plan.send_size[i], MPI_DOUBLE,
-                   plan.group[i], REQ_FFT_FORW, fft.recv_buf.data(),
-                   plan.recv_size[i], MPI_DOUBLE, plan.group[i], REQ_FFT_FORW,
-                   comm, MPI_STATUS_IGNORE);
-    } else { /* Self communication... */
-      std::swap(fft.send_buf, fft.recv_buf);
+void start_grid_comm(GridComm const &gc, const double *in,
+                     fft_mesh_buffers &buf,
+                     const boost::mpi::communicator &comm) {
+  auto const n = static_cast<int>(gc.group.size());
+  auto const send_offset = block_offsets(gc.send_size);
+  auto const recv_offset = block_offsets(gc.recv_size);
+  buf.send_req.assign(n, MPI_REQUEST_NULL);
+  buf.recv_req.assign(n, MPI_REQUEST_NULL);
+
+  for (int i = 0; i < n; i++) {
+    if (gc.group[i] != comm.rank()) {
+      MPI_Irecv(buf.recv_buf.data() + recv_offset[i], gc.recv_size[i],
+                MPI_DOUBLE, gc.group[i], gc.tag, comm, &buf.recv_req[i]);
+    }
+  }
+  for (int i = 0; i < n; i++) {
+    auto *const send_buf = buf.send_buf.data() + send_offset[i];
+    gc.pack_function(in, send_buf, &(gc.send_block[6 * i]),
+                     &(gc.send_block[6 * i + 3]), gc.send_mesh, gc.element);
+    if (gc.group[i] != comm.rank()) {
+      MPI_Isend(send_buf, gc.send_size[i], MPI_DOUBLE, gc.group[i], gc.tag,
+                comm, &buf.send_req[i]);
     }
-    fft_unpack_block(fft.recv_buf.data(), out, &(plan.recv_block[6 * i]),
-                     &(plan.recv_block[6 * i + 3]), plan.new_mesh,
-                     plan.element);
   }
 }
 
-/** Communicate the grid data according to the given backward FFT plan.
- *  \param plan_f Forward FFT plan.
- *  \param plan_b Backward FFT plan.
- *  \param in     input mesh.
+/** Complete the grid communication of a mesh started by
+ *  @ref start_grid_comm. The blocks are unpacked in the order they
+ *  arrive, starting with the block of this node.
+ *  \param gc     Grid communication.
  *  \param out    output mesh.
- *  \param fft    FFT communication plan.
+ *  \param buf    Buffers of the mesh.
  *  \param comm   MPI communicator.
  */
-void back_grid_comm(fft_forw_plan plan_f, fft_back_plan plan_b,
-                    const double *in, double *out, fft_data_struct &fft,
-                    const boost::mpi::communicator &comm) {
-  /* Back means: Use the send/receive stuff from the forward plan but
-     replace the receive blocks by the send blocks and vice
-     versa. Attention then also new_mesh and old_mesh are exchanged */
-
-  for (int i = 0; i < plan_f.group.size(); i++) {
-    plan_b.pack_function(in, fft.send_buf.data(), &(plan_f.recv_block[6 * i]),
-                         &(plan_f.recv_block[6 * i + 3]), plan_f.new_mesh,
-                         plan_f.element);
-
-    if (plan_f.group[i] != comm.rank()) { /* send first, receive second */
-      MPI_Sendrecv(fft.send_buf.data(), plan_f.recv_size[i], MPI_DOUBLE,
-                   plan_f.group[i], REQ_FFT_BACK, fft.recv_buf.data(),
-                   plan_f.send_size[i], MPI_DOUBLE, plan_f.group[i],
-                   REQ_FFT_BACK, comm, MPI_STATUS_IGNORE);
-    } else { /* Self communication... */
-      std::swap(fft.send_buf, fft.recv_buf);
+void finish_grid_comm(GridComm const &gc, double *out, fft_mesh_buffers &buf,
+                      const boost::mpi::communicator &comm) {
+  auto const n = static_cast<int>(gc.group.size());
+  auto const send_offset = block_offsets(gc.send_size);
+  auto const recv_offset = block_offsets(gc.recv_size);
+
+  int n_pending = 0;
+  for (int i = 0; i < n; i++) {
+    if (gc.group[i] == comm.rank()) { /* Self communication... */
+      fft_unpack_block(buf.send_buf.data() + send_offset[i], out,
+                       &(gc.recv_block[6 * i]), &(gc.recv_block[6 * i + 3]),
+                       gc.recv_mesh, gc.element);
+    } else {
+      n_pending++;
     }
-    fft_unpack_block(fft.recv_buf.data(), out, &(plan_f.send_block[6 * i]),
-                     &(plan_f.send_block[6 * i + 3]), plan_f.old_mesh,
-                     plan_f.element);
   }
+  for (; n_pending > 0; n_pending--) {
+    int i;
+    MPI_Waitany(n, buf.recv_req.data(), &i, MPI_STATUS_IGNORE);
+    fft_unpack_block(buf.recv_buf.data() + recv_offset[i], out,
+                     &(gc.recv_block[6 * i]), &(gc.recv_block[6 * i + 3]),
+                     gc.recv_mesh, gc.element);
+  }
+  MPI_Waitall(n, buf.send_req.data(), MPI_STATUSES_IGNORE);
 }
 
 /** Calculate 'best' mapping between a 2D and 3D grid.
@@ -489,6 +554,91 @@ void calc_2d_grid(int n, int grid[3]) {
     }
   }
 }
+
+/** Whether the communication groups between two node grids can be
+ *  built, see @ref find_comm_groups.
+ */
+bool grids_match(int const grid1[3], int const grid2[3]) {
+  for (int i = 0; i < 3; i++) {
+    if (grid1[i] % grid2[i] != 0 and grid2[i] % grid1[i] != 0)
+      return false;
+  }
+  return true;
+}
+
+/** Whether the FFT node grids following from a 2D grid fit to each other
+ *  and to the 3D grid, allowing for the same permutations as
+ *  @ref fft_init.
+ *  \param g3d      3D grid.
+ *  \param g2d      2D grid of the first direction.
+ *  \param row_dir  row direction of the first direction.
+ */
+bool fft_grids_match(int const g3d[3], int const g2d[3], int row_dir) {
+  int grids[4][3];
+  for (int i = 0; i < 3; i++) {
+    grids[0][i] = g3d[i];
+    grids[1][i] = g2d[i];
+    grids[2][i] = g2d[(i + 1) % 3];
+    grids[3][i] = g2d[(i + 2) % 3];
+  }
+  for (int i = 1; i < 4; i++) {
+    if (not grids_match(grids[i - 1], grids[i])) {
+      /* try permutation */
+      auto const dir = (row_dir + 4 - i) % 3;
+      std::swap(grids[i][(dir + 1) % 3], grids[i][(dir + 2) % 3]);
+      if (not grids_match(grids[i - 1], grids[i]))
+        return false;
+    }
+  }
+  return true;
+}
+
+/** Calculate the 2D node grid of the first FFT direction. The rows of
+ *  the first direction are always along z, so that the k-space meshes
+ *  end up in the order yzx, on which the P3M algorithms rely. The most
+ *  square 2D grid is mapped on the 3D grid by @ref map_3don2d_grid. If
+ *  that gives a different row direction, or the following FFT node grids
+ *  do not fit, all factorizations of the number of nodes are tried, the
+ *  most square ones first. Such a grid always exists, e.g.
+ *  <tt>{g3d[0], g3d[1] * g3d[2], 1}</tt>.
+ *  \param g3d      3D grid.
+ *  \param n_nodes  number of nodes.
+ *  \param g2d      2D grid.
+ *  \return         index of the row direction.
+ */
+int calc_fft_grid(int const g3d[3], int n_nodes, int g2d[3]) {
+  int mult[3];
+  calc_2d_grid(n_nodes, g2d);
+  if (map_3don2d_grid(g3d, g2d, mult) == 2 and fft_grids_match(g3d, g2d, 2))
+    return 2;
+
+  for (auto i = static_cast<int>(std::sqrt(n_nodes)); i >= 1; i--) {
+    if (n_nodes % i != 0)
+      continue;
+    int const factors[2][2] = {{n_nodes / i, i}, {i, n_nodes / i}};
+    for (auto const &f : factors) {
+      g2d[0] = f[0];
+      g2d[1] = f[1];
+      g2d[2] = 1;
+      if (fft_grids_match(g3d, g2d, 2))
+        return 2;
+    }
+  }
+  throw std::runtime_error("INTERNAL ERROR: no FFT node grid found");
+}
+
+/** Buffers for the concurrent transformation of @p n_meshes meshes. */
+std::vector<fft_mesh_buffers> &mesh_buffers(fft_data_struct &fft,
+                                            size_t n_meshes) {
+  if (fft.buffers.size() < n_meshes)
+    fft.buffers.resize(n_meshes);
+  for (auto &buf : fft.buffers) {
+    buf.data_buf.resize(fft.max_mesh_size);
+    buf.send_buf.resize(fft.max_comm_size);
+    buf.recv_buf.resize(fft.max_comm_size);
+  }
+  return fft.buffers;
+}
 } // namespace
 
 int fft_init(const Utils::Vector3i &ca_mesh_dim, int const *ca_mesh_margin,
@@ -496,8 +646,6 @@ int fft_init(const Utils::Vector3i &ca_mesh_dim, int const *ca_mesh_margin,
              fft_data_struct &fft, const Utils::Vector3i &grid,
              const boost::mpi::communicator &comm) {
   int i, j;
-  /* helpers */
-  int mult[3];
 
   int n_grid[4][3];         /* The four node grids. */
   int my_pos[4][3];         /* The position of comm.rank() in the node grids. */
@@ -529,9 +677,7 @@ int fft_init(const Utils::Vector3i &ca_mesh_dim, int const *ca_mesh_margin,
   }
 
   /* FFT node grids (n_grid[1 - 3]) */
-  calc_2d_grid(comm.size(), n_grid[1]);
-  /* resort n_grid[1] dimensions if necessary */
-  fft.plan[1].row_dir = map_3don2d_grid(n_grid[0], n_grid[1], mult);
+  fft.plan[1].row_dir = calc_fft_grid(n_grid[0], comm.size(), n_grid[1]);
   fft.plan[0].n_permute = 0;
   for (i = 1; i < 4; i++)
     fft.plan[i].n_permute = (fft.plan[1].row_dir + i) % 3;
@@ -539,8 +685,14 @@ int fft_init(const Utils::Vector3i &ca_mesh_dim, int const *ca_mesh_margin,
     n_grid[2][i] = n_grid[1][(i + 1) % 3];
     n_grid[3][i] = n_grid[1][(i + 2) % 3];
   }
-  fft.plan[2].row_dir = (fft.plan[1].row_dir - 1) % 3;
-  fft.plan[3].row_dir = (fft.plan[1].row_dir - 2) % 3;
+  fft.plan[2].row_dir = (fft.plan[1].row_dir + 2) % 3;
+  fft.plan[3].row_dir = (fft.plan[1].row_dir + 1) % 3;
+
+  /* The real-to-complex FFT of the first direction (z) leaves only the
+     modes 0 <= k_z <= mesh_z / 2, the others are their complex
+     conjugates. The later directions work on this half mesh. */
+  int const ks_mesh_dim[3] = {global_mesh_dim[0], global_mesh_dim[1],
+                              global_mesh_dim[2] / 2 + 1};
 
   /* === communication groups === */
   /* copy local mesh off real space charge assignment grid */
@@ -549,6 +701,7 @@ int fft_init(const Utils::Vector3i &ca_mesh_dim, int const *ca_mesh_margin,
 
   for (i = 1; i < 4; i++) {
     using Utils::make_span;
+    auto const mesh_dim = (i == 1) ? global_mesh_dim : ks_mesh_dim;
     auto group = find_comm_groups(
         {n_grid[i - 1][0], n_grid[i - 1][1], n_grid[i - 1][2]},
         {n_grid[i][0], n_grid[i][1], n_grid[i][2]}, n_id[i - 1],
@@ -576,7 +729,7 @@ int fft_init(const Utils::Vector3i &ca_mesh_dim, int const *ca_mesh_margin,
     fft.plan[i].recv_size.resize(fft.plan[i].group.size());
 
     fft.plan[i].new_size =
-        calc_local_mesh(my_pos[i], n_grid[i], global_mesh_dim, global_mesh_off,
+        calc_local_mesh(my_pos[i], n_grid[i], mesh_dim, global_mesh_off,
                         fft.plan[i].new_mesh, fft.plan[i].start);
     permute_ifield(fft.plan[i].new_mesh, 3, -(fft.plan[i].n_permute));
     permute_ifield(fft.plan[i].start, 3, -(fft.plan[i].n_permute));
@@ -588,13 +741,11 @@ int fft_init(const Utils::Vector3i &ca_mesh_dim, int const *ca_mesh_margin,
       int node = fft.plan[i].group[j];
       fft.plan[i].send_size[j] = calc_send_block(
           my_pos[i - 1], n_grid[i - 1], &(n_pos[i][3 * node]), n_grid[i],
-          global_mesh_dim, global_mesh_off, &(fft.plan[i].send_block[6 * j]));
+          mesh_dim, global_mesh_off, &(fft.plan[i].send_block[6 * j]));
       permute_ifield(&(fft.plan[i].send_block[6 * j]), 3,
                      -(fft.plan[i - 1].n_permute));
       permute_ifield(&(fft.plan[i].send_block[6 * j + 3]), 3,
                      -(fft.plan[i - 1].n_permute));
-      if (fft.plan[i].send_size[j] > fft.max_comm_size)
-        fft.max_comm_size = fft.plan[i].send_size[j];
       /* First plan send blocks have to be adjusted, since the CA grid
          may have an additional margin outside the actual domain of the
          node */
@@ -605,17 +756,17 @@ int fft_init(const Utils::Vector3i &ca_mesh_dim, int const *ca_mesh_margin,
       /* recv block: comm.rank() from comm-group-node i (identity: node) */
       fft.plan[i].recv_size[j] = calc_send_block(
           my_pos[i], n_grid[i], &(n_pos[i - 1][3 * node]), n_grid[i - 1],
-          global_mesh_dim, global_mesh_off, &(fft.plan[i].recv_block[6 * j]));
+          mesh_dim, global_mesh_off, &(fft.plan[i].recv_block[6 * j]));
       permute_ifield(&(fft.plan[i].recv_block[6 * j]), 3,
                      -(fft.plan[i].n_permute));
       permute_ifield(&(fft.plan[i].recv_block[6 * j + 3]), 3,
                      -(fft.plan[i].n_permute));
-      if (fft.plan[i].recv_size[j] > fft.max_comm_size)
-        fft.max_comm_size = fft.plan[i].recv_size[j];
     }
 
     for (j = 0; j < 3; j++)
       fft.plan[i].old_mesh[j] = fft.plan[i - 1].new_mesh[j];
+    if (i == 2)
+      fft.plan[i].old_mesh[2] = ks_mesh_dim[2];
     if (i == 1)
       fft.plan[i].element = 1;
     else {
@@ -625,14 +776,19 @@ int fft_init(const Utils::Vector3i &ca_mesh_dim, int const *ca_mesh_margin,
         fft.plan[i].recv_size[j] *= 2;
       }
     }
+    /* the blocks for all nodes of the group are communicated at once */
+    fft.max_comm_size = std::max(
+        {fft.max_comm_size,
+         std::accumulate(fft.plan[i].send_size.begin(),
+                         fft.plan[i].send_size.end(), 0),
+         std::accumulate(fft.plan[i].recv_size.begin(),
+                         fft.plan[i].recv_size.end(), 0)});
   }
 
-  /* Factor 2 for complex fields */
-  fft.max_comm_size *= 2;
-  fft.max_mesh_size = (ca_mesh_dim[0] * ca_mesh_dim[1] * ca_mesh_dim[2]);
-  for (i = 1; i < 4; i++)
-    if (2 * fft.plan[i].new_size > fft.max_mesh_size)
-      fft.max_mesh_size = 2 * fft.plan[i].new_size;
+  fft.max_mesh_size = std::max(
+      {ca_mesh_dim[0] * ca_mesh_dim[1] * ca_mesh_dim[2],
+       fft.plan[1].new_size, 2 * fft.plan[1].n_ffts * ks_mesh_dim[2],
+       2 * fft.plan[2].new_size, 2 * fft.plan[3].new_size});
 
   /* === pack function === */
   for (i = 1; i < 4; i++) {
@@ -647,11 +803,13 @@ int fft_init(const Utils::Vector3i &ca_mesh_dim, int const *ca_mesh_margin,
     (*ks_pnum) = 5;
   }
 
-  /* Factor 2 for complex numbers */
-  fft.send_buf.resize(fft.max_comm_size);
-  fft.recv_buf.resize(fft.max_comm_size);
-  fft.data_buf.resize(fft.max_mesh_size);
-  auto *c_data = (fftw_complex *)(fft.data_buf.data());
+  auto &buffers = mesh_buffers(fft, 1);
+  auto *r_data = buffers[0].data_buf.data();
+  auto *c_data = (fftw_complex *)(buffers[0].data_buf.data());
+  /* the first direction is transformed out of place, from the real rows
+     in the buffer to the complex rows in the mesh */
+  fft_vector<double> ks_data(fft.max_mesh_size);
+  auto *c_ks_data = (fftw_complex *)(ks_data.data());
 
   /* === FFT Routines (Using FFTW / RFFTW package)=== */
   for (i = 1; i < 4; i++) {
@@ -660,10 +818,17 @@ int fft_init(const Utils::Vector3i &ca_mesh_dim, int const *ca_mesh_margin,
 
     if (fft.init_tag)
       fftw_destroy_plan(fft.plan[i].our_fftw_plan);
-    fft.plan[i].our_fftw_plan = fftw_plan_many_dft(
-        1, &fft.plan[i].new_mesh[2], fft.plan[i].n_ffts, c_data, nullptr, 1,
-        fft.plan[i].new_mesh[2], c_data, nullptr, 1, fft.plan[i].new_mesh[2],
-        fft.plan[i].dir, FFTW_PATIENT);
+    if (i == 1) {
+      fft.plan[i].our_fftw_plan = fftw_plan_many_dft_r2c(
+          1, &fft.plan[i].new_mesh[2], fft.plan[i].n_ffts, r_data, nullptr, 1,
+          fft.plan[i].new_mesh[2], c_ks_data, nullptr, 1, ks_mesh_dim[2],
+          FFTW_PATIENT);
+    } else {
+      fft.plan[i].our_fftw_plan = fftw_plan_many_dft(
+          1, &fft.plan[i].new_mesh[2], fft.plan[i].n_ffts, c_data, nullptr, 1,
+          fft.plan[i].new_mesh[2], c_data, nullptr, 1, fft.plan[i].new_mesh[2],
+          fft.plan[i].dir, FFTW_PATIENT);
+    }
   }
 
   /* === The BACK Direction === */
@@ -673,10 +838,17 @@ int fft_init(const Utils::Vector3i &ca_mesh_dim, int const *ca_mesh_margin,
 
     if (fft.init_tag)
       fftw_destroy_plan(fft.back[i].our_fftw_plan);
-    fft.back[i].our_fftw_plan = fftw_plan_many_dft(
-        1, &fft.plan[i].new_mesh[2], fft.plan[i].n_ffts, c_data, nullptr, 1,
-        fft.plan[i].new_mesh[2], c_data, nullptr, 1, fft.plan[i].new_mesh[2],
-        fft.back[i].dir, FFTW_PATIENT);
+    if (i == 1) {
+      fft.back[i].our_fftw_plan = fftw_plan_many_dft_c2r(
+          1, &fft.plan[i].new_mesh[2], fft.plan[i].n_ffts, c_ks_data, nullptr,
+          1, ks_mesh_dim[2], r_data, nullptr, 1, fft.plan[i].new_mesh[2],
+          FFTW_PATIENT);
+    } else {
+      fft.back[i].our_fftw_plan = fftw_plan_many_dft(
+          1, &fft.plan[i].new_mesh[2], fft.plan[i].n_ffts, c_data, nullptr, 1,
+          fft.plan[i].new_mesh[2], c_data, nullptr, 1, fft.plan[i].new_mesh[2],
+          fft.back[i].dir, FFTW_PATIENT);
+    }
 
     fft.back[i].pack_function = pack_block_permute1;
   }
@@ -693,73 +865,106 @@ int fft_init(const Utils::Vector3i &ca_mesh_dim, int const *ca_mesh_margin,
 
 void fft_perform_forw(double *data, fft_data_struct &fft,
                       const boost::mpi::communicator &comm) {
-  /* ===== first direction  ===== */
+  fft_perform_forw(Utils::make_const_span(&data, 1), fft, comm);
+}
 
-  auto *c_data = (fftw_complex *)data;
-  auto *c_data_buf = (fftw_complex *)fft.data_buf.data();
+void fft_perform_forw(Utils::Span<double *const> data, fft_data_struct &fft,
+                      const boost::mpi::communicator &comm) {
+  auto const n_meshes = static_cast<int>(data.size());
+  auto &buffers = mesh_buffers(fft, data.size());
+  auto const comm_1 = forw_grid_comm(fft.plan[1]);
+  auto const comm_2 = forw_grid_comm(fft.plan[2]);
+  auto const comm_3 = forw_grid_comm(fft.plan[3]);
 
+  /* ===== first direction  ===== */
   /* communication to current dir row format (in is data) */
-  forw_grid_comm(fft.plan[1], data, fft.data_buf.data(), fft, comm);
-
-  /* complexify the real data array (in is fft.data_buf) */
-  for (int i = 0; i < fft.plan[1].new_size; i++) {
-    data[2 * i + 0] = fft.data_buf[i]; /* real value */
-    data[2 * i + 1] = 0;               /* complex value */
+  for (int m = 0; m < n_meshes; m++) {
+    start_grid_comm(comm_1, data[m], buffers[m], comm);
+  }
+  for (int m = 0; m < n_meshes; m++) {
+    auto *c_data = (fftw_complex *)data[m];
+    auto &data_buf = buffers[m].data_buf;
+
+    finish_grid_comm(comm_1, data_buf.data(), buffers[m], comm);
+    /* perform real-to-complex FFT (in is data_buf, out is data) */
+    fftw_execute_dft_r2c(fft.plan[1].our_fftw_plan, data_buf.data(), c_data);
+    /* communication to next dir row format (in is data) */
+    start_grid_comm(comm_2, data[m], buffers[m], comm);
   }
-  /* perform FFT (in/out is data)*/
-  fftw_execute_dft(fft.plan[1].our_fftw_plan, c_data, c_data);
+
   /* ===== second direction ===== */
-  /* communication to current dir row format (in is data) */
-  forw_grid_comm(fft.plan[2], data, fft.data_buf.data(), fft, comm);
-  /* perform FFT (in/out is fft.data_buf)*/
-  fftw_execute_dft(fft.plan[2].our_fftw_plan, c_data_buf, c_data_buf);
+  for (int m = 0; m < n_meshes; m++) {
+    auto *data_buf = buffers[m].data_buf.data();
+    auto *c_data_buf = (fftw_complex *)data_buf;
+
+    finish_grid_comm(comm_2, data_buf, buffers[m], comm);
+    /* perform FFT (in/out is data_buf)*/
+    fftw_execute_dft(fft.plan[2].our_fftw_plan, c_data_buf, c_data_buf);
+    /* communication to next dir row format (in is data_buf) */
+    start_grid_comm(comm_3, data_buf, buffers[m], comm);
+  }
+
   /* ===== third direction  ===== */
-  /* communication to current dir row format (in is fft.data_buf) */
-  forw_grid_comm(fft.plan[3], fft.data_buf.data(), data, fft, comm);
-  /* perform FFT (in/out is data)*/
-  fftw_execute_dft(fft.plan[3].our_fftw_plan, c_data, c_data);
+  for (int m = 0; m < n_meshes; m++) {
+    auto *c_data = (fftw_complex *)data[m];
+
+    finish_grid_comm(comm_3, data[m], buffers[m], comm);
+    /* perform FFT (in/out is data)*/
+    fftw_execute_dft(fft.plan[3].our_fftw_plan, c_data, c_data);
+  }
 
   /* REMARK: Result has to be in data. */
 }
 
-void fft_perform_back(double *data, bool check_complex, fft_data_struct &fft,
+void fft_perform_back(double *data, fft_data_struct &fft,
                       const boost::mpi::communicator &comm) {
+  fft_perform_back(Utils::make_const_span(&data, 1), fft, comm);
+}
 
-  auto *c_data = (fftw_complex *)data;
-  auto *c_data_buf = (fftw_complex *)fft.data_buf.data();
+void fft_perform_back(Utils::Span<double *const> data, fft_data_struct &fft,
+                      const boost::mpi::communicator &comm) {
+  auto const n_meshes = static_cast<int>(data.size());
+  auto &buffers = mesh_buffers(fft, data.size());
+  auto const comm_3 = back_grid_comm(fft.plan[3], fft.back[3]);
+  auto const comm_2 = back_grid_comm(fft.plan[2], fft.back[2]);
+  auto const comm_1 = back_grid_comm(fft.plan[1], fft.back[1]);
 
   /* ===== third direction  ===== */
+  for (int m = 0; m < n_meshes; m++) {
+    auto *c_data = (fftw_complex *)data[m];
 
-  /* perform FFT (in is data) */
-  fftw_execute_dft(fft.back[3].our_fftw_plan, c_data, c_data);
-  /* communicate (in is data)*/
-  back_grid_comm(fft.plan[3], fft.back[3], data, fft.data_buf.data(), fft,
-                 comm);
+    /* perform FFT (in is data) */
+    fftw_execute_dft(fft.back[3].our_fftw_plan, c_data, c_data);
+    /* communicate (in is data)*/
+    start_grid_comm(comm_3, data[m], buffers[m], comm);
+  }
 
   /* ===== second direction ===== */
-  /* perform FFT (in is fft.data_buf) */
-  fftw_execute_dft(fft.back[2].our_fftw_plan, c_data_buf, c_data_buf);
-  /* communicate (in is fft.data_buf) */
-  back_grid_comm(fft.plan[2], fft.back[2], fft.data_buf.data(), data, fft,
-                 comm);
+  for (int m = 0; m < n_meshes; m++) {
+    auto *data_buf = buffers[m].data_buf.data();
+    auto *c_data_buf = (fftw_complex *)data_buf;
+
+    finish_grid_comm(comm_3, data_buf, buffers[m], comm);
+    /* perform FFT (in is data_buf) */
+    fftw_execute_dft(fft.back[2].our_fftw_plan, c_data_buf, c_data_buf);
+    /* communicate (in is data_buf) */
+    start_grid_comm(comm_2, data_buf, buffers[m], comm);
+  }
 
   /* ===== first direction  ===== */
-  /* perform FFT (in is data) */
-  fftw_execute_dft(fft.back[1].our_fftw_plan, c_data, c_data);
-  /* throw away the (hopefully) empty complex component (in is data)*/
-  for (int i = 0; i < fft.plan[1].new_size; i++) {
-    fft.data_buf[i] = data[2 * i]; /* real value */
-    // Vincent:
-    if (check_complex && (data[2 * i + 1] > 1e-5)) {
-      printf("Complex value is not zero (i=%d,data=%g)!!!\n", i,
-             data[2 * i + 1]);
-      if (i > 100)
-        throw std::runtime_error("Complex value is not zero");
-    }
+  for (int m = 0; m < n_meshes; m++) {
+    auto *c_data = (fftw_complex *)data[m];
+    auto &data_buf = buffers[m].data_buf;
+
+    finish_grid_comm(comm_2, data[m], buffers[m], comm);
+    /* perform complex-to-real FFT (in is data, out is data_buf) */
+    fftw_execute_dft_c2r(fft.back[1].our_fftw_plan, c_data, data_buf.data());
+    /* communicate (in is data_buf) */
+    start_grid_comm(comm_1, data_buf.data(), buffers[m], comm);
+  }
+  for (int m = 0; m < n_meshes; m++) {
+    finish_grid_comm(comm_1, data[m], buffers[m], comm);
   }
-  /* communicate (in is fft.data_buf) */
-  back_grid_comm(fft.plan[1], fft.back[1], fft.data_buf.data(), data, fft,
-                 comm);
 
   /* REMARK: Result has to be in data. */
 }
@@ -31,9 +31,18 @@
  *  1D-FFT. After performing the FFT on that direction the data is
  *  redistributed.
  *
- *  For simplicity at the moment I have implemented a full complex to
- *  complex FFT (even though a real to complex FFT would be
- *  sufficient)
+ *  The rows of the first direction are along z. Since the mesh is real,
+ *  this direction is a real to complex FFT, which keeps only the modes
+ *  \f$0 \le k_z \le N_z/2\f$; the modes with negative \f$k_z\f$ are the
+ *  complex conjugates of these. The other two directions are complex to
+ *  complex FFTs on this half mesh. In k-space, the mesh points with
+ *  \f$0 < k_z < N_z/2\f$ therefore stand for two modes in sums over the
+ *  full mesh, see @ref fft_ks_mode_weight.
+ *
+ *  The redistributions are done with non-blocking point-to-point
+ *  communication: the blocks are unpacked in the order they arrive.
+ *  When several meshes are transformed in one call, the redistribution
+ *  of one mesh proceeds while the 1D FFTs of the next mesh are computed.
  *
  *  \todo Combine the forward and backward structures.
  *  \todo The packing routines could be moved to utils.hpp when they are needed
@@ -45,10 +54,14 @@
 #include "config.hpp"
 #if defined(P3M) || defined(DP3M)
 
+#include <utils/Span.hpp>
 #include <utils/Vector.hpp>
 
 #include <boost/mpi/communicator.hpp>
 #include <fftw3.h>
+#include <mpi.h>
+
+#include <vector>
 
 /************************************************
  * data types
@@ -140,6 +153,20 @@ struct fft_back_plan {
                         int const *, int const *, int);
 };
 
+/** Buffers for the transformation of one mesh. */
+struct fft_mesh_buffers {
+  /** Buffer for receive data. */
+  fft_vector<double> data_buf;
+  /** send buffer, holds the blocks for all nodes of the group. */
+  std::vector<double> send_buf;
+  /** receive buffer, holds the blocks from all nodes of the group. */
+  std::vector<double> recv_buf;
+  /** Pending send requests. */
+  std::vector<MPI_Request> send_req;
+  /** Pending receive requests. */
+  std::vector<MPI_Request> recv_req;
+};
+
 /** Information about the three one dimensional FFTs and how the nodes
  *  have to communicate inbetween.
  *
@@ -162,12 +189,8 @@ struct fft_data_struct {
   /** Maximal local mesh size. */
   int max_mesh_size = 0;
 
-  /** send buffer. */
-  std::vector<double> send_buf;
-  /** receive buffer. */
-  std::vector<double> recv_buf;
-  /** Buffer for receive data. */
-  fft_vector<double> data_buf;
+  /** Buffers, one set for each mesh transformed concurrently. */
+  std::vector<fft_mesh_buffers> buffers;
 };
 
 /** \name Exported Functions */
@@ -185,6 +208,9 @@ struct fft_data_struct {
  *  \param grid            Number of nodes in each spatial dimension.
  *  \param comm            MPI communicator.
  *  \return Maximal size of local fft mesh (needed for allocation of ca_mesh).
+ *  In k-space, the local mesh is <tt>fft.plan[3].new_mesh</tt> of the
+ *  global mesh <tt>{global_mesh_dim[1], global_mesh_dim[2] / 2 + 1,
+ *  global_mesh_dim[0]}</tt>.
  */
 int fft_init(const Utils::Vector3i &ca_mesh_dim, int const *ca_mesh_margin,
              int *global_mesh_dim, double *global_mesh_off, int *ks_pnum,
@@ -200,16 +226,45 @@ int fft_init(const Utils::Vector3i &ca_mesh_dim, int const *ca_mesh_margin,
 void fft_perform_forw(double *data, fft_data_struct &fft,
                       const boost::mpi::communicator &comm);
 
-/** Perform an in-place backward 3D FFT.
+/** Perform in-place forward 3D FFTs of several meshes. The
+ *  redistribution of each mesh overlaps with the 1D FFTs of the others.
+ *  \warning The content of the meshes is overwritten.
+ *  \param[in,out] data  Meshes.
+ *  \param fft           FFT plan.
+ *  \param comm          MPI communicator
+ */
+void fft_perform_forw(Utils::Span<double *const> data, fft_data_struct &fft,
+                      const boost::mpi::communicator &comm);
+
+/** Perform an in-place backward 3D FFT. The k-space mesh is taken to be
+ *  the half spectrum of a real mesh.
  *  \warning The content of \a data is overwritten.
  *  \param[in,out] data   Mesh.
- *  \param check_complex  Throw an error if the complex component is non-zero.
  *  \param fft            FFT plan.
  *  \param comm           MPI communicator.
  */
-void fft_perform_back(double *data, bool check_complex, fft_data_struct &fft,
+void fft_perform_back(double *data, fft_data_struct &fft,
+                      const boost::mpi::communicator &comm);
+
+/** Perform in-place backward 3D FFTs of several meshes. The
+ *  redistribution of each mesh overlaps with the 1D FFTs of the others.
+ *  \warning The content of the meshes is overwritten.
+ *  \param[in,out] data   Meshes.
+ *  \param fft            FFT plan.
+ *  \param comm           MPI communicator.
+ */
+void fft_perform_back(Utils::Span<double *const> data, fft_data_struct &fft,
                       const boost::mpi::communicator &comm);
 
+/** Number of modes of the full k-space mesh represented by a point of the
+ *  half mesh of the real to complex FFT.
+ *  \param n_z     global index of the point along z.
+ *  \param mesh_z  global mesh size along z.
+ */
+inline int fft_ks_mode_weight(int n_z, int mesh_z) {
+  return (n_z == 0 or 2 * n_z == mesh_z) ? 1 : 2;
+}
+
 /** pack a block (size[3] starting at start[3]) of an input 3d-grid
  *  with dimension dim[3] into an output 3d-block with dimension size[3].
  *
@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2020 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "electrostatics_magnetostatics/gather_dipoles.hpp"
+
+#ifdef DIPOLES
+#include "communication.hpp"
+#include "grid.hpp"
+
+#include <utils/mpi/all_gatherv.hpp>
+
+#include <boost/mpi/collectives/all_gather.hpp>
+
+std::vector<Particle *> dipolar_particles(ParticleRange const &particles) {
+  std::vector<Particle *> result;
+  for (auto &p : particles) {
+    if (p.p.dipm != 0.0)
+      result.push_back(&p);
+  }
+  return result;
+}
+
+GatheredDipoles gather_dipoles(std::vector<Particle *> const &local) {
+  std::vector<double> send_buf;
+  send_buf.reserve(6 * local.size());
+  for (auto const p : local) {
+    auto const pos = folded_position(p->r.p, box_geo);
+    auto const dip = p->calc_dip();
+    send_buf.insert(send_buf.end(),
+                    {pos[0], pos[1], pos[2], dip[0], dip[1], dip[2]});
+  }
+
+  std::vector<int> sizes;
+  boost::mpi::all_gather(comm_cart, static_cast<int>(send_buf.size()), sizes);
+  std::vector<int> displs(sizes.size(), 0);
+  for (std::size_t i = 1; i < sizes.size(); i++) {
+    displs[i] = displs[i - 1] + sizes[i - 1];
+  }
+  std::vector<double> recv_buf(displs.back() + sizes.back());
+  Utils::Mpi::all_gatherv(comm_cart, send_buf.data(),
+                          static_cast<int>(send_buf.size()), recv_buf.data(),
+                          sizes.data(), displs.data());
+
+  GatheredDipoles dipoles;
+  auto const n_dipoles = recv_buf.size() / 6;
+  for (auto *v : {&dipoles.x, &dipoles.y, &dipoles.z, &dipoles.mx, &dipoles.my,
+                  &dipoles.mz}) {
+    v->resize(n_dipoles);
+  }
+  for (std::size_t i = 0; i < n_dipoles; i++) {
+    dipoles.x[i] = recv_buf[6 * i + 0];
+    dipoles.y[i] = recv_buf[6 * i + 1];
+    dipoles.z[i] = recv_buf[6 * i + 2];
+    dipoles.mx[i] = recv_buf[6 * i + 3];
+    dipoles.my[i] = recv_buf[6 * i + 4];
+    dipoles.mz[i] = recv_buf[6 * i + 5];
+  }
+  dipoles.offset = displs[this_node] / 6;
+
+  return dipoles;
+}
+#endif // DIPOLES
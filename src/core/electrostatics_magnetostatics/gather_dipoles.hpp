@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2020 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef ESPRESSO_GATHER_DIPOLES_HPP
+#define ESPRESSO_GATHER_DIPOLES_HPP
+/** \file
+ *  Replication of the dipoles of all MPI ranks on every rank, for the
+ *  dipolar methods which evaluate the interactions of the local particles
+ *  with all others.
+ *
+ *  Implementation in gather_dipoles.cpp.
+ */
+
+#include "config.hpp"
+
+#ifdef DIPOLES
+#include "Particle.hpp"
+
+#include <ParticleRange.hpp>
+
+#include <vector>
+
+/** Dipoles of all ranks in structure-of-arrays layout, with the positions
+ *  folded into the primary box. The dipoles are ordered by rank.
+ */
+struct GatheredDipoles {
+  std::vector<double> x, y, z;
+  std::vector<double> mx, my, mz;
+  /** Index of the first dipole of this rank. */
+  int offset;
+};
+
+/** Local particles which carry a dipole moment. */
+std::vector<Particle *> dipolar_particles(ParticleRange const &particles);
+
+/** Collect the dipoles of all ranks on every rank.
+ *
+ *  Has to be called on all ranks.
+ *
+ *  @param local  dipolar particles of this rank, see @ref dipolar_particles
+ */
+GatheredDipoles gather_dipoles(std::vector<Particle *> const &local);
+
+#endif // DIPOLES
+#endif
@@ -30,9 +30,13 @@
 
 #ifdef ELECTROSTATICS
 
+#include <algorithm>
 #include <cmath>
 #include <cstddef>
 #include <cstdlib>
+#include <numeric>
+#include <utility>
+#include <vector>
 
 #include "electrostatics_magnetostatics/p3m_gpu.hpp"
 
@@ -43,6 +47,7 @@
 #include "errorhandling.hpp"
 #include "event.hpp"
 #include "forces.hpp"
+#include "integrate.hpp"
 #include "nonbonded_interactions/nonbonded_interaction_data.hpp"
 
 #include "short_range_loop.hpp"
@@ -53,6 +58,160 @@
 
 iccp3m_struct iccp3m_cfg;
 
+namespace {
+/** Induced charges of all ICC particles at one time. */
+struct ICCSolution {
+  double time;
+  std::vector<double> charges;
+};
+
+/** Converged induced charges of the last time steps, oldest first. */
+std::vector<ICCSolution> charge_history;
+
+bool is_icc_particle(Particle const &p) {
+  return p.p.identity < iccp3m_cfg.n_ic + iccp3m_cfg.first_id &&
+         p.p.identity >= iccp3m_cfg.first_id;
+}
+
+/** Add the converged charges to @ref charge_history. The charges are
+ *  collected on all ranks, so that the history stays valid when the ICC
+ *  particles change their rank.
+ */
+void store_charges(const ParticleRange &particles) {
+  if (iccp3m_cfg.extrapolation_order <= 0) {
+    charge_history.clear();
+    return;
+  }
+
+  std::vector<double> charges(iccp3m_cfg.n_ic, 0.);
+  for (auto const &p : particles) {
+    if (is_icc_particle(p))
+      charges[p.p.identity - iccp3m_cfg.first_id] = p.p.q;
+  }
+  MPI_Allreduce(MPI_IN_PLACE, charges.data(), iccp3m_cfg.n_ic, MPI_DOUBLE,
+                MPI_SUM, comm_cart);
+
+  /* repeated force calculations at the same time replace the entry */
+  if (not charge_history.empty() and charge_history.back().time == sim_time)
+    charge_history.pop_back();
+  charge_history.push_back({sim_time, std::move(charges)});
+
+  auto const n_points =
+      static_cast<std::size_t>(iccp3m_cfg.extrapolation_order) + 1;
+  if (charge_history.size() > n_points) {
+    charge_history.erase(charge_history.begin(),
+                         charge_history.end() - n_points);
+  }
+}
+
+/** Set the charges of the ICC particles to the polynomial extrapolation of
+ *  the stored solutions to the current time.
+ *
+ *  @return whether the charges were changed
+ */
+bool extrapolate_charges(std::vector<Particle *> const &icc_particles) {
+  auto const n_points =
+      static_cast<std::size_t>(iccp3m_cfg.extrapolation_order) + 1;
+  if (iccp3m_cfg.extrapolation_order <= 0 or
+      charge_history.size() < n_points or
+      charge_history.back().time == sim_time)
+    return false;
+
+  /* Lagrange weights of the stored solutions at the current time */
+  auto const first = charge_history.end() - n_points;
+  std::vector<double> weights(n_points, 1.);
+  for (std::size_t k = 0; k < n_points; k++) {
+    for (std::size_t l = 0; l < n_points; l++) {
+      if (l != k) {
+        weights[k] *= (sim_time - first[l].time) /
+                      (first[k].time - first[l].time);
+      }
+    }
+  }
+
+  for (auto p : icc_particles) {
+    auto const id = p->p.identity - iccp3m_cfg.first_id;
+    double q = 0.;
+    for (std::size_t k = 0; k < n_points; k++) {
+      q += weights[k] * first[k].charges[id];
+    }
+    p->p.q = q;
+  }
+  return true;
+}
+
+/** Coefficients of the Anderson acceleration, which minimize
+ *  \f$\| r - \sum_c \gamma_c \Delta r_c \|\f$ over the residuals of all
+ *  ranks. The normal equations are solved by Gaussian elimination.
+ *
+ *  @param dr_history  differences of the residuals of the last iterates
+ *  @param residual    residual of the current iterate
+ */
+std::vector<double>
+anderson_coefficients(std::vector<std::vector<double>> const &dr_history,
+                      std::vector<double> const &residual) {
+  auto const m = dr_history.size();
+  /* matrix in the first m * m entries, right hand side in the last m */
+  std::vector<double> system(m * (m + 1), 0.);
+  for (std::size_t a = 0; a < m; a++) {
+    for (std::size_t b = 0; b < m; b++) {
+      system[a * m + b] = std::inner_product(
+          dr_history[a].begin(), dr_history[a].end(), dr_history[b].begin(),
+          0.);
+    }
+    system[m * m + a] = std::inner_product(
+        dr_history[a].begin(), dr_history[a].end(), residual.begin(), 0.);
+  }
+  MPI_Allreduce(MPI_IN_PLACE, system.data(), static_cast<int>(system.size()),
+                MPI_DOUBLE, MPI_SUM, comm_cart);
+
+  auto matrix = [&system, m](std::size_t a, std::size_t b) -> double & {
+    return system[a * m + b];
+  };
+  std::vector<double> gamma(system.begin() + m * m, system.end());
+
+  /* small shift of the diagonal against linearly dependent differences */
+  double diag_max = 0.;
+  for (std::size_t a = 0; a < m; a++) {
+    diag_max = std::max(diag_max, matrix(a, a));
+  }
+  for (std::size_t a = 0; a < m; a++) {
+    matrix(a, a) += 1e-12 * diag_max;
+  }
+
+  for (std::size_t c = 0; c < m; c++) {
+    auto pivot = c;
+    for (std::size_t a = c + 1; a < m; a++) {
+      if (std::abs(matrix(a, c)) > std::abs(matrix(pivot, c)))
+        pivot = a;
+    }
+    if (matrix(pivot, c) == 0.) {
+      /* no residual differences at all: plain relaxation */
+      return std::vector<double>(m, 0.);
+    }
+    for (std::size_t b = 0; b < m; b++) {
+      std::swap(matrix(c, b), matrix(pivot, b));
+    }
+    std::swap(gamma[c], gamma[pivot]);
+    for (std::size_t a = c + 1; a < m; a++) {
+      auto const factor = matrix(a, c) / matrix(c, c);
+      for (std::size_t b = c; b < m; b++) {
+        matrix(a, b) -= factor * matrix(c, b);
+      }
+      gamma[a] -= factor * gamma[c];
+    }
+  }
+  for (std::size_t c = m; c-- > 0;) {
+    for (std::size_t b = c + 1; b < m; b++) {
+      gamma[c] -= matrix(c, b) * gamma[b];
+    }
+    gamma[c] /= matrix(c, c);
+  }
+
+  return gamma;
+}
+} // namespace
+
 void init_forces_iccp3m(const ParticleRange &particles,
                         const ParticleRange &ghosts_particles);
 
@@ -90,6 +249,8 @@ void iccp3m_alloc_lists() {
   iccp3m_cfg.sigma.resize(n_ic);
 }
 
+void iccp3m_reset_history() { charge_history.clear(); }
+
 int iccp3m_iteration(const ParticleRange &particles,
                      const ParticleRange &ghost_particles) {
   if (iccp3m_cfg.n_ic == 0)
@@ -105,6 +266,23 @@ int iccp3m_iteration(const ParticleRange &particles,
   auto const pref = 1.0 / (coulomb.prefactor * 6.283185307);
   iccp3m_cfg.citeration = 0;
 
+  std::vector<Particle *> icc_particles;
+  for (auto &p : particles) {
+    if (is_icc_particle(p))
+      icc_particles.push_back(&p);
+  }
+  auto const n_local = icc_particles.size();
+
+  if (extrapolate_charges(icc_particles)) {
+    cell_structure.ghosts_update(Cells::DATA_PART_PROPERTIES);
+  }
+
+  /* charge densities and residuals of the current iterate */
+  std::vector<double> h(n_local), residual(n_local), hnew(n_local);
+  /* differences of the previous iterates for the Anderson acceleration */
+  std::vector<double> h_prev, residual_prev;
+  std::vector<std::vector<double>> dh_history, dr_history;
+
   double globalmax = 1e100;
 
   for (int j = 0; j < iccp3m_cfg.num_iteration; j++) {
@@ -116,62 +294,96 @@ int iccp3m_iteration(const ParticleRange &particles,
 
     double diff = 0;
 
-    for (auto &p : particles) {
-      if (p.p.identity < iccp3m_cfg.n_ic + iccp3m_cfg.first_id &&
-          p.p.identity >= iccp3m_cfg.first_id) {
-        auto const id = p.p.identity - iccp3m_cfg.first_id;
-        /* the dielectric-related prefactor: */
-        auto const del_eps = (iccp3m_cfg.ein[id] - iccp3m_cfg.eout) /
-                             (iccp3m_cfg.ein[id] + iccp3m_cfg.eout);
-        /* calculate the electric field at the certain position */
-        auto const E = p.f.f / p.p.q + iccp3m_cfg.ext_field;
-
-        if (E[0] == 0 && E[1] == 0 && E[2] == 0) {
-          runtimeErrorMsg()
-              << "ICCP3M found zero electric field on a charge. This must "
-                 "never happen";
-        }
+    for (std::size_t k = 0; k < n_local; k++) {
+      auto const &p = *icc_particles[k];
+      auto const id = p.p.identity - iccp3m_cfg.first_id;
+      /* the dielectric-related prefactor: */
+      auto const del_eps = (iccp3m_cfg.ein[id] - iccp3m_cfg.eout) /
+                           (iccp3m_cfg.ein[id] + iccp3m_cfg.eout);
+      /* calculate the electric field at the certain position */
+      auto const E = p.f.f / p.p.q + iccp3m_cfg.ext_field;
+
+      if (E[0] == 0 && E[1] == 0 && E[2] == 0) {
+        runtimeErrorMsg()
+            << "ICCP3M found zero electric field on a charge. This must "
+               "never happen";
+      }
 
-        /* recalculate the old charge density */
-        auto const hold = p.p.q / iccp3m_cfg.areas[id];
-        /* determine if it is higher than the previously highest charge
-         * density */
-        hmax = std::max(hmax, std::abs(hold));
-
-        auto const f1 = del_eps * pref * (E * iccp3m_cfg.normals[id]);
-        auto const f2 = (not iccp3m_cfg.sigma.empty())
-                            ? (2 * iccp3m_cfg.eout) /
-                                  (iccp3m_cfg.eout + iccp3m_cfg.ein[id]) *
-                                  (iccp3m_cfg.sigma[id])
-                            : 0.;
-        /* relative variation: never use an estimator which can be negative
-         * here */
-        auto const hnew =
-            (1. - iccp3m_cfg.relax) * hold + (iccp3m_cfg.relax) * (f1 + f2);
-
-        /* Take the largest error to check for convergence */
-        auto const relative_difference =
-            std::abs(1 * (hnew - hold) / (hmax + std::abs(hnew + hold)));
-
-        diff = std::max(diff, relative_difference);
-
-        p.p.q = hnew * iccp3m_cfg.areas[id];
-
-        /* check if the charge now is more than 1e6, to determine if ICC still
-         * leads to reasonable results */
-        /* this is kind of an arbitrary measure but does a good job spotting
-         * divergence! */
-        if (std::abs(p.p.q) > 1e6) {
-          runtimeErrorMsg()
-              << "too big charge assignment in iccp3m! q >1e6 , assigned "
-                 "charge= "
-              << p.p.q;
-
-          diff = 1e90; /* A very high value is used as error code */
-          break;
+      /* recalculate the old charge density */
+      auto const hold = p.p.q / iccp3m_cfg.areas[id];
+      /* determine if it is higher than the previously highest charge
+       * density */
+      hmax = std::max(hmax, std::abs(hold));
+
+      auto const f1 = del_eps * pref * (E * iccp3m_cfg.normals[id]);
+      auto const f2 = (not iccp3m_cfg.sigma.empty())
+                          ? (2 * iccp3m_cfg.eout) /
+                                (iccp3m_cfg.eout + iccp3m_cfg.ein[id]) *
+                                (iccp3m_cfg.sigma[id])
+                          : 0.;
+      h[k] = hold;
+      residual[k] = f1 + f2 - hold;
+      /* relative variation: never use an estimator which can be negative
+       * here */
+      auto const hrelax = hold + iccp3m_cfg.relax * residual[k];
+
+      /* Take the largest error to check for convergence */
+      auto const relative_difference =
+          std::abs(1 * (hrelax - hold) / (hmax + std::abs(hrelax + hold)));
+
+      diff = std::max(diff, relative_difference);
+    }
+
+    if (iccp3m_cfg.anderson_depth > 0 and j > 0) {
+      std::vector<double> dh(n_local), dr(n_local);
+      for (std::size_t k = 0; k < n_local; k++) {
+        dh[k] = h[k] - h_prev[k];
+        dr[k] = residual[k] - residual_prev[k];
+      }
+      dh_history.push_back(std::move(dh));
+      dr_history.push_back(std::move(dr));
+      if (dh_history.size() >
+          static_cast<std::size_t>(iccp3m_cfg.anderson_depth)) {
+        dh_history.erase(dh_history.begin());
+        dr_history.erase(dr_history.begin());
+      }
+      auto const gamma = anderson_coefficients(dr_history, residual);
+      for (std::size_t k = 0; k < n_local; k++) {
+        hnew[k] = h[k] + iccp3m_cfg.relax * residual[k];
+        for (std::size_t c = 0; c < gamma.size(); c++) {
+          hnew[k] -= gamma[c] * (dh_history[c][k] +
+                                 iccp3m_cfg.relax * dr_history[c][k]);
         }
       }
-    } /* cell particles */
+    } else {
+      for (std::size_t k = 0; k < n_local; k++) {
+        hnew[k] = h[k] + iccp3m_cfg.relax * residual[k];
+      }
+    }
+    if (iccp3m_cfg.anderson_depth > 0) {
+      h_prev = h;
+      residual_prev = residual;
+    }
+
+    for (std::size_t k = 0; k < n_local; k++) {
+      auto &p = *icc_particles[k];
+      auto const id = p.p.identity - iccp3m_cfg.first_id;
+      p.p.q = hnew[k] * iccp3m_cfg.areas[id];
+
+      /* check if the charge now is more than 1e6, to determine if ICC still
+       * leads to reasonable results */
+      /* this is kind of an arbitrary measure but does a good job spotting
+       * divergence! */
+      if (std::abs(p.p.q) > 1e6) {
+        runtimeErrorMsg()
+            << "too big charge assignment in iccp3m! q >1e6 , assigned "
+               "charge= "
+            << p.p.q;
+
+        diff = 1e90; /* A very high value is used as error code */
+        break;
+      }
+    }
     /* Update charges on ghosts. */
     cell_structure.ghosts_update(Cells::DATA_PART_PROPERTIES);
 
@@ -188,6 +400,8 @@ int iccp3m_iteration(const ParticleRange &particles,
         << "ICC failed to converge in the given number of maximal steps.";
   }
 
+  store_charges(particles);
+
   on_particle_charge_change();
 
   return iccp3m_cfg.citeration;
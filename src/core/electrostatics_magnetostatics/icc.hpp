@@ -70,6 +70,13 @@ struct iccp3m_struct {
   double relax = 0.7; /**< relaxation parameter for iteration */
   int citeration = 0; /**< current number of iterations */
   int first_id = 0; /**< id of the first particle in the dielectric boundary */
+  int anderson_depth = 0; /**< Number of previous iterates used by the
+                               Anderson acceleration, 0 for plain
+                               relaxation */
+  int extrapolation_order = 0; /**< Order of the polynomial extrapolation of
+                                    the induced charges from the previous
+                                    time steps, 0 to start from the last
+                                    charges */
 
   template <typename Archive>
   void serialize(Archive &ar, long int /* version */) {
@@ -85,12 +92,22 @@ struct iccp3m_struct {
     ar &sigma;
     ar &ext_field;
     ar &citeration;
+    ar &anderson_depth;
+    ar &extrapolation_order;
   }
 };
 extern iccp3m_struct iccp3m_cfg; /**< Global state of the ICCP3M solver */
 
 /** The main iterative scheme, where the surface element charges are calculated
  *  self-consistently.
+ *
+ *  The fixed-point iteration is either relaxed with @ref
+ *  iccp3m_struct::relax "relax", or accelerated by Anderson mixing of the
+ *  last @ref iccp3m_struct::anderson_depth "anderson_depth" iterates
+ *  @cite walker11a, which for this linear problem is equivalent to GMRES.
+ *  The initial guess is extrapolated from the induced charges of the
+ *  previous time steps if @ref iccp3m_struct::extrapolation_order
+ *  "extrapolation_order" is positive.
  */
 int iccp3m_iteration(const ParticleRange &particles,
                      const ParticleRange &ghost_particles);
@@ -99,6 +116,11 @@ int iccp3m_iteration(const ParticleRange &particles,
  */
 void iccp3m_alloc_lists();
 
+/** Discard the induced charges of the previous time steps, which are used
+ *  for the extrapolation of the initial guess.
+ */
+void iccp3m_reset_history();
+
 /** check sanity of parameters for use with ICCP3M
  */
 int iccp3m_sanity_check();
@@ -26,62 +26,185 @@
 #include "communication.hpp"
 #include "dipole.hpp"
 #include "electrostatics_magnetostatics/dipole.hpp"
+#include "electrostatics_magnetostatics/gather_dipoles.hpp"
 #include "errorhandling.hpp"
 #include "grid.hpp"
 
 #include <utils/constants.hpp>
 
-double calc_dipole_dipole_ia(Particle &p1, Utils::Vector3d const &dip1,
-                             Particle &p2, bool force_flag) {
+#include <cmath>
+#include <vector>
 
-  // Cache dipole moment
-  auto const dip2 = p2.calc_dip();
+namespace {
+/** Energy, force and torque acting on one dipole, without prefactor. */
+struct DipoleRowSum {
+  double u = 0.;
+  Utils::Vector3d f{};
+  Utils::Vector3d t{};
+};
 
-  // Distance between particles
-  auto const dr = get_mi_vector(p1.r.p, p2.r.p, box_geo);
+/** @brief Add the interactions of dipole @p i with the dipoles
+ *  [@p j_begin, @p j_end), shifted by the image vector @p shift.
+ *
+ *  The distance vectors are folded back into the minimum image along the
+ *  directions in which @p mi_length is non-zero. The loop over the partner
+ *  dipoles is written such that it can be vectorized.
+ *
+ *  @tparam force_flag    whether to calculate forces and torques
+ *  @param dipoles        all dipoles
+ *  @param i              index of the dipole to calculate the sums for
+ *  @param j_begin        first partner dipole
+ *  @param j_end          one past the last partner dipole
+ *  @param shift          image vector added to the distance vectors
+ *  @param mi_length      box length along the minimum image directions,
+ *                        zero otherwise
+ *  @param mi_length_i    inverse of @p mi_length, zero if it is zero
+ *  @param sum            sums to add the interactions to
+ */
+template <bool force_flag>
+void add_dipole_row(GatheredDipoles const &dipoles, int i, int j_begin,
+                    int j_end, Utils::Vector3d const &shift,
+                    Utils::Vector3d const &mi_length,
+                    Utils::Vector3d const &mi_length_i, DipoleRowSum &sum) {
+  auto const x1 = dipoles.x[i] + shift[0];
+  auto const y1 = dipoles.y[i] + shift[1];
+  auto const z1 = dipoles.z[i] + shift[2];
+  auto const mx1 = dipoles.mx[i];
+  auto const my1 = dipoles.my[i];
+  auto const mz1 = dipoles.mz[i];
+
+  auto const *const x2 = dipoles.x.data();
+  auto const *const y2 = dipoles.y.data();
+  auto const *const z2 = dipoles.z.data();
+  auto const *const mx2 = dipoles.mx.data();
+  auto const *const my2 = dipoles.my.data();
+  auto const *const mz2 = dipoles.mz.data();
+
+  double u = 0., fx = 0., fy = 0., fz = 0., tx = 0., ty = 0., tz = 0.;
+
+#ifdef OPENMP
+#pragma omp simd reduction(+ : u, fx, fy, fz, tx, ty, tz)
+#endif
+  for (int j = j_begin; j < j_end; j++) {
+    auto rx = x1 - x2[j];
+    auto ry = y1 - y2[j];
+    auto rz = z1 - z2[j];
+    rx -= std::round(rx * mi_length_i[0]) * mi_length[0];
+    ry -= std::round(ry * mi_length_i[1]) * mi_length[1];
+    rz -= std::round(rz * mi_length_i[2]) * mi_length[2];
+
+    auto const r2 = rx * rx + ry * ry + rz * rz;
+    auto const r = std::sqrt(r2);
+    auto const r3 = r2 * r;
+    auto const r5 = r3 * r2;
+
+    auto const pe1 = mx1 * mx2[j] + my1 * my2[j] + mz1 * mz2[j];
+    auto const pe2 = mx1 * rx + my1 * ry + mz1 * rz;
+    auto const pe3 = mx2[j] * rx + my2[j] * ry + mz2[j] * rz;
+
+    u += pe1 / r3 - 3.0 * pe2 * pe3 / r5;
+
+    if (force_flag) {
+      auto const r7 = r5 * r2;
+      auto const ab = 3.0 * pe1 / r5 - 15.0 * pe2 * pe3 / r7;
+      auto const c = 3.0 * pe3 / r5;
+      auto const d = 3.0 * pe2 / r5;
+
+      fx += ab * rx + c * mx1 + d * mx2[j];
+      fy += ab * ry + c * my1 + d * my2[j];
+      fz += ab * rz + c * mz1 + d * mz2[j];
+
+#ifdef ROTATION
+      tx += -(my1 * mz2[j] - mz1 * my2[j]) / r3 + (my1 * rz - mz1 * ry) * c;
+      ty += -(mz1 * mx2[j] - mx1 * mz2[j]) / r3 + (mz1 * rx - mx1 * rz) * c;
+      tz += -(mx1 * my2[j] - my1 * mx2[j]) / r3 + (mx1 * ry - my1 * rx) * c;
+#endif
+    }
+  }
 
-  // Powers of distance
-  auto const r2 = dr.norm2();
-  auto const r = sqrt(r2);
-  auto const r3 = r2 * r;
-  auto const r5 = r3 * r2;
-  auto const r7 = r5 * r2;
+  sum.u += u;
+  sum.f += Utils::Vector3d{fx, fy, fz};
+  sum.t += Utils::Vector3d{tx, ty, tz};
+}
 
-  // Dot products
-  auto const pe1 = dip1 * dip2;
-  auto const pe2 = dip1 * dr;
-  auto const pe3 = dip2 * dr;
-  auto const pe4 = 3.0 / r5;
+/** @brief Dipolar interactions of the local dipoles with all dipoles.
+ *
+ *  The dipoles of all ranks are gathered on every rank, and each rank
+ *  calculates the full sums for its own dipoles, so that no forces have
+ *  to be communicated back. The local dipoles are distributed over the
+ *  threads.
+ *
+ *  @param force_flag  whether to add the forces and torques to the particles
+ *  @param particles   local particles
+ *  @param n_cut       range of the periodic images, with spherical cutoff
+ *  @param minimum_image  whether to apply the minimum image convention in
+ *                        the periodic directions
+ *  @return the dipolar energy of the local dipoles
+ */
+double dipolar_direct_sum(bool force_flag, ParticleRange const &particles,
+                          int n_cut, bool minimum_image) {
+  auto const local = dipolar_particles(particles);
+  auto const dipoles = gather_dipoles(local);
+  auto const n_dipoles = static_cast<int>(dipoles.x.size());
+  auto const n_local = static_cast<int>(local.size());
+  auto const &box_l = box_geo.length();
+
+  Utils::Vector3d mi_length{}, mi_length_i{};
+  int n_cut_dir[3];
+  for (int d = 0; d < 3; d++) {
+    if (minimum_image and box_geo.periodic(d)) {
+      mi_length[d] = box_l[d];
+      mi_length_i[d] = 1. / box_l[d];
+    }
+    n_cut_dir[d] = box_geo.periodic(d) ? n_cut : 0;
+  }
 
-  // Energy
-  auto const u = dipole.prefactor * (pe1 / r3 - pe4 * pe2 * pe3);
+  /* periodic images within the spherical cutoff, without the primary box */
+  std::vector<Utils::Vector3d> shifts;
+  for (int nx = -n_cut_dir[0]; nx <= n_cut_dir[0]; nx++) {
+    for (int ny = -n_cut_dir[1]; ny <= n_cut_dir[1]; ny++) {
+      for (int nz = -n_cut_dir[2]; nz <= n_cut_dir[2]; nz++) {
+        auto const n2 = nx * nx + ny * ny + nz * nz;
+        if (n2 != 0 and n2 <= n_cut * n_cut) {
+          shifts.push_back({nx * box_l[0], ny * box_l[1], nz * box_l[2]});
+        }
+      }
+    }
+  }
 
-  // Forces, if requested
-  if (force_flag) {
-    auto const a = pe4 * pe1;
-    auto const b = -15.0 * pe2 * pe3 / r7;
-    auto const ab = a + b;
-    auto const cc = pe4 * pe3;
-    auto const dd = pe4 * pe2;
+  auto const add_row =
+      force_flag ? &add_dipole_row<true> : &add_dipole_row<false>;
+  auto const no_shift = Utils::Vector3d{};
 
-    // Forces
-    auto const ff = ab * dr + cc * dip1 + dd * dip2;
-    p1.f.f += dipole.prefactor * ff;
-    p2.f.f -= dipole.prefactor * ff;
+  double u = 0.;
+#ifdef OPENMP
+#pragma omp parallel for schedule(dynamic) reduction(+ : u)
+#endif
+  for (int k = 0; k < n_local; k++) {
+    auto const i = dipoles.offset + k;
+    DipoleRowSum sum;
+    /* primary box, without the self-interaction */
+    add_row(dipoles, i, 0, i, no_shift, mi_length, mi_length_i, sum);
+    add_row(dipoles, i, i + 1, n_dipoles, no_shift, mi_length, mi_length_i,
+            sum);
+    for (auto const &shift : shifts) {
+      add_row(dipoles, i, 0, n_dipoles, shift, mi_length, mi_length_i, sum);
+    }
+    u += sum.u;
 
+    /* every thread only writes the forces of its own particles */
+    if (force_flag) {
+      local[k]->f.f += dipole.prefactor * sum.f;
 #ifdef ROTATION
-    // Torques
-    auto const aa = vector_product(dip1, dip2);
-    auto const b1 = vector_product(dip1, dr);
-    auto const b2 = vector_product(dip2, dr);
-    p1.f.torque += dipole.prefactor * (-aa / r3 + b1 * cc);
-    p2.f.torque += dipole.prefactor * (aa / r3 + b2 * dd);
+      local[k]->f.torque += dipole.prefactor * sum.t;
 #endif
+    }
   }
 
-  // Return energy
-  return u;
+  /* every pair was visited from both sides */
+  return 0.5 * dipole.prefactor * u;
 }
+} // namespace
 
 /* =============================================================================
                   DAWAANR => DIPOLAR ALL WITH ALL AND NO REPLICA
@@ -90,43 +213,13 @@ double calc_dipole_dipole_ia(Particle &p1, Utils::Vector3d const &dip1,
 
 double dawaanr_calculations(bool force_flag, bool energy_flag,
                             const ParticleRange &particles) {
-
-  if (n_nodes != 1) {
-    fprintf(stderr, "error: DAWAANR is just for one cpu...\n");
-    errexit();
-  }
   if (!(force_flag) && !(energy_flag)) {
     fprintf(stderr, "I don't know why you call dawaanr_calculations() "
                     "with all flags zero.\n");
     return 0;
   }
 
-  // Variable to sum up the energy
-  double u = 0;
-
-  auto parts = particles;
-
-  // Iterate over all cells
-  for (auto it = parts.begin(), end = parts.end(); it != end; ++it) {
-    // If the particle has no dipole moment, ignore it
-    if (it->p.dipm == 0.0)
-      continue;
-
-    const Utils::Vector3d dip1 = it->calc_dip();
-    auto jt = it;
-    /* Skip diagonal */
-    ++jt;
-    for (; jt != end; ++jt) {
-      // If the particle has no dipole moment, ignore it
-      if (jt->p.dipm == 0.0)
-        continue;
-      // Calculate energy and/or force between the particles
-      u += calc_dipole_dipole_ia(*it, dip1, *jt, force_flag);
-    }
-  }
-
-  // Return energy
-  return u;
+  return dipolar_direct_sum(force_flag, particles, 0, true);
 }
 
 /* =============================================================================
@@ -145,193 +238,17 @@ int magnetic_dipolar_direct_sum_sanity_checks() {
 double
 magnetic_dipolar_direct_sum_calculations(bool force_flag, bool energy_flag,
                                          ParticleRange const &particles) {
-  std::vector<double> x, y, z;
-  std::vector<double> mx, my, mz;
-  std::vector<double> fx, fy, fz;
-#ifdef ROTATION
-  std::vector<double> tx, ty, tz;
-#endif
-  double u;
-
-  if (n_nodes != 1) {
-    fprintf(stderr, "error: magnetic Direct Sum is just for one cpu...\n");
-    errexit();
-  }
   if (!(force_flag) && !(energy_flag)) {
     fprintf(stderr, "I don't know why you call magnetic_dipolar_direct_sum_"
                     "calculations() with all flags zero\n");
     return 0;
   }
 
-  auto const n_part = particles.size();
-
-  x.resize(n_part);
-  y.resize(n_part);
-  z.resize(n_part);
-
-  mx.resize(n_part);
-  my.resize(n_part);
-  mz.resize(n_part);
-
-  if (force_flag) {
-    fx.resize(n_part);
-    fy.resize(n_part);
-    fz.resize(n_part);
-
-#ifdef ROTATION
-    tx.resize(n_part);
-    ty.resize(n_part);
-    tz.resize(n_part);
-#endif
-  }
-
-  int dip_particles = 0;
-  for (auto const &p : particles) {
-    if (p.p.dipm != 0.0) {
-      const Utils::Vector3d dip = p.calc_dip();
-
-      mx[dip_particles] = dip[0];
-      my[dip_particles] = dip[1];
-      mz[dip_particles] = dip[2];
-
-      /* here we wish the coordinates to be folded into the primary box */
-      auto const ppos = folded_position(p.r.p, box_geo);
-      x[dip_particles] = ppos[0];
-      y[dip_particles] = ppos[1];
-      z[dip_particles] = ppos[2];
-
-      if (force_flag) {
-        fx[dip_particles] = 0;
-        fy[dip_particles] = 0;
-        fz[dip_particles] = 0;
-
-#ifdef ROTATION
-        tx[dip_particles] = 0;
-        ty[dip_particles] = 0;
-        tz[dip_particles] = 0;
-#endif
-      }
-
-      dip_particles++;
-    }
-  }
-
-  /*now we do the calculations */
-
-  { /* beginning of the area of calculation */
-    int NCUT[3], NCUT2;
-
-    for (int i = 0; i < 3; i++) {
-      NCUT[i] = Ncut_off_magnetic_dipolar_direct_sum;
-      if (box_geo.periodic(i) == 0) {
-        NCUT[i] = 0;
-      }
-    }
-    NCUT2 = Ncut_off_magnetic_dipolar_direct_sum *
-            Ncut_off_magnetic_dipolar_direct_sum;
-
-    u = 0;
-
-    for (int i = 0; i < dip_particles; i++) {
-      for (int j = 0; j < dip_particles; j++) {
-        auto const pe1 = mx[i] * mx[j] + my[i] * my[j] + mz[i] * mz[j];
-        auto const rx = x[i] - x[j];
-        auto const ry = y[i] - y[j];
-        auto const rz = z[i] - z[j];
-
-        for (int nx = -NCUT[0]; nx <= NCUT[0]; nx++) {
-          auto const rnx = rx + nx * box_geo.length()[0];
-          auto const rnx2 = rnx * rnx;
-          for (int ny = -NCUT[1]; ny <= NCUT[1]; ny++) {
-            auto const rny = ry + ny * box_geo.length()[1];
-            auto const rny2 = rny * rny;
-            for (int nz = -NCUT[2]; nz <= NCUT[2]; nz++) {
-              if (!(i == j && nx == 0 && ny == 0 && nz == 0)) {
-                if (nx * nx + ny * ny + nz * nz <= NCUT2) {
-                  auto const rnz = rz + nz * box_geo.length()[2];
-                  auto const r2 = rnx2 + rny2 + rnz * rnz;
-                  auto const r = sqrt(r2);
-                  auto const r3 = r2 * r;
-                  auto const r5 = r3 * r2;
-                  auto const r7 = r5 * r2;
-
-                  auto const pe2 = mx[i] * rnx + my[i] * rny + mz[i] * rnz;
-                  auto const pe3 = mx[j] * rnx + my[j] * rny + mz[j] * rnz;
-
-                  // Energy ............................
-
-                  u += pe1 / r3 - 3.0 * pe2 * pe3 / r5;
-
-                  if (force_flag) {
-                    double a, b, c, d;
-                    // force ............................
-                    a = mx[i] * mx[j] + my[i] * my[j] + mz[i] * mz[j];
-                    a = 3.0 * a / r5;
-                    b = -15.0 * pe2 * pe3 / r7;
-                    c = 3.0 * pe3 / r5;
-                    d = 3.0 * pe2 / r5;
-
-                    fx[i] += (a + b) * rnx + c * mx[i] + d * mx[j];
-                    fy[i] += (a + b) * rny + c * my[i] + d * my[j];
-                    fz[i] += (a + b) * rnz + c * mz[i] + d * mz[j];
-
-#ifdef ROTATION
-                    // torque ............................
-                    c = 3.0 / r5 * pe3;
-                    auto const ax = my[i] * mz[j] - my[j] * mz[i];
-                    auto const ay = mx[j] * mz[i] - mx[i] * mz[j];
-                    auto const az = mx[i] * my[j] - mx[j] * my[i];
-
-                    auto const bx = my[i] * rnz - rny * mz[i];
-                    auto const by = rnx * mz[i] - mx[i] * rnz;
-                    auto const bz = mx[i] * rny - rnx * my[i];
-
-                    tx[i] += -ax / r3 + bx * c;
-                    ty[i] += -ay / r3 + by * c;
-                    tz[i] += -az / r3 + bz * c;
-#endif
-                  } /* of force_flag  */
-                }
-              } /* of nx*nx+ny*ny +nz*nz< NCUT*NCUT   and   !(i==j && nx==0 &&
-                   ny==0 && nz==0) */
-            }   /* of  for nz */
-          }     /* of  for ny  */
-        }       /* of  for nx  */
-      }
-    } /* of  j and i  */
-  }   /* end of the area of calculation */
-
-  /* set the forces, and torques of the particles within ESPResSo */
-  if (force_flag) {
-
-    int dip_particles2 = 0;
-
-    for (auto &p : particles) {
-      if (p.p.dipm != 0.0) {
-
-        p.f.f[0] += dipole.prefactor * fx[dip_particles2];
-        p.f.f[1] += dipole.prefactor * fy[dip_particles2];
-        p.f.f[2] += dipole.prefactor * fz[dip_particles2];
-
-#ifdef ROTATION
-        p.f.torque[0] += dipole.prefactor * tx[dip_particles2];
-        p.f.torque[1] += dipole.prefactor * ty[dip_particles2];
-        p.f.torque[2] += dipole.prefactor * tz[dip_particles2];
-#endif
-        dip_particles2++;
-      }
-    }
-  } /*of if force_flag */
-
-  return 0.5 * dipole.prefactor * u;
+  return dipolar_direct_sum(force_flag, particles,
+                            Ncut_off_magnetic_dipolar_direct_sum, false);
 }
 
 int dawaanr_set_params() {
-  if (n_nodes > 1) {
-    runtimeErrorMsg() << "MPI parallelization not supported by "
-                      << "DipolarDirectSumCpu.";
-    return ES_ERROR;
-  }
   if (dipole.method != DIPOLAR_ALL_WITH_ALL_AND_NO_REPLICA) {
     Dipole::set_method_local(DIPOLAR_ALL_WITH_ALL_AND_NO_REPLICA);
   }
@@ -342,12 +259,6 @@ int dawaanr_set_params() {
 }
 
 int mdds_set_params(int n_cut) {
-  if (n_nodes > 1) {
-    runtimeErrorMsg() << "MPI parallelization not supported by "
-                      << "DipolarDirectSumWithReplicaCpu.";
-    return ES_ERROR;
-  }
-
   Ncut_off_magnetic_dipolar_direct_sum = n_cut;
 
   if (Ncut_off_magnetic_dipolar_direct_sum == 0) {
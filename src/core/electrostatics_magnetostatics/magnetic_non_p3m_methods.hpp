@@ -34,6 +34,10 @@
  *   the system.
  *   Uses spherical summation order.
  *
+ *  Both methods gather the dipoles of all MPI ranks on every rank. Each rank
+ *  then sums up the interactions of its own dipoles with all others, which
+ *  are distributed over the threads.
+ *
  */
 #include "config.hpp"
 #include <ParticleRange.hpp>
@@ -41,22 +45,19 @@
 #ifdef DIPOLES
 #include "Particle.hpp"
 
-/** Calculate dipolar energy and/or force between two particles */
-double calc_dipole_dipole_ia(Particle &p1, Particle &p2, bool force_flag);
-
 /* =============================================================================
                   DAWAANR => DIPOLAR ALL WITH ALL AND NO REPLICA
    =============================================================================
 */
 
 /** Core of the DAWAANR method: here you compute all the magnetic forces,
- *  torques and the magnetic energy for the whole system
+ *  torques and the magnetic energy of the local particles
  */
 double dawaanr_calculations(bool force_flag, bool energy_flag,
                             ParticleRange const &particles);
 
 /** Switch on DAWAANR magnetostatics.
- *  @return ES_ERROR, if not on a single CPU
+ *  @return ES_OK
  */
 int dawaanr_set_params();
 
@@ -69,7 +70,7 @@ int dawaanr_set_params();
 int magnetic_dipolar_direct_sum_sanity_checks();
 
 /** Core of the method: here you compute all the magnetic forces, torques and
- *  the energy for the whole system using direct sum
+ *  the energy of the local particles using direct sum
  */
 double magnetic_dipolar_direct_sum_calculations(bool force_flag,
                                                 bool energy_flag,
@@ -77,7 +78,7 @@ double magnetic_dipolar_direct_sum_calculations(bool force_flag,
 
 /** Switch on direct sum magnetostatics.
  *  @param n_cut cut off for the explicit summation
- *  @return ES_ERROR, if not on a single CPU
+ *  @return ES_OK
  */
 int mdds_set_params(int n_cut);
 
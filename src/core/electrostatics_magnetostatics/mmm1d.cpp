@@ -42,7 +42,10 @@ using Utils::strcat_alloc;
 #include <utils/constants.hpp>
 #include <utils/math/sqr.hpp>
 
+#include <algorithm>
+#include <cmath>
 #include <cstdio>
+#include <vector>
 
 /** How many trial calculations */
 #define TEST_INTEGRATIONS 1000
@@ -54,6 +57,9 @@ using Utils::strcat_alloc;
 /** minimal radius for the far formula in multiples of box_l[2] */
 #define MIN_RAD 0.01
 
+/** Largest number of grid points of the far formula table. */
+#define MAX_FAR_TABLE_POINTS (1 << 20)
+
 /** if you define this, the Besselfunctions are calculated up
     to machine precision, otherwise 10^-14, which should be
     definitely enough for daily life. */
@@ -69,7 +75,7 @@ using Utils::strcat_alloc;
 static double uz, L2, uz2, prefuz2, prefL3_i;
 /*@}*/
 
-MMM1D_struct mmm1d_params = {0.05, 1e-5, 0};
+MMM1D_struct mmm1d_params = {0.05, 1e-5, 0, true};
 /** From which distance a certain Bessel cutoff is valid. Can't be part of the
     params since these get broadcasted. */
 static std::vector<double> bessel_radii;
@@ -117,6 +123,265 @@ static void determine_bessel_radii(double maxPWerror, int maxP) {
   }
 }
 
+/** number of Bessel terms of the far formula at radius @p rxy */
+static int n_bessel_terms(double rxy) {
+  int n = 0;
+  while (n + 1 < MAXIMAL_B_CUT && bessel_radii[n] >= rxy)
+    n++;
+  return n;
+}
+
+/** Bessel sums of the far formula, without prefactors. */
+struct FarSums {
+  /** radial force, @f$\sum_p p K_1(2\pi p\rho) \cos(2\pi p z)@f$ */
+  double sr;
+  /** axial force, @f$\sum_p p K_0(2\pi p\rho) \sin(2\pi p z)@f$ */
+  double sz;
+  /** energy, @f$\sum_p K_0(2\pi p\rho) \cos(2\pi p z)@f$ */
+  double se;
+};
+
+/** Far formula Bessel sums on a grid in the radial distance @f$\rho@f$ and
+ *  the axial distance @f$z@f$, both in units of box_l[2], interpolated by
+ *  bicubic Lagrange polynomials. The sums are even in @f$z@f$, except
+ *  for @ref FarSums::sz, and periodic with period 1, so the grid covers
+ *  @f$z\in[0, 1/2]@f$. The grid has one extra point below and two above
+ *  the range in both directions for the interpolation stencils.
+ *
+ *  The table only depends on the box, the error bound and the smallest
+ *  switching radius, so that it is reused during the tuning of the
+ *  switching radius.
+ */
+static struct {
+  /* parameters the table was built for */
+  Utils::Vector3d box_l;
+  double maxPWerror;
+  double rho_min;
+  /** whether the table can be used */
+  bool valid;
+  /** number of Bessel terms in the table */
+  int n_terms;
+  /** range of @f$\rho@f$ */
+  double rho_begin, rho_end;
+  double h_rho, h_rho_i;
+  double h_z, h_z_i;
+  /** number of grid cells */
+  int cells_rho, cells_z;
+  /** @ref FarSums of the grid points, @f$z@f$ running fastest */
+  std::vector<FarSums> data;
+} far_table = {{0., 0., 0.}, 0., 0., false, 0, 0., 0., 0., 0., 0., 0.,
+               0, 0, {}};
+
+/** Bessel sums with a fixed number of terms, for the table */
+static FarSums far_sums(double rxy_d, double z_d, int n_terms) {
+  FarSums sums = {0., 0., 0.};
+  for (int bp = 1; bp <= n_terms; bp++) {
+    double fq = C_2PI * bp, k0, k1;
+#ifdef BESSEL_MACHINE_PREC
+    k0 = K0(fq * rxy_d);
+    k1 = K1(fq * rxy_d);
+#else
+    LPK01(fq * rxy_d, &k0, &k1);
+#endif
+    sums.sr += bp * k1 * cos(fq * z_d);
+    sums.sz += bp * k0 * sin(fq * z_d);
+    sums.se += k0 * cos(fq * z_d);
+  }
+  return sums;
+}
+
+/** Weights of the cubic Lagrange interpolation at the points -1, 0, 1, 2
+ *  for @p t in [0, 1].
+ */
+static void lagrange_weights(double t, double w[4]) {
+  w[0] = -t * (t - 1.) * (t - 2.) / 6.;
+  w[1] = (t + 1.) * (t - 1.) * (t - 2.) / 2.;
+  w[2] = -(t + 1.) * t * (t - 2.) / 2.;
+  w[3] = (t + 1.) * t * (t - 1.) / 6.;
+}
+
+/** Interpolate the Bessel sums from the table.
+ *
+ *  @param rxy_d  radial distance in units of box_l[2], in the table range
+ *  @param z_d    axial distance in units of box_l[2]
+ */
+static FarSums far_table_sums(double rxy_d, double z_d) {
+  /* fold z into [0, 1/2] */
+  auto z = z_d - std::floor(z_d);
+  auto sign = 1.;
+  if (z > 0.5) {
+    z = 1. - z;
+    sign = -1.;
+  }
+
+  auto const x = (rxy_d - far_table.rho_begin) * far_table.h_rho_i;
+  auto const y = z * far_table.h_z_i;
+  auto const i = std::min(static_cast<int>(x), far_table.cells_rho - 1);
+  auto const j = std::min(static_cast<int>(y), far_table.cells_z - 1);
+  double w_rho[4], w_z[4];
+  lagrange_weights(x - i, w_rho);
+  lagrange_weights(y - j, w_z);
+
+  auto const n_z = far_table.cells_z + 3;
+  FarSums sums = {0., 0., 0.};
+  for (int a = 0; a < 4; a++) {
+    auto const *row = far_table.data.data() + (i + a) * n_z + j;
+    double sr = 0., sz = 0., se = 0.;
+    for (int b = 0; b < 4; b++) {
+      sr += w_z[b] * row[b].sr;
+      sz += w_z[b] * row[b].sz;
+      se += w_z[b] * row[b].se;
+    }
+    sums.sr += w_rho[a] * sr;
+    sums.sz += w_rho[a] * sz;
+    sums.se += w_rho[a] * se;
+  }
+  sums.sz *= sign;
+  return sums;
+}
+
+/** Fill the table on a grid with the given number of cells. */
+static void fill_far_table(int cells_rho, int cells_z) {
+  auto &t = far_table;
+  t.cells_rho = cells_rho;
+  t.cells_z = cells_z;
+  t.h_rho = (t.rho_end - t.rho_begin) / cells_rho;
+  t.h_rho_i = 1. / t.h_rho;
+  t.h_z = 0.5 / cells_z;
+  t.h_z_i = 1. / t.h_z;
+
+  auto const n_rho = cells_rho + 3;
+  auto const n_z = cells_z + 3;
+  auto const n_terms = t.n_terms;
+
+  /* the Bessel functions only depend on rho, the trigonometric
+     functions only on z */
+  std::vector<double> k0(n_rho * n_terms), k1(n_rho * n_terms);
+  for (int i = 0; i < n_rho; i++) {
+    auto const rho = t.rho_begin + (i - 1) * t.h_rho;
+    for (int bp = 1; bp <= n_terms; bp++) {
+#ifdef BESSEL_MACHINE_PREC
+      k0[i * n_terms + bp - 1] = K0(C_2PI * bp * rho);
+      k1[i * n_terms + bp - 1] = K1(C_2PI * bp * rho);
+#else
+      LPK01(C_2PI * bp * rho, &k0[i * n_terms + bp - 1],
+            &k1[i * n_terms + bp - 1]);
+#endif
+    }
+  }
+  std::vector<double> cosines(n_z * n_terms), sines(n_z * n_terms);
+  for (int j = 0; j < n_z; j++) {
+    auto const z = (j - 1) * t.h_z;
+    for (int bp = 1; bp <= n_terms; bp++) {
+      cosines[j * n_terms + bp - 1] = cos(C_2PI * bp * z);
+      sines[j * n_terms + bp - 1] = sin(C_2PI * bp * z);
+    }
+  }
+
+  t.data.resize(n_rho * n_z);
+  for (int i = 0; i < n_rho; i++) {
+    for (int j = 0; j < n_z; j++) {
+      FarSums sums = {0., 0., 0.};
+      for (int b = 0; b < n_terms; b++) {
+        auto const bk0 = k0[i * n_terms + b];
+        auto const bk1 = k1[i * n_terms + b];
+        sums.sr += (b + 1) * bk1 * cosines[j * n_terms + b];
+        sums.sz += (b + 1) * bk0 * sines[j * n_terms + b];
+        sums.se += bk0 * cosines[j * n_terms + b];
+      }
+      t.data[i * n_z + j] = sums;
+    }
+  }
+}
+
+/** Largest interpolation error of the forces and the energy at
+ *  (@p rxy_d, @p z_d).
+ */
+static double far_table_error(double rxy_d, double z_d) {
+  auto const exact = far_sums(rxy_d, z_d, far_table.n_terms);
+  auto const interpolated = far_table_sums(rxy_d, z_d);
+  auto const force_pref = uz2 * 4 * C_2PI;
+  return std::max({force_pref * std::abs(exact.sr - interpolated.sr),
+                   force_pref * std::abs(exact.sz - interpolated.sz),
+                   4 * uz * std::abs(exact.se - interpolated.se)});
+}
+
+/** Build the far formula table, refining the grid until the interpolation
+ *  error is below a tenth of the pairwise error bound. If this needs more
+ *  than @ref MAX_FAR_TABLE_POINTS points, e.g. for error bounds close to
+ *  the machine precision, the far formula is evaluated directly.
+ */
+static void prepare_far_table() {
+  auto const rho_min =
+      (mmm1d_params.far_switch_radius_2 > 0)
+          ? std::min(std::sqrt(mmm1d_params.far_switch_radius_2),
+                     0.2 * box_geo.length()[2])
+          : 0.2 * box_geo.length()[2];
+
+  if (not mmm1d_params.far_table) {
+    far_table.valid = false;
+    far_table.maxPWerror = 0.;
+    return;
+  }
+  if (far_table.box_l == box_geo.length() and
+      far_table.maxPWerror == mmm1d_params.maxPWerror and
+      far_table.rho_min == rho_min)
+    return;
+
+  far_table.box_l = box_geo.length();
+  far_table.maxPWerror = mmm1d_params.maxPWerror;
+  far_table.rho_min = rho_min;
+  far_table.valid = false;
+  far_table.data.clear();
+
+  far_table.n_terms = n_bessel_terms(rho_min);
+  far_table.rho_begin = rho_min * uz;
+  far_table.rho_end = bessel_radii[0] * uz;
+  if (far_table.n_terms == 0 or far_table.rho_end <= far_table.rho_begin)
+    return;
+
+  auto const tolerance = 0.1 * mmm1d_params.maxPWerror;
+  int cells_rho = 16, cells_z = 16;
+  while ((cells_rho + 3) * (cells_z + 3) <= MAX_FAR_TABLE_POINTS) {
+    /* the extra point below the range has to have a positive radius */
+    if ((far_table.rho_end - far_table.rho_begin) / cells_rho >=
+        far_table.rho_begin) {
+      cells_rho *= 2;
+      continue;
+    }
+    fill_far_table(cells_rho, cells_z);
+    auto const h_rho = far_table.h_rho;
+    auto const h_z = far_table.h_z;
+
+    /* the sums vary fastest at small radii */
+    double error_z = 0., error_rho = 0.;
+    for (int i : {0, 1, cells_rho / 2}) {
+      for (int j = 0; j < cells_z; j++) {
+        error_z = std::max(error_z,
+                           far_table_error(far_table.rho_begin + i * h_rho,
+                                           (j + 0.5) * h_z));
+      }
+    }
+    for (int i : {0, 1, cells_rho / 2}) {
+      for (int j = 0; j <= cells_z; j++) {
+        error_rho = std::max(
+            error_rho,
+            far_table_error(far_table.rho_begin + (i + 0.5) * h_rho, j * h_z));
+      }
+    }
+
+    if (error_z <= tolerance and error_rho <= tolerance) {
+      far_table.valid = true;
+      return;
+    }
+    if (error_z > tolerance)
+      cells_z *= 2;
+    if (error_rho > tolerance)
+      cells_rho *= 2;
+  }
+  far_table.data.clear();
+}
+
 static void prepare_polygamma_series(double maxPWerror, double maxrad2) {
   /* polygamma, determine order */
   int n;
@@ -135,10 +400,11 @@ static void prepare_polygamma_series(double maxPWerror, double maxrad2) {
   } while (err > 0.1 * maxPWerror);
 }
 
-int MMM1D_set_params(double switch_rad, double maxPWerror) {
+int MMM1D_set_params(double switch_rad, double maxPWerror, bool far_table) {
   mmm1d_params.far_switch_radius_2 =
       (switch_rad > 0) ? Utils::sqr(switch_rad) : -1;
   mmm1d_params.maxPWerror = maxPWerror;
+  mmm1d_params.far_table = far_table;
   coulomb.method = COULOMB_MMM1D;
 
   mpi_bcast_coulomb_params();
@@ -175,6 +441,7 @@ void MMM1D_init() {
   determine_bessel_radii(mmm1d_params.maxPWerror, MAXIMAL_B_CUT);
   prepare_polygamma_series(mmm1d_params.maxPWerror,
                            mmm1d_params.far_switch_radius_2);
+  prepare_far_table();
 }
 
 void add_mmm1d_coulomb_pair_force(double chpref, Utils::Vector3d const &d,
@@ -249,19 +516,26 @@ void add_mmm1d_coulomb_pair_force(double chpref, Utils::Vector3d const &d,
     double sr = 0, sz = 0;
     int bp;
 
-    for (bp = 1; bp < MAXIMAL_B_CUT; bp++) {
-      if (bessel_radii[bp - 1] < rxy)
-        break;
+    if (far_table.valid && rxy_d >= far_table.rho_begin &&
+        rxy_d < far_table.rho_end) {
+      auto const sums = far_table_sums(rxy_d, z_d);
+      sr = sums.sr;
+      sz = sums.sz;
+    } else {
+      for (bp = 1; bp < MAXIMAL_B_CUT; bp++) {
+        if (bessel_radii[bp - 1] < rxy)
+          break;
 
-      double fq = C_2PI * bp, k0, k1;
+        double fq = C_2PI * bp, k0, k1;
 #ifdef BESSEL_MACHINE_PREC
-      k0 = K0(fq * rxy_d);
-      k1 = K1(fq * rxy_d);
+        k0 = K0(fq * rxy_d);
+        k1 = K1(fq * rxy_d);
 #else
-      LPK01(fq * rxy_d, &k0, &k1);
+        LPK01(fq * rxy_d, &k0, &k1);
 #endif
-      sr += bp * k1 * cos(fq * z_d);
-      sz += bp * k0 * sin(fq * z_d);
+        sr += bp * k1 * cos(fq * z_d);
+        sz += bp * k0 * sin(fq * z_d);
+      }
     }
     sr *= uz2 * 4 * C_2PI;
     sz *= uz2 * 4 * C_2PI;
@@ -325,12 +599,17 @@ double mmm1d_coulomb_pair_energy(double const chpref, Utils::Vector3d const &d,
     /* The first Bessel term will compensate a little bit the
        log term, so add them close together */
     E = -0.25 * log(rxy2_d) + 0.5 * (M_LN2 - C_GAMMA);
-    for (bp = 1; bp < MAXIMAL_B_CUT; bp++) {
-      if (bessel_radii[bp - 1] < rxy)
-        break;
+    if (far_table.valid && rxy_d >= far_table.rho_begin &&
+        rxy_d < far_table.rho_end) {
+      E += far_table_sums(rxy_d, z_d).se;
+    } else {
+      for (bp = 1; bp < MAXIMAL_B_CUT; bp++) {
+        if (bessel_radii[bp - 1] < rxy)
+          break;
 
-      double fq = C_2PI * bp;
-      E += K0(fq * rxy_d) * cos(fq * z_d);
+        double fq = C_2PI * bp;
+        E += K0(fq * rxy_d) * cos(fq * z_d);
+      }
     }
     E *= 4 * uz;
   }
@@ -25,7 +25,12 @@
     method see MMM in general. The MMM1D method works only with the nsquared,
     since neither the near nor far formula can be decomposed. However, this
     implementation is reasonably fast, so that one can use up to 200 charges
-    easily in a simulation.  */
+    easily in a simulation.
+
+    The Bessel sums of the far formula only depend on the radial and axial
+    distance of a pair. They are tabulated once per box and error bound and
+    interpolated, with a grid refined until the sampled interpolation error
+    is below a tenth of the pairwise error bound.  */
 #ifndef MMM1D_H
 #define MMM1D_H
 
@@ -44,6 +49,8 @@ typedef struct {
   double maxPWerror;
   /** cutoff of the Bessel sum. Only used by the GPU implementation */
   int bessel_cutoff;
+  /** whether to interpolate the far formula from a table */
+  bool far_table;
 } MMM1D_struct;
 extern MMM1D_struct mmm1d_params;
 
@@ -54,8 +61,10 @@ extern MMM1D_struct mmm1d_params;
  *  @param switch_rad at which xy-distance the calculation switches from the far
  *      to the near formula. If -1, this parameter will be tuned automatically.
  *  @param maxPWerror @copydoc MMM1D_struct::maxPWerror
+ *  @param far_table @copydoc MMM1D_struct::far_table
  */
-int MMM1D_set_params(double switch_rad, double maxPWerror);
+int MMM1D_set_params(double switch_rad, double maxPWerror,
+                     bool far_table = true);
 
 /// check that MMM1D can run with the current parameters
 int MMM1D_sanity_checks();
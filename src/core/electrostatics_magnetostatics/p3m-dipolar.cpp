@@ -192,7 +192,7 @@ void dp3m_init() {
     dp3m.params.r_cut = 0.0;
     dp3m.params.r_cut_iL = 0.0;
   } else {
-    if (dp3m_sanity_checks(node_grid))
+    if (dp3m_sanity_checks())
       return;
 
     dp3m.params.cao3 = Utils::int_pow<3>(dp3m.params.cao);
@@ -255,7 +255,9 @@ double dp3m_average_dipolar_self_energy(double box_l, int mesh) {
           node_phi += 0.0;
         } else {
           double const U2 = dp3m_perform_aliasing_sums_dipolar_self_energy(n);
+          /* the mesh holds only half of the modes, see fft.hpp */
           node_phi +=
+              fft_ks_mode_weight(n[1], dp3m.params.mesh[1]) *
               dp3m.g_energy[ind] * U2 *
               (Utils::sqr(dp3m.d_op[n[0]]) + Utils::sqr(dp3m.d_op[n[1]]) +
                Utils::sqr(dp3m.d_op[n[2]]));
@@ -480,9 +482,7 @@ double dp3m_calc_kspace_forces(bool force_flag, bool energy_flag,
     dp3m.sm.gather_grid(Utils::make_span(meshes), comm_cart,
                         dp3m.local_mesh.dim);
 
-    fft_perform_forw(dp3m.rs_mesh_dip[0].data(), dp3m.fft, comm_cart);
-    fft_perform_forw(dp3m.rs_mesh_dip[1].data(), dp3m.fft, comm_cart);
-    fft_perform_forw(dp3m.rs_mesh_dip[2].data(), dp3m.fft, comm_cart);
+    fft_perform_forw(Utils::make_const_span(meshes), dp3m.fft, comm_cart);
     // Note: after these calls, the grids are in the order yzx and not xyz
     // anymore!!!
   }
@@ -502,7 +502,10 @@ double dp3m_calc_kspace_forces(bool force_flag, bool energy_flag,
       for (j[0] = 0; j[0] < dp3m.fft.plan[3].new_mesh[0]; j[0]++) {
         for (j[1] = 0; j[1] < dp3m.fft.plan[3].new_mesh[1]; j[1]++) {
           for (j[2] = 0; j[2] < dp3m.fft.plan[3].new_mesh[2]; j[2]++) {
+            /* the mesh holds only half of the modes, see fft.hpp */
             node_k_space_energy_dip +=
+                fft_ks_mode_weight(j[1] + dp3m.fft.plan[3].start[1],
+                                   dp3m.params.mesh[1]) *
                 dp3m.g_energy[i] *
                 (Utils::sqr(dp3m.rs_mesh_dip[0][ind] *
                                 dp3m.d_op[j[2] + dp3m.fft.plan[3].start[2]] +
@@ -605,7 +608,7 @@ double dp3m_calc_kspace_forces(bool force_flag, bool energy_flag,
         }
 
         /* Back FFT force component mesh */
-        fft_perform_back(dp3m.rs_mesh.data(), false, dp3m.fft, comm_cart);
+        fft_perform_back(dp3m.rs_mesh.data(), dp3m.fft, comm_cart);
         /* redistribute force component mesh */
         dp3m.sm.spread_grid(dp3m.rs_mesh.data(), comm_cart,
                             dp3m.local_mesh.dim);
@@ -685,17 +688,12 @@ double dp3m_calc_kspace_forces(bool force_flag, bool energy_flag,
             }
           }
         }
-        /* Back FFT force component mesh */
-        fft_perform_back(dp3m.rs_mesh_dip[0].data(), false, dp3m.fft,
-                         comm_cart);
-        fft_perform_back(dp3m.rs_mesh_dip[1].data(), false, dp3m.fft,
-                         comm_cart);
-        fft_perform_back(dp3m.rs_mesh_dip[2].data(), false, dp3m.fft,
-                         comm_cart);
-        /* redistribute force component mesh */
         std::array<double *, 3> meshes = {dp3m.rs_mesh_dip[0].data(),
                                           dp3m.rs_mesh_dip[1].data(),
                                           dp3m.rs_mesh_dip[2].data()};
+        /* Back FFT force component mesh */
+        fft_perform_back(Utils::make_const_span(meshes), dp3m.fft, comm_cart);
+        /* redistribute force component mesh */
 
         dp3m.sm.spread_grid(Utils::make_span(meshes), comm_cart,
                             dp3m.local_mesh.dim);
@@ -1379,6 +1377,10 @@ int dp3m_adaptive_tune(char **logger) {
     expo = log(pow((double)dp3m.sum_dip_part, (1.0 / 3.0))) / log(2.0);
 
     tmp_mesh = (int)(pow(2.0, (double)((int)expo)) + 0.1);
+    /* the mesh loop has to start from an even mesh, see
+       dp3m_sanity_checks(); fewer than 8 dipoles give a mesh of 1 */
+    if (tmp_mesh < 2)
+      tmp_mesh = 2;
     /* this limits the tried meshes if the accuracy cannot
        be obtained with smaller meshes, but normally not all these
        meshes have to be tested */
@@ -1671,7 +1673,7 @@ bool dp3m_sanity_checks_boxl() {
 
 /*****************************************************************************/
 
-bool dp3m_sanity_checks(const Utils::Vector3i &grid) {
+bool dp3m_sanity_checks() {
   bool ret = false;
 
   if (!box_geo.periodic(0) || !box_geo.periodic(1) || !box_geo.periodic(2)) {
@@ -1685,6 +1687,12 @@ bool dp3m_sanity_checks(const Utils::Vector3i &grid) {
     ret = true;
   }
 
+  if (!node_grid_is_regular()) {
+    runtimeErrorMsg() << "dipolar P3M requires a regular node grid, disable "
+                         "the load balancing";
+    ret = true;
+  }
+
   if ((box_geo.length()[0] != box_geo.length()[1]) ||
       (box_geo.length()[1] != box_geo.length()[2])) {
     runtimeErrorMsg() << "dipolar P3M requires a cubic box";
@@ -1704,13 +1712,12 @@ bool dp3m_sanity_checks(const Utils::Vector3i &grid) {
     runtimeErrorMsg() << "dipolar P3M_init: mesh size is not yet set";
     ret = true;
   }
-  if (dp3m.params.cao == 0) {
-    runtimeErrorMsg() << "dipolar P3M_init: cao is not yet set";
+  if (dp3m.params.mesh[0] > 0 && dp3m.params.mesh[0] % 2 == 1) {
+    runtimeErrorMsg() << "dipolar P3M_init: mesh size must be even";
     ret = true;
   }
-  if (grid[0] < grid[1] || grid[1] < grid[2]) {
-    runtimeErrorMsg()
-        << "dipolar P3M_init: node grid must be sorted, largest first";
+  if (dp3m.params.cao == 0) {
+    runtimeErrorMsg() << "dipolar P3M_init: cao is not yet set";
     ret = true;
   }
 
@@ -35,6 +35,7 @@
 #include "fft.hpp"
 #include "grid.hpp"
 #include "integrate.hpp"
+#include "threads.hpp"
 #include "tuning.hpp"
 #ifdef CUDA
 #include "p3m_gpu_error.hpp"
@@ -54,9 +55,17 @@ using Utils::strcat_alloc;
 #include <boost/range/numeric.hpp>
 #include <mpi.h>
 
+#include <algorithm>
+#include <array>
 #include <complex>
 #include <cstdio>
 #include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <vector>
 
 /************************************************
  * variables
@@ -90,7 +99,7 @@ p3m_data_struct p3m;
  */
 static void p3m_init_a_ai_cao_cut();
 
-static bool p3m_sanity_checks_system(const Utils::Vector3i &grid);
+static bool p3m_sanity_checks_system();
 
 /** Checks for correctness for charges in P3M of the cao_cut,
  *  necessary when the box length changes
@@ -296,6 +305,104 @@ int p3m_set_eps(double eps) {
 }
 
 namespace {
+/** Charged particles of a range, in the order of the range. Their
+ *  positions in this list are the indices of their interpolation weights
+ *  in @ref p3m_data_struct::inter_weights.
+ */
+std::vector<Particle *> charged_particles(const ParticleRange &particles) {
+  std::vector<Particle *> charged;
+  for (auto &p : particles) {
+    if (p.p.q != 0.0) {
+      charged.push_back(&p);
+    }
+  }
+  return charged;
+}
+
+/**
+ * @brief Concurrent P3M grid interpolation of all points in a cache.
+ *
+ * The local mesh is divided into blocks of @p cao mesh points per
+ * direction, and the points are grouped by the block that holds the
+ * corner of their interpolation cube. The cubes of points from two
+ * blocks that are at least two blocks apart in one direction do not
+ * overlap, so the blocks are processed in 8 colors, and the blocks of one
+ * color concurrently. Within a block the points are visited in the order
+ * of the cache, so the result does not depend on the number of threads.
+ *
+ * @param local_mesh Mesh info.
+ * @param cache Interpolation weights of the points.
+ * @param kernel The kernel to run, called with the index of the point
+ *        in the cache, the linear grid index and the weight.
+ */
+template <size_t cao, class Kernel>
+void p3m_colored_interpolate(p3m_local_mesh const &local_mesh,
+                             p3m_interpolation_cache const &cache,
+                             Kernel kernel) {
+  assert(cao == cache.cao());
+
+  auto const &dim = local_mesh.dim;
+  auto const block_size = static_cast<int>(cao);
+  Utils::Vector3i n_blocks;
+  for (int d = 0; d < 3; d++) {
+    n_blocks[d] = (dim[d] + block_size - 1) / block_size;
+  }
+
+  /* sort the points by block, keeping the order within a block */
+  auto const n_points = static_cast<int>(cache.size());
+  std::vector<int> block_of(n_points);
+  std::vector<int> block_start(n_blocks[0] * n_blocks[1] * n_blocks[2] + 1,
+                               0);
+  for (int i = 0; i < n_points; i++) {
+    auto const ind = cache.load<cao>(i).ind;
+    auto const corner = Utils::Vector3i{ind / (dim[1] * dim[2]),
+                                        (ind / dim[2]) % dim[1], ind % dim[2]};
+    block_of[i] = Utils::get_linear_index(corner / block_size, n_blocks,
+                                          Utils::MemoryOrder::ROW_MAJOR);
+    block_start[block_of[i] + 1]++;
+  }
+  std::partial_sum(block_start.begin(), block_start.end(),
+                   block_start.begin());
+  std::vector<int> order(n_points);
+  {
+    auto next = block_start;
+    for (int i = 0; i < n_points; i++) {
+      order[next[block_of[i]]++] = i;
+    }
+  }
+
+  /* distribute the non-empty blocks over the colors */
+  std::array<std::vector<int>, 8> colors;
+  Utils::Vector3i b;
+  for (b[0] = 0; b[0] < n_blocks[0]; b[0]++) {
+    for (b[1] = 0; b[1] < n_blocks[1]; b[1]++) {
+      for (b[2] = 0; b[2] < n_blocks[2]; b[2]++) {
+        auto const block = Utils::get_linear_index(
+            b, n_blocks, Utils::MemoryOrder::ROW_MAJOR);
+        if (block_start[block] != block_start[block + 1]) {
+          colors[(b[0] % 2) + 2 * (b[1] % 2) + 4 * (b[2] % 2)].push_back(
+              block);
+        }
+      }
+    }
+  }
+
+  for (auto const &color : colors) {
+    auto const n_color_blocks = static_cast<int>(color.size());
+#ifdef OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int k = 0; k < n_color_blocks; k++) {
+      auto const block = color[k];
+      for (int j = block_start[block]; j < block_start[block + 1]; j++) {
+        auto const i = order[j];
+        p3m_interpolate(local_mesh, cache.load<cao>(i),
+                        [i, &kernel](int ind, double w) { kernel(i, ind, w); });
+      }
+    }
+  }
+}
+
 template <size_t cao> struct AssignCharge {
   void operator()(double q, const Utils::Vector3d &real_pos,
                   const Utils::Vector3d &ai, p3m_local_mesh const &local_mesh,
@@ -318,12 +425,23 @@ template <size_t cao> struct AssignCharge {
   }
 
   void operator()(const ParticleRange &particles) {
-    for (auto &p : particles) {
-      if (p.p.q != 0.0) {
-        this->operator()(p.p.q, p.r.p, p3m.params.ai, p3m.local_mesh,
-                         p3m.inter_weights);
-      }
+    auto const charged = charged_particles(particles);
+    auto const n_charged = static_cast<int>(charged.size());
+
+    p3m.inter_weights.resize(charged.size());
+#ifdef OPENMP
+#pragma omp parallel for
+#endif
+    for (int i = 0; i < n_charged; i++) {
+      p3m.inter_weights.store(
+          i, p3m_calculate_interpolation_weights<cao>(
+                 charged[i]->r.p, p3m.params.ai, p3m.local_mesh));
     }
+
+    p3m_colored_interpolate<cao>(p3m.local_mesh, p3m.inter_weights,
+                                 [&charged](int i, int ind, double w) {
+                                   p3m.rs_mesh[ind] += w * charged[i]->p.q;
+                                 });
   }
 };
 } // namespace
@@ -359,23 +477,26 @@ template <size_t cao> struct AssignForces {
 
     assert(cao == p3m.inter_weights.cao());
 
-    /* charged particle counter, charge fraction counter */
-    int cp_cnt = 0;
-
-    for (auto &p : particles) {
-      auto const q = p.p.q;
-      if (q != 0.0) {
-        auto const pref = q * force_prefac;
-        auto const w = p3m.inter_weights.load<cao>(cp_cnt++);
+    auto const charged = charged_particles(particles);
+    auto const n_charged = static_cast<int>(charged.size());
+    assert(charged.size() == p3m.inter_weights.size());
 
-        Utils::Vector3d E{};
-        p3m_interpolate(p3m.local_mesh, w, [&E](int ind, double w) {
-          E += w * Utils::Vector3d{p3m.E_mesh[0][ind], p3m.E_mesh[1][ind],
-                                   p3m.E_mesh[2][ind]};
-        });
+    /* every thread only writes the forces of its own particles */
+#ifdef OPENMP
+#pragma omp parallel for
+#endif
+    for (int i = 0; i < n_charged; i++) {
+      auto &p = *charged[i];
+      auto const pref = p.p.q * force_prefac;
+      auto const w = p3m.inter_weights.load<cao>(i);
+
+      Utils::Vector3d E{};
+      p3m_interpolate(p3m.local_mesh, w, [&E](int ind, double w) {
+        E += w * Utils::Vector3d{p3m.E_mesh[0][ind], p3m.E_mesh[1][ind],
+                                 p3m.E_mesh[2][ind]};
+      });
 
-        p.f.f -= pref * E;
-      }
+      p.f.f -= pref * E;
     }
   }
 };
@@ -527,16 +648,11 @@ double p3m_calc_kspace_forces(bool force_flag, bool energy_flag,
       }
     }
 
-    /* Back FFT force component mesh */
-    for (int d = 0; d < 3; d++) {
-      fft_perform_back(p3m.E_mesh[d].data(),
-                       /* check_complex */ !p3m.params.tuning, p3m.fft,
-                       comm_cart);
-    }
-
     {
       std::array<double *, 3> E_fields = {
           p3m.E_mesh[0].data(), p3m.E_mesh[1].data(), p3m.E_mesh[2].data()};
+      /* Back FFT force component mesh */
+      fft_perform_back(Utils::make_const_span(E_fields), p3m.fft, comm_cart);
       /* redistribute force component mesh */
       p3m.sm.spread_grid(Utils::make_span(E_fields), comm_cart,
                          p3m.local_mesh.dim);
@@ -825,7 +941,9 @@ template <int cao> void calc_influence_function_energy() {
         }
 
         else
+          /* the mesh holds only half of the modes, see fft.hpp */
           p3m.g_energy[ind] =
+              fft_ks_mode_weight(n[KZ], p3m.params.mesh[RZ]) *
               perform_aliasing_sums_energy<cao>(n) / Utils::pi();
       }
     }
@@ -862,6 +980,132 @@ void p3m_calc_influence_function_energy() {
 
 #define P3M_TUNE_MAX_CUTS 50
 
+/** Parameter sets timed during the last tuning. */
+static std::vector<P3MTuningRecord> p3m_tuning_records;
+/** File holding the tuning cache, empty if disabled. */
+static std::string p3m_tuning_cache_path;
+
+void p3m_set_tuning_cache(std::string const &path) {
+  p3m_tuning_cache_path = path;
+}
+
+std::vector<P3MTuningRecord> const &p3m_tuning_table() {
+  return p3m_tuning_records;
+}
+
+/** Get the quantities that determine the outcome of the tuning.
+ *
+ *  These are the system properties entering the error estimates, the
+ *  parameters fixed by the user and the parallelization and cell system
+ *  options, which affect the timings. Must be called before the tuning
+ *  modifies the parameters.
+ */
+static std::vector<double> p3m_tuning_signature() {
+  std::vector<double> signature = {
+      box_geo.length()[0],
+      box_geo.length()[1],
+      box_geo.length()[2],
+      p3m.sum_q2,
+      p3m.square_sum_q,
+      coulomb.prefactor,
+      p3m.params.accuracy,
+      p3m.params.r_cut_iL,
+      skin,
+      (coulomb.method == COULOMB_ELC_P3M) ? elc_params.gap_size : 0.};
+  for (int value : {static_cast<int>(coulomb.method), p3m.sum_qpart,
+                    p3m.params.mesh[0], p3m.params.mesh[1], p3m.params.mesh[2],
+                    p3m.params.cao, n_nodes, node_grid[0], node_grid[1],
+                    node_grid[2], n_threads}) {
+    signature.push_back(value);
+  }
+  for (int value : {cell_structure.decomposition_type(),
+                    static_cast<int>(cell_structure.use_verlet_list),
+                    static_cast<int>(cell_structure.use_soa),
+                    static_cast<int>(cell_structure.use_async_ghosts),
+                    static_cast<int>(cell_structure.use_spatial_sort),
+                    static_cast<int>(cell_structure.use_eighth_shell)}) {
+    signature.push_back(value);
+  }
+  return signature;
+}
+
+/** First line of the tuning cache. The entries are only valid for the
+ *  same file format and the same compiled features, which change the
+ *  signature and the timings.
+ */
+static std::string p3m_tuning_cache_header() {
+  std::vector<std::string> features(FEATURES, FEATURES + NUM_FEATURES);
+  std::sort(features.begin(), features.end());
+  std::string header = "# ESPResSo P3M tuning cache, format 2, features:";
+  for (auto const &feature : features) {
+    header += " " + feature;
+  }
+  return header;
+}
+
+/** Whether a tuning cache was written by this build. */
+static bool p3m_tuning_cache_valid(std::istream &cache) {
+  std::string header;
+  return std::getline(cache, header) and header == p3m_tuning_cache_header();
+}
+
+/** Find the tuning result for a signature in the tuning cache.
+ *
+ *  After the header, each line of the cache holds a signature followed by
+ *  the mesh, cao, r_cut_iL, alpha_L, accuracy and time of the optimum. If a
+ *  signature occurs more than once, the last entry is used.
+ */
+static boost::optional<P3MTuningRecord>
+p3m_tuning_cache_lookup(std::vector<double> const &signature) {
+  boost::optional<P3MTuningRecord> result;
+  std::ifstream cache(p3m_tuning_cache_path);
+  if (not p3m_tuning_cache_valid(cache))
+    return result;
+  std::string line;
+  while (std::getline(cache, line)) {
+    std::istringstream entry(line);
+    std::vector<double> key(signature.size());
+    for (auto &value : key) {
+      entry >> value;
+    }
+    P3MTuningRecord record{};
+    entry >> record.mesh[0] >> record.mesh[1] >> record.mesh[2] >>
+        record.cao >> record.r_cut_iL >> record.alpha_L >> record.accuracy >>
+        record.time;
+    if (entry and key == signature) {
+      result = record;
+    }
+  }
+  return result;
+}
+
+/** Append a tuning result to the tuning cache. A missing cache, or one
+ *  written by a different build, is replaced by a new one.
+ *  @returns whether the entry was written.
+ */
+static bool p3m_tuning_cache_store(std::vector<double> const &signature,
+                                   P3MTuningRecord const &record) {
+  auto const valid = [] {
+    std::ifstream cache(p3m_tuning_cache_path);
+    return p3m_tuning_cache_valid(cache);
+  }();
+  std::ofstream cache(p3m_tuning_cache_path,
+                      valid ? std::ios::app : std::ios::trunc);
+  if (not valid) {
+    cache << p3m_tuning_cache_header() << "\n";
+  }
+  /* enough digits to read back the exact signature */
+  cache << std::setprecision(17);
+  for (auto const value : signature) {
+    cache << value << " ";
+  }
+  cache << record.mesh[0] << " " << record.mesh[1] << " " << record.mesh[2]
+        << " " << record.cao << " " << record.r_cut_iL << " "
+        << record.alpha_L << " " << record.accuracy << " " << record.time
+        << "\n";
+  return static_cast<bool>(cache);
+}
+
 /** Get the minimal error for this combination of parameters.
  *
  *  The real space error is tuned such that it contributes half of the
@@ -1048,6 +1292,14 @@ static double p3m_mc_time(char **log, const int mesh[3], int cao,
 
   *_accuracy =
       p3m_get_accuracy(mesh, cao, r_cut_iL, _alpha_L, &rs_err, &ks_err);
+  p3m_tuning_records.push_back({{mesh[0], mesh[1], mesh[2]},
+                                cao,
+                                r_cut_iL,
+                                *_alpha_L,
+                                *_accuracy,
+                                rs_err,
+                                ks_err,
+                                int_time});
 
   /* print result */
   sprintf(b, "%-4d %-3d %.5e %.5e %.5e %.3e %.3e %-8.2f\n", mesh[0], cao,
@@ -1210,6 +1462,41 @@ static double p3m_m_time(char **log, const int mesh[3], int cao_min,
   return best_time;
 }
 
+/** Set and broadcast the parameters found by the tuning.
+ *
+ *  @param[out] log    log output
+ *  @param[in]  tuned  the optimal parameters
+ */
+static void p3m_set_tuned_params(char **log, P3MTuningRecord const &tuned) {
+  char b[3 * ES_INTEGER_SPACE + 5 * ES_DOUBLE_SPACE + 128];
+
+  if (coulomb.method != COULOMB_P3M && coulomb.method != COULOMB_ELC_P3M &&
+      coulomb.method != COULOMB_P3M_GPU)
+    coulomb.method = COULOMB_P3M;
+
+  /* set tuned p3m parameters */
+  p3m.params.tuning = false;
+  p3m.params.r_cut = tuned.r_cut_iL * box_geo.length()[0];
+  p3m.params.r_cut_iL = tuned.r_cut_iL;
+  p3m.params.mesh[0] = tuned.mesh[0];
+  p3m.params.mesh[1] = tuned.mesh[1];
+  p3m.params.mesh[2] = tuned.mesh[2];
+  p3m.params.cao = tuned.cao;
+  p3m.params.alpha_L = tuned.alpha_L;
+  p3m.params.alpha = p3m.params.alpha_L * (1. / box_geo.length()[0]);
+  p3m.params.accuracy = tuned.accuracy;
+  /* broadcast tuned p3m parameters */
+  mpi_bcast_coulomb_params();
+
+  /* Tell the user about the outcome */
+  sprintf(b,
+          "\nresulting parameters: mesh: (%d %d %d), cao: %d, r_cut_iL: %.4e,"
+          "\n                      alpha_L: %.4e, accuracy: %.4e, time: %.2f\n",
+          tuned.mesh[0], tuned.mesh[1], tuned.mesh[2], tuned.cao,
+          tuned.r_cut_iL, tuned.alpha_L, tuned.accuracy, tuned.time);
+  *log = strcat_alloc(*log, b);
+}
+
 int p3m_adaptive_tune(char **log) {
   int mesh[3] = {0, 0, 0};
   int tmp_mesh[3];
@@ -1231,7 +1518,7 @@ int p3m_adaptive_tune(char **log) {
     }
   }
 
-  if (p3m_sanity_checks_system(node_grid)) {
+  if (p3m_sanity_checks_system()) {
     return ES_ERROR;
   }
 
@@ -1253,6 +1540,28 @@ int p3m_adaptive_tune(char **log) {
     return ES_ERROR;
   }
 
+  p3m_tuning_records.clear();
+  auto const signature = p3m_tuning_signature();
+
+  if (!p3m_tuning_cache_path.empty()) {
+    if (auto cached = p3m_tuning_cache_lookup(signature)) {
+      /* the error estimate is cheap, so make sure that the entry is valid */
+      cached->accuracy =
+          p3m_get_accuracy(cached->mesh, cached->cao, cached->r_cut_iL,
+                           &cached->alpha_L, &cached->rs_err, &cached->ks_err);
+      if (cached->accuracy <= p3m.params.accuracy) {
+        p3m_tuning_records.push_back(*cached);
+        *log = strcat_alloc(*log, "parameters taken from the tuning cache ");
+        *log = strcat_alloc(*log, p3m_tuning_cache_path.c_str());
+        *log = strcat_alloc(*log, "\n");
+        p3m_set_tuned_params(log, *cached);
+        return ES_OK;
+      }
+      *log = strcat_alloc(*log, "cached parameters do not reach the accuracy "
+                                "goal, tuning again\n");
+    }
+  }
+
   /* Activate tuning mode */
   p3m.params.tuning = true;
 
@@ -1404,27 +1713,17 @@ int p3m_adaptive_tune(char **log) {
     return ES_ERROR;
   }
 
-  /* set tuned p3m parameters */
-  p3m.params.tuning = false;
-  p3m.params.r_cut = r_cut_iL * box_geo.length()[0];
-  p3m.params.r_cut_iL = r_cut_iL;
-  p3m.params.mesh[0] = mesh[0];
-  p3m.params.mesh[1] = mesh[1];
-  p3m.params.mesh[2] = mesh[2];
-  p3m.params.cao = cao;
-  p3m.params.alpha_L = alpha_L;
-  p3m.params.alpha = p3m.params.alpha_L * (1. / box_geo.length()[0]);
-  p3m.params.accuracy = accuracy;
-  /* broadcast tuned p3m parameters */
-  mpi_bcast_coulomb_params();
+  P3MTuningRecord const tuned = {
+      {mesh[0], mesh[1], mesh[2]}, cao, r_cut_iL, alpha_L, accuracy, 0., 0.,
+      time_best};
+  if (!p3m_tuning_cache_path.empty() &&
+      !p3m_tuning_cache_store(signature, tuned)) {
+    *log = strcat_alloc(*log, "could not write to the tuning cache ");
+    *log = strcat_alloc(*log, p3m_tuning_cache_path.c_str());
+    *log = strcat_alloc(*log, "\n");
+  }
 
-  /* Tell the user about the outcome */
-  sprintf(b,
-          "\nresulting parameters: mesh: (%d %d %d), cao: %d, r_cut_iL: %.4e,"
-          "\n                      alpha_L: %.4e, accuracy: %.4e, time: %.2f\n",
-          mesh[0], mesh[1], mesh[2], cao, r_cut_iL, alpha_L, accuracy,
-          time_best);
-  *log = strcat_alloc(*log, b);
+  p3m_set_tuned_params(log, tuned);
   return ES_OK;
 }
 
@@ -1559,7 +1858,7 @@ bool p3m_sanity_checks_boxl() {
  *
  * @return false if ok, true on error.
  */
-bool p3m_sanity_checks_system(const Utils::Vector3i &grid) {
+bool p3m_sanity_checks_system() {
   bool ret = false;
 
   if (!box_geo.periodic(0) || !box_geo.periodic(1) || !box_geo.periodic(2)) {
@@ -1573,8 +1872,9 @@ bool p3m_sanity_checks_system(const Utils::Vector3i &grid) {
     ret = true;
   }
 
-  if (grid[0] < grid[1] || grid[1] < grid[2]) {
-    runtimeErrorMsg() << "P3M_init: node grid must be sorted, largest first";
+  if (!node_grid_is_regular()) {
+    runtimeErrorMsg() << "P3M requires a regular node grid, disable the "
+                         "load balancing";
     ret = true;
   }
 
@@ -1592,7 +1892,7 @@ bool p3m_sanity_checks_system(const Utils::Vector3i &grid) {
 bool p3m_sanity_checks() {
   bool ret = false;
 
-  if (p3m_sanity_checks_system(node_grid))
+  if (p3m_sanity_checks_system())
     ret = true;
 
   if (p3m_sanity_checks_boxl())
@@ -1602,6 +1902,13 @@ bool p3m_sanity_checks() {
     runtimeErrorMsg() << "P3M_init: mesh size is not yet set";
     ret = true;
   }
+  for (int i = 0; i < 3; i++) {
+    if (p3m.params.mesh[i] > 0 && p3m.params.mesh[i] % 2 == 1) {
+      runtimeErrorMsg() << "P3M_init: mesh size must be even";
+      ret = true;
+      break;
+    }
+  }
   if (p3m.params.cao == 0) {
     runtimeErrorMsg() << "P3M_init: cao is not yet set";
     ret = true;
@@ -46,6 +46,9 @@
 #include <utils/constants.hpp>
 #include <utils/math/AS_erfc_part.hpp>
 
+#include <string>
+#include <vector>
+
 /************************************************
  * data types
  ************************************************/
@@ -79,7 +82,9 @@ struct p3m_data_struct {
   std::array<std::vector<double>, 3> d_op;
   /** Force optimised influence function (k-space) */
   std::vector<double> g_force;
-  /** Energy optimised influence function (k-space) */
+  /** Energy optimised influence function (k-space), times the number of
+   *  modes each mesh point stands for, see @ref fft_ks_mode_weight.
+   */
   std::vector<double> g_energy;
 
   p3m_interpolation_cache inter_weights;
@@ -96,6 +101,22 @@ struct p3m_data_struct {
 /** P3M parameters. */
 extern p3m_data_struct p3m;
 
+/** Parameter set timed by p3m_adaptive_tune(). */
+struct P3MTuningRecord {
+  int mesh[3];
+  int cao;
+  double r_cut_iL;
+  double alpha_L;
+  /** estimated total error */
+  double accuracy;
+  /** estimated real space error */
+  double rs_err;
+  /** estimated Fourier space error */
+  double ks_err;
+  /** time for one force calculation in ms */
+  double time;
+};
+
 /** Tune P3M parameters to desired accuracy.
  *
  *  The parameters
@@ -130,12 +151,29 @@ extern p3m_data_struct p3m;
  *  The function is based on routines of the program HE_Q.cpp written by M.
  *  Deserno.
  *
+ *  If a tuning cache is set via p3m_set_tuning_cache(), the result is
+ *  looked up in the cache first and the timings are skipped if the cache
+ *  holds an entry for the same system signature (box, charges, accuracy
+ *  goal, fixed parameters and rank layout). New results are appended to
+ *  the cache.
+ *
  *  @param[out]  log  log output
  *  @retval ES_OK
  *  @retval ES_ERROR
  */
 int p3m_adaptive_tune(char **log);
 
+/** Set the file in which p3m_adaptive_tune() caches its results.
+ *  An empty path disables the cache.
+ */
+void p3m_set_tuning_cache(std::string const &path);
+
+/** Parameter sets timed during the last call to p3m_adaptive_tune(),
+ *  in the order in which they were tried. If the parameters were taken
+ *  from the tuning cache, only the cached optimum is listed.
+ */
+std::vector<P3MTuningRecord> const &p3m_tuning_table();
+
 /** Initialize all structures, parameters and arrays needed for the
  *  P3M algorithm for charge-charge interactions.
  */
@@ -88,6 +88,30 @@ public:
     boost::copy(w.w_z, it);
   }
 
+  /**
+   * @brief Store weights for one point at a given position.
+   *
+   * This allows to fill the cache concurrently, it has to be
+   * resized to hold the point before, see
+   * @ref p3m_interpolation_cache::resize.
+   *
+   * @tparam cao Interpolation order has to match the order
+   *         set at last call to @ref p3m_interpolation_cache::reset.
+   * @param i Index of the entry.
+   * @param w Interpolation weights to store.
+   */
+  template <int cao>
+  void store(size_t i, const InterpolationWeights<cao> &w) {
+    assert(cao == m_cao);
+    assert(i < size());
+
+    ca_fmp[i] = w.ind;
+    auto it = ca_frac.begin() + 3 * i * m_cao;
+    it = boost::copy(w.w_x, it);
+    it = boost::copy(w.w_y, it);
+    boost::copy(w.w_z, it);
+  }
+
   /**
    * @brief Load entry from the cache.
    *
@@ -126,6 +150,16 @@ public:
     ca_frac.clear();
     ca_fmp.clear();
   }
+
+  /**
+   * @brief Change the number of points in the cache.
+   *
+   * @param n Number of points.
+   */
+  void resize(size_t n) {
+    ca_fmp.resize(n);
+    ca_frac.resize(3 * n * m_cao);
+  }
 };
 
 /**
@@ -140,7 +174,8 @@ p3m_calculate_interpolation_weights(const Utils::Vector3d &position,
                                     const Utils::Vector3d &ai,
                                     p3m_local_mesh const &local_mesh) {
   /** position shift for calc. of first assignment mesh point. */
-  static auto const pos_shift = std::floor((cao - 1) / 2.0) - (cao % 2) / 2.0;
+  constexpr auto pos_shift =
+      static_cast<double>((cao - 1) / 2) - (cao % 2) / 2.0;
 
   /* distance to nearest mesh point */
   Utils::Vector3d dist;
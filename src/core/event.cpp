@@ -43,6 +43,7 @@
 #include "partCfg_global.hpp"
 #include "particle_data.hpp"
 #include "thermostat.hpp"
+#include "threads.hpp"
 #include "virtual_sites.hpp"
 
 #include <utils/mpi/all_compare.hpp>
@@ -80,6 +81,8 @@ void on_program_start() {
 
   init_node_grid();
 
+  threads_init();
+
   /* initially go for domain decomposition */
   cells_re_init(CELL_STRUCTURE_DOMDEC);
 
@@ -153,6 +156,10 @@ void on_integration_start() {
 }
 
 void on_observable_calc() {
+  /* This precedes the short-range loops of the observables,
+   * and via on_integration_start() those of the integration. */
+  cells_sanity_checks();
+
   /* Prepare particle structure: Communication step: number of ghosts and ghost
    * information */
   cells_update_ghosts(global_ghost_flags());
@@ -219,6 +226,7 @@ void on_coulomb_change() {
 }
 
 void on_short_range_ia_change() {
+  update_batched_ia_params();
   cells_re_init(cell_structure.decomposition_type());
 
   recalc_forces = true;
@@ -321,7 +329,9 @@ void on_parameter_change(int field) {
     reinit_thermo = true;
     break;
   case FIELD_FORCE_CAP:
-    /* If the force cap changed, forces are invalid */
+  case FIELD_LONG_RANGE_INTERVAL:
+    /* If the force cap or the weight of the long-range forces changed,
+     * forces are invalid */
     recalc_forces = true;
     break;
   case FIELD_THERMO_SWITCH:
@@ -332,6 +342,9 @@ void on_parameter_change(int field) {
   case FIELD_SIMTIME:
     recalc_forces = true;
     break;
+  case FIELD_N_THREADS:
+    threads_init();
+    break;
   }
 }
 
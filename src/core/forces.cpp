@@ -27,6 +27,7 @@
 
 #include "EspressoSystemInterface.hpp"
 
+#include "cells.hpp"
 #include "collision.hpp"
 #include "comfixed_global.hpp"
 #include "communication.hpp"
@@ -40,14 +41,103 @@
 #include "grid_based_algorithms/lb_interface.hpp"
 #include "grid_based_algorithms/lb_particle_coupling.hpp"
 #include "immersed_boundaries.hpp"
+#include "load_balance.hpp"
 #include "short_range_loop.hpp"
 
 #include <profiler/profiler.hpp>
+#include <utils/math/sqr.hpp>
 
 #include <cassert>
+#include <mpi.h>
+#include <vector>
 
 ActorList forceActors;
 
+namespace {
+/**
+ * @brief Whether the non-bonded pair kernel can be run concurrently.
+ *
+ * This is the case if the kernel only writes to the two particles
+ * it is called with, and does not accumulate global state.
+ */
+bool pair_force_is_thread_safe() {
+#ifdef COLLISION_DETECTION
+  if (collision_params.mode != COLLISION_MODE_OFF)
+    return false;
+#endif
+#ifdef NPT
+  if (integ_switch == INTEG_METHOD_NPT_ISO)
+    return false;
+#endif
+#if defined(ELECTROSTATICS) && defined(SCAFACOS)
+  if (coulomb.method == COULOMB_SCAFACOS)
+    return false;
+#endif
+  return true;
+}
+
+/**
+ * @brief Whether the non-bonded pair forces can be calculated on the
+ *        structure-of-arrays copies of the particles.
+ *
+ * The copies only hold positions, types and charges, so this is not
+ * possible if pair interactions need other particle properties or
+ * the charges change during the force calculation.
+ */
+bool soa_pair_forces_available(CellStructure const &cell_structure) {
+  if (not cell_structure.use_soa or cell_structure.minimum_image_distance())
+    return false;
+#ifdef COLLISION_DETECTION
+  if (collision_params.mode != COLLISION_MODE_OFF)
+    return false;
+#endif
+#ifdef DPD
+  if (thermo_switch & THERMO_DPD)
+    return false;
+#endif
+#ifdef DIPOLES
+  if (dipole.method != DIPOLAR_NONE)
+    return false;
+#endif
+#ifdef ELECTROSTATICS
+  if (iccp3m_cfg.n_ic > 0)
+    return false;
+#ifdef P3M
+  if (coulomb.method == COULOMB_ELC_P3M and elc_params.dielectric_contrast_on)
+    return false;
+#endif
+#endif
+  return true;
+}
+
+/**
+ * @brief Add the long range forces multiplied by a weight.
+ *
+ * The forces already acting on the particles are set aside, so that
+ * only the long range contribution is scaled.
+ */
+void calc_weighted_long_range_forces(const ParticleRange &particles,
+                                     double weight) {
+  std::vector<ParticleForce> forces;
+  forces.reserve(particles.size());
+  for (auto &p : particles) {
+    forces.push_back(p.f);
+    p.f = {};
+  }
+
+  calc_long_range_forces(particles);
+
+  auto force = forces.begin();
+  for (auto &p : particles) {
+    p.f.f *= weight;
+#ifdef ROTATION
+    p.f.torque *= weight;
+#endif
+    p.f += *force++;
+  }
+}
+} // namespace
+
 void init_forces(const ParticleRange &particles) {
   ESPRESSO_PROFILER_CXX_MARK_FUNCTION;
   /* The force initialization depends on the used thermostat and the
@@ -79,7 +169,7 @@ void init_forces_ghosts(const ParticleRange &particles) {
   }
 }
 
-void force_calc(CellStructure &cell_structure) {
+void force_calc(CellStructure &cell_structure, int long_range_weight) {
   ESPRESSO_PROFILER_CXX_MARK_FUNCTION;
 
   espressoSystemInterface.update();
@@ -91,6 +181,8 @@ void force_calc(CellStructure &cell_structure) {
   auto particles = cell_structure.local_particles();
   auto ghost_particles = cell_structure.ghost_particles();
 #ifdef ELECTROSTATICS
+  if (iccp3m_cfg.n_ic > 0)
+    cell_structure.ghosts_update_wait();
   iccp3m_iteration(particles, cell_structure.ghost_particles());
 #endif
   init_forces(particles);
@@ -102,7 +194,11 @@ void force_calc(CellStructure &cell_structure) {
 #endif
   }
 
-  calc_long_range_forces(particles);
+  if (long_range_weight == 1) {
+    calc_long_range_forces(particles);
+  } else if (long_range_weight > 1) {
+    calc_weighted_long_range_forces(particles, long_range_weight);
+  }
 
 #ifdef ELECTROSTATICS
   auto const coulomb_cutoff = Coulomb::cutoff(box_geo.length());
@@ -116,17 +212,42 @@ void force_calc(CellStructure &cell_structure) {
   auto const dipole_cutoff = INACTIVE_CUTOFF;
 #endif
 
-  short_range_loop(
-      [](Particle &p) { add_single_particle_force(p); },
-      [](Particle &p1, Particle &p2, Distance const &d) {
-        add_non_bonded_pair_force(p1, p2, d.vec21, sqrt(d.dist2), d.dist2);
+  auto const particle_kernel = [](Particle &p) {
+    add_single_particle_force(p);
+  };
+  auto const pair_kernel = [](Particle &p1, Particle &p2, Distance const &d) {
+    add_non_bonded_pair_force(p1, p2, d.vec21, sqrt(d.dist2), d.dist2);
 #ifdef COLLISION_DETECTION
-        if (collision_params.mode != COLLISION_MODE_OFF)
-          detect_collision(p1, p2, d.dist2);
+    if (collision_params.mode != COLLISION_MODE_OFF)
+      detect_collision(p1, p2, d.dist2);
 #endif
-      },
+  };
+  auto const verlet_criterion =
       VerletCriterion{skin, interaction_range(), coulomb_cutoff, dipole_cutoff,
-                      collision_detection_cutoff()});
+                      collision_detection_cutoff()};
+
+  auto const short_range_start = MPI_Wtime();
+  if (soa_pair_forces_available(cell_structure)) {
+    auto const max_cut2 = Utils::sqr(cells_max_cutoff());
+    cell_structure.soa_reset_forces();
+    batched_short_range_loop(
+        [max_cut2](Cell &c1, int i, Cell &c2, int j_first, int j_last) {
+          add_non_bonded_pair_forces_soa(c1, i, c2, j_first, j_last,
+                                         max_cut2);
+        },
+        pair_force_is_thread_safe());
+    cell_structure.soa_add_forces();
+
+    cell_structure.ghosts_update_wait();
+    for (auto &p : particles) {
+      particle_kernel(p);
+    }
+  } else if (pair_force_is_thread_safe()) {
+    parallel_short_range_loop(particle_kernel, pair_kernel, verlet_criterion);
+  } else {
+    short_range_loop(particle_kernel, pair_kernel, verlet_criterion);
+  }
+  load_balance_add_sample(MPI_Wtime() - short_range_start);
 
   Constraints::constraints.add_forces(particles, sim_time);
 
@@ -60,8 +60,12 @@ void init_forces_ghosts(const ParticleRange &particles);
  *  <li> Calculate non-bonded short range interaction forces
  *  <li> Calculate long range interaction forces
  *  </ol>
+ *
+ *  @param cell_structure     Particles to calculate the forces for
+ *  @param long_range_weight  Factor for the long range forces, which are
+ *                            skipped if it is zero
  */
-void force_calc(CellStructure &cell_structure);
+void force_calc(CellStructure &cell_structure, int long_range_weight = 1);
 
 /** Calculate long range forces (P3M, ...). */
 void calc_long_range_forces(const ParticleRange &particles);
@@ -23,6 +23,7 @@
 
 #include "config.hpp"
 
+#include "Cell.hpp"
 #include "bonded_interactions/angle_cosine.hpp"
 #include "bonded_interactions/angle_cossquare.hpp"
 #include "bonded_interactions/angle_harmonic.hpp"
@@ -39,6 +40,7 @@
 #include "forces.hpp"
 #include "immersed_boundary/ibm_tribend.hpp"
 #include "immersed_boundary/ibm_triel.hpp"
+#include "integrate.hpp"
 #include "integrators/langevin_inline.hpp"
 #include "nonbonded_interactions/bmhtf-nacl.hpp"
 #include "nonbonded_interactions/buckingham.hpp"
@@ -75,6 +77,13 @@
 #include "dpd.hpp"
 #endif
 
+#include <utils/Vector.hpp>
+#include <utils/math/int_pow.hpp>
+#include <utils/math/sqr.hpp>
+
+#include <algorithm>
+#include <cmath>
+
 /** Initialize the forces for a ghost particle */
 inline ParticleForce init_ghost_force(Particle const &) { return {}; }
 
@@ -121,12 +130,11 @@ inline ParticleForce init_local_particle_force(Particle const &part) {
   return thermostat_force(part) + external_force(part);
 }
 
-inline Utils::Vector3d calc_non_bonded_pair_force_parts(
-    Particle const &p1, Particle const &p2, IA_parameters const &ia_params,
-    Utils::Vector3d const &d, double const dist,
-    Utils::Vector3d *torque1 = nullptr, Utils::Vector3d *torque2 = nullptr) {
-
-  Utils::Vector3d force{};
+/** Sum of the force factors of all central non-bonded pair potentials,
+ *  the force on the first particle is the factor times the distance vector.
+ */
+inline double calc_central_pair_force_factor(IA_parameters const &ia_params,
+                                             double const dist) {
   double force_factor = 0;
 /* Lennard-Jones */
 #ifdef LENNARD_JONES
@@ -180,13 +188,40 @@ inline Utils::Vector3d calc_non_bonded_pair_force_parts(
 #ifdef LJCOS2
   force_factor += ljcos2_pair_force_factor(ia_params, dist);
 #endif
-/* Thole damping */
-#ifdef THOLE
-  force += thole_pair_force(p1, p2, ia_params, d, dist);
-#endif
 /* tabulated */
 #ifdef TABULATED
   force_factor += tabulated_pair_force_factor(ia_params, dist);
+#endif
+  return force_factor;
+}
+
+/** Check whether all non-bonded interactions of a type pair are
+ *  central and independent of the particle properties other than
+ *  the type, so that @ref calc_central_pair_force_factor gives
+ *  the full force.
+ */
+inline bool is_central_pair_interaction(IA_parameters const &ia_params) {
+#ifdef THOLE
+  if (ia_params.thole.scaling_coeff != 0.)
+    return false;
+#endif
+#ifdef GAY_BERNE
+  if (ia_params.gay_berne.cut != INACTIVE_CUTOFF)
+    return false;
+#endif
+  return true;
+}
+
+inline Utils::Vector3d calc_non_bonded_pair_force_parts(
+    Particle const &p1, Particle const &p2, IA_parameters const &ia_params,
+    Utils::Vector3d const &d, double const dist,
+    Utils::Vector3d *torque1 = nullptr, Utils::Vector3d *torque2 = nullptr) {
+
+  Utils::Vector3d force{};
+  auto const force_factor = calc_central_pair_force_factor(ia_params, dist);
+/* Thole damping */
+#ifdef THOLE
+  force += thole_pair_force(p1, p2, ia_params, d, dist);
 #endif
 /* Gay-Berne */
 #ifdef GAY_BERNE
@@ -319,6 +354,277 @@ inline void add_non_bonded_pair_force(Particle &p1, Particle &p2,
 #endif
 }
 
+/** Calculate the non-bonded force between two particles of the
+ *  structure-of-arrays copies of the cells.
+ *
+ *  Only central pair potentials and the central part of the short-range
+ *  electrostatics are evaluated on the copies, the forces are accumulated
+ *  in @ref ParticleSoA::fx etc. Pairs involving exclusions or non-central
+ *  interactions are handed to @ref add_non_bonded_pair_force.
+ *  The positions have to be in the same image, i.e. no minimum image
+ *  convention is applied.
+ *
+ *  @param[in,out] c1      cell of the first particle.
+ *  @param i               index of the first particle in @p c1.
+ *  @param[in,out] c2      cell of the second particle.
+ *  @param j               index of the second particle in @p c2.
+ */
+inline void add_non_bonded_pair_force_soa(Cell &c1, int i, Cell &c2, int j) {
+  auto &s1 = c1.soa();
+  auto &s2 = c2.soa();
+
+  auto const d = Utils::Vector3d{s1.x[i] - s2.x[j], s1.y[i] - s2.y[j],
+                                 s1.z[i] - s2.z[j]};
+  auto const dist2 = d.norm2();
+  auto const dist = std::sqrt(dist2);
+  IA_parameters const &ia_params = *get_ia_param(s1.type[i], s2.type[j]);
+
+  if (s1.has_exclusions[i] or s2.has_exclusions[j] or
+      not is_central_pair_interaction(ia_params)) {
+    add_non_bonded_pair_force(c1.particles().begin()[i],
+                              c2.particles().begin()[j], d, dist, dist2);
+    return;
+  }
+
+  Utils::Vector3d force{};
+  if (dist < ia_params.max_cut) {
+    force = calc_central_pair_force_factor(ia_params, dist) * d;
+  }
+#ifdef ELECTROSTATICS
+  auto const q1q2 = s1.q[i] * s2.q[j];
+  if (q1q2 != 0.) {
+    force += Coulomb::central_force(q1q2, d, dist);
+  }
+#endif
+#ifdef NPT
+  npt_add_virial_contribution(force, d);
+#endif
+
+  s1.fx[i] += force[0];
+  s1.fy[i] += force[1];
+  s1.fz[i] += force[2];
+  s2.fx[j] -= force[0];
+  s2.fy[j] -= force[1];
+  s2.fz[j] -= force[2];
+}
+
+namespace detail {
+/** @name Short-range Coulomb force factors for the batched kernel.
+ *  Return the force on the first particle divided by the distance
+ *  vector, including the Coulomb prefactor.
+ */
+/*@{*/
+struct NoCoulombBatch {
+  double operator()(double, double, double) const { return 0.; }
+};
+
+#ifdef ELECTROSTATICS
+#ifdef P3M
+struct P3MCoulombBatch {
+  double prefactor = coulomb.prefactor;
+  double alpha = p3m.params.alpha;
+  double r_cut = p3m.params.r_cut;
+
+  double operator()(double q1q2, double dist, double dist2) const {
+    auto const adist = alpha * dist;
+#if USE_ERFC_APPROXIMATION
+    auto const erfc_part_ri = Utils::AS_erfc_part(adist) / dist;
+    auto const fac = q1q2 * exp(-adist * adist) *
+                     (erfc_part_ri + 2.0 * alpha * Utils::sqrt_pi_i()) / dist2;
+#else
+    auto const erfc_part_ri = erfc(adist) / dist;
+    auto const fac = q1q2 *
+                     (erfc_part_ri + 2.0 * alpha * Utils::sqrt_pi_i() *
+                                         exp(-adist * adist)) /
+                     dist2;
+#endif
+    return (dist < r_cut and dist > 0.) ? prefactor * fac : 0.;
+  }
+};
+#endif
+
+struct DHCoulombBatch {
+  double prefactor = coulomb.prefactor;
+  double kappa = std::max(dh_params.kappa, 0.);
+  double r_cut = dh_params.r_cut;
+
+  double operator()(double q1q2, double dist, double dist2) const {
+    /* For kappa = 0 this is the plain Coulomb force. */
+    auto const kappa_dist = kappa * dist;
+    auto const fac = q1q2 * exp(-kappa_dist) * (1.0 + kappa_dist) /
+                     (dist2 * dist);
+    return (dist < r_cut) ? prefactor * fac : 0.;
+  }
+};
+#endif
+/*@}*/
+
+/** Size of the blocks of partners that are evaluated together. */
+constexpr int soa_batch_size = 32;
+
+/** Calculate the non-bonded forces between a particle and a range of
+ *  partners on the structure-of-arrays copies.
+ *
+ *  Lennard-Jones, WCA and the short-range Coulomb part are evaluated
+ *  for blocks of partners in a loop without branches, which the compiler
+ *  can vectorize, pairs outside of the cutoff are masked out.
+ *  Pairs that need anything else (exclusions, other potentials) are
+ *  evaluated afterwards by @ref add_non_bonded_pair_force_soa.
+ */
+template <class CoulombKernel>
+void add_non_bonded_pair_forces_batched(Cell &c1, int i, Cell &c2,
+                                        int j_first, int j_last,
+                                        double max_cut2,
+                                        CoulombKernel const &coulomb_kernel) {
+  auto &s1 = c1.soa();
+  auto &s2 = c2.soa();
+  auto const &params = batched_ia_params;
+
+  auto const row = s1.type[i] * params.n_types;
+  auto const x1 = s1.x[i];
+  auto const y1 = s1.y[i];
+  auto const z1 = s1.z[i];
+  auto const q1 = s1.q[i];
+  auto const excl1 = s1.has_exclusions[i];
+
+  double fx1 = 0., fy1 = 0., fz1 = 0.;
+  char slow[soa_batch_size];
+
+  for (int j0 = j_first; j0 < j_last; j0 += soa_batch_size) {
+    auto const n = std::min(soa_batch_size, j_last - j0);
+
+    auto const *const x2 = s2.x.data() + j0;
+    auto const *const y2 = s2.y.data() + j0;
+    auto const *const z2 = s2.z.data() + j0;
+    auto const *const q2 = s2.q.data() + j0;
+    auto const *const type2 = s2.type.data() + j0;
+    auto const *const excl2 = s2.has_exclusions.data() + j0;
+    auto *const fx2 = s2.fx.data() + j0;
+    auto *const fy2 = s2.fy.data() + j0;
+    auto *const fz2 = s2.fz.data() + j0;
+
+#ifdef OPENMP
+#pragma omp simd reduction(+ : fx1, fy1, fz1)
+#endif
+    for (int k = 0; k < n; k++) {
+      auto const dx = x1 - x2[k];
+      auto const dy = y1 - y2[k];
+      auto const dz = z1 - z2[k];
+      auto const dist2 = dx * dx + dy * dy + dz * dz;
+      auto const dist = std::sqrt(dist2);
+      auto const index = row + type2[k];
+
+      auto const r_off = dist - params.lj_offset[index];
+      auto const lj_frac6 = Utils::int_pow<6>(params.lj_sig[index] / r_off);
+      auto const lj = (dist < params.lj_r_max[index] and
+                       dist > params.lj_r_min[index])
+                          ? 48.0 * params.lj_eps[index] * lj_frac6 *
+                                (lj_frac6 - 0.5) / (r_off * dist)
+                          : 0.;
+
+      auto const wca_frac6 = Utils::int_pow<6>(params.wca_sig[index] / dist);
+      auto const wca = (dist < params.wca_cut[index])
+                           ? 48.0 * params.wca_eps[index] * wca_frac6 *
+                                 (wca_frac6 - 0.5) / dist2
+                           : 0.;
+
+      auto const coulomb = coulomb_kernel(q1 * q2[k], dist, dist2);
+
+      auto const in_range = (dist2 <= max_cut2);
+      auto const batchable =
+          params.batchable[index] and not(excl1 or excl2[k]);
+      auto const fac = (in_range and batchable) ? lj + wca + coulomb : 0.;
+      slow[k] = in_range and not batchable;
+
+      fx1 += fac * dx;
+      fy1 += fac * dy;
+      fz1 += fac * dz;
+      fx2[k] -= fac * dx;
+      fy2[k] -= fac * dy;
+      fz2[k] -= fac * dz;
+    }
+
+    for (int k = 0; k < n; k++) {
+      if (slow[k])
+        add_non_bonded_pair_force_soa(c1, i, c2, j0 + k);
+    }
+  }
+
+  s1.fx[i] += fx1;
+  s1.fy[i] += fy1;
+  s1.fz[i] += fz1;
+}
+} // namespace detail
+
+/** Calculate the non-bonded forces between a particle and a range of
+ *  particles on the structure-of-arrays copies of the cells.
+ *
+ *  If possible, the forces are evaluated in batches (see
+ *  @ref detail::add_non_bonded_pair_forces_batched), otherwise
+ *  pair by pair with @ref add_non_bonded_pair_force_soa.
+ *  The batched parameters have to be up to date, see
+ *  @ref update_batched_ia_params.
+ *
+ *  @param[in,out] c1      cell of the first particle.
+ *  @param i               index of the first particle in @p c1.
+ *  @param[in,out] c2      cell of the partners.
+ *  @param j_first         index of the first partner in @p c2.
+ *  @param j_last          index after the last partner in @p c2.
+ *  @param max_cut2        square of the maximal interaction range.
+ */
+inline void add_non_bonded_pair_forces_soa(Cell &c1, int i, Cell &c2,
+                                           int j_first, int j_last,
+                                           double max_cut2) {
+  auto const pair_by_pair = [&]() {
+    auto &s1 = c1.soa();
+    auto &s2 = c2.soa();
+    for (int j = j_first; j < j_last; j++) {
+      auto const dist2 = Utils::sqr(s1.x[i] - s2.x[j]) +
+                         Utils::sqr(s1.y[i] - s2.y[j]) +
+                         Utils::sqr(s1.z[i] - s2.z[j]);
+      if (dist2 <= max_cut2)
+        add_non_bonded_pair_force_soa(c1, i, c2, j);
+    }
+  };
+
+#ifdef NPT
+  /* The virial is accumulated pair by pair */
+  if (integ_switch == INTEG_METHOD_NPT_ISO) {
+    pair_by_pair();
+    return;
+  }
+#endif
+
+#ifdef ELECTROSTATICS
+  switch (coulomb.method) {
+  case COULOMB_NONE:
+    detail::add_non_bonded_pair_forces_batched(c1, i, c2, j_first, j_last,
+                                               max_cut2,
+                                               detail::NoCoulombBatch{});
+    break;
+#ifdef P3M
+  case COULOMB_P3M_GPU:
+  case COULOMB_P3M:
+  case COULOMB_ELC_P3M:
+    detail::add_non_bonded_pair_forces_batched(c1, i, c2, j_first, j_last,
+                                               max_cut2,
+                                               detail::P3MCoulombBatch{});
+    break;
+#endif
+  case COULOMB_DH:
+    detail::add_non_bonded_pair_forces_batched(c1, i, c2, j_first, j_last,
+                                               max_cut2,
+                                               detail::DHCoulombBatch{});
+    break;
+  default:
+    pair_by_pair();
+  }
+#else
+  detail::add_non_bonded_pair_forces_batched(
+      c1, i, c2, j_first, j_last, max_cut2, detail::NoCoulombBatch{});
+#endif
+}
+
 /** Compute the bonded interaction force between particle pairs.
  *
  *  @param[in] p1          First particle.
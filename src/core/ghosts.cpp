@@ -44,42 +44,12 @@
 #include <boost/serialization/vector.hpp>
 
 #include <algorithm>
+#include <unordered_set>
 #include <vector>
 
 /** Tag for ghosts communications. */
 #define REQ_GHOST_SEND 100
 
-/**
- * Class that stores marshalled data for ghost communications.
- * To store and retrieve data, use the adapter classes below.
- */
-class CommBuf {
-public:
-  /** Returns a pointer to the non-bond storage.
-   */
-  char *data() { return buf.data(); }
-  const char *data() const { return buf.data(); }
-
-  /** Returns the number of elements in the non-bond storage.
-   */
-  size_t size() const { return buf.size(); }
-
-  /** Resizes the underlying storage s.t. the object is capable
-   * of holding "new_size" chars.
-   * @param new_size new size
-   */
-  void resize(size_t new_size) { buf.resize(new_size); }
-
-  /** Returns a reference to the bond storage.
-   */
-  auto &bonds() { return bondbuf; }
-  const auto &bonds() const { return bondbuf; }
-
-private:
-  std::vector<char> buf;     ///< Buffer for everything but bonds
-  std::vector<char> bondbuf; ///< Buffer for bond lists
-};
-
 static size_t calc_transmit_size(unsigned data_parts) {
   size_t size = {};
   if (data_parts & GHOSTTRANS_PROPRTS) {
@@ -116,12 +86,6 @@ static void prepare_send_buffer(CommBuf &send_buffer,
 
   auto archiver = Utils::MemcpyOArchive{Utils::make_span(send_buffer)};
 
-  /* Construct archive that pushes back to the bond buffer */
-  namespace io = boost::iostreams;
-  io::stream<io::back_insert_device<std::vector<char>>> os{
-      io::back_inserter(send_buffer.bonds())};
-  boost::archive::binary_oarchive bond_archiver{os};
-
   /* put in data */
   for (auto part_list : ghost_comm.part_lists) {
     if (data_parts & GHOSTTRANS_PARTNUM) {
@@ -144,14 +108,26 @@ static void prepare_send_buffer(CommBuf &send_buffer,
         if (data_parts & GHOSTTRANS_FORCE) {
           archiver << part.f;
         }
-        if (data_parts & GHOSTTRANS_BONDS) {
-          bond_archiver << part.bonds();
-        }
       }
     }
   }
 
   assert(archiver.bytes_written() == send_buffer.size());
+
+  if ((data_parts & GHOSTTRANS_BONDS) and
+      not(data_parts & GHOSTTRANS_PARTNUM)) {
+    /* Construct archive that pushes back to the bond buffer */
+    namespace io = boost::iostreams;
+    io::stream<io::back_insert_device<std::vector<char>>> os{
+        io::back_inserter(send_buffer.bonds())};
+    boost::archive::binary_oarchive bond_archiver{os};
+
+    for (auto part_list : ghost_comm.part_lists) {
+      for (Particle &part : *part_list) {
+        bond_archiver << part.bonds();
+      }
+    }
+  }
 }
 
 static void prepare_ghost_cell(ParticleList *cell, int size) {
@@ -350,25 +326,31 @@ void ghost_communicator(const GhostCommunicator &gcr, unsigned int data_parts) {
 
     /* transfer data */
     // Use two send/recvs in order to avoid having to serialize CommBuf
-    // (which consists of already serialized data).
+    // (which consists of already serialized data). The bonds are only
+    // sent if requested.
+    auto const bonds = (data_parts & GHOSTTRANS_BONDS) != 0;
     switch (comm_type) {
     case GHOST_RECV:
       comm.recv(node, REQ_GHOST_SEND, recv_buffer.data(), recv_buffer.size());
-      comm.recv(node, REQ_GHOST_SEND, recv_buffer.bonds());
+      if (bonds)
+        comm.recv(node, REQ_GHOST_SEND, recv_buffer.bonds());
       break;
     case GHOST_SEND:
       comm.send(node, REQ_GHOST_SEND, send_buffer.data(), send_buffer.size());
-      comm.send(node, REQ_GHOST_SEND, send_buffer.bonds());
+      if (bonds)
+        comm.send(node, REQ_GHOST_SEND, send_buffer.bonds());
       break;
     case GHOST_BCST:
       if (node == comm.rank()) {
         boost::mpi::broadcast(comm, send_buffer.data(), send_buffer.size(),
                               node);
-        boost::mpi::broadcast(comm, send_buffer.bonds(), node);
+        if (bonds)
+          boost::mpi::broadcast(comm, send_buffer.bonds(), node);
       } else {
         boost::mpi::broadcast(comm, recv_buffer.data(), recv_buffer.size(),
                               node);
-        boost::mpi::broadcast(comm, recv_buffer.bonds(), node);
+        if (bonds)
+          boost::mpi::broadcast(comm, recv_buffer.bonds(), node);
       }
       break;
     case GHOST_RDCE:
@@ -418,3 +400,189 @@ void ghost_communicator(const GhostCommunicator &gcr, unsigned int data_parts) {
     }
   }
 }
+
+bool AsyncGhostCommunicator::is_supported(const GhostCommunicator &gcr,
+                                          unsigned int data_parts) {
+  auto const fixed_size_parts =
+      GHOSTTRANS_PROPRTS | GHOSTTRANS_POSITION | GHOSTTRANS_MOMENTUM;
+  if ((data_parts & ~fixed_size_parts) and (data_parts != GHOSTTRANS_FORCE))
+    return false;
+
+  return std::all_of(gcr.communications.begin(), gcr.communications.end(),
+                     [](GhostCommunication const &ghost_comm) {
+                       int const comm_type = ghost_comm.type & GHOST_JOBMASK;
+                       return (comm_type == GHOST_SEND) or
+                              (comm_type == GHOST_RECV) or
+                              (comm_type == GHOST_LOCL);
+                     });
+}
+
+/** Split the communications into stages, a new stage starts
+ *  with the first communication that sends a cell which is
+ *  received in the current stage.
+ */
+static std::vector<size_t> find_stages(const GhostCommunicator &gcr) {
+  std::vector<size_t> stages = {0};
+  std::unordered_set<ParticleList const *> received;
+
+  for (size_t i = 0; i < gcr.communications.size(); i++) {
+    auto const &ghost_comm = gcr.communications[i];
+    int const comm_type = ghost_comm.type & GHOST_JOBMASK;
+    auto const &part_lists = ghost_comm.part_lists;
+
+    /* for local transfers, the first half of the cells are sent */
+    auto const send_begin = part_lists.begin();
+    auto const send_end = (comm_type == GHOST_LOCL)
+                              ? send_begin + part_lists.size() / 2
+                              : ((comm_type == GHOST_SEND) ? part_lists.end()
+                                                           : send_begin);
+    auto const recv_begin =
+        (comm_type == GHOST_LOCL)
+            ? send_end
+            : ((comm_type == GHOST_RECV) ? send_begin : part_lists.end());
+
+    if (std::any_of(send_begin, send_end, [&received](ParticleList *pl) {
+          return received.count(pl) != 0;
+        })) {
+      stages.push_back(i);
+      received.clear();
+    }
+
+    received.insert(recv_begin, part_lists.end());
+  }
+
+  stages.push_back(gcr.communications.size());
+
+  return stages;
+}
+
+AsyncGhostCommunicator::~AsyncGhostCommunicator() {
+  /* The cell structure is a global, which may outlive MPI. */
+  int finalized;
+  MPI_Finalized(&finalized);
+  if (finalized)
+    return;
+
+  for (auto &r : m_requests) {
+    if (r.request != MPI_REQUEST_NULL)
+      MPI_Request_free(&r.request);
+  }
+}
+
+void AsyncGhostCommunicator::begin(const GhostCommunicator &gcr,
+                                   unsigned int data_parts) {
+  assert(not pending());
+  assert(is_supported(gcr, data_parts));
+
+  m_gcr = &gcr;
+  m_data_parts = data_parts;
+  m_stages = find_stages(gcr);
+  m_stage = 0;
+  m_buffers.resize(gcr.communications.size());
+  if (m_requests.size() < gcr.communications.size())
+    m_requests.resize(gcr.communications.size());
+
+  post_stage();
+  test();
+}
+
+void AsyncGhostCommunicator::start_request(size_t i) {
+  auto const &ghost_comm = m_gcr->communications[i];
+  auto &buffer = m_buffers[i];
+  auto &r = m_requests[i];
+
+  int const comm_type = ghost_comm.type & GHOST_JOBMASK;
+  MPI_Comm const comm = m_gcr->mpi_comm;
+  auto const size = static_cast<int>(buffer.size());
+
+  if (r.request == MPI_REQUEST_NULL or r.type != comm_type or
+      r.node != ghost_comm.node or r.comm != comm or
+      r.data != buffer.data() or r.size != size) {
+    if (r.request != MPI_REQUEST_NULL)
+      MPI_Request_free(&r.request);
+
+    if (comm_type == GHOST_SEND) {
+      MPI_Send_init(buffer.data(), size, MPI_BYTE, ghost_comm.node,
+                    REQ_GHOST_SEND, comm, &r.request);
+    } else {
+      MPI_Recv_init(buffer.data(), size, MPI_BYTE, ghost_comm.node,
+                    REQ_GHOST_SEND, comm, &r.request);
+    }
+
+    r.type = comm_type;
+    r.node = ghost_comm.node;
+    r.comm = comm;
+    r.data = buffer.data();
+    r.size = size;
+  }
+
+  m_active.push_back(r.request);
+}
+
+void AsyncGhostCommunicator::post_stage() {
+  /* Messages between the same pair of nodes are matched in the order
+   * they are posted, which is the order of the communicators. */
+  for (auto i = m_stages[m_stage]; i < m_stages[m_stage + 1]; i++) {
+    auto const &ghost_comm = m_gcr->communications[i];
+
+    switch (ghost_comm.type & GHOST_JOBMASK) {
+    case GHOST_LOCL:
+      cell_cell_transfer(ghost_comm, m_data_parts);
+      break;
+    case GHOST_SEND:
+      prepare_send_buffer(m_buffers[i], ghost_comm, m_data_parts);
+      start_request(i);
+      break;
+    case GHOST_RECV:
+      prepare_recv_buffer(m_buffers[i], ghost_comm, m_data_parts);
+      start_request(i);
+      break;
+    }
+  }
+
+  if (not m_active.empty())
+    MPI_Startall(static_cast<int>(m_active.size()), m_active.data());
+}
+
+void AsyncGhostCommunicator::finish_stage() {
+  m_active.clear();
+
+  for (auto i = m_stages[m_stage]; i < m_stages[m_stage + 1]; i++) {
+    auto const &ghost_comm = m_gcr->communications[i];
+    if ((ghost_comm.type & GHOST_JOBMASK) == GHOST_RECV) {
+      if (m_data_parts == GHOSTTRANS_FORCE)
+        add_forces_from_recv_buffer(m_buffers[i], ghost_comm);
+      else
+        put_recv_buffer(m_buffers[i], ghost_comm, m_data_parts);
+    }
+  }
+
+  if (++m_stage + 1 < m_stages.size()) {
+    post_stage();
+  } else {
+    m_gcr = nullptr;
+  }
+}
+
+bool AsyncGhostCommunicator::test() {
+  while (pending()) {
+    int done = 1;
+    if (not m_active.empty())
+      MPI_Testall(static_cast<int>(m_active.size()), m_active.data(), &done,
+                  MPI_STATUSES_IGNORE);
+    if (not done)
+      return false;
+    finish_stage();
+  }
+
+  return true;
+}
+
+void AsyncGhostCommunicator::wait() {
+  while (pending()) {
+    if (not m_active.empty())
+      MPI_Waitall(static_cast<int>(m_active.size()), m_active.data(),
+                  MPI_STATUSES_IGNORE);
+    finish_stage();
+  }
+}
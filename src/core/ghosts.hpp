@@ -82,11 +82,25 @@
  *
  *  The ghost communicators are created by the cell
  *  systems.
+ *
+ *  Between two resorts, the number of ghosts does not change, and only
+ *  data with a fixed size per particle (positions, momenta, forces) is
+ *  communicated. These updates are done by @ref AsyncGhostCommunicator,
+ *  which reuses its buffers and persistent MPI requests from step to step.
+ *  It can also be used without blocking, so that the force calculation can
+ *  start on the cells that do not need ghosts while the messages are in
+ *  flight. Bond lists are only serialized and sent if @ref GHOSTTRANS_BONDS
+ *  is requested.
  */
 #include "ParticleList.hpp"
 
 #include <boost/mpi/communicator.hpp>
 
+#include <mpi.h>
+
+#include <cstddef>
+#include <vector>
+
 /** \name Transfer types, for \ref GhostCommunicator::type */
 /************************************************************/
 /*@{*/
@@ -157,6 +171,105 @@ struct GhostCommunicator {
   std::vector<GhostCommunication> communications;
 };
 
+/**
+ * Class that stores marshalled data for ghost communications.
+ * To store and retrieve data, use the adapter functions in ghosts.cpp.
+ */
+class CommBuf {
+public:
+  /** Returns a pointer to the non-bond storage.
+   */
+  char *data() { return buf.data(); }
+  const char *data() const { return buf.data(); }
+
+  /** Returns the number of elements in the non-bond storage.
+   */
+  size_t size() const { return buf.size(); }
+
+  /** Resizes the underlying storage s.t. the object is capable
+   * of holding "new_size" chars.
+   * @param new_size new size
+   */
+  void resize(size_t new_size) { buf.resize(new_size); }
+
+  /** Returns a reference to the bond storage.
+   */
+  auto &bonds() { return bondbuf; }
+  const auto &bonds() const { return bondbuf; }
+
+private:
+  std::vector<char> buf;     ///< Buffer for everything but bonds
+  std::vector<char> bondbuf; ///< Buffer for bond lists
+};
+
+/**
+ * @brief Non-blocking execution of a ghost communicator.
+ *
+ * The communications are split into stages, such that no communication
+ * sends a cell that is received in the same stage. All messages of a
+ * stage are in flight at the same time, and the next stage is started as
+ * soon as the previous one is complete, in @ref test or @ref wait. For the
+ * domain decomposition, every direction is one stage. Only @ref GHOST_SEND,
+ * @ref GHOST_RECV and @ref GHOST_LOCL communications and data parts with a
+ * fixed size per particle are supported (see @ref is_supported). The cells
+ * of the communicator must not be changed until the communication is
+ * complete.
+ *
+ * The buffers are kept, and every message uses a persistent MPI request,
+ * which is only recreated if the peer, the buffer or its size changed,
+ * i.e. after a resort.
+ */
+class AsyncGhostCommunicator {
+public:
+  AsyncGhostCommunicator() = default;
+  AsyncGhostCommunicator(AsyncGhostCommunicator const &) = delete;
+  AsyncGhostCommunicator &operator=(AsyncGhostCommunicator const &) = delete;
+  ~AsyncGhostCommunicator();
+
+  /** Whether the communication can be done without blocking. */
+  static bool is_supported(const GhostCommunicator &gcr,
+                           unsigned int data_parts);
+
+  /** @brief Start the communication. */
+  void begin(const GhostCommunicator &gcr, unsigned int data_parts);
+  /** @brief Make progress without blocking.
+   *  @return Whether the communication is complete.
+   */
+  bool test();
+  /** @brief Complete the communication. */
+  void wait();
+  /** Whether a communication is in progress. */
+  bool pending() const { return m_gcr != nullptr; }
+
+private:
+  /** Persistent request for the message of one communication. */
+  struct PersistentRequest {
+    MPI_Request request = MPI_REQUEST_NULL;
+    int type = GHOST_LOCL;
+    int node = -1;
+    MPI_Comm comm = MPI_COMM_NULL;
+    char *data = nullptr;
+    int size = 0;
+  };
+
+  void start_request(size_t i);
+  void post_stage();
+  void finish_stage();
+
+  const GhostCommunicator *m_gcr = nullptr;
+  unsigned int m_data_parts = 0u;
+  /** Index of the first communication of every stage, and the end. */
+  std::vector<size_t> m_stages;
+  /** Current stage */
+  size_t m_stage = 0;
+  /** Send or receive buffer of every communication */
+  std::vector<CommBuf> m_buffers;
+  /** Request of every communication */
+  std::vector<PersistentRequest> m_requests;
+  /** Active requests of the current stage */
+  std::vector<MPI_Request> m_active;
+};
+
 /*@}*/
 
 /** \name Exported Functions */
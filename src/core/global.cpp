@@ -34,6 +34,7 @@
 #include "object-in-fluid/oif_global_forces.hpp"
 #include "rattle.hpp"
 #include "thermostat.hpp"
+#include "threads.hpp"
 #include "tuning.hpp"
 
 #include <utils/mpi/all_compare.hpp>
@@ -156,6 +157,10 @@ const std::unordered_map<int, Datafield> fields{
      {brownian.gamma.data(), 3,
       "brownian.gamma"}}, /* 58  from thermostat.cpp */
 #endif // PARTICLE_ANISOTROPY
+    {FIELD_N_THREADS, {&n_threads, 1, "n_threads"}}, /* from threads.cpp */
+    {FIELD_LONG_RANGE_INTERVAL,
+     {&long_range_interval, 1,
+      "long_range_interval"}}, /* from integrate.cpp */
 };
 
 std::size_t hash_value(Datafield const &field) {
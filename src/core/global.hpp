@@ -85,6 +85,10 @@ enum Fields {
   FIELD_BROWNIAN_GAMMA,
   /** index of \ref BrownianThermostat::gamma_rotation */
   FIELD_BROWNIAN_GAMMA_ROTATION,
+  /** index of \ref n_threads */
+  FIELD_N_THREADS,
+  /** index of \ref long_range_interval */
+  FIELD_LONG_RANGE_INTERVAL,
 };
 
 /** Broadcast a global variable.
@@ -33,6 +33,8 @@
 #include <mpi.h>
 #include <utils/mpi/cart_comm.hpp>
 
+#include <algorithm>
+
 /**********************************************
  * variables
  **********************************************/
@@ -41,6 +43,10 @@ BoxGeometry box_geo;
 LocalBox<double> local_geo;
 
 Utils::Vector3i node_grid{};
+std::array<std::vector<double>, 3> node_boundaries;
+
+/** Whether @ref node_boundaries are equidistant. */
+static bool node_boundaries_regular = true;
 
 /************************************************************/
 
@@ -51,7 +57,15 @@ int map_position_node_array(const Utils::Vector3d &pos) {
 
   Utils::Vector3i im;
   for (int i = 0; i < 3; i++) {
-    im[i] = std::floor(f_pos[i] / local_geo.length()[i]);
+    if (node_boundaries_regular) {
+      im[i] = std::floor(f_pos[i] / local_geo.length()[i]);
+    } else {
+      auto const &b = node_boundaries[i];
+      auto const x = f_pos[i] / box_geo.length()[i];
+      im[i] = static_cast<int>(std::upper_bound(b.begin(), b.end(), x) -
+                               b.begin()) -
+              1;
+    }
     im[i] = boost::algorithm::clamp(im[i], 0, node_grid[i] - 1);
   }
 
@@ -89,8 +103,64 @@ LocalBox<double> regular_decomposition(const BoxGeometry &box,
   return {my_left, local_length, boundaries};
 }
 
+std::vector<double> regular_node_boundaries(int n) {
+  std::vector<double> b(n + 1);
+  for (int i = 0; i <= n; i++) {
+    b[i] = static_cast<double>(i) / n;
+  }
+
+  return b;
+}
+
+LocalBox<double> rectilinear_decomposition(
+    const BoxGeometry &box, Utils::Vector3i const &node_pos,
+    std::array<std::vector<double>, 3> const &boundaries) {
+  Utils::Vector3d my_left;
+  Utils::Vector3d my_right;
+
+  /* The corners are calculated the same way on all nodes,
+   * so that neighbors agree exactly on their common face. */
+  for (int i = 0; i < 3; i++) {
+    auto const &b = boundaries[i];
+    my_left[i] = b[node_pos[i]] * box.length()[i];
+    my_right[i] = b[node_pos[i] + 1] * box.length()[i];
+  }
+
+  Utils::Array<int, 6> local_boundaries;
+  for (int dir = 0; dir < 3; dir++) {
+    auto const n = static_cast<int>(boundaries[dir].size()) - 1;
+    /* left boundary ? */
+    local_boundaries[2 * dir] = (node_pos[dir] == 0);
+    /* right boundary ? */
+    local_boundaries[2 * dir + 1] = -(node_pos[dir] == n - 1);
+  }
+
+  return LocalBox<double>::from_corners(my_left, my_right, local_boundaries);
+}
+
+void set_node_boundaries(
+    std::array<std::vector<double>, 3> const &boundaries) {
+  node_boundaries = boundaries;
+
+  node_boundaries_regular = true;
+  for (int i = 0; i < 3; i++) {
+    if (node_boundaries[i] != regular_node_boundaries(node_grid[i]))
+      node_boundaries_regular = false;
+  }
+
+  grid_changed_box_l(box_geo);
+}
+
+bool node_grid_is_regular() { return node_boundaries_regular; }
+
 void grid_changed_box_l(const BoxGeometry &box) {
-  local_geo = regular_decomposition(box, calc_node_pos(comm_cart), node_grid);
+  if (node_boundaries_regular) {
+    local_geo =
+        regular_decomposition(box, calc_node_pos(comm_cart), node_grid);
+  } else {
+    local_geo = rectilinear_decomposition(box, calc_node_pos(comm_cart),
+                                          node_boundaries);
+  }
 }
 
 void grid_changed_n_nodes() {
@@ -101,6 +171,11 @@ void grid_changed_n_nodes() {
 
   calc_node_neighbors(comm_cart);
 
+  for (int i = 0; i < 3; i++) {
+    node_boundaries[i] = regular_node_boundaries(node_grid[i]);
+  }
+  node_boundaries_regular = true;
+
   grid_changed_box_l(box_geo);
 }
 
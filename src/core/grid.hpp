@@ -38,7 +38,10 @@
 #include <utils/Vector.hpp>
 
 #include <boost/mpi/communicator.hpp>
+
+#include <array>
 #include <limits>
+#include <vector>
 
 extern BoxGeometry box_geo;
 extern LocalBox<double> local_geo;
@@ -46,11 +49,28 @@ extern LocalBox<double> local_geo;
 /** The number of nodes in each spatial dimension. */
 extern Utils::Vector3i node_grid;
 
+/** Positions of the node boundaries in each spatial dimension as fractions
+ *  of the box length, @ref node_grid[i] + 1 increasing values from 0 to 1.
+ *  They are equidistant unless they were shifted by the load balancing.
+ */
+extern std::array<std::vector<double>, 3> node_boundaries;
+
 /** Make sure that the node grid is set, eventually
  *  determine one automatically.
  */
 void init_node_grid();
 
+/** @brief Set the node boundaries and recalculate the local box.
+ *  This is a local operation, the caller has to re-initialize the cell
+ *  system on all nodes afterwards.
+ */
+void set_node_boundaries(std::array<std::vector<double>, 3> const &boundaries);
+
+/** @brief Whether all nodes have local boxes of equal size. This is
+ *  required by the methods with a regular mesh such as P3M and LB.
+ */
+bool node_grid_is_regular();
+
 /** @brief Map a spatial position to the node grid */
 int map_position_node_array(const Utils::Vector3d &pos);
 
@@ -114,4 +134,23 @@ inline Utils::Vector3d unfolded_position(const Utils::Vector3d &pos,
 LocalBox<double> regular_decomposition(const BoxGeometry &box,
                                        Utils::Vector3i const &node_pos,
                                        Utils::Vector3i const &node_grid);
+
+/** @brief Equidistant node boundaries for @p n nodes. */
+std::vector<double> regular_node_boundaries(int n);
+
+/**
+ * @brief Composition of the simulation box into rectilinear parts, where
+ *        the nodes in the same plane of the node grid share their
+ *        boundaries in the normal direction.
+ *
+ * @param box Geometry of the simulation box
+ * @param node_pos Position of node in the node grid
+ * @param boundaries Node boundaries in each direction as fractions of the
+ *        box length, see @ref node_boundaries
+ * @return Geometry for the node
+ */
+LocalBox<double>
+rectilinear_decomposition(const BoxGeometry &box,
+                          Utils::Vector3i const &node_pos,
+                          std::array<std::vector<double>, 3> const &boundaries);
 #endif
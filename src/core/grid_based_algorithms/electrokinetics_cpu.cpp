@@ -0,0 +1,525 @@
+/*
+ * Copyright (C) 2010-2020 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/** \file
+ *  Implementation of \ref electrokinetics_cpu.hpp
+ *
+ *  All updates are written as gathers onto the local sites: a site pulls
+ *  the fluxes over its links and the advected densities of its neighbors
+ *  from the halo. A flux between two sites is computed from the same data
+ *  on both ends, so the species are conserved across MPI ranks and the
+ *  sites can be updated by the OpenMP threads independently.
+ */
+
+#include "config.hpp"
+
+#ifdef ELECTROKINETICS_CPU
+
+#include "grid_based_algorithms/electrokinetics_cpu.hpp"
+
+#include "MpiCallbacks.hpp"
+#include "communication.hpp"
+#include "electrostatics_magnetostatics/fft.hpp"
+#include "errorhandling.hpp"
+#include "grid.hpp"
+#include "grid_based_algorithms/halo.hpp"
+#include "grid_based_algorithms/lb.hpp"
+
+#include <utils/constants.hpp>
+#include <utils/index.hpp>
+#include <utils/math/int_pow.hpp>
+
+#include <boost/optional.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <array>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+using Utils::get_linear_index;
+
+/* k-space directions of the FFT output, as in p3m.cpp */
+#define KY 0
+#define KZ 1
+#define KX 2
+
+namespace {
+EKParameters ek_params;
+std::vector<EKSpecies> ek_species;
+bool ek_active = false;
+
+/** Number of ions of each species per lattice site, halo included. */
+std::vector<std::vector<double>> ek_rho;
+/** Buffer for the propagated densities. */
+std::vector<double> ek_rho_new;
+/** Electrostatic potential at the lattice sites, halo included. */
+std::vector<double> ek_potential;
+/** Boundary flags of the lattice sites, halo included. The flags are
+ *  exchanged like the other fields, since the halo of @ref lbfields is not
+ *  folded into the periodic images.
+ */
+std::vector<double> ek_boundary;
+/** Fluid displacement during one LB step in lattice units, halo included. */
+std::array<std::vector<double>, 3> ek_displacement;
+
+/** Halo communicator for a scalar field on @ref lblattice. */
+HaloCommunicator ek_halo_comm(0);
+
+fft_data_struct ek_fft;
+int ek_ks_pnum = 0;
+/** Charge density in real space, potential in k-space. */
+fft_vector<double> ek_fft_mesh;
+/** Green's function of the lattice Laplacian for the local k-space block. */
+std::vector<double> ek_greens_function;
+
+/** Links of a site to the upper half of its D3Q19 neighbors, in the order
+ *  of the GPU implementation. Faces first, then edges.
+ */
+const std::array<Utils::Vector3i, 9> ek_links = {
+    {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}, {1, 1, 0}, {1, -1, 0}, {1, 0, 1},
+     {1, 0, -1}, {0, 1, 1}, {0, 1, -1}}};
+
+bool is_boundary(Lattice::index_t index) { return ek_boundary[index] != 0.; }
+
+Lattice::index_t linear_offset(Utils::Vector3i const &c) {
+  auto const &halo_grid = lblattice.halo_grid;
+  return c[0] + halo_grid[0] * (c[1] + halo_grid[1] * c[2]);
+}
+
+void halo_exchange(std::vector<double> &field) {
+  halo_communication(&ek_halo_comm, reinterpret_cast<char *>(field.data()));
+}
+
+/** Run a kernel on all local sites, the z-planes of the lattice are
+ *  distributed over the OpenMP threads.
+ *
+ *  @param kernel  Callable as kernel(index) with the linear index of a site
+ */
+template <class Kernel> void for_each_local_site(Kernel const &kernel) {
+  auto const &grid = lblattice.grid;
+  auto const &halo_grid = lblattice.halo_grid;
+
+#ifdef OPENMP
+#pragma omp parallel for
+#endif
+  for (int z = 1; z <= grid[2]; z++) {
+    for (int y = 1; y <= grid[1]; y++) {
+      auto index = get_linear_index(1, y, z, halo_grid);
+      for (int x = 1; x <= grid[0]; x++, index++) {
+        kernel(index);
+      }
+    }
+  }
+}
+
+/** Diffusive and migrative flux of a species over the link @p l from site
+ *  @p i to site @p j during one LB step, in number of ions. The link is
+ *  closed if one of the sites belongs to a boundary.
+ */
+double link_flux(EKSpecies const &species, std::vector<double> const &rho,
+                 Lattice::index_t i, Lattice::index_t j, int l) {
+  if (is_boundary(i) or is_boundary(j)) {
+    return 0.;
+  }
+  auto const &c = ek_links[l];
+  auto const agrid = lblattice.agrid;
+  auto const length = (l < 3) ? 1. : std::sqrt(2.);
+  auto const &ext = species.ext_force_density;
+
+  auto const force =
+      species.valency * (ek_potential[i] - ek_potential[j]) /
+          (length * agrid) +
+      (c[0] * ext[0] + c[1] * ext[1] + c[2] * ext[2]) / length;
+  auto const flux = (rho[i] - rho[j]) / (length * agrid) +
+                    force * (rho[i] + rho[j]) / (2. * ek_params.T);
+
+  auto const d = species.D / (1. + 2. * std::sqrt(2.));
+  return flux * d / agrid * lbpar.tau;
+}
+
+/** Fraction of the ions of a site moved by the displacement @p d to the
+ *  neighbor at offset @p o by the volume-of-fluid advection.
+ */
+double advected_fraction(Utils::Vector3d const &d, Utils::Vector3i const &o) {
+  auto fraction = 1.;
+  for (int j = 0; j < 3; j++) {
+    if (o[j] == 0) {
+      fraction *= 1. - std::abs(d[j]);
+    } else if ((d[j] >= 0.) == (o[j] > 0)) {
+      fraction *= std::abs(d[j]);
+    } else {
+      return 0.;
+    }
+  }
+  return fraction;
+}
+
+Utils::Vector3d displacement(Lattice::index_t index) {
+  return {ek_displacement[0][index], ek_displacement[1][index],
+          ek_displacement[2][index]};
+}
+
+/** Boundary flags of the local sites from @ref lbfields, exchanged into
+ *  the halo.
+ */
+void update_boundaries() {
+#ifdef LB_BOUNDARIES
+  for_each_local_site([](Lattice::index_t index) {
+    ek_boundary[index] = (lbfields[index].boundary != 0) ? 1. : 0.;
+  });
+  halo_exchange(ek_boundary);
+#endif
+}
+
+/** Fluid displacement at the local sites from the current populations and
+ *  forces, exchanged into the halo.
+ */
+void calc_displacements() {
+  for_each_local_site([](Lattice::index_t index) {
+    Utils::Vector3d d{};
+    if (not is_boundary(index)) {
+      auto const modes = lb_calc_modes(index, lbfluid);
+      d = lb_calc_momentum_density(modes, lbfields[index].force_density) /
+          lb_calc_density(modes, lbpar);
+    }
+    for (int j = 0; j < 3; j++) {
+      ek_displacement[j][index] = d[j];
+    }
+  });
+  for (auto &field : ek_displacement) {
+    halo_exchange(field);
+  }
+}
+
+/** Propagate one species by one LB step and apply its force to the fluid.
+ *  The densities in the halo have to be up to date.
+ */
+void propagate_species(EKSpecies const &species, std::vector<double> &rho) {
+  auto const agrid = lblattice.agrid;
+  auto const force_conv = lbpar.tau * lbpar.tau / agrid;
+  auto const friction_conv =
+      (species.D > 0.) ? 0.5 * ek_params.T * lbpar.tau / species.D : 0.;
+
+  std::array<Lattice::index_t, 9> link_offsets;
+  for (int l = 0; l < 9; l++) {
+    link_offsets[l] = linear_offset(ek_links[l]);
+  }
+
+  /* the 26 neighbors for the advection */
+  std::vector<std::pair<Utils::Vector3i, Lattice::index_t>> neighbors;
+  for (int z = -1; z <= 1; z++) {
+    for (int y = -1; y <= 1; y++) {
+      for (int x = -1; x <= 1; x++) {
+        if (x != 0 or y != 0 or z != 0) {
+          Utils::Vector3i const o{x, y, z};
+          neighbors.emplace_back(o, linear_offset(o));
+        }
+      }
+    }
+  }
+
+  for_each_local_site([&](Lattice::index_t index) {
+    auto density = rho[index];
+    Utils::Vector3d force{};
+
+    for (int l = 0; l < 9; l++) {
+      auto const upper = index + link_offsets[l];
+      auto const lower = index - link_offsets[l];
+      auto const flux_out = link_flux(species, rho, index, upper, l);
+      auto const flux_in = link_flux(species, rho, lower, index, l);
+      density += flux_in - flux_out;
+      if (ek_params.fluidcoupling_ideal_contribution) {
+        /* each link pushes both of its sites */
+        auto const &c = ek_links[l];
+        for (int j = 0; j < 3; j++) {
+          force[j] += (flux_out + flux_in) * c[j] * friction_conv;
+        }
+      }
+    }
+
+    if (not ek_params.fluidcoupling_ideal_contribution) {
+      /* field from the central difference at the site, unlike the GPU
+       * kernel, which evaluates it on the links */
+      for (int j = 0; j < 3; j++) {
+        auto const offset = link_offsets[j];
+        auto const field = -species.valency *
+                           (ek_potential[index + offset] -
+                            ek_potential[index - offset]) /
+                           (2. * agrid);
+        force[j] = rho[index] * (field + species.ext_force_density[j]) *
+                   force_conv;
+      }
+    }
+
+    if (ek_params.advection) {
+      auto const d = displacement(index);
+      for (auto const &n : neighbors) {
+        auto const upper = index + n.second;
+        auto const lower = index - n.second;
+        if (not(is_boundary(index) or is_boundary(upper))) {
+          density -= rho[index] * advected_fraction(d, n.first);
+        }
+        if (not(is_boundary(lower) or is_boundary(index))) {
+          density +=
+              rho[lower] * advected_fraction(displacement(lower), n.first);
+        }
+      }
+    }
+
+    ek_rho_new[index] = density;
+    lbfields[index].force_density += force;
+  });
+
+  std::swap(rho, ek_rho_new);
+}
+
+/** Solve the Poisson equation for the charge density of the species and
+ *  exchange the potential into the halo.
+ */
+void calc_potential() {
+  auto const &grid = lblattice.grid;
+  auto const &halo_grid = lblattice.halo_grid;
+  auto const site_volume = Utils::int_pow<3>(lblattice.agrid);
+
+  for (int x = 0; x < grid[0]; x++) {
+    for (int y = 0; y < grid[1]; y++) {
+      for (int z = 0; z < grid[2]; z++) {
+        auto const index = get_linear_index(x + 1, y + 1, z + 1, halo_grid);
+        auto charge = 0.;
+        for (std::size_t s = 0; s < ek_species.size(); s++) {
+          charge += ek_species[s].valency * ek_rho[s][index];
+        }
+        ek_fft_mesh[(x * grid[1] + y) * grid[2] + z] = charge / site_volume;
+      }
+    }
+  }
+
+  fft_perform_forw(ek_fft_mesh.data(), ek_fft, comm_cart);
+  for (std::size_t i = 0; i < ek_greens_function.size(); i++) {
+    ek_fft_mesh[2 * i] *= ek_greens_function[i];
+    ek_fft_mesh[2 * i + 1] *= ek_greens_function[i];
+  }
+  fft_perform_back(ek_fft_mesh.data(), ek_fft, comm_cart);
+
+  for (int x = 0; x < grid[0]; x++) {
+    for (int y = 0; y < grid[1]; y++) {
+      for (int z = 0; z < grid[2]; z++) {
+        auto const index = get_linear_index(x + 1, y + 1, z + 1, halo_grid);
+        ek_potential[index] = ek_fft_mesh[(x * grid[1] + y) * grid[2] + z];
+      }
+    }
+  }
+  halo_exchange(ek_potential);
+}
+
+/** Set up the FFT on the local lattice sites and the Green's function of
+ *  the lattice Laplacian, which makes the potential consistent with the
+ *  finite differences of the fluxes. The k = 0 mode is dropped, i.e. the
+ *  system is neutralized by a homogeneous background.
+ */
+void init_fft() {
+  auto const &global_grid = lblattice.global_grid;
+  auto const agrid = lblattice.agrid;
+  int const margin[6] = {0, 0, 0, 0, 0, 0};
+  int mesh[3] = {global_grid[0], global_grid[1], global_grid[2]};
+  double mesh_off[3] = {0.5, 0.5, 0.5};
+
+  auto const size = fft_init(lblattice.grid, margin, mesh, mesh_off,
+                             &ek_ks_pnum, ek_fft, node_grid, comm_cart);
+  ek_fft_mesh.resize(size);
+
+  auto const &plan = ek_fft.plan[3];
+  auto const n_sites = global_grid[0] * global_grid[1] * global_grid[2];
+  auto const prefactor = -4. * Utils::pi() * ek_params.prefactor * agrid *
+                         agrid * 0.5 / n_sites;
+  ek_greens_function.resize(plan.new_size);
+
+  int ind = 0;
+  int n[3];
+  for (n[0] = plan.start[0]; n[0] < plan.start[0] + plan.new_mesh[0]; n[0]++) {
+    for (n[1] = plan.start[1]; n[1] < plan.start[1] + plan.new_mesh[1];
+         n[1]++) {
+      for (n[2] = plan.start[2]; n[2] < plan.start[2] + plan.new_mesh[2];
+           n[2]++) {
+        if (n[KX] == 0 and n[KY] == 0 and n[KZ] == 0) {
+          ek_greens_function[ind++] = 0.;
+        } else {
+          auto const cos_sum =
+              std::cos(2. * Utils::pi() * n[KX] / global_grid[0]) +
+              std::cos(2. * Utils::pi() * n[KY] / global_grid[1]) +
+              std::cos(2. * Utils::pi() * n[KZ] / global_grid[2]);
+          ek_greens_function[ind++] = prefactor / (cos_sum - 3.);
+        }
+      }
+    }
+  }
+}
+
+void mpi_ek_cpu_activate_local(EKParameters const &params,
+                               std::vector<EKSpecies> const &species) {
+  ek_params = params;
+  ek_species = species;
+  ek_active = true;
+  ek_cpu_init();
+}
+
+REGISTER_CALLBACK(mpi_ek_cpu_activate_local)
+
+void mpi_ek_cpu_deactivate_local() {
+  ek_active = false;
+  ek_species.clear();
+  ek_rho.clear();
+}
+
+REGISTER_CALLBACK(mpi_ek_cpu_deactivate_local)
+
+boost::optional<double> mpi_ek_cpu_get_density(int species,
+                                               Utils::Vector3i const &ind) {
+  if (lblattice.is_local(ind)) {
+    auto const index =
+        get_linear_index(lblattice.local_index(ind), lblattice.halo_grid);
+    return ek_rho[species][index] / Utils::int_pow<3>(lblattice.agrid);
+  }
+  return {};
+}
+
+REGISTER_CALLBACK_ONE_RANK(mpi_ek_cpu_get_density)
+
+void mpi_ek_cpu_set_density(int species, Utils::Vector3i const &ind,
+                            double density) {
+  if (lblattice.is_local(ind)) {
+    auto const index =
+        get_linear_index(lblattice.local_index(ind), lblattice.halo_grid);
+    ek_rho[species][index] = density * Utils::int_pow<3>(lblattice.agrid);
+  }
+}
+
+REGISTER_CALLBACK(mpi_ek_cpu_set_density)
+
+boost::optional<double> mpi_ek_cpu_get_potential(Utils::Vector3i const &ind) {
+  if (lblattice.is_local(ind)) {
+    auto const index =
+        get_linear_index(lblattice.local_index(ind), lblattice.halo_grid);
+    return ek_potential[index];
+  }
+  return {};
+}
+
+REGISTER_CALLBACK_ONE_RANK(mpi_ek_cpu_get_potential)
+
+void check_node_index(Utils::Vector3i const &ind) {
+  if (not ek_active) {
+    throw std::runtime_error("CPU electrokinetics is not active");
+  }
+  for (int i = 0; i < 3; i++) {
+    if (ind[i] < 0 or ind[i] >= lblattice.global_grid[i]) {
+      throw std::out_of_range("Node index out of range");
+    }
+  }
+}
+
+void check_species(int species) {
+  if (species < 0 or species >= static_cast<int>(ek_species.size())) {
+    throw std::out_of_range("Invalid electrokinetic species");
+  }
+}
+} // namespace
+
+EKParameters const &ek_cpu_parameters() { return ek_params; }
+
+std::vector<EKSpecies> const &ek_cpu_species() { return ek_species; }
+
+void mpi_ek_cpu_activate(EKParameters const &params,
+                         std::vector<EKSpecies> const &species) {
+  mpi_call_all(mpi_ek_cpu_activate_local, params, species);
+}
+
+void mpi_ek_cpu_deactivate() { mpi_call_all(mpi_ek_cpu_deactivate_local); }
+
+void ek_cpu_init() {
+  if (not ek_active) {
+    return;
+  }
+  if (not node_grid_is_regular()) {
+    runtimeErrorMsg() << "CPU electrokinetics requires a regular node grid";
+    return;
+  }
+
+  auto const volume = static_cast<std::size_t>(lblattice.halo_grid_volume);
+  auto const site_volume = Utils::int_pow<3>(lblattice.agrid);
+  ek_rho.resize(ek_species.size());
+  for (std::size_t s = 0; s < ek_species.size(); s++) {
+    ek_rho[s].assign(volume, ek_species[s].density * site_volume);
+  }
+  ek_rho_new.assign(volume, 0.);
+  ek_potential.assign(volume, 0.);
+  ek_boundary.assign(volume, 0.);
+  for (auto &field : ek_displacement) {
+    field.assign(volume, 0.);
+  }
+
+  release_halo_communication(&ek_halo_comm);
+  ek_halo_comm = HaloCommunicator(0);
+  prepare_halo_communication(&ek_halo_comm, &lblattice, FIELDTYPE_DOUBLE,
+                             MPI_DOUBLE, node_grid);
+
+  init_fft();
+  calc_potential();
+}
+
+void ek_cpu_integrate() {
+  if (not ek_active) {
+    return;
+  }
+
+  update_boundaries();
+  if (ek_params.advection) {
+    calc_displacements();
+  }
+
+  for (std::size_t s = 0; s < ek_species.size(); s++) {
+    halo_exchange(ek_rho[s]);
+    propagate_species(ek_species[s], ek_rho[s]);
+  }
+
+  calc_potential();
+}
+
+double ek_cpu_node_get_density(int species, Utils::Vector3i const &ind) {
+  check_node_index(ind);
+  check_species(species);
+  return ::Communication::mpiCallbacks().call(
+      ::Communication::Result::one_rank, mpi_ek_cpu_get_density, species, ind);
+}
+
+void ek_cpu_node_set_density(int species, Utils::Vector3i const &ind,
+                             double density) {
+  check_node_index(ind);
+  check_species(species);
+  mpi_call_all(mpi_ek_cpu_set_density, species, ind, density);
+}
+
+double ek_cpu_node_get_potential(Utils::Vector3i const &ind) {
+  check_node_index(ind);
+  return ::Communication::mpiCallbacks().call(
+      ::Communication::Result::one_rank, mpi_ek_cpu_get_potential, ind);
+}
+
+#endif // ELECTROKINETICS_CPU
@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2010-2020 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/** \file
+ *  Electrokinetics on the CPU.
+ *
+ *  The densities of the ionic species live on the sites of the CPU
+ *  lattice-Boltzmann lattice @ref lblattice and are distributed over the
+ *  MPI ranks like the fluid. Each LB step the species are propagated by
+ *  the link-centered diffusion/migration fluxes and by volume-of-fluid
+ *  advection with the fluid, and the electrostatic potential of the
+ *  resulting charge density is obtained from the Poisson equation with the
+ *  distributed FFT of @ref fft.hpp. The scheme is that of the GPU
+ *  implementation in electrokinetics_cuda.cu.
+ *
+ *  Implementation in electrokinetics_cpu.cpp.
+ */
+
+#ifndef CORE_GRID_BASED_ALGORITHMS_ELECTROKINETICS_CPU_HPP
+#define CORE_GRID_BASED_ALGORITHMS_ELECTROKINETICS_CPU_HPP
+
+#include "config.hpp"
+
+#ifdef ELECTROKINETICS_CPU
+
+#include <utils/Vector.hpp>
+
+#include <vector>
+
+/** Parameters of the CPU electrokinetics. */
+struct EKParameters {
+  /** Temperature of the ions. */
+  double T = 1.;
+  /** Electrostatic prefactor (Bjerrum length times temperature). */
+  double prefactor = 1.;
+  /** Whether the species are advected with the fluid. */
+  bool advection = true;
+  /** Whether the fluid is driven by the friction with the ions (true) or
+   *  by the electrostatic and external forces on them (false).
+   */
+  bool fluidcoupling_ideal_contribution = true;
+
+  template <class Archive> void serialize(Archive &ar, long int) {
+    ar &T &prefactor &advection &fluidcoupling_ideal_contribution;
+  }
+};
+
+/** Ionic species of the CPU electrokinetics. */
+struct EKSpecies {
+  /** Initial homogeneous number density. */
+  double density = 0.;
+  /** Diffusion coefficient. */
+  double D = 0.;
+  /** Charge number. */
+  double valency = 0.;
+  /** External force on a single ion. */
+  Utils::Vector3d ext_force_density = {};
+
+  template <class Archive> void serialize(Archive &ar, long int) {
+    ar &density &D &valency &ext_force_density;
+  }
+};
+
+/** Parameters of the active CPU electrokinetics. */
+EKParameters const &ek_cpu_parameters();
+
+/** Species of the active CPU electrokinetics. */
+std::vector<EKSpecies> const &ek_cpu_species();
+
+/** Activate the CPU electrokinetics on all nodes.
+ *  The CPU lattice-Boltzmann fluid has to be set up already. The species
+ *  start from their homogeneous densities.
+ *
+ *  @param params   Electrokinetic parameters
+ *  @param species  Ionic species
+ */
+void mpi_ek_cpu_activate(EKParameters const &params,
+                         std::vector<EKSpecies> const &species);
+
+/** Deactivate the CPU electrokinetics on all nodes. */
+void mpi_ek_cpu_deactivate();
+
+/** Reset the species to their homogeneous densities after a change of the
+ *  lattice. Called from @ref lb_init, does nothing if the electrokinetics
+ *  is inactive.
+ */
+void ek_cpu_init();
+
+/** Propagate the species by one LB time step and add their forces to
+ *  the fluid. Called before the LB collision, does nothing if the
+ *  electrokinetics is inactive.
+ */
+void ek_cpu_integrate();
+
+/** @name Node access from the head node */
+/*@{*/
+double ek_cpu_node_get_density(int species, Utils::Vector3i const &ind);
+void ek_cpu_node_set_density(int species, Utils::Vector3i const &ind,
+                             double density);
+double ek_cpu_node_get_potential(Utils::Vector3i const &ind);
+/*@}*/
+
+#endif // ELECTROKINETICS_CPU
+
+#endif
@@ -39,6 +39,8 @@
 /** Primitive fieldtypes and their initializers */
 struct _Fieldtype fieldtype_double = {0, nullptr, nullptr, sizeof(double), 0,
                                       0, 0,       false,   nullptr};
+struct _Fieldtype fieldtype_float = {0, nullptr, nullptr, sizeof(float), 0,
+                                     0, 0,       false,   nullptr};
 
 void halo_create_field_vector(int vblocks, int vstride, int vskip,
                               Fieldtype oldtype, Fieldtype *const newtype) {
@@ -35,6 +35,7 @@
 #include "errorhandling.hpp"
 #include "global.hpp"
 #include "grid.hpp"
+#include "grid_based_algorithms/electrokinetics_cpu.hpp"
 #include "grid_based_algorithms/lb_boundaries.hpp"
 #include "halo.hpp"
 #include "integrate.hpp"
@@ -52,14 +53,19 @@ using Utils::get_linear_index;
 #include <utils/memory.hpp>
 
 #include <Random123/philox.h>
-#include <boost/multi_array.hpp>
-#include <boost/range/numeric.hpp>
 #include <mpi.h>
 #include <profiler/profiler.hpp>
 
+#include <algorithm>
 #include <cassert>
 #include <cinttypes>
 #include <iostream>
+#include <memory>
+#include <utility>
+
+#ifdef OPENMP
+#include <omp.h>
+#endif
 
 namespace {
 /** Basis of the mode space as described in @cite dunweg07a */
@@ -165,19 +171,49 @@ LB_Parameters lbpar = {
 
 Lattice lblattice;
 
-using LB_FluidData = boost::multi_array<double, 2>;
-static LB_FluidData lbfluid_a;
-static LB_FluidData lbfluid_b;
+/** Storage of the populations, the @ref D3Q19::n_vel populations are
+ *  stored one after the other for the whole lattice. The memory is not
+ *  initialized on allocation, so that the pages are placed by the first
+ *  touch in @ref lb_realloc_fluid.
+ */
+using LB_FluidData = std::unique_ptr<lbPopulationFloat[]>;
+static LB_FluidData lbfluid_data;
 
 /** Pointer to the velocity populations of the fluid.
- *  lbfluid contains pre-collision populations, lbfluid_post
- *  contains post-collision.
+ *  The populations are streamed in place (see @ref lb_collide_stream),
+ *  so there is a single copy, which holds the pre-collision populations
+ *  between the updates.
  */
 LB_Fluid lbfluid;
-LB_Fluid lbfluid_post;
 
 std::vector<LB_FluidNode> lbfields;
 
+/** Runs of consecutive fluid sites along x in the local rows. The runs of
+ *  row r (y = 1 + r % grid[1], z = 1 + r / grid[1]) are
+ *  fluid_runs[fluid_run_offsets[r]] up to fluid_runs[fluid_run_offsets[r+1]],
+ *  each run is the range [first, second) of x. Set up by
+ *  @ref lb_init_fluid_nodes.
+ */
+static std::vector<std::pair<int, int>> fluid_runs;
+static std::vector<std::size_t> fluid_run_offsets;
+
+#ifdef LB_BOUNDARIES
+/** Link of a boundary site to an interior site, along which population
+ *  @p i propagates into the boundary site @p index.
+ */
+struct BoundaryLink {
+  Lattice::index_t index;
+  int i;
+};
+
+/** Links of boundary sites to interior fluid sites, in the order of
+ *  the sites.
+ */
+static std::vector<BoundaryLink> boundary_links;
+/** Links of boundary sites in the halo to interior boundary sites. */
+static std::vector<BoundaryLink> halo_boundary_links;
+#endif // LB_BOUNDARIES
+
 HaloCommunicator update_halo_comm = HaloCommunicator(0);
 
 /** measures the MD time since the last fluid update */
@@ -201,32 +237,83 @@ void lb_initialize_fields(std::vector<LB_FluidNode> &fields,
     field.boundary = false;
 #endif // LB_BOUNDARIES
   }
+  lb_init_fluid_nodes(fields, lb_lattice);
 }
 
-/** (Re-)allocate memory for the fluid and initialize pointers. */
-void lb_realloc_fluid(LB_FluidData &lb_fluid_a, LB_FluidData &lb_fluid_b,
-                      const Lattice::index_t halo_grid_volume,
-                      LB_Fluid &lb_fluid, LB_Fluid &lb_fluid_post) {
-  const std::array<int, 2> size = {{D3Q19::n_vel, halo_grid_volume}};
+/** Contiguous block of rows of the calling thread, the @p n_rows rows
+ *  are split evenly over the threads of the enclosing parallel region.
+ */
+static std::pair<int, int> lb_thread_rows(int n_rows) {
+#ifdef OPENMP
+  auto const n_parts = omp_get_num_threads();
+  auto const part = omp_get_thread_num();
+#else
+  auto const n_parts = 1;
+  auto const part = 0;
+#endif
+  return {(n_rows * part) / n_parts, (n_rows * (part + 1)) / n_parts};
+}
 
-  lb_fluid_a.resize(size);
-  lb_fluid_b.resize(size);
+/**
+ * @brief Run a kernel on all rows of lattice sites along x, halo included.
+ *
+ * The rows are distributed over @ref n_threads threads as by
+ * @ref lb_thread_rows, which is also used by @ref lb_collide_stream.
+ * Memory first touched here is thus placed close to the thread which
+ * later updates it.
+ *
+ * @param lb_lattice  Lattice instance
+ * @param kernel      Callable as kernel(index, n) with the linear index
+ *                    of the first site of a row and the number of sites.
+ */
+template <class Kernel>
+static void lb_for_each_row(Lattice const &lb_lattice, Kernel const &kernel) {
+  auto const &grid = lb_lattice.halo_grid;
+
+#ifdef OPENMP
+#pragma omp parallel
+#endif
+  {
+    auto const rows = lb_thread_rows(grid[1] * grid[2]);
+    for (int row = rows.first; row < rows.second; row++) {
+      kernel(get_linear_index(0, row % grid[1], row / grid[1], grid), grid[0]);
+    }
+  }
+}
+
+/** (Re-)allocate memory for the fluid and initialize pointers.
+ *  The populations are zeroed by the threads which update the
+ *  corresponding rows in @ref lb_collide_stream.
+ */
+void lb_realloc_fluid(LB_FluidData &lb_fluid_data, const Lattice &lb_lattice,
+                      LB_Fluid &lb_fluid) {
+  auto const volume = lb_lattice.halo_grid_volume;
+  auto const size = static_cast<std::size_t>(D3Q19::n_vel) * volume;
+
+  lb_fluid_data.reset(new lbPopulationFloat[size]);
 
   using Utils::Span;
-  for (int i = 0; i < size[0]; i++) {
-    lb_fluid[i] = Span<double>(lb_fluid_a[i].origin(), size[1]);
-    lb_fluid_post[i] = Span<double>(lb_fluid_b[i].origin(), size[1]);
+  for (int i = 0; i < D3Q19::n_vel; i++) {
+    lb_fluid[i] =
+        Span<lbPopulationFloat>(lb_fluid_data.get() + i * volume, volume);
   }
+
+  lb_for_each_row(lb_lattice, [&](Lattice::index_t index, int n) {
+    for (int i = 0; i < D3Q19::n_vel; i++) {
+      std::fill_n(lb_fluid[i].begin() + index, n, lbPopulationFloat{0});
+    }
+  });
 }
 
 void lb_set_equilibrium_populations(const Lattice &lb_lattice,
                                     const LB_Parameters &lb_parameters) {
-  for (Lattice::index_t index = 0; index < lb_lattice.halo_grid_volume;
-       ++index) {
-    lb_set_population_from_density_momentum_density_stress(
-        index, lb_parameters.density, Utils::Vector3d{} /*momentum density*/,
-        Utils::Vector6d{} /*stress*/);
-  }
+  lb_for_each_row(lb_lattice, [&](Lattice::index_t index, int n) {
+    for (auto const end = index + n; index < end; ++index) {
+      lb_set_population_from_density_momentum_density_stress(
+          index, lb_parameters.density, Utils::Vector3d{} /*momentum density*/,
+          Utils::Vector6d{} /*stress*/);
+    }
+  });
 }
 
 void lb_init(const LB_Parameters &lb_parameters) {
@@ -248,8 +335,7 @@ void lb_init(const LB_Parameters &lb_parameters) {
   }
 
   /* allocate memory for data structures */
-  lb_realloc_fluid(lbfluid_a, lbfluid_b, lblattice.halo_grid_volume, lbfluid,
-                   lbfluid_post);
+  lb_realloc_fluid(lbfluid_data, lblattice, lbfluid);
 
   lb_initialize_fields(lbfields, lbpar, lblattice);
 
@@ -264,6 +350,10 @@ void lb_init(const LB_Parameters &lb_parameters) {
 #ifdef LB_BOUNDARIES
   LBBoundaries::lb_init_boundaries();
 #endif
+
+#ifdef ELECTROKINETICS_CPU
+  ek_cpu_init();
+#endif
 }
 
 void lb_reinit_fluid(std::vector<LB_FluidNode> &lb_fields,
@@ -324,14 +414,24 @@ void lb_reinit_parameters(LB_Parameters &lb_parameters) {
   }
 }
 
+/** MPI datatype of @ref lbPopulationFloat. */
+static MPI_Datatype population_mpi_type() {
+#ifdef LB_SINGLE_PRECISION
+  return MPI_FLOAT;
+#else
+  return MPI_DOUBLE;
+#endif
+}
+
 /** Halo communication for push scheme */
 static void halo_push_communication(LB_Fluid &lb_fluid,
                                     const Lattice &lb_lattice) {
   Lattice::index_t index;
   int x, y, z, count;
   int rnode, snode;
-  double *buffer;
+  lbPopulationFloat *buffer;
   MPI_Status status;
+  auto const mpi_type = population_mpi_type();
 
   auto const yperiod = lb_lattice.halo_grid[0];
   auto const zperiod = lb_lattice.halo_grid[0] * lb_lattice.halo_grid[1];
@@ -342,8 +442,8 @@ static void halo_push_communication(LB_Fluid &lb_fluid,
    * X direction *
    ***************/
   count = 5 * lb_lattice.halo_grid[1] * lb_lattice.halo_grid[2];
-  std::vector<double> sbuf(count);
-  std::vector<double> rbuf(count);
+  std::vector<lbPopulationFloat> sbuf(count);
+  std::vector<lbPopulationFloat> rbuf(count);
 
   /* send to right, recv from left i = 1, 7, 9, 11, 13 */
   snode = node_neighbors[1];
@@ -364,8 +464,8 @@ static void halo_push_communication(LB_Fluid &lb_fluid,
     }
   }
 
-  MPI_Sendrecv(sbuf.data(), count, MPI_DOUBLE, snode, REQ_HALO_SPREAD,
-               rbuf.data(), count, MPI_DOUBLE, rnode, REQ_HALO_SPREAD,
+  MPI_Sendrecv(sbuf.data(), count, mpi_type, snode, REQ_HALO_SPREAD,
+               rbuf.data(), count, mpi_type, rnode, REQ_HALO_SPREAD,
                comm_cart, &status);
 
   buffer = rbuf.data();
@@ -402,8 +502,8 @@ static void halo_push_communication(LB_Fluid &lb_fluid,
     }
   }
 
-  MPI_Sendrecv(sbuf.data(), count, MPI_DOUBLE, snode, REQ_HALO_SPREAD,
-               rbuf.data(), count, MPI_DOUBLE, rnode, REQ_HALO_SPREAD,
+  MPI_Sendrecv(sbuf.data(), count, mpi_type, snode, REQ_HALO_SPREAD,
+               rbuf.data(), count, mpi_type, rnode, REQ_HALO_SPREAD,
                comm_cart, &status);
 
   buffer = rbuf.data();
@@ -448,8 +548,8 @@ static void halo_push_communication(LB_Fluid &lb_fluid,
     index += zperiod - lb_lattice.halo_grid[0];
   }
 
-  MPI_Sendrecv(sbuf.data(), count, MPI_DOUBLE, snode, REQ_HALO_SPREAD,
-               rbuf.data(), count, MPI_DOUBLE, rnode, REQ_HALO_SPREAD,
+  MPI_Sendrecv(sbuf.data(), count, mpi_type, snode, REQ_HALO_SPREAD,
+               rbuf.data(), count, mpi_type, rnode, REQ_HALO_SPREAD,
                comm_cart, &status);
 
   buffer = rbuf.data();
@@ -488,8 +588,8 @@ static void halo_push_communication(LB_Fluid &lb_fluid,
     index += zperiod - lb_lattice.halo_grid[0];
   }
 
-  MPI_Sendrecv(sbuf.data(), count, MPI_DOUBLE, snode, REQ_HALO_SPREAD,
-               rbuf.data(), count, MPI_DOUBLE, rnode, REQ_HALO_SPREAD,
+  MPI_Sendrecv(sbuf.data(), count, mpi_type, snode, REQ_HALO_SPREAD,
+               rbuf.data(), count, mpi_type, rnode, REQ_HALO_SPREAD,
                comm_cart, &status);
 
   buffer = rbuf.data();
@@ -534,8 +634,8 @@ static void halo_push_communication(LB_Fluid &lb_fluid,
     }
   }
 
-  MPI_Sendrecv(sbuf.data(), count, MPI_DOUBLE, snode, REQ_HALO_SPREAD,
-               rbuf.data(), count, MPI_DOUBLE, rnode, REQ_HALO_SPREAD,
+  MPI_Sendrecv(sbuf.data(), count, mpi_type, snode, REQ_HALO_SPREAD,
+               rbuf.data(), count, mpi_type, rnode, REQ_HALO_SPREAD,
                comm_cart, &status);
 
   buffer = rbuf.data();
@@ -572,8 +672,8 @@ static void halo_push_communication(LB_Fluid &lb_fluid,
     }
   }
 
-  MPI_Sendrecv(sbuf.data(), count, MPI_DOUBLE, snode, REQ_HALO_SPREAD,
-               rbuf.data(), count, MPI_DOUBLE, rnode, REQ_HALO_SPREAD,
+  MPI_Sendrecv(sbuf.data(), count, mpi_type, snode, REQ_HALO_SPREAD,
+               rbuf.data(), count, mpi_type, rnode, REQ_HALO_SPREAD,
                comm_cart, &status);
 
   buffer = rbuf.data();
@@ -611,6 +711,10 @@ void lb_sanity_checks(const LB_Parameters &lb_parameters) {
   if (cell_structure.decomposition_type() != CELL_STRUCTURE_DOMDEC) {
     runtimeErrorMsg() << "LB requires domain-decomposition cellsystem";
   }
+  if (!node_grid_is_regular()) {
+    runtimeErrorMsg() << "LB requires a regular node grid, disable the load "
+                         "balancing";
+  }
 }
 
 uint64_t lb_fluid_get_rng_state() {
@@ -646,8 +750,13 @@ void lb_prepare_communication(HaloCommunicator &halo_comm,
    * datatypes */
 
   /* prepare the communication for a single velocity */
-  prepare_halo_communication(&comm, &lb_lattice, FIELDTYPE_DOUBLE, MPI_DOUBLE,
-                             node_grid);
+#ifdef LB_SINGLE_PRECISION
+  auto const fieldtype = FIELDTYPE_FLOAT;
+#else
+  auto const fieldtype = FIELDTYPE_DOUBLE;
+#endif
+  prepare_halo_communication(&comm, &lb_lattice, fieldtype,
+                             population_mpi_type(), node_grid);
 
   halo_comm.num = comm.num;
   halo_comm.halo_info.resize(comm.num);
@@ -669,7 +778,7 @@ void lb_prepare_communication(HaloCommunicator &halo_comm,
 
     MPI_Aint lower;
     MPI_Aint extent;
-    MPI_Type_get_extent(MPI_DOUBLE, &lower, &extent);
+    MPI_Type_get_extent(population_mpi_type(), &lower, &extent);
     MPI_Type_create_hvector(D3Q19::n_vel, 1,
                             lb_lattice.halo_grid_volume * extent,
                             comm.halo_info[i].datatype, &hinfo->datatype);
@@ -677,7 +786,8 @@ void lb_prepare_communication(HaloCommunicator &halo_comm,
 
     halo_create_field_hvector(
         D3Q19::n_vel, 1,
-        static_cast<int>(lb_lattice.halo_grid_volume * sizeof(double)),
+        static_cast<int>(lb_lattice.halo_grid_volume *
+                         sizeof(lbPopulationFloat)),
         comm.halo_info[i].fieldtype, &hinfo->fieldtype);
   }
 
@@ -938,40 +1048,172 @@ std::array<T, 19> lb_calc_n_from_m(const std::array<T, 19> &modes) {
   return ret;
 }
 
-template <typename T>
-inline void lb_stream(LB_Fluid &lbfluid, Lattice::index_t index,
-                      const std::array<T, 19> &populations,
-                      const Lattice &lb_lattice) {
-  const std::array<int, 3> period = {
-      {1, lb_lattice.halo_grid[0],
-       lb_lattice.halo_grid[0] * lb_lattice.halo_grid[1]}};
-
-  for (int i = 0; i < populations.size(); i++) {
-    auto const next = index + boost::inner_product(period, D3Q19::c[i], 0);
-    lbfluid[i][next] = populations[i];
+/** Populations whose velocity points to a larger linear index, every link
+ *  between two nodes is represented by one of them and its lower node.
+ */
+static constexpr std::array<int, 9> upward_populations = {
+    {1, 3, 5, 7, 10, 11, 14, 15, 18}};
+
+/** Population with the opposite velocity. */
+static constexpr std::array<int, 19> reverse_population = {
+    {0, 2, 1, 4, 3, 6, 5, 8, 7, 10, 9, 12, 11, 14, 13, 16, 15, 18, 17}};
+
+/** Velocity of population @p i in lattice units. */
+static Utils::Vector3i lb_velocity(int i) {
+  return {static_cast<int>(D3Q19::c[i][0]), static_cast<int>(D3Q19::c[i][1]),
+          static_cast<int>(D3Q19::c[i][2])};
+}
+
+/** Difference of the linear indices of the sites linked by population
+ *  @p i.
+ */
+static Lattice::index_t lb_velocity_offset(int i,
+                                           Utils::Vector3i const &halo_grid) {
+  auto const c = lb_velocity(i);
+  return c[0] + halo_grid[0] * (c[1] + halo_grid[1] * c[2]);
+}
+
+/** Whether the site at @p pos (halo coordinates) is a halo site. */
+static bool lb_in_halo(Utils::Vector3i const &pos,
+                       Utils::Vector3i const &grid) {
+  return pos[0] < 1 or pos[0] > grid[0] or pos[1] < 1 or pos[1] > grid[1] or
+         pos[2] < 1 or pos[2] > grid[2];
+}
+
+void lb_init_fluid_nodes(std::vector<LB_FluidNode> const &lb_fields,
+                         Lattice const &lb_lattice) {
+  auto const &grid = lb_lattice.grid;
+  auto const &halo_grid = lb_lattice.halo_grid;
+  auto const is_fluid = [&lb_fields](Lattice::index_t index) {
+#ifdef LB_BOUNDARIES
+    return not lb_fields[index].boundary;
+#else
+    return true;
+#endif
+  };
+
+  fluid_runs.clear();
+  fluid_run_offsets.assign(1, 0);
+  for (int z = 1; z <= grid[2]; z++) {
+    for (int y = 1; y <= grid[1]; y++) {
+      auto const row = get_linear_index(0, y, z, halo_grid);
+      for (int x = 1; x <= grid[0];) {
+        auto const begin = x;
+        while (x <= grid[0] and is_fluid(row + x))
+          x++;
+        if (x > begin)
+          fluid_runs.emplace_back(begin, x);
+        while (x <= grid[0] and not is_fluid(row + x))
+          x++;
+      }
+      fluid_run_offsets.push_back(fluid_runs.size());
+    }
+  }
+
+#ifdef LB_BOUNDARIES
+  boundary_links.clear();
+  halo_boundary_links.clear();
+  for (int z = 0; z < halo_grid[2]; z++) {
+    for (int y = 0; y < halo_grid[1]; y++) {
+      for (int x = 0; x < halo_grid[0]; x++) {
+        auto const index = get_linear_index(x, y, z, halo_grid);
+        if (is_fluid(index))
+          continue;
+
+        Utils::Vector3i const pos{x, y, z};
+        for (int i = 0; i < D3Q19::n_vel; i++) {
+          if (lb_in_halo(pos - lb_velocity(i), grid))
+            continue;
+
+          auto const neighbor = index - lb_velocity_offset(i, halo_grid);
+          if (is_fluid(neighbor)) {
+            boundary_links.push_back({index, i});
+          } else if (lb_in_halo(pos, grid)) {
+            halo_boundary_links.push_back({index, i});
+          } else {
+            /* nothing propagates along links between interior boundary
+             * sites, they are cleared once */
+            lbfluid[reverse_population[i]][neighbor] = lbfluid[i][index] = 0;
+          }
+        }
+      }
+    }
   }
+#endif // LB_BOUNDARIES
 }
 
-/* Collisions and streaming (push scheme) */
+/**
+ * @brief Collisions and in-place streaming.
+ *
+ * Swap algorithm of @cite mattila07a with a single copy of the populations:
+ * the post-collision populations of a node are stored in the slots of the
+ * opposite velocities, and streaming along a link then amounts to
+ * swapping the slot of the lower node with the slot of the upper node.
+ * The swaps are done right after the collision of the upper node of a
+ * link, because the lower node has already been visited. Every slot
+ * belongs to exactly one link, so the threads only have to defer the links
+ * to the rows of the previous thread until that thread is done.
+ *
+ * Only the fluid nodes are visited, along the runs set up by
+ * @ref lb_init_fluid_nodes, so that the solid part of porous or channel
+ * geometries costs no work. The populations of links from the halo are
+ * fetched afterwards by @ref halo_push_communication, those of links from
+ * boundary nodes by @ref lb_bounce_back, as in the push scheme.
+ */
 inline void lb_collide_stream() {
   ESPRESSO_PROFILER_CXX_MARK_FUNCTION;
-  /* loop over all lattice cells (halo excluded) */
 #ifdef LB_BOUNDARIES
   for (auto &lbboundary : LBBoundaries::lbboundaries) {
     (*lbboundary).reset_force();
   }
 #endif // LB_BOUNDARIES
 
-  Lattice::index_t index = lblattice.halo_offset;
-  for (int z = 1; z <= lblattice.grid[2]; z++) {
-    for (int y = 1; y <= lblattice.grid[1]; y++) {
-      for (int x = 1; x <= lblattice.grid[0]; x++) {
-        // as we only want to apply this to non-boundary nodes we can throw out
-        // the if-clause if we have a non-bounded domain
+  auto const &grid = lblattice.grid;
+  auto const &halo_grid = lblattice.halo_grid;
+  auto const n_rows = grid[1] * grid[2];
+
+  std::array<Utils::Vector3i, 19> c;
+  std::array<Lattice::index_t, 19> offset;
+  for (int i = 0; i < D3Q19::n_vel; i++) {
+    c[i] = lb_velocity(i);
+    offset[i] = lb_velocity_offset(i, halo_grid);
+  }
+
+  auto const in_halo = [&grid](Utils::Vector3i const &pos) {
+    return lb_in_halo(pos, grid);
+  };
+  auto const is_boundary = [](Lattice::index_t index) {
 #ifdef LB_BOUNDARIES
-        if (!lbfields[index].boundary)
-#endif // LB_BOUNDARIES
-        {
+    return lbfields[index].boundary != 0;
+#else
+    return false;
+#endif
+  };
+  auto const swap_link = [](Lattice::index_t lower, int i,
+                            Lattice::index_t upper) {
+    std::swap(lbfluid[reverse_population[i]][lower], lbfluid[i][upper]);
+  };
+
+#ifdef OPENMP
+#pragma omp parallel
+#endif
+  {
+    auto const rows = lb_thread_rows(n_rows);
+    auto const first_row_index = [&](int row) {
+      return get_linear_index(0, 1 + row % grid[1], 1 + row / grid[1],
+                              halo_grid);
+    };
+    auto const first =
+        (rows.first < n_rows) ? first_row_index(rows.first) + 1 : 0;
+
+    for (int row = rows.first; row < rows.second; row++) {
+      auto const row_index = first_row_index(row);
+      for (auto run = fluid_run_offsets[row]; run < fluid_run_offsets[row + 1];
+           ++run) {
+        Utils::Vector3i pos{fluid_runs[run].first, 1 + row % grid[1],
+                            1 + row / grid[1]};
+        auto index = row_index + pos[0];
+        for (; pos[0] < fluid_runs[run].second; ++pos[0], ++index) {
           /* calculate modes locally */
           auto const modes = lb_calc_modes(index, lbfluid);
 
@@ -987,38 +1229,69 @@ inline void lb_collide_stream() {
               lb_apply_forces(index, thermalized_modes, lbpar, lbfields);
 
 #ifdef VIRTUAL_SITES_INERTIALESS_TRACERS
-          // Safeguard the node forces so that we can later use them for the IBM
-          // particle update
+          // Safeguard the node forces so that we can later use them for the
+          // IBM particle update
           lbfields[index].force_density_buf = lbfields[index].force_density;
 #endif
 
           /* reset the force density */
           lbfields[index].force_density = lbpar.ext_force_density;
 
+          /* transform back to populations, stored reversed */
           auto const populations = lb_calc_n_from_m(modes_with_forces);
+          for (int i = 0; i < D3Q19::n_vel; i++) {
+            lbfluid[reverse_population[i]][index] =
+                static_cast<lbPopulationFloat>(populations[i]);
+          }
 
-          /* transform back to populations and streaming */
-          lb_stream(lbfluid_post, index, populations, lblattice);
+          /* streaming along the links of which this node is the upper
+           * node, and along the links into the halo and into boundary
+           * nodes, which are not visited */
+          for (auto const i : upward_populations) {
+            auto const lower = index - offset[i];
+            auto const upper = index + offset[i];
+            if (lower >= first or in_halo(pos - c[i]) or is_boundary(lower))
+              swap_link(lower, i, index);
+            if (in_halo(pos + c[i]) or is_boundary(upper))
+              swap_link(index, i, upper);
+          }
         }
+      }
+    }
 
-        ++index; /* next node */
+#ifdef OPENMP
+#pragma omp barrier
+#endif
+
+    /* links to the rows of the previous thread */
+    auto const last_row = std::min(rows.first + grid[1] + 1, rows.second);
+    for (int row = rows.first; row < last_row; row++) {
+      auto const row_index = first_row_index(row);
+      for (auto run = fluid_run_offsets[row]; run < fluid_run_offsets[row + 1];
+           ++run) {
+        Utils::Vector3i pos{fluid_runs[run].first, 1 + row % grid[1],
+                            1 + row / grid[1]};
+        auto index = row_index + pos[0];
+        for (; pos[0] < fluid_runs[run].second; ++pos[0], ++index) {
+          for (auto const i : upward_populations) {
+            auto const lower = index - offset[i];
+            if (lower < first and not in_halo(pos - c[i]) and
+                not is_boundary(lower))
+              swap_link(lower, i, index);
+          }
+        }
       }
-      index += 2; /* skip halo region */
     }
-    index += 2 * lblattice.halo_grid[0]; /* skip halo region */
   }
 
   /* exchange halo regions */
-  halo_push_communication(lbfluid_post, lblattice);
+  halo_push_communication(lbfluid, lblattice);
 
 #ifdef LB_BOUNDARIES
   /* boundary conditions for links */
-  lb_bounce_back(lbfluid_post, lbpar, lbfields);
+  lb_bounce_back(lbfluid, lbpar, lbfields);
 #endif // LB_BOUNDARIES
 
-  /* swap the pointers for old and new population fields */
-  std::swap(lbfluid, lbfluid_post);
-
   halo_communication(&update_halo_comm,
                      reinterpret_cast<char *>(lbfluid[0].data()));
 
@@ -1040,6 +1313,10 @@ void lattice_boltzmann_update() {
   if (fluidstep >= factor) {
     fluidstep = 0;
 
+#ifdef ELECTROKINETICS_CPU
+    ek_cpu_integrate();
+#endif
+
     lb_collide_stream();
   }
 }
@@ -1345,70 +1622,33 @@ Utils::Vector6d lb_calc_pressure_tensor(std::array<double, 19> const &modes,
 #ifdef LB_BOUNDARIES
 void lb_bounce_back(LB_Fluid &lbfluid, const LB_Parameters &lb_parameters,
                     const std::vector<LB_FluidNode> &lb_fields) {
-  int k, i, l;
-  int yperiod = lblattice.halo_grid[0];
-  int zperiod = lblattice.halo_grid[0] * lblattice.halo_grid[1];
-  int next[19];
-  double population_shift;
-  next[0] = 0;                     // ( 0, 0, 0) =
-  next[1] = 1;                     // ( 1, 0, 0) +
-  next[2] = -1;                    // (-1, 0, 0)
-  next[3] = yperiod;               // ( 0, 1, 0) +
-  next[4] = -yperiod;              // ( 0,-1, 0)
-  next[5] = zperiod;               // ( 0, 0, 1) +
-  next[6] = -zperiod;              // ( 0, 0,-1)
-  next[7] = (1 + yperiod);         // ( 1, 1, 0) +
-  next[8] = -(1 + yperiod);        // (-1,-1, 0)
-  next[9] = (1 - yperiod);         // ( 1,-1, 0)
-  next[10] = -(1 - yperiod);       // (-1, 1, 0) +
-  next[11] = (1 + zperiod);        // ( 1, 0, 1) +
-  next[12] = -(1 + zperiod);       // (-1, 0,-1)
-  next[13] = (1 - zperiod);        // ( 1, 0,-1)
-  next[14] = -(1 - zperiod);       // (-1, 0, 1) +
-  next[15] = (yperiod + zperiod);  // ( 0, 1, 1) +
-  next[16] = -(yperiod + zperiod); // ( 0,-1,-1)
-  next[17] = (yperiod - zperiod);  // ( 0, 1,-1)
-  next[18] = -(yperiod - zperiod); // ( 0,-1, 1) +
-  int reverse[] = {0, 2,  1,  4,  3,  6,  5,  8,  7, 10,
-                   9, 12, 11, 14, 13, 16, 15, 18, 17};
-
-  /* bottom-up sweep */
-  for (int z = 0; z < lblattice.grid[2] + 2; z++) {
-    for (int y = 0; y < lblattice.grid[1] + 2; y++) {
-      for (int x = 0; x < lblattice.grid[0] + 2; x++) {
-        k = get_linear_index(x, y, z, lblattice.halo_grid);
-
-        if (lb_fields[k].boundary) {
-          for (i = 0; i < 19; i++) {
-            population_shift = 0;
-            for (l = 0; l < 3; l++) {
-              population_shift -= lb_parameters.density * 2 * D3Q19::c[i][l] *
-                                  D3Q19::w[i] * lb_fields[k].slip_velocity[l] /
-                                  D3Q19::c_sound_sq<double>;
-            }
-
-            if (x - D3Q19::c[i][0] > 0 &&
-                x - D3Q19::c[i][0] < lblattice.grid[0] + 1 &&
-                y - D3Q19::c[i][1] > 0 &&
-                y - D3Q19::c[i][1] < lblattice.grid[1] + 1 &&
-                z - D3Q19::c[i][2] > 0 &&
-                z - D3Q19::c[i][2] < lblattice.grid[2] + 1) {
-              if (!lb_fields[k - next[i]].boundary) {
-                for (l = 0; l < 3; l++) {
-                  (*LBBoundaries::lbboundaries[lb_fields[k].boundary - 1])
-                      .force()[l] += // TODO
-                      (2 * lbfluid[i][k] + population_shift) * D3Q19::c[i][l];
-                }
-                lbfluid[reverse[i]][k - next[i]] =
-                    lbfluid[i][k] + population_shift;
-              } else {
-                lbfluid[reverse[i]][k - next[i]] = lbfluid[i][k] = 0.0;
-              }
-            }
-          }
-        }
-      }
+  auto const &halo_grid = lblattice.halo_grid;
+
+  for (auto const &link : boundary_links) {
+    auto const k = link.index;
+    auto const i = link.i;
+    auto const &node = lb_fields[k];
+
+    double population_shift = 0;
+    for (int l = 0; l < 3; l++) {
+      population_shift -= lb_parameters.density * 2 * D3Q19::c[i][l] *
+                          D3Q19::w[i] * node.slip_velocity[l] /
+                          D3Q19::c_sound_sq<double>;
+    }
+
+    auto &force = (*LBBoundaries::lbboundaries[node.boundary - 1]).force();
+    for (int l = 0; l < 3; l++) {
+      force[l] += (2 * lbfluid[i][k] + population_shift) * D3Q19::c[i][l];
     }
+    lbfluid[reverse_population[i]][k - lb_velocity_offset(i, halo_grid)] =
+        static_cast<lbPopulationFloat>(lbfluid[i][k] + population_shift);
+  }
+
+  for (auto const &link : halo_boundary_links) {
+    auto const k = link.index;
+    auto const i = link.i;
+    lbfluid[reverse_population[i]][k - lb_velocity_offset(i, halo_grid)] =
+        lbfluid[i][k] = 0;
   }
 }
 #endif
@@ -143,11 +143,19 @@ void lb_reinit_fluid(std::vector<LB_FluidNode> &lb_fields,
                      const LB_Parameters &lb_parameters);
 
 void lb_reinit_parameters(LB_Parameters &lb_parameters);
+#ifdef LB_SINGLE_PRECISION
+/** Floating point type of the stored populations. */
+using lbPopulationFloat = float;
+#else
+/** Floating point type of the stored populations. */
+using lbPopulationFloat = double;
+#endif
+
 /** Pointer to the velocity populations of the fluid.
- *  lbfluid contains pre-collision populations, lbfluid_post
- *  contains post-collision populations
+ *  lbfluid contains the pre-collision populations, the update streams
+ *  in place.
  */
-using LB_Fluid = std::array<Utils::Span<double>, 19>;
+using LB_Fluid = std::array<Utils::Span<lbPopulationFloat>, 19>;
 extern LB_Fluid lbfluid;
 
 class LB_Fluid_Ref {
@@ -254,6 +262,8 @@ void lb_prepare_communication(HaloCommunicator &halo_comm,
  * The populations that have propagated into a boundary node
  * are bounced back to the node they came from. This results
  * in no slip boundary conditions, cf. @cite ladd01a.
+ * Only the links between boundary and fluid nodes listed by
+ * @ref lb_init_fluid_nodes are visited.
  */
 void lb_bounce_back(LB_Fluid &lbfluid, const LB_Parameters &lb_parameters,
                     const std::vector<LB_FluidNode> &lb_fields);
@@ -267,6 +277,16 @@ void lb_collect_boundary_forces(double *result);
 void lb_initialize_fields(std::vector<LB_FluidNode> &fields,
                           LB_Parameters const &lb_parameters,
                           Lattice const &lb_lattice);
+
+/** Set up the lists of fluid nodes and of boundary links which are visited
+ *  by the fluid update, from the boundary flags of the nodes. Has to be
+ *  called whenever the flags change, the populations on links between
+ *  boundary nodes are cleared.
+ *  @param lb_fields   Fluid nodes
+ *  @param lb_lattice  Lattice instance
+ */
+void lb_init_fluid_nodes(std::vector<LB_FluidNode> const &lb_fields,
+                         Lattice const &lb_lattice);
 void lb_on_param_change(LBParam param);
 
 /*@}*/
@@ -249,6 +249,7 @@ void lb_init_boundaries() {
         }
       }
     }
+    lb_init_fluid_nodes(lbfields, lblattice);
 #endif
   }
 }
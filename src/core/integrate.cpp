@@ -43,12 +43,14 @@
 #include "grid.hpp"
 #include "grid_based_algorithms/lb_interface.hpp"
 #include "grid_based_algorithms/lb_particle_coupling.hpp"
+#include "load_balance.hpp"
 #include "nonbonded_interactions/nonbonded_interaction_data.hpp"
 #include "npt.hpp"
 #include "rattle.hpp"
 #include "rotation.hpp"
 #include "signalhandling.hpp"
 #include "thermostat.hpp"
+#include "tuning.hpp"
 #include "virtual_sites.hpp"
 
 #include "integrators/brownian_inline.hpp"
@@ -76,6 +78,8 @@ int n_verlet_updates = 0;
 
 double time_step = -1.0;
 
+int long_range_interval = 1;
+
 double sim_time = 0.0;
 double skin = 0.0;
 bool skin_set = false;
@@ -92,6 +96,40 @@ void notify_sig_int() {
   ctrl_C = 0;              // reset
   set_py_interrupt = true; // global to notify Python
 }
+
+/** Number of time steps since the long-range forces were last evaluated. */
+int long_range_step = 0;
+
+/** @brief Weight of the long-range forces in the next force calculation.
+ *
+ *  With multiple time stepping, the long-range forces are only evaluated
+ *  every @ref long_range_interval steps, and are then applied as an impulse
+ *  for all of these steps (r-RESPA). Since the velocity Verlet integrator
+ *  applies the force of a step in two half kicks, scaling it by the
+ *  interval gives exactly the impulse of the outer time step.
+ *
+ *  @param initial  Whether this is the initial force calculation, which
+ *                  restarts the cycle.
+ *  @return 0 to skip the long-range forces, otherwise the factor by
+ *          which they are multiplied.
+ */
+int long_range_weight(bool initial) {
+  if (integ_switch != INTEG_METHOD_NVT or long_range_interval == 1)
+    return 1;
+  long_range_step = initial ? 0 : (long_range_step + 1) % long_range_interval;
+  return (long_range_step == 0) ? long_range_interval : 0;
+}
+
+/** @brief Set the number of time steps between two evaluations of the
+ *  long-range forces. Stored forces are invalidated on change, since their
+ *  long-range part might be weighted.
+ */
+void set_long_range_interval(int interval) {
+  if (interval != long_range_interval) {
+    long_range_interval = interval;
+    mpi_bcast_parameter(FIELD_LONG_RANGE_INTERVAL);
+  }
+}
 } // namespace
 
 /** Thermostats increment the RNG counter here. */
@@ -101,6 +139,19 @@ void integrator_sanity_checks() {
   if (time_step < 0.0) {
     runtimeErrorMsg() << "time_step not set";
   }
+  if (integ_switch == INTEG_METHOD_NVT and long_range_interval > 1) {
+    /* The forces of the actors and the GPU methods are added
+     * outside of calc_long_range_forces(), so they would be
+     * applied in every step without weight. */
+    auto gpu_method = false;
+#if defined(ELECTROSTATICS) && defined(CUDA)
+    gpu_method |= (coulomb.method == COULOMB_P3M_GPU);
+#endif
+    if (not forceActors.empty() or gpu_method) {
+      runtimeErrorMsg() << "A long-range interval larger than 1 is not "
+                           "supported by the active long-range method";
+    }
+  }
 }
 
 /** @brief Calls the hook for propagation kernels before the force calculation
@@ -190,7 +241,7 @@ int integrate(int n_steps, int reuse_forces) {
     // Communication step: distribute ghost positions
     cells_update_ghosts(global_ghost_flags());
 
-    force_calc(cell_structure);
+    force_calc(cell_structure, long_range_weight(true));
 
     if (integ_switch != INTEG_METHOD_STEEPEST_DESCENT) {
 #ifdef ROTATION
@@ -216,6 +267,7 @@ int integrate(int n_steps, int reuse_forces) {
   int integrated_steps = 0;
   for (int step = 0; step < n_steps; step++) {
     ESPRESSO_PROFILER_CXX_MARK_LOOP_ITERATION(integration_loop, step);
+    auto const step_start = MPI_Wtime();
 
     auto particles = cell_structure.local_particles();
 
@@ -243,12 +295,13 @@ int integrate(int n_steps, int reuse_forces) {
     virtual_sites()->update();
 #endif
 
-    // Communication step: distribute ghost positions
-    cells_update_ghosts(global_ghost_flags());
+    // Communication step: distribute ghost positions, this may
+    // overlap with the force calculation.
+    cells_update_ghosts_begin(global_ghost_flags());
 
     particles = cell_structure.local_particles();
 
-    force_calc(cell_structure);
+    force_calc(cell_structure, long_range_weight(false));
 
 #ifdef VIRTUAL_SITES
     virtual_sites()->after_force_calc();
@@ -277,6 +330,9 @@ int integrate(int n_steps, int reuse_forces) {
 
     integrated_steps++;
 
+    adaptive_skin_update(MPI_Wtime() - step_start);
+    load_balance_update();
+
     if (check_runtime_errors(comm_cart))
       break;
 
@@ -412,17 +468,25 @@ int integrate_set_steepest_descent(const double f_max, const double gamma,
     return ES_ERROR;
   }
   steepest_descent_init(f_max, gamma, max_steps, max_displacement);
+  set_long_range_interval(1);
   integ_switch = INTEG_METHOD_STEEPEST_DESCENT;
   mpi_bcast_parameter(FIELD_INTEG_SWITCH);
   return ES_OK;
 }
 
-void integrate_set_nvt() {
+int integrate_set_nvt(int interval) {
+  if (interval < 1) {
+    runtimeErrorMsg() << "The long-range interval must be positive.\n";
+    return ES_ERROR;
+  }
+  set_long_range_interval(interval);
   integ_switch = INTEG_METHOD_NVT;
   mpi_bcast_parameter(FIELD_INTEG_SWITCH);
+  return ES_OK;
 }
 
 void integrate_set_bd() {
+  set_long_range_interval(1);
   integ_switch = INTEG_METHOD_BD;
   mpi_bcast_parameter(FIELD_INTEG_SWITCH);
 }
@@ -432,6 +496,7 @@ int integrate_set_sd() {
     runtimeErrorMsg() << "Stokesian Dynamics requires periodicity 0 0 0\n";
     return ES_ERROR;
   }
+  set_long_range_interval(1);
   integ_switch = INTEG_METHOD_SD;
   mpi_bcast_parameter(FIELD_INTEG_SWITCH);
   return ES_OK;
@@ -497,6 +562,7 @@ int integrate_set_npt_isotropic(double ext_pressure, double piston,
   }
 
   /* set integrator switch */
+  set_long_range_interval(1);
   integ_switch = INTEG_METHOD_NPT_ISO;
   mpi_bcast_parameter(FIELD_INTEG_SWITCH);
   mpi_bcast_parameter(FIELD_NPTISO_PISTON);
@@ -42,6 +42,11 @@ extern int n_verlet_updates;
 /** Time step for the integration. */
 extern double time_step;
 
+/** Number of time steps between two evaluations of the long-range forces
+ *  by the velocity Verlet integrator (r-RESPA multiple time stepping).
+ */
+extern int long_range_interval;
+
 /** Actual simulation time (only on MASTER NODE). */
 extern double sim_time;
 /** Verlet list skin. */
@@ -118,8 +123,13 @@ int python_integrate(int n_steps, bool recalc_forces, bool reuse_forces);
 int integrate_set_steepest_descent(double f_max, double gamma, int max_steps,
                                    double max_displacement);
 
-/** @brief Set the velocity Verlet integrator for the NVT ensemble. */
-void integrate_set_nvt();
+/** @brief Set the velocity Verlet integrator for the NVT ensemble.
+ *  @param interval  Number of time steps between two evaluations of the
+ *                   long-range forces
+ *  @retval ES_OK on success
+ *  @retval ES_ERROR on error
+ */
+int integrate_set_nvt(int interval);
 
 /** @brief Set the Brownian Dynamics integrator. */
 void integrate_set_bd();
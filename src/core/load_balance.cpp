@@ -0,0 +1,223 @@
+/*
+ * Copyright (C) 2020 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/** \file
+ *  Implementation of load_balance.hpp.
+ */
+#include "load_balance.hpp"
+#include "cells.hpp"
+#include "communication.hpp"
+#include "electrostatics_magnetostatics/coulomb.hpp"
+#include "electrostatics_magnetostatics/dipole.hpp"
+#include "global.hpp"
+#include "grid.hpp"
+#include "grid_based_algorithms/lb_interface.hpp"
+#include "integrate.hpp"
+
+#include <utils/mpi/cart_comm.hpp>
+
+#include <boost/mpi/collectives/all_gather.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+
+std::vector<double>
+balance_node_boundaries(std::vector<double> const &boundaries,
+                        std::vector<double> const &loads, double min_width,
+                        double damping) {
+  auto const n = static_cast<int>(loads.size());
+  assert(boundaries.size() == loads.size() + 1);
+
+  auto const total = std::accumulate(loads.begin(), loads.end(), 0.);
+  if (total <= 0. or n * min_width > 1.)
+    return boundaries;
+
+  auto new_boundaries = boundaries;
+
+  /* Invert the piecewise linear cumulative load at the
+   * multiples of the mean load per slab. */
+  int k = 0;
+  double cum = 0.;
+  for (int j = 1; j < n; j++) {
+    auto const target = total * j / n;
+    while (k < n - 1 and cum + loads[k] < target) {
+      cum += loads[k++];
+    }
+    auto const width = boundaries[k + 1] - boundaries[k];
+    auto const frac =
+        (loads[k] > 0.) ? std::min((target - cum) / loads[k], 1.) : 0.;
+    auto const pos = boundaries[k] + frac * width;
+
+    new_boundaries[j] = boundaries[j] + damping * (pos - boundaries[j]);
+  }
+
+  /* Enforce the minimal width from both sides, this
+   * is always possible because n * min_width <= 1. */
+  for (int j = 1; j < n; j++) {
+    new_boundaries[j] =
+        std::max(new_boundaries[j], new_boundaries[j - 1] + min_width);
+  }
+  for (int j = n - 1; j > 0; j--) {
+    new_boundaries[j] =
+        std::min(new_boundaries[j], new_boundaries[j + 1] - min_width);
+  }
+
+  return new_boundaries;
+}
+
+namespace {
+LoadBalanceParameters load_balance_params;
+
+/** State of the load balancing, the window is identical on all nodes. */
+struct LoadBalanceState {
+  /** Force calculation time of this node in the current window. */
+  double time = 0.;
+  /** Number of steps in the current window. */
+  int steps = 0;
+  /** Imbalance measured in the last window. */
+  double imbalance = 0.;
+} load_balance_state;
+
+/** Whether the active methods allow for irregular node boundaries. */
+bool load_balance_possible() {
+  if (cell_structure.decomposition_type() != CELL_STRUCTURE_DOMDEC)
+    return false;
+
+  if (lattice_switch != ActiveLB::NONE)
+    return false;
+
+#ifdef ELECTROSTATICS
+  switch (coulomb.method) {
+  case COULOMB_P3M:
+  case COULOMB_P3M_GPU:
+  case COULOMB_ELC_P3M:
+    return false;
+  default:
+    break;
+  }
+#endif
+
+#ifdef DIPOLES
+  switch (dipole.method) {
+  case DIPOLAR_P3M:
+  case DIPOLAR_MDLC_P3M:
+    return false;
+  default:
+    break;
+  }
+#endif
+
+  return true;
+}
+
+/** Re-initialize the cell system for new node boundaries, keeping the
+ *  forces, which do not depend on the decomposition.
+ */
+void apply_node_boundaries(
+    std::array<std::vector<double>, 3> const &boundaries) {
+  auto const recalc = recalc_forces;
+  set_node_boundaries(boundaries);
+  cells_re_init(cell_structure.decomposition_type());
+  recalc_forces = recalc;
+}
+} // namespace
+
+LoadBalanceParameters const &load_balance_parameters() {
+  return load_balance_params;
+}
+
+double load_imbalance() { return load_balance_state.imbalance; }
+
+void mpi_set_load_balance_local(int interval, double threshold,
+                                double damping) {
+  load_balance_params.interval = interval;
+  load_balance_params.threshold = threshold;
+  load_balance_params.damping = damping;
+  load_balance_state = LoadBalanceState{};
+
+  if (interval <= 0 and not node_grid_is_regular()) {
+    std::array<std::vector<double>, 3> boundaries;
+    for (int i = 0; i < 3; i++) {
+      boundaries[i] = regular_node_boundaries(node_grid[i]);
+    }
+    apply_node_boundaries(boundaries);
+  }
+}
+
+REGISTER_CALLBACK(mpi_set_load_balance_local)
+
+void mpi_set_load_balance(LoadBalanceParameters const &params) {
+  mpi_call_all(mpi_set_load_balance_local, params.interval, params.threshold,
+               params.damping);
+}
+
+void load_balance_add_sample(double time) {
+  if (load_balance_params.interval > 0)
+    load_balance_state.time += time;
+}
+
+void load_balance_update() {
+  auto const &params = load_balance_params;
+  auto &state = load_balance_state;
+
+  if (params.interval <= 0)
+    return;
+
+  if (++state.steps < params.interval)
+    return;
+
+  std::vector<double> times;
+  boost::mpi::all_gather(comm_cart, state.time, times);
+  state.time = 0.;
+  state.steps = 0;
+
+  auto const total = std::accumulate(times.begin(), times.end(), 0.);
+  if (total <= 0.)
+    return;
+
+  auto const mean = total / static_cast<double>(times.size());
+  state.imbalance = *std::max_element(times.begin(), times.end()) / mean - 1.;
+
+  if (state.imbalance <= params.threshold or comm_cart.size() == 1 or
+      not load_balance_possible())
+    return;
+
+  /* Slabs have to be at least one cell wide, and
+   * must not degenerate without interactions. */
+  auto const range = std::max(interaction_range(), 0.);
+
+  auto boundaries = node_boundaries;
+  for (int dir = 0; dir < 3; dir++) {
+    if (node_grid[dir] == 1)
+      continue;
+
+    std::vector<double> loads(node_grid[dir], 0.);
+    for (int rank = 0; rank < comm_cart.size(); rank++) {
+      auto const pos = Utils::Mpi::cart_coords<3>(comm_cart, rank);
+      loads[pos[dir]] += times[rank];
+    }
+
+    auto const min_width =
+        std::max(range / box_geo.length()[dir], 0.1 / node_grid[dir]);
+    boundaries[dir] = balance_node_boundaries(node_boundaries[dir], loads,
+                                              min_width, params.damping);
+  }
+
+  apply_node_boundaries(boundaries);
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2020 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/** \file
+ *  Dynamic load balancing of the domain decomposition.
+ *
+ *  The node boundaries of the domain decomposition (@ref node_boundaries)
+ *  are shifted during @ref integrate such that all nodes spend about the
+ *  same time in the short-range force calculation. The boundaries of a
+ *  plane of the node grid are shifted together, so every node keeps its
+ *  neighbors and the ghost communication only changes in the sizes of the
+ *  exchanged cells.
+ *
+ *  Implementation in load_balance.cpp.
+ */
+
+#ifndef ESPRESSO_LOAD_BALANCE_HPP
+#define ESPRESSO_LOAD_BALANCE_HPP
+
+#include <vector>
+
+/** Parameters of the dynamic load balancing. */
+struct LoadBalanceParameters {
+  /** Number of integration steps per timing window, 0 disables balancing. */
+  int interval = 0;
+  /** Relative imbalance of the force calculation time above which the
+   *  node boundaries are shifted.
+   */
+  double threshold = 0.1;
+  /** Fraction of the estimated shift of the boundaries applied per window. */
+  double damping = 0.5;
+};
+
+/** Parameters of the dynamic load balancing. */
+LoadBalanceParameters const &load_balance_parameters();
+
+/** Set the parameters of the dynamic load balancing on all nodes.
+ *  Disabling the load balancing restores the regular decomposition.
+ */
+void mpi_set_load_balance(LoadBalanceParameters const &params);
+
+/** Relative imbalance of the short-range force calculation time,
+ *  i.e. the maximum over the mean of the node times minus one, as measured
+ *  in the last timing window.
+ */
+double load_imbalance();
+
+/** Account for the time spent in the short-range force calculation on this
+ *  node, called by @ref force_calc.
+ *
+ *  @param time  Wall time in seconds.
+ */
+void load_balance_add_sample(double time);
+
+/** Dynamic load balancing, called by @ref integrate after every step on all
+ *  nodes.
+ *
+ *  At the end of each window of @ref LoadBalanceParameters::interval steps,
+ *  the times of all nodes are gathered. If the imbalance exceeds
+ *  @ref LoadBalanceParameters::threshold, the time of every plane of the
+ *  node grid is used to move the node boundaries in the normal direction
+ *  towards an equal split of the work (see @ref balance_node_boundaries),
+ *  and the cell system is re-initialized. Nothing is done for other cell
+ *  systems than the domain decomposition, and while methods that require
+ *  a regular decomposition (P3M, LB) are active. This is collective.
+ */
+void load_balance_update();
+
+/** @brief New node boundaries in one direction from the measured loads.
+ *
+ *  The load is assumed to be evenly distributed within every slab. The new
+ *  boundaries split the total load into equal parts, and are moved from
+ *  the old ones by the fraction @p damping of this shift. The slabs do not
+ *  become narrower than @p min_width, the boundaries are left unchanged if
+ *  this is impossible.
+ *
+ *  @param boundaries  Old boundaries, increasing from 0 to 1.
+ *  @param loads       Load of each slab, one less than boundaries.
+ *  @param min_width   Smallest permissible slab width.
+ *  @param damping     Fraction of the shift to apply, in (0, 1].
+ *  @return New boundaries.
+ */
+std::vector<double>
+balance_node_boundaries(std::vector<double> const &boundaries,
+                        std::vector<double> const &loads, double min_width,
+                        double damping);
+
+#endif
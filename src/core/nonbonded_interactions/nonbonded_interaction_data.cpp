@@ -45,6 +45,7 @@
  *****************************************/
 int max_seen_particle_type = 0;
 std::vector<IA_parameters> ia_params;
+BatchedIAParameters batched_ia_params;
 
 double min_global_cut = INACTIVE_CUTOFF;
 
@@ -178,6 +179,50 @@ static double recalc_maximal_cutoff(const IA_parameters &data) {
   return max_cut_current;
 }
 
+void update_batched_ia_params() {
+  auto const n_types = max_seen_particle_type;
+  auto const n_pairs = static_cast<std::size_t>(n_types * n_types);
+  auto &params = batched_ia_params;
+
+  params.n_types = n_types;
+  params.batchable.assign(n_pairs, 0);
+  params.lj_eps.assign(n_pairs, 0.);
+  params.lj_sig.assign(n_pairs, 0.);
+  params.lj_offset.assign(n_pairs, 0.);
+  params.lj_r_min.assign(n_pairs, 0.);
+  params.lj_r_max.assign(n_pairs, INACTIVE_CUTOFF);
+  params.wca_eps.assign(n_pairs, 0.);
+  params.wca_sig.assign(n_pairs, 0.);
+  params.wca_cut.assign(n_pairs, INACTIVE_CUTOFF);
+
+  for (int i = 0; i < n_types; i++) {
+    for (int j = 0; j < n_types; j++) {
+      auto const &data = *get_ia_param(i, j);
+      auto const index = i * n_types + j;
+      /* Copy without the batched potentials, to check
+       * if any other potential is active. */
+      auto rest = data;
+
+#ifdef LENNARD_JONES
+      params.lj_eps[index] = data.lj.eps;
+      params.lj_sig[index] = data.lj.sig;
+      params.lj_offset[index] = data.lj.offset;
+      params.lj_r_min[index] = data.lj.min + data.lj.offset;
+      params.lj_r_max[index] = data.lj.cut + data.lj.offset;
+      rest.lj = {};
+#endif
+#ifdef WCA
+      params.wca_eps[index] = data.wca.eps;
+      params.wca_sig[index] = data.wca.sig;
+      params.wca_cut[index] = data.wca.cut;
+      rest.wca = {};
+#endif
+
+      params.batchable[index] = (recalc_maximal_cutoff(rest) <= 0.);
+    }
+  }
+}
+
 double maximal_cutoff_nonbonded() {
   auto max_cut_nonbonded = INACTIVE_CUTOFF;
 
@@ -223,6 +268,7 @@ void realloc_ia_params(int nsize) {
 
   max_seen_particle_type = nsize;
   std::swap(ia_params, new_params);
+  update_batched_ia_params();
 }
 
 void reset_ia_params() {
@@ -268,6 +268,23 @@ struct IA_parameters {
 
 extern std::vector<IA_parameters> ia_params;
 
+/** Parameters of the potentials that are evaluated in batches on the
+ *  structure-of-arrays particle copies. The entries for the type pair
+ *  (i, j) are stored at index i * n_types + j, so that the parameters
+ *  of one type with all partner types are contiguous. The table is
+ *  rebuilt by @ref update_batched_ia_params.
+ */
+struct BatchedIAParameters {
+  int n_types = 0;
+  /** Non-zero if Lennard-Jones and WCA are the only
+   *  active potentials of the type pair. */
+  std::vector<char> batchable;
+  std::vector<double> lj_eps, lj_sig, lj_offset, lj_r_min, lj_r_max;
+  std::vector<double> wca_eps, wca_sig, wca_cut;
+};
+
+extern BatchedIAParameters batched_ia_params;
+
 /************************************************
  * exported variables
  ************************************************/
@@ -279,6 +296,12 @@ extern int max_seen_particle_type;
  *  interactions).
  */
 double maximal_cutoff_nonbonded();
+
+/** Rebuild @ref batched_ia_params from the local @ref ia_params.
+ *  Has to be called whenever the non-bonded parameters or the
+ *  number of particle types change.
+ */
+void update_batched_ia_params();
 /** Maximal interaction cutoff (bonded interactions).
  */
 double maximal_cutoff_bonded();
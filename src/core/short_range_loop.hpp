@@ -19,15 +19,23 @@
 #ifndef CORE_SHORT_RANGE_HPP
 #define CORE_SHORT_RANGE_HPP
 
+#include "config.hpp"
+
 #include "algorithm/for_each_pair.hpp"
+#include "algorithm/link_cell_batched.hpp"
 #include "cells.hpp"
 #include "grid.hpp"
 #include "integrate.hpp"
+#include "threads.hpp"
 
 #include <boost/iterator/indirect_iterator.hpp>
 #include <profiler/profiler.hpp>
+#include <utils/math/sqr.hpp>
 
+#include <algorithm>
+#include <iterator>
 #include <utility>
+#include <vector>
 
 /**
  * @brief Distance vector and length handed to pair kernels.
@@ -63,30 +71,186 @@ template <typename CellIterator, typename ParticleKernel, typename PairKernel,
           typename VerletCriterion>
 void decide_distance(CellIterator first, CellIterator last,
                      ParticleKernel &&particle_kernel, PairKernel &&pair_kernel,
-                     VerletCriterion &&verlet_criterion) {
+                     VerletCriterion &&verlet_criterion,
+                     bool self_pairs = true) {
   if (cell_structure.minimum_image_distance()) {
     Algorithm::for_each_pair(
         first, last, std::forward<ParticleKernel>(particle_kernel),
         std::forward<PairKernel>(pair_kernel), MinimalImageDistance{box_geo},
         std::forward<VerletCriterion>(verlet_criterion),
-        cell_structure.use_verlet_list, rebuild_verletlist);
+        cell_structure.use_verlet_list, rebuild_verletlist, self_pairs);
   } else {
     Algorithm::for_each_pair(
         first, last, std::forward<ParticleKernel>(particle_kernel),
         std::forward<PairKernel>(pair_kernel), EuclidianDistance{},
         std::forward<VerletCriterion>(verlet_criterion),
-        cell_structure.use_verlet_list, rebuild_verletlist);
+        cell_structure.use_verlet_list, rebuild_verletlist, self_pairs);
   }
 }
 
+/**
+ * @brief Run the pair kernel for the pairs between ghost cells, see
+ *        @ref CellStructure::interacting_ghost_cells. The ghosts have
+ *        to be up to date.
+ */
+template <typename PairKernel, typename VerletCriterion>
+void ghost_pair_loop(PairKernel &pair_kernel,
+                     VerletCriterion const &verlet_criterion) {
+  auto const cells = cell_structure.interacting_ghost_cells();
+
+  decide_distance(boost::make_indirect_iterator(cells.begin()),
+                  boost::make_indirect_iterator(cells.end()),
+                  [](Particle &) {}, pair_kernel, verlet_criterion, false);
+}
+
 /**
  * @brief Functor that returns true for any argument.
  */
 struct True {
   template <class... T> bool operator()(T...) const { return true; }
 };
+
+/**
+ * @brief Run a loop over cells concurrently on groups of independent cells.
+ *
+ * The groups are processed one after another, the cells within
+ * a group are distributed over the threads. Because the neighborhoods
+ * of the cells in a group do not overlap, no two threads write
+ * to the same particle. The cell loop is called with an iterator
+ * range over a single cell.
+ */
+template <typename CellLoop>
+void parallel_cell_loop(std::vector<Cell *> const &cells,
+                        CellLoop const &cell_loop) {
+  auto const n_cells = static_cast<int>(cells.size());
+#ifdef OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+  for (int i = 0; i < n_cells; i++) {
+    auto const first = boost::make_indirect_iterator(cells.begin() + i);
+
+    cell_loop(first, std::next(first));
+  }
+}
+
+template <typename CellLoop>
+void colored_cell_loop(std::vector<std::vector<Cell *>> const &colors,
+                       CellLoop const &cell_loop) {
+  for (auto const &color : colors) {
+    parallel_cell_loop(color, cell_loop);
+  }
+}
+
+/**
+ * @brief Run a loop over the local cells while a ghost update started
+ *        by @ref CellStructure::ghosts_update_begin is in flight.
+ *
+ * The cell loop is first run on the cells whose pairs do not involve
+ * ghost cells, checking for progress of the communication in between.
+ * Then the ghost update is completed, @p ghosts_ready is called, and the
+ * cell loop is run on the remaining cells.
+ *
+ * @param parallel Run the cell loop concurrently on independent
+ *        cells, see @ref colored_cell_loop.
+ * @param cell_loop Loop over an iterator range of cells.
+ * @param ghosts_ready Called once the ghosts are up to date.
+ */
+template <typename CellLoop, typename GhostsReady>
+void overlapped_cell_loop(bool parallel, CellLoop const &cell_loop,
+                          GhostsReady const &ghosts_ready) {
+  auto const border_cells = cell_structure.border_cells();
+  auto const is_border = [&border_cells](Cell *c) {
+    return std::binary_search(border_cells.begin(), border_cells.end(), c);
+  };
+
+  if (parallel) {
+    std::vector<std::vector<Cell *>> interior_colors, border_colors;
+    for (auto const &color : cell_structure.cell_colors()) {
+      interior_colors.emplace_back();
+      border_colors.emplace_back();
+      std::partition_copy(color.begin(), color.end(),
+                          std::back_inserter(border_colors.back()),
+                          std::back_inserter(interior_colors.back()),
+                          is_border);
+    }
+
+    for (auto const &color : interior_colors) {
+      parallel_cell_loop(color, cell_loop);
+      cell_structure.ghosts_update_test();
+    }
+    cell_structure.ghosts_update_wait();
+    ghosts_ready();
+    colored_cell_loop(border_colors, cell_loop);
+  } else {
+    auto const cells = cell_structure.local_cells();
+    auto const run = [&cell_loop](auto it) {
+      auto const first = boost::make_indirect_iterator(it);
+      cell_loop(first, std::next(first));
+    };
+
+    for (auto it = cells.begin(); it != cells.end(); ++it) {
+      if (not is_border(*it)) {
+        run(it);
+        cell_structure.ghosts_update_test();
+      }
+    }
+    cell_structure.ghosts_update_wait();
+    ghosts_ready();
+    for (auto it = cells.begin(); it != cells.end(); ++it) {
+      if (is_border(*it))
+        run(it);
+    }
+  }
+}
+
+/**
+ * @brief Criterion for the cluster pair lists on the structure-of-arrays
+ *        copies: the bounding boxes of the clusters are closer than
+ *        the interaction range.
+ */
+struct ClusterBoxCriterion {
+  double range2;
+
+  bool operator()(Cell &c1, int i_first, int i_last, Cell &c2, int j_first,
+                  int j_last) const {
+    auto const box1 = c1.soa().bounding_box(i_first, i_last);
+    auto const box2 = c2.soa().bounding_box(j_first, j_last);
+
+    auto dist2 = 0.;
+    for (int i = 0; i < 3; i++) {
+      auto const gap = std::max({0., box2.first[i] - box1.second[i],
+                                 box1.first[i] - box2.second[i]});
+      dist2 += gap * gap;
+    }
+
+    return dist2 <= range2;
+  }
+};
+
+/**
+ * @brief Run the pair kernel concurrently on groups of independent cells.
+ */
+template <typename PairKernel, typename VerletCriterion>
+void colored_pair_loop(std::vector<std::vector<Cell *>> const &colors,
+                       PairKernel &pair_kernel,
+                       VerletCriterion const &verlet_criterion) {
+  colored_cell_loop(colors, [&](auto first, auto last) {
+    decide_distance(
+        first, last, [](Particle &) {}, pair_kernel, verlet_criterion);
+  });
+}
 } // namespace detail
 
+/**
+ * @brief Run the particle kernel for all local particles and the pair
+ *        kernel for all pairs within the interaction range.
+ *
+ * If a ghost update is still in flight (see
+ * @ref CellStructure::ghosts_update_begin), the pairs that do not involve
+ * ghosts are processed first, and the particle kernel is run once the
+ * ghosts are complete, see @ref detail::overlapped_cell_loop. The pairs
+ * between ghost cells come last, see @ref detail::ghost_pair_loop.
+ */
 template <class ParticleKernel, class PairKernel,
           class VerletCriterion = detail::True>
 void short_range_loop(ParticleKernel &&particle_kernel,
@@ -96,22 +260,157 @@ void short_range_loop(ParticleKernel &&particle_kernel,
 
   assert(cell_structure.get_resort_particles() == Cells::RESORT_NONE);
 
-  if (interaction_range() != INACTIVE_CUTOFF) {
+  if (interaction_range() != INACTIVE_CUTOFF and
+      cell_structure.ghosts_update_pending()) {
+    detail::overlapped_cell_loop(
+        false,
+        [&](auto first, auto last) {
+          detail::decide_distance(
+              first, last, [](Particle &) {}, pair_kernel, verlet_criterion);
+        },
+        [&]() {
+          for (auto &p : cell_structure.local_particles()) {
+            particle_kernel(p);
+          }
+        });
+    detail::ghost_pair_loop(pair_kernel, verlet_criterion);
+
+    rebuild_verletlist = false;
+  } else if (interaction_range() != INACTIVE_CUTOFF) {
     auto first =
         boost::make_indirect_iterator(cell_structure.local_cells().begin());
     auto last =
         boost::make_indirect_iterator(cell_structure.local_cells().end());
 
-    detail::decide_distance(
-        first, last, std::forward<ParticleKernel>(particle_kernel),
-        std::forward<PairKernel>(pair_kernel), verlet_criterion);
+    detail::decide_distance(first, last,
+                            std::forward<ParticleKernel>(particle_kernel),
+                            pair_kernel, verlet_criterion);
+    detail::ghost_pair_loop(pair_kernel, verlet_criterion);
 
     rebuild_verletlist = false;
   } else {
+    cell_structure.ghosts_update_wait();
     for (auto &p : cell_structure.local_particles()) {
       particle_kernel(p);
     }
   }
 }
 
+/**
+ * @brief Threaded version of @ref short_range_loop.
+ *
+ * The particle kernel is run serially for all local particles,
+ * afterwards the pair kernel is run by @ref n_threads threads on
+ * independent groups of cells (see @ref CellStructure::cell_colors).
+ * The pair kernel may only modify the two particles it is called
+ * with. The pairs between ghost cells are processed serially at the end.
+ * With a single thread this is equivalent to @ref short_range_loop.
+ */
+template <class ParticleKernel, class PairKernel,
+          class VerletCriterion = detail::True>
+void parallel_short_range_loop(ParticleKernel &&particle_kernel,
+                               PairKernel &&pair_kernel,
+                               const VerletCriterion &verlet_criterion = {}) {
+  if (n_threads == 1 or interaction_range() == INACTIVE_CUTOFF) {
+    short_range_loop(std::forward<ParticleKernel>(particle_kernel),
+                     std::forward<PairKernel>(pair_kernel), verlet_criterion);
+    return;
+  }
+
+  ESPRESSO_PROFILER_CXX_MARK_FUNCTION;
+
+  assert(cell_structure.get_resort_particles() == Cells::RESORT_NONE);
+
+  auto const run_particle_kernel = [&]() {
+    for (auto &p : cell_structure.local_particles()) {
+      particle_kernel(p);
+    }
+  };
+
+  if (cell_structure.ghosts_update_pending()) {
+    detail::overlapped_cell_loop(
+        true,
+        [&](auto first, auto last) {
+          detail::decide_distance(
+              first, last, [](Particle &) {}, pair_kernel, verlet_criterion);
+        },
+        run_particle_kernel);
+  } else {
+    run_particle_kernel();
+    detail::colored_pair_loop(cell_structure.cell_colors(), pair_kernel,
+                              verlet_criterion);
+  }
+  detail::ghost_pair_loop(pair_kernel, verlet_criterion);
+
+  rebuild_verletlist = false;
+}
+
+/** Number of consecutive particles that form a cluster in the
+ *  cluster pair lists of the structure-of-arrays copies. */
+constexpr int soa_cluster_size = 4;
+
+/**
+ * @brief Pair loop on the structure-of-arrays copies of the cells.
+ *
+ * Runs the batch kernel for all pairs of the local cells, see
+ * @ref Algorithm::link_cell_batched. If Verlet lists are enabled,
+ * cluster pair lists are used instead (see
+ * @ref Algorithm::verlet_ia_clustered), in which case the kernel
+ * is also called for pairs up to the interaction range plus skin.
+ * This requires up-to-date copies (see @ref CellStructure::use_soa)
+ * and a cell system without minimum image convention.
+ *
+ * @param batch_kernel Kernel for a particle and a range of partners.
+ * @param parallel If true, and more than one thread is used, the
+ *        kernel is run concurrently on independent cells, in which case
+ *        it may only modify the particles it is called with.
+ */
+template <class BatchKernel>
+void batched_short_range_loop(BatchKernel &&batch_kernel, bool parallel) {
+  ESPRESSO_PROFILER_CXX_MARK_FUNCTION;
+
+  assert(cell_structure.get_resort_particles() == Cells::RESORT_NONE);
+  assert(not cell_structure.minimum_image_distance());
+
+  if (interaction_range() == INACTIVE_CUTOFF)
+    return;
+
+  auto const use_clusters = cell_structure.use_verlet_list;
+  auto const rebuild = cell_structure.rebuild_cluster_pairs;
+  auto const cluster_criterion =
+      detail::ClusterBoxCriterion{Utils::sqr(interaction_range())};
+
+  auto const pair_loop = [&](auto first, auto last, bool self_pairs) {
+    if (use_clusters) {
+      Algorithm::verlet_ia_clustered(first, last, soa_cluster_size,
+                                     batch_kernel, cluster_criterion,
+                                     rebuild, self_pairs);
+    } else {
+      Algorithm::link_cell_batched(first, last, batch_kernel, self_pairs);
+    }
+  };
+  auto const cell_loop = [&](auto first, auto last) {
+    pair_loop(first, last, true);
+  };
+
+  if (cell_structure.ghosts_update_pending()) {
+    detail::overlapped_cell_loop(parallel and n_threads > 1, cell_loop,
+                                 []() {});
+  } else if (parallel and n_threads > 1) {
+    detail::colored_cell_loop(cell_structure.cell_colors(), cell_loop);
+  } else {
+    cell_loop(
+        boost::make_indirect_iterator(cell_structure.local_cells().begin()),
+        boost::make_indirect_iterator(cell_structure.local_cells().end()));
+  }
+
+  /* pairs between ghost cells, see detail::ghost_pair_loop */
+  auto const ghost_cells = cell_structure.interacting_ghost_cells();
+  pair_loop(boost::make_indirect_iterator(ghost_cells.begin()),
+            boost::make_indirect_iterator(ghost_cells.end()), false);
+
+  if (use_clusters)
+    cell_structure.rebuild_cluster_pairs = false;
+}
+
 #endif
@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2020 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/** \file
+ *  Implementation of \ref threads.hpp "threads.hpp".
+ */
+#include "threads.hpp"
+
+#include "config.hpp"
+#include "errorhandling.hpp"
+
+#ifdef OPENMP
+#include <omp.h>
+#endif
+
+int n_threads = 1;
+
+void threads_init() {
+  if (n_threads < 1) {
+    runtimeErrorMsg() << "number of threads has to be positive, got "
+                      << n_threads;
+    n_threads = 1;
+  }
+#ifdef OPENMP
+  omp_set_num_threads(n_threads);
+#else
+  if (n_threads != 1) {
+    runtimeErrorMsg() << "threaded kernels require OpenMP support";
+    n_threads = 1;
+  }
+#endif
+}
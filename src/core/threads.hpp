@@ -0,0 +1,38 @@
+/*
+ * Copyright (C) 2020 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_THREADS_HPP
+#define CORE_THREADS_HPP
+/** \file
+ *  Shared-memory parallelism within an MPI rank.
+ *
+ *  The number of threads per rank is a global parameter, which defaults
+ *  to one, so that pure MPI runs do not oversubscribe the cores of a node.
+ *  Threaded kernels use OpenMP and run serially if ESPResSo was built
+ *  without OpenMP support.
+ *
+ *  Implementation in threads.cpp.
+ */
+
+/** Number of threads per MPI rank used by threaded kernels. */
+extern int n_threads;
+
+/** @brief Apply @ref n_threads to the thread pool of this rank. */
+void threads_init();
+
+#endif
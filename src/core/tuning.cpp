@@ -24,15 +24,22 @@
 #include "cells.hpp"
 #include "communication.hpp"
 #include "errorhandling.hpp"
+#include "event.hpp"
 #include "global.hpp"
 #include "grid.hpp"
 #include "integrate.hpp"
+#include "tuning.hpp"
 #include <utils/statistics/RunningAverage.hpp>
 
+#include <boost/algorithm/clamp.hpp>
+#include <boost/mpi/collectives/all_reduce.hpp>
+#include <boost/mpi/operations.hpp>
 #include <boost/range/algorithm/max_element.hpp>
 #include <boost/range/algorithm/min_element.hpp>
 #include <nonbonded_interactions/nonbonded_interaction_data.hpp>
 
+#include <algorithm>
+
 int timing_samples = 10;
 
 double time_force_calc(int default_samples) {
@@ -88,6 +95,16 @@ static double time_calc(int rds) {
   return 1000. * (tock - tick) / rds;
 }
 
+/** The maximal skin is the remainder from the required cutoff to
+ *  the maximal range that can be supported by the cell system, but
+ *  never larger than half the box size.
+ */
+static double max_permissible_skin() {
+  return std::min(
+      *boost::min_element(cell_structure.max_range()) - maximal_cutoff(),
+      0.5 * *boost::max_element(box_geo.length()));
+}
+
 void tune_skin(double min_skin, double max_skin, double tol, int int_steps,
                bool adjust_max_skin) {
   skin_set = true;
@@ -96,15 +113,8 @@ void tune_skin(double min_skin, double max_skin, double tol, int int_steps,
   double b = max_skin;
   double time_a, time_b;
 
-  /* The maximal skin is the remainder from the required cutoff to
-   * the maximal range that can be supported by the cell system, but
-   * never larger than half the box size. */
-  double const max_permissible_skin = std::min(
-      *boost::min_element(cell_structure.max_range()) - maximal_cutoff(),
-      0.5 * *boost::max_element(box_geo.length()));
-
-  if (adjust_max_skin and max_skin > max_permissible_skin)
-    b = max_permissible_skin;
+  if (adjust_max_skin)
+    b = std::min(max_skin, max_permissible_skin());
 
   while (fabs(a - b) > tol) {
     skin = a;
@@ -124,3 +134,100 @@ void tune_skin(double min_skin, double max_skin, double tol, int int_steps,
   skin = 0.5 * (a + b);
   mpi_bcast_parameter(FIELD_SKIN);
 }
+
+namespace {
+AdaptiveSkinParameters adaptive_skin_params;
+
+/** State of the online skin adaption, identical on all nodes. */
+struct AdaptiveSkinState {
+  /** Wall time accumulated in the current window. */
+  double time = 0.;
+  /** Number of steps in the current window. */
+  int steps = 0;
+  /** Time per step of the previous window, negative if there is none. */
+  double last_time_per_step = -1.;
+  /** Current step size of the skin. */
+  double delta = 0.;
+  /** Direction of the next skin change, +1 or -1. */
+  int direction = 1;
+} adaptive_skin_state;
+} // namespace
+
+AdaptiveSkinParameters const &adaptive_skin_parameters() {
+  return adaptive_skin_params;
+}
+
+void mpi_set_adaptive_skin_local(int interval, double min_skin,
+                                 double max_skin, double tol) {
+  adaptive_skin_params.interval = interval;
+  adaptive_skin_params.min_skin = min_skin;
+  adaptive_skin_params.max_skin = max_skin;
+  adaptive_skin_params.tol = tol;
+  adaptive_skin_state = AdaptiveSkinState{};
+}
+
+REGISTER_CALLBACK(mpi_set_adaptive_skin_local)
+
+void mpi_set_adaptive_skin(AdaptiveSkinParameters const &params) {
+  mpi_call_all(mpi_set_adaptive_skin_local, params.interval, params.min_skin,
+               params.max_skin, params.tol);
+}
+
+void adaptive_skin_update(double step_time) {
+  auto const &params = adaptive_skin_params;
+  auto &state = adaptive_skin_state;
+
+  if (params.interval <= 0)
+    return;
+
+  state.time += step_time;
+  if (++state.steps < params.interval)
+    return;
+
+  /* The slowest node determines the speed, and all nodes
+   * have to take the same decision. */
+  auto const time_per_step =
+      boost::mpi::all_reduce(comm_cart, state.time,
+                             boost::mpi::maximum<double>()) /
+      state.steps;
+  state.time = 0.;
+  state.steps = 0;
+
+  /* Without short-range interactions the skin does not matter. */
+  if (cells_max_cutoff() <= 0.)
+    return;
+
+  if (state.last_time_per_step < 0.) {
+    state.delta = std::max(0.1 * skin, params.tol);
+  } else if (time_per_step > state.last_time_per_step) {
+    state.direction = -state.direction;
+    state.delta = std::max(0.5 * state.delta, params.tol);
+  }
+  state.last_time_per_step = time_per_step;
+
+  auto const upper = std::min(params.max_skin, max_permissible_skin());
+  auto const lower = std::min(params.min_skin, upper);
+  auto const new_skin =
+      boost::algorithm::clamp(skin + state.direction * state.delta, lower, upper);
+
+  /* At a bound, try the other direction in the next window. */
+  if (new_skin == skin) {
+    state.direction = -state.direction;
+    return;
+  }
+
+  /* The skin only enters the cell grid, the Verlet criterion and the
+   * particle halos of the mesh methods, which are all rebuilt by the
+   * re-init. Unlike on_parameter_change(FIELD_SKIN) this does not
+   * re-tune the long-range methods. The re-init resorts the particles,
+   * so the Verlet lists are rebuilt with the new skin in the next step.
+   * Its cost is charged to the next window, so that a skin change
+   * has to pay off over the window to be kept. */
+  auto const reinit_start = MPI_Wtime();
+  skin = new_skin;
+  skin_set = true;
+  /* Positions and interactions are unchanged, so the forces of this
+   * step stay exact and recalc_forces is left alone. */
+  cells_re_init(cell_structure.decomposition_type());
+  state.time = MPI_Wtime() - reinit_start;
+}
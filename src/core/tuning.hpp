@@ -23,7 +23,9 @@
  *  variable @ref timing_samples (called @c timings in the Python interface)
  *  you can specify how many force evaluations are sampled. Via \ref markTime
  *  and \ref diffTime you can also easily time anything other than
- *  the force evaluation.
+ *  the force evaluation. @ref tune_skin finds the optimal @ref skin by
+ *  bisection, while @ref adaptive_skin_update adjusts it online during
+ *  @ref integrate.
  *
  *  Implementation in tuning.cpp.
  */
@@ -31,6 +33,8 @@
 #ifndef TUNING_H
 #define TUNING_H
 
+#include <limits>
+
 /** If positive, the number of samples for timing */
 extern int timing_samples;
 
@@ -59,4 +63,43 @@ double diffTime();
 void tune_skin(double min_skin, double max_skin, double tol, int int_steps,
                bool adjust_max_skin);
 
+/** Parameters of the online skin adaption in @ref integrate. */
+struct AdaptiveSkinParameters {
+  /** Number of integration steps per timing window, 0 disables adaption. */
+  int interval = 0;
+  /** Smallest skin to use. */
+  double min_skin = 0.;
+  /** Largest skin to use, capped at the maximal permissible skin. */
+  double max_skin = std::numeric_limits<double>::infinity();
+  /** Smallest change of the skin between two windows. */
+  double tol = 1e-3;
+};
+
+/** Parameters of the online skin adaption. */
+AdaptiveSkinParameters const &adaptive_skin_parameters();
+
+/** Set the parameters of the online skin adaption on all nodes and
+ *  restart it from the current @ref skin.
+ */
+void mpi_set_adaptive_skin(AdaptiveSkinParameters const &params);
+
+/** Online skin adaption, called by @ref integrate after every step on all
+ *  nodes.
+ *
+ *  The wall time of the integration steps is accumulated over windows of
+ *  @ref AdaptiveSkinParameters::interval steps, which include the force
+ *  calculations as well as the Verlet list rebuilds. At the end of each
+ *  window the slowest node's time per step is compared to the one of the
+ *  previous window: if the last change of the @ref skin made the integration
+ *  faster, the skin is moved further in the same direction, otherwise the
+ *  direction is reversed and the step size is halved down to
+ *  @ref AdaptiveSkinParameters::tol. Since the step size never drops below
+ *  the tolerance, the skin keeps following the optimum when the system
+ *  changes. The cell system re-init after a skin change is accounted to
+ *  the following window. This is collective.
+ *
+ *  @param step_time  Wall time of the last integration step in seconds.
+ */
+void adaptive_skin_update(double step_time);
+
 #endif
@@ -57,4 +57,19 @@ BOOST_AUTO_TEST_CASE(constructors) {
     BOOST_CHECK(boost::equal(boundaries, box.boundary()));
     check_length(box);
   }
+
+  /* corners */
+  {
+    Utils::Vector<double, 3> const lower_corner = {1., 2., 3.};
+    Utils::Vector<double, 3> const upper_corner = {4., 5.1, 6.3};
+    Utils::Array<int, 6> const boundaries = {-1, 0, 1, 1, 0, -1};
+
+    auto const box = LocalBox<double>::from_corners(lower_corner, upper_corner,
+                                                    boundaries);
+
+    BOOST_CHECK(box.my_left() == lower_corner);
+    BOOST_CHECK(box.my_right() == upper_corner);
+    BOOST_CHECK(boost::equal(boundaries, box.boundary()));
+    check_length(box);
+  }
 }
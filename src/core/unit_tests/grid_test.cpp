@@ -23,6 +23,8 @@
 
 #include "grid.hpp"
 
+#include <boost/range/algorithm/equal.hpp>
+
 #include <cmath>
 #include <limits>
 
@@ -229,3 +231,49 @@ BOOST_AUTO_TEST_CASE(regular_decomposition_test) {
         }
   }
 }
+
+BOOST_AUTO_TEST_CASE(rectilinear_decomposition_test) {
+  auto const box_l = Utils::Vector3d{10, 20, 30};
+  auto box = BoxGeometry();
+  box.set_length(box_l);
+  auto const node_grid = Utils::Vector3i{1, 2, 3};
+
+  /* regular boundaries reproduce the regular decomposition */
+  {
+    std::array<std::vector<double>, 3> boundaries;
+    for (int i = 0; i < 3; i++)
+      boundaries[i] = regular_node_boundaries(node_grid[i]);
+
+    Utils::Vector3i node_pos;
+    for (node_pos[0] = 0; node_pos[0] < node_grid[0]; node_pos[0]++)
+      for (node_pos[1] = 0; node_pos[1] < node_grid[1]; node_pos[1]++)
+        for (node_pos[2] = 0; node_pos[2] < node_grid[2]; node_pos[2]++) {
+          auto const expected = regular_decomposition(box, node_pos, node_grid);
+          auto const result =
+              rectilinear_decomposition(box, node_pos, boundaries);
+
+          BOOST_CHECK_SMALL((result.my_left() - expected.my_left()).norm(),
+                            100. * epsilon<double>);
+          BOOST_CHECK_SMALL((result.length() - expected.length()).norm(),
+                            100. * epsilon<double>);
+          BOOST_CHECK(boost::equal(result.boundary(), expected.boundary()));
+        }
+  }
+
+  /* shifted boundaries */
+  {
+    std::array<std::vector<double>, 3> const boundaries{
+        {{0., 1.}, {0., 0.25, 1.}, {0., 0.5, 0.6, 1.}}};
+
+    auto const result = rectilinear_decomposition(box, {0, 1, 1}, boundaries);
+
+    BOOST_CHECK_SMALL((result.my_left() - Utils::Vector3d{0., 5., 15.}).norm(),
+                      100. * epsilon<double>);
+    BOOST_CHECK_SMALL((result.length() - Utils::Vector3d{10., 15., 3.}).norm(),
+                      100. * epsilon<double>);
+    BOOST_CHECK_EQUAL(result.boundary()[2], 0);
+    BOOST_CHECK_EQUAL(result.boundary()[3], -1);
+    BOOST_CHECK_EQUAL(result.boundary()[4], 0);
+    BOOST_CHECK_EQUAL(result.boundary()[5], 0);
+  }
+}
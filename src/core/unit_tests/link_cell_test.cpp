@@ -26,12 +26,14 @@
 
 #include "Cell.hpp"
 #include "algorithm/link_cell.hpp"
+#include "algorithm/link_cell_batched.hpp"
 
-BOOST_AUTO_TEST_CASE(link_cell) {
-  const unsigned n_cells = 10;
-  const auto n_part_per_cell = 10;
-  const auto n_part = n_cells * n_part_per_cell;
+namespace {
+const unsigned n_cells = 10;
+const auto n_part_per_cell = 10;
+const auto n_part = n_cells * n_part_per_cell;
 
+std::vector<Cell> make_cells() {
   std::vector<Cell> cells(n_cells);
 
   auto id = 0;
@@ -52,6 +54,13 @@ BOOST_AUTO_TEST_CASE(link_cell) {
     }
   }
 
+  return cells;
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(link_cell) {
+  auto cells = make_cells();
+
   std::vector<std::pair<int, int>> lc_pairs;
   lc_pairs.reserve((n_part * (n_part - 1)) / 2);
   std::vector<unsigned> id_counts(n_part, 0u);
@@ -85,3 +94,75 @@ BOOST_AUTO_TEST_CASE(link_cell) {
       ++it;
     }
 }
+
+BOOST_AUTO_TEST_CASE(link_cell_batched) {
+  auto cells = make_cells();
+
+  std::vector<std::pair<int, int>> lc_pairs;
+  lc_pairs.reserve((n_part * (n_part - 1)) / 2);
+
+  Algorithm::link_cell_batched(
+      cells.begin(), cells.end(),
+      [&lc_pairs](Cell &c1, int i, Cell &c2, int j_first, int j_last) {
+        auto const id1 = c1.particles().begin()[i].p.identity;
+        for (int j = j_first; j < j_last; j++) {
+          auto const id2 = c2.particles().begin()[j].p.identity;
+          /* All cells are red neighbors, so pairs across cells are
+           * visited twice */
+          if (id1 < id2)
+            lc_pairs.emplace_back(id1, id2);
+        }
+      });
+
+  BOOST_CHECK(lc_pairs.size() == (n_part * (n_part - 1) / 2));
+
+  /* Every pair is visited exactly once */
+  std::sort(lc_pairs.begin(), lc_pairs.end());
+  auto it = lc_pairs.begin();
+  for (int i = 0; i < n_part; i++)
+    for (int j = i + 1; j < n_part; j++) {
+      BOOST_CHECK((it->first == i) && (it->second == j));
+      ++it;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(link_cell_without_self_pairs) {
+  auto cells = make_cells();
+
+  std::vector<std::pair<int, int>> lc_pairs;
+  auto const same_cell = [](int id1, int id2) {
+    return (id1 / n_part_per_cell) == (id2 / n_part_per_cell);
+  };
+
+  Algorithm::link_cell(
+      cells.begin(), cells.end(), [](Particle const &) {},
+      [&lc_pairs](Particle const &p1, Particle const &p2, int) {
+        if (p1.p.identity < p2.p.identity)
+          lc_pairs.emplace_back(p1.p.identity, p2.p.identity);
+      },
+      [](Particle const &, Particle const &) { return 0; }, false);
+
+  /* Only the pairs across cells are visited */
+  BOOST_CHECK(lc_pairs.size() == (n_part * (n_part - n_part_per_cell)) / 2);
+  BOOST_CHECK(std::none_of(lc_pairs.begin(), lc_pairs.end(),
+                           [&same_cell](std::pair<int, int> const &pair) {
+                             return same_cell(pair.first, pair.second);
+                           }));
+
+  std::vector<std::pair<int, int>> batched_pairs;
+  Algorithm::link_cell_batched(
+      cells.begin(), cells.end(),
+      [&batched_pairs](Cell &c1, int i, Cell &c2, int j_first, int j_last) {
+        auto const id1 = c1.particles().begin()[i].p.identity;
+        for (int j = j_first; j < j_last; j++) {
+          auto const id2 = c2.particles().begin()[j].p.identity;
+          if (id1 < id2)
+            batched_pairs.emplace_back(id1, id2);
+        }
+      },
+      false);
+
+  std::sort(lc_pairs.begin(), lc_pairs.end());
+  std::sort(batched_pairs.begin(), batched_pairs.end());
+  BOOST_CHECK(lc_pairs == batched_pairs);
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2020 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE load balancing test
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "load_balance.hpp"
+
+#include <vector>
+
+BOOST_AUTO_TEST_CASE(balanced) {
+  std::vector<double> const boundaries{0., 0.25, 0.5, 1.};
+  std::vector<double> const loads{1., 1., 1.};
+
+  auto const result = balance_node_boundaries(boundaries, loads, 0.1, 1.);
+
+  for (int i = 0; i < 4; i++)
+    BOOST_CHECK_CLOSE(result[i], boundaries[i], 1e-10);
+}
+
+BOOST_AUTO_TEST_CASE(equal_split) {
+  /* The load is concentrated in the first slab. */
+  std::vector<double> const boundaries{0., 0.5, 1.};
+  std::vector<double> const loads{3., 1.};
+
+  auto const result = balance_node_boundaries(boundaries, loads, 0.1, 1.);
+  BOOST_CHECK_EQUAL(result.front(), 0.);
+  BOOST_CHECK_EQUAL(result.back(), 1.);
+  BOOST_CHECK_CLOSE(result[1], 1. / 3., 1e-10);
+
+  /* Only half of the shift with damping */
+  auto const damped = balance_node_boundaries(boundaries, loads, 0.1, 0.5);
+  BOOST_CHECK_CLOSE(damped[1], 0.5 * (0.5 + 1. / 3.), 1e-10);
+}
+
+BOOST_AUTO_TEST_CASE(min_width) {
+  std::vector<double> const boundaries{0., 0.25, 0.5, 0.75, 1.};
+  std::vector<double> const loads{100., 0., 0., 0.};
+
+  auto const result = balance_node_boundaries(boundaries, loads, 0.2, 1.);
+  for (int i = 0; i < 4; i++)
+    BOOST_CHECK_GE(result[i + 1] - result[i], 0.2 - 1e-12);
+
+  /* Impossible minimal width leaves the boundaries alone */
+  auto const unchanged = balance_node_boundaries(boundaries, loads, 0.3, 1.);
+  BOOST_CHECK(unchanged == boundaries);
+
+  /* No load, no information */
+  auto const no_load =
+      balance_node_boundaries(boundaries, {0., 0., 0., 0.}, 0.1, 1.);
+  BOOST_CHECK(no_load == boundaries);
+}
@@ -145,3 +145,72 @@ BOOST_AUTO_TEST_CASE(verlet_ia) {
 
   check_pairs(n_part, pairs);
 }
+
+BOOST_AUTO_TEST_CASE(verlet_ia_clustered) {
+  const unsigned n_cells = 20;
+  /* Not a multiple of the cluster size */
+  const auto n_part_per_cell = 10;
+  const auto n_part = n_cells * n_part_per_cell;
+  const auto cluster_size = 4;
+
+  std::vector<Cell> cells(n_cells);
+
+  auto id = 0;
+  for (auto &c : cells) {
+    std::vector<Cell *> neighbors;
+
+    for (auto &n : cells) {
+      if (&c != &n)
+        neighbors.push_back(&n);
+    }
+
+    c.m_neighbors = Neighbors<Cell *>(neighbors, {});
+
+    c.particles().resize(n_part_per_cell);
+
+    for (auto &p : c.particles()) {
+      p.p.identity = id++;
+    }
+  }
+
+  std::vector<std::pair<int, int>> pairs;
+  pairs.reserve((n_part * (n_part - 1)) / 2);
+
+  auto batch_kernel = [&pairs](Cell &c1, int i, Cell &c2, int j_first,
+                               int j_last) {
+    BOOST_CHECK(j_last - j_first <= cluster_size);
+    auto const id1 = c1.particles().begin()[i].p.identity;
+    for (int j = j_first; j < j_last; j++) {
+      auto const id2 = c2.particles().begin()[j].p.identity;
+      /* All cells are red neighbors, so pairs across cells are
+       * visited twice */
+      if (id1 < id2)
+        pairs.emplace_back(id1, id2);
+    }
+  };
+  auto cluster_criterion = [](Cell &, int i_first, int i_last, Cell &,
+                              int j_first, int j_last) {
+    BOOST_CHECK(i_last - i_first <= cluster_size);
+    BOOST_CHECK(j_last - j_first <= cluster_size);
+    return true;
+  };
+
+  for (auto rebuild : {true, false}) {
+    pairs.clear();
+
+    Algorithm::verlet_ia_clustered(cells.begin(), cells.end(), cluster_size,
+                                   batch_kernel, cluster_criterion, rebuild);
+
+    std::sort(pairs.begin(), pairs.end());
+    check_pairs(n_part, pairs);
+  }
+
+  /* Clusters that do not fulfill the criterion are not stored */
+  Algorithm::verlet_ia_clustered(
+      cells.begin(), cells.end(), cluster_size, batch_kernel,
+      [](Cell &, int, int, Cell &, int, int) { return false; },
+      /* rebuild */ true);
+  BOOST_CHECK(std::all_of(cells.begin(), cells.end(), [](Cell const &c) {
+    return c.m_cluster_pairs.empty();
+  }));
+}
@@ -330,6 +330,7 @@ class Analysis:
 
         # Update in ESPResSo core
         analyze.update_pressure()
+        handle_errors("calc_pressure failed")
 
         return _Observable_stat_to_dict(analyze.get_obs_pressure(), True)
 
@@ -364,6 +365,7 @@ class Analysis:
 
         # Update in ESPResSo core
         analyze.update_pressure()
+        handle_errors("calc_pressure failed")
 
         return _Observable_stat_to_dict(analyze.get_obs_pressure(), False)
 
@@ -371,6 +373,7 @@ class Analysis:
         def dpd_stress(self):
             cdef Vector9d p
             p = dpd_stress()
+            handle_errors("dpd_stress failed")
             return array_locked((
                 p[0], p[1], p[2],
                 p[3], p[4], p[5],
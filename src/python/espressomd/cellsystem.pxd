@@ -25,6 +25,10 @@ from .utils cimport Vector3i
 cdef extern from "communication.hpp":
     void mpi_bcast_cell_structure(int cs)
     void mpi_set_use_verlet_lists(bool use_verlet_lists)
+    void mpi_set_use_soa(bool use_soa)
+    void mpi_set_use_async_ghosts(bool use_async_ghosts)
+    void mpi_set_use_spatial_sort(bool use_spatial_sort)
+    void mpi_set_use_eighth_shell(bool use_eighth_shell)
     int n_nodes
     vector[int] mpi_resort_particles(int global_flag)
 
@@ -35,16 +39,40 @@ cdef extern from "cells.hpp":
     ctypedef struct CellStructure:
         int decomposition_type()
         bool use_verlet_list
+        bool use_soa
+        bool use_async_ghosts
+        bool use_spatial_sort
+        bool use_eighth_shell
 
     CellStructure cell_structure
 
     const DomainDecomposition * get_domain_decomposition()
 
     vector[pair[int, int]] mpi_get_pairs(double distance)
+    vector[vector[int]] mpi_get_cell_particle_ids()
 
 cdef extern from "tuning.hpp":
     cdef void c_tune_skin "tune_skin" (double min_skin, double max_skin, double tol, int int_steps, bool adjust_max_skin)
 
+    ctypedef struct AdaptiveSkinParameters:
+        int interval
+        double min_skin
+        double max_skin
+        double tol
+
+    const AdaptiveSkinParameters & adaptive_skin_parameters()
+    void mpi_set_adaptive_skin(const AdaptiveSkinParameters & params)
+
+cdef extern from "load_balance.hpp":
+    ctypedef struct LoadBalanceParameters:
+        int interval
+        double threshold
+        double damping
+
+    const LoadBalanceParameters & load_balance_parameters()
+    void mpi_set_load_balance(const LoadBalanceParameters & params)
+    double load_imbalance()
+
 cdef extern from "DomainDecomposition.hpp":
     cppclass  DomainDecomposition:
         Vector3i cell_grid
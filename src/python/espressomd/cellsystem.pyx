@@ -18,10 +18,10 @@
 #
 import numpy as np
 from libcpp.cast cimport dynamic_cast
-from .grid cimport node_grid
+from .grid cimport node_grid, node_boundaries
 from . cimport integrate
-from .globals cimport FIELD_SKIN, FIELD_NODEGRID
-from .globals cimport verlet_reuse, skin
+from .globals cimport FIELD_SKIN, FIELD_NODEGRID, FIELD_N_THREADS
+from .globals cimport verlet_reuse, skin, n_threads
 from .globals cimport mpi_bcast_parameter
 from .cellsystem cimport cell_structure
 from .utils cimport handle_errors
@@ -29,7 +29,10 @@ from .utils import is_valid_type
 from .utils cimport Vector3i
 
 cdef class CellSystem:
-    def set_domain_decomposition(self, use_verlet_lists=True):
+    def set_domain_decomposition(self, use_verlet_lists=True, use_soa=False,
+                                 use_async_ghosts=False,
+                                 use_spatial_sort=False,
+                                 use_eighth_shell=False):
         """
         Activates domain decomposition cell system.
 
@@ -38,15 +41,39 @@ cdef class CellSystem:
         use_verlet_lists : :obj:`bool`, optional
             Activates or deactivates the usage of Verlet lists
             in the algorithm.
+        use_soa : :obj:`bool`, optional
+            Calculate the non-bonded forces on a structure-of-arrays
+            copy of the particle positions, types and charges.
+            In this case, the Verlet lists store pairs of clusters
+            of particles instead of particle pairs.
+        use_async_ghosts : :obj:`bool`, optional
+            Send the ghost positions without blocking, and start the
+            force calculation on the cells that do not need ghosts
+            while the communication is in flight.
+        use_spatial_sort : :obj:`bool`, optional
+            Order the particles within the cells and the cells
+            themselves along a space-filling curve whenever the
+            particles are resorted.
+        use_eighth_shell : :obj:`bool`, optional
+            Only import ghost particles from the neighbors in the
+            upper directions, and calculate the pairs between ghosts
+            of different neighbors locally. This halves the ghost
+            volume and the number of messages, but does not support
+            bonds, exclusions, virtual sites, collision detection and
+            lattice-Boltzmann.
 
         """
         mpi_set_use_verlet_lists(use_verlet_lists)
+        mpi_set_use_soa(use_soa)
+        mpi_set_use_async_ghosts(use_async_ghosts)
+        mpi_set_use_spatial_sort(use_spatial_sort)
+        mpi_set_use_eighth_shell(use_eighth_shell)
         mpi_bcast_cell_structure(CELL_STRUCTURE_DOMDEC)
 
         handle_errors("Error while initializing the cell system.")
         return True
 
-    def set_n_square(self, use_verlet_lists=True):
+    def set_n_square(self, use_verlet_lists=True, use_spatial_sort=False):
         """
         Activates the nsquare force calculation.
 
@@ -55,15 +82,26 @@ cdef class CellSystem:
         use_verlet_lists : :obj:`bool`, optional
             Activates or deactivates the usage of the Verlet
             lists for this algorithm.
+        use_spatial_sort : :obj:`bool`, optional
+            Order the particles of each node along a space-filling
+            curve whenever the particles are resorted.
 
         """
         mpi_set_use_verlet_lists(use_verlet_lists)
+        mpi_set_use_soa(False)
+        mpi_set_use_async_ghosts(False)
+        mpi_set_use_spatial_sort(use_spatial_sort)
+        mpi_set_use_eighth_shell(False)
         mpi_bcast_cell_structure(CELL_STRUCTURE_NSQUARE)
 
         return True
 
     def get_state(self):
-        s = {"use_verlet_list": cell_structure.use_verlet_list}
+        s = {"use_verlet_list": cell_structure.use_verlet_list,
+             "use_soa": cell_structure.use_soa,
+             "use_async_ghosts": cell_structure.use_async_ghosts,
+             "use_spatial_sort": cell_structure.use_spatial_sort,
+             "use_eighth_shell": cell_structure.use_eighth_shell}
 
         if cell_structure.decomposition_type() == CELL_STRUCTURE_DOMDEC:
             dd = get_domain_decomposition()
@@ -80,11 +118,21 @@ cdef class CellSystem:
         s["verlet_reuse"] = verlet_reuse
         s["n_nodes"] = n_nodes
         s["node_grid"] = np.array([node_grid[0], node_grid[1], node_grid[2]])
+        s["n_threads"] = n_threads
+        s["adaptive_skin"] = self.get_adaptive_skin()
+        s["load_balancing"] = self.get_load_balancing()
+        s["load_imbalance"] = load_imbalance()
+        s["node_boundaries"] = [np.array(node_boundaries[i])
+                                for i in range(3)]
 
         return s
 
     def __getstate__(self):
-        s = {"use_verlet_list": cell_structure.use_verlet_list}
+        s = {"use_verlet_list": cell_structure.use_verlet_list,
+             "use_soa": cell_structure.use_soa,
+             "use_async_ghosts": cell_structure.use_async_ghosts,
+             "use_spatial_sort": cell_structure.use_spatial_sort,
+             "use_eighth_shell": cell_structure.use_eighth_shell}
 
         if cell_structure.decomposition_type() == CELL_STRUCTURE_DOMDEC:
             s["type"] = "domain_decomposition"
@@ -93,24 +141,54 @@ cdef class CellSystem:
 
         s["skin"] = skin
         s["node_grid"] = np.array([node_grid[0], node_grid[1], node_grid[2]])
+        s["n_threads"] = n_threads
+        s["adaptive_skin"] = self.get_adaptive_skin()
+        s["load_balancing"] = self.get_load_balancing()
         return s
 
     def __setstate__(self, d):
         use_verlet_lists = None
+        use_soa = False
+        use_async_ghosts = False
+        use_spatial_sort = False
+        use_eighth_shell = False
         for key in d:
             if key == "use_verlet_list":
                 use_verlet_lists = d[key]
+            elif key == "use_soa":
+                use_soa = d[key]
+            elif key == "use_async_ghosts":
+                use_async_ghosts = d[key]
+            elif key == "use_spatial_sort":
+                use_spatial_sort = d[key]
+            elif key == "use_eighth_shell":
+                use_eighth_shell = d[key]
             elif key == "type":
                 if d[key] == "domain_decomposition":
                     self.set_domain_decomposition(
-                        use_verlet_lists=use_verlet_lists)
+                        use_verlet_lists=use_verlet_lists, use_soa=use_soa,
+                        use_async_ghosts=use_async_ghosts,
+                        use_spatial_sort=use_spatial_sort,
+                        use_eighth_shell=use_eighth_shell)
                 elif d[key] == "nsquare":
-                    self.set_n_square(use_verlet_lists=use_verlet_lists)
+                    self.set_n_square(use_verlet_lists=use_verlet_lists,
+                                      use_spatial_sort=use_spatial_sort)
         self.skin = d['skin']
         self.node_grid = d['node_grid']
+        if 'n_threads' in d:
+            self.n_threads = d['n_threads']
+        if 'adaptive_skin' in d:
+            self.set_adaptive_skin(**d['adaptive_skin'])
+        if 'load_balancing' in d:
+            self.set_load_balancing(**d['load_balancing'])
 
     def get_pairs_(self, distance):
-        return mpi_get_pairs(distance)
+        pairs = mpi_get_pairs(distance)
+        handle_errors("Error in get_pairs")
+        return pairs
+
+    def get_cell_particle_ids_(self):
+        return mpi_get_cell_particle_ids()
 
     def resort(self, global_flag=True):
         """
@@ -151,6 +229,25 @@ cdef class CellSystem:
         def __get__(self):
             return np.array([node_grid[0], node_grid[1], node_grid[2]])
 
+    property n_threads:
+        """
+        Number of threads per MPI rank used by the threaded kernels,
+        e.g. the short-range force loop. Requires OpenMP support.
+        Defaults to 1.
+
+        """
+
+        def __set__(self, int _n_threads):
+            if _n_threads < 1:
+                raise ValueError("Number of threads must be >= 1")
+            global n_threads
+            n_threads = _n_threads
+            mpi_bcast_parameter(FIELD_N_THREADS)
+            handle_errors("Setting the number of threads failed")
+
+        def __get__(self):
+            return n_threads
+
     property skin:
         """
         Value of the skin layer expects a floating point number.
@@ -200,3 +297,94 @@ cdef class CellSystem:
         c_tune_skin(min_skin, max_skin, tol, int_steps, adjust_max_skin)
         handle_errors("Error during tune_skin")
         return self.skin
+
+    def set_adaptive_skin(self, interval, min_skin=0., max_skin=None,
+                          tol=1e-3):
+        """
+        Adjusts the skin on the fly during the integration. The wall time
+        per integration step is measured over windows of ``interval``
+        steps, and the skin is moved towards smaller time per step after
+        each window, see :ref:`Adaptive skin`.
+
+        Parameters
+        -----------
+        interval : :obj:`int`
+            Number of integration steps per timing window,
+            ``0`` disables the adaption.
+        min_skin : :obj:`float`, optional
+            Minimum skin to use.
+        max_skin : :obj:`float`, optional
+            Maximum skin to use. Defaults to the maximum
+            permissible skin.
+        tol : :obj:`float`, optional
+            Smallest change of the skin between two windows.
+
+        """
+        cdef AdaptiveSkinParameters params
+        if interval < 0:
+            raise ValueError("interval must be >= 0")
+        if tol <= 0:
+            raise ValueError("tol must be > 0")
+        if max_skin is None:
+            max_skin = float("inf")
+        if min_skin < 0 or max_skin < min_skin:
+            raise ValueError("Need 0 <= min_skin <= max_skin")
+        params.interval = interval
+        params.min_skin = min_skin
+        params.max_skin = max_skin
+        params.tol = tol
+        mpi_set_adaptive_skin(params)
+
+    def get_adaptive_skin(self):
+        """
+        Parameters of the online skin adaption,
+        see :meth:`set_adaptive_skin`.
+
+        """
+        cdef AdaptiveSkinParameters params = adaptive_skin_parameters()
+        return {"interval": params.interval, "min_skin": params.min_skin,
+                "max_skin": params.max_skin, "tol": params.tol}
+
+    def set_load_balancing(self, interval, threshold=0.1, damping=0.5):
+        """
+        Balances the load of the domain decomposition during the
+        integration by shifting the boundaries between the nodes. The time
+        each node spends in the short-range force calculation is measured
+        over windows of ``interval`` steps, see :ref:`Load balancing`.
+
+        Parameters
+        -----------
+        interval : :obj:`int`
+            Number of integration steps per timing window,
+            ``0`` disables the load balancing and restores
+            equally sized subdomains.
+        threshold : :obj:`float`, optional
+            Relative imbalance of the force calculation time
+            above which the node boundaries are shifted.
+        damping : :obj:`float`, optional
+            Fraction of the estimated shift of the boundaries
+            that is applied after a window, in (0, 1].
+
+        """
+        cdef LoadBalanceParameters params
+        if interval < 0:
+            raise ValueError("interval must be >= 0")
+        if threshold < 0:
+            raise ValueError("threshold must be >= 0")
+        if not 0 < damping <= 1:
+            raise ValueError("damping must be in (0, 1]")
+        params.interval = interval
+        params.threshold = threshold
+        params.damping = damping
+        mpi_set_load_balance(params)
+        handle_errors("Error in set_load_balancing")
+
+    def get_load_balancing(self):
+        """
+        Parameters of the load balancing,
+        see :meth:`set_load_balancing`.
+
+        """
+        cdef LoadBalanceParameters params = load_balance_parameters()
+        return {"interval": params.interval, "threshold": params.threshold,
+                "damping": params.damping}
@@ -121,3 +121,28 @@ IF ELECTROKINETICS and CUDA:
 
         int ek_set_electrostatics_coupling(bool electrostatics_coupling)
         int ek_print_vtk_particle_potential(char * filename)
+
+IF ELECTROKINETICS_CPU:
+    from libcpp.vector cimport vector
+    from .utils cimport Vector3d, Vector3i
+
+    cdef extern from "grid_based_algorithms/electrokinetics_cpu.hpp":
+        cdef cppclass EKParameters:
+            double T
+            double prefactor
+            bool advection
+            bool fluidcoupling_ideal_contribution
+
+        cdef cppclass EKSpecies:
+            double density
+            double D
+            double valency
+            Vector3d ext_force_density
+
+        const EKParameters & ek_cpu_parameters()
+        const vector[EKSpecies] & ek_cpu_species()
+        void mpi_ek_cpu_activate(const EKParameters & params, const vector[EKSpecies] & species) except +
+        void mpi_ek_cpu_deactivate()
+        double ek_cpu_node_get_density(int species, const Vector3i & ind) except +
+        void ek_cpu_node_set_density(int species, const Vector3i & ind, double density) except +
+        double ek_cpu_node_get_potential(const Vector3i & ind) except +
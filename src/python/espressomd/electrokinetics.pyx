@@ -22,6 +22,11 @@ IF CUDA:
     from .lb cimport lb_lbnode_is_index_valid
     from .lb cimport lb_lbfluid_set_lattice_switch
     from .lb cimport GPU
+IF ELECTROKINETICS_CPU:
+    from .lb cimport HydrodynamicInteraction
+    from .lb cimport lb_lbfluid_set_lattice_switch
+    from .lb cimport lb_lbnode_is_index_valid
+    from .lb cimport CPU, NONE
 from . import utils
 import tempfile
 import shutil
@@ -29,6 +34,132 @@ from .utils import is_valid_type
 from .utils cimport Vector3i, Vector6d, handle_errors
 import numpy as np
 
+IF ELECTROKINETICS_CPU:
+    cdef class ElectrokineticsCPU(HydrodynamicInteraction):
+        """
+        Creates the electrokinetic method coupled to the lattice-Boltzmann
+        fluid on the CPU.
+
+        Takes the parameters of :class:`espressomd.lb.LBFluid` and in
+        addition the temperature ``T`` and the electrostatic ``prefactor``
+        of the ions, the flags ``advection`` and ``fluid_coupling``
+        (``"friction"`` or ``"estatics"``) and the ionic ``species`` as
+        a list of dicts with the keys ``density``, ``D``, ``valency`` and
+        ``ext_force_density``.
+
+        """
+
+        def validate_params(self):
+            HydrodynamicInteraction.validate_params(self)
+
+            if self._params["T"] <= 0.:
+                raise ValueError("T has to be a positive double")
+
+            if self._params["fluid_coupling"] not in ["friction", "estatics"]:
+                raise ValueError(
+                    "fluid_coupling has to be 'friction' or 'estatics'.")
+
+            for species in self._params["species"]:
+                for key in species:
+                    if key not in self.species_keys():
+                        raise ValueError(
+                            "Unknown species parameter '{}'".format(key))
+                if species.get("D", 0.) < 0.:
+                    raise ValueError("D has to be a non-negative double")
+
+        def valid_keys(self):
+            return HydrodynamicInteraction.valid_keys(self) + (
+                "T", "prefactor", "advection", "fluid_coupling", "species")
+
+        def required_keys(self):
+            return HydrodynamicInteraction.required_keys(self) + ["T", "prefactor"]
+
+        def default_params(self):
+            params = HydrodynamicInteraction.default_params(self)
+            params.update({"T": -1.,
+                           "prefactor": -1.,
+                           "advection": True,
+                           "fluid_coupling": "friction",
+                           "species": []})
+            return params
+
+        def species_keys(self):
+            return "density", "D", "valency", "ext_force_density"
+
+        def _set_lattice_switch(self):
+            lb_lbfluid_set_lattice_switch(CPU)
+
+        def _activate_method(self):
+            self.validate_params()
+            self._set_lattice_switch()
+            self._set_params_in_es_core()
+
+            cdef EKParameters params
+            params.T = self._params["T"]
+            params.prefactor = self._params["prefactor"]
+            params.advection = self._params["advection"]
+            params.fluidcoupling_ideal_contribution = \
+                self._params["fluid_coupling"] == "friction"
+
+            cdef vector[EKSpecies] species
+            cdef EKSpecies s
+            for p in self._params["species"]:
+                s.density = p.get("density", 0.)
+                s.D = p.get("D", 0.)
+                s.valency = p.get("valency", 0.)
+                ext_force_density = p.get("ext_force_density", [0., 0., 0.])
+                for i in range(3):
+                    s.ext_force_density[i] = ext_force_density[i]
+                species.push_back(s)
+
+            mpi_ek_cpu_activate(params, species)
+            handle_errors("CPU electrokinetics activation")
+
+        def _deactivate_method(self):
+            mpi_ek_cpu_deactivate()
+            lb_lbfluid_set_lattice_switch(NONE)
+
+        cdef Vector3i _node_index(self, node) except *:
+            utils.check_type_or_throw_except(
+                node, 3, int, "The index of a node consists of three integers.")
+            cdef Vector3i ind
+            ind[0] = node[0]
+            ind[1] = node[1]
+            ind[2] = node[2]
+            if not lb_lbnode_is_index_valid(ind):
+                raise ValueError("Node index out of bounds")
+            return ind
+
+        def set_density(self, species, density, node):
+            """
+            Sets the number density of a species at a node.
+
+            Parameters
+            ----------
+            species : :obj:`int`
+                Index of the species in ``species``.
+            density : :obj:`float`
+                The number density.
+            node : (3,) array_like of :obj:`int`
+                The node index.
+
+            """
+            ek_cpu_node_set_density(species, self._node_index(node), density)
+
+        def get_density(self, species, node):
+            """
+            Returns the number density of a species at a node.
+
+            """
+            return ek_cpu_node_get_density(species, self._node_index(node))
+
+        def get_potential(self, node):
+            """
+            Returns the electrostatic potential at a node.
+
+            """
+            return ek_cpu_node_get_potential(self._node_index(node))
+
 IF ELECTROKINETICS:
     cdef class Electrokinetics(HydrodynamicInteraction):
         """
@@ -35,9 +35,10 @@ IF ELECTROSTATICS and P3M:
             double delta_mid_bot,
             bool const_pot,
             double pot_diff
+            int max_block_size
 
         int ELC_set_params(double maxPWerror, double min_dist, double far_cut,
-                           bool neutralize, double delta_mid_top, double delta_mid_bot, bool const_pot, double pot_diff)
+                           bool neutralize, double delta_mid_top, double delta_mid_bot, bool const_pot, double pot_diff, int max_block_size)
 
         # links intern C-struct with python object
         ELC_struct elc_params
@@ -56,6 +57,8 @@ IF ELECTROSTATICS and P3M:
             double relax
             int citeration
             int first_id
+            int anderson_depth
+            int extrapolation_order
 
         # links intern C-struct with python object
         iccp3m_struct iccp3m_cfg
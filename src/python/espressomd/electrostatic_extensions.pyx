@@ -82,6 +82,11 @@ IF ELECTROSTATICS and P3M:
         far_cut : :obj:`float`, optional
             Cutoff radius, use with care, intended for testing purposes. When
             setting the cutoff directly, the maximal pairwise error is ignored.
+        max_block_size : :obj:`int`, optional
+            Largest number of doubles in the particle blocks of the far
+            formula modes that are set up at once, intended for testing
+            purposes. The modes are processed in batches that fit. By
+            default, a budget of :math:`2^{21}` doubles is used.
         """
 
         def validate_params(self):
@@ -96,11 +101,13 @@ IF ELECTROSTATICS and P3M:
             check_type_or_throw_except(self._params["far_cut"], 1, float, "")
             check_type_or_throw_except(
                 self._params["neutralize"], 1, type(True), "")
+            check_type_or_throw_except(
+                self._params["max_block_size"], 1, int, "")
 
         def valid_keys(self):
             return ["maxPWerror", "gap_size", "far_cut", "neutralize",
                     "delta_mid_top", "delta_mid_bot", "const_pot", "pot_diff",
-                    "check_neutrality"]
+                    "check_neutrality", "max_block_size"]
 
         def required_keys(self):
             return ["maxPWerror", "gap_size"]
@@ -114,7 +121,8 @@ IF ELECTROSTATICS and P3M:
                     "const_pot": False,
                     "pot_diff": 0.0,
                     "neutralize": True,
-                    "check_neutrality": True}
+                    "check_neutrality": True,
+                    "max_block_size": -1}
 
         def _get_params_from_es_core(self):
             params = {}
@@ -138,7 +146,8 @@ IF ELECTROSTATICS and P3M:
                 self._params["delta_mid_top"],
                 self._params["delta_mid_bot"],
                 self._params["const_pot"],
-                    self._params["pot_diff"]):
+                self._params["pot_diff"],
+                    self._params["max_block_size"]):
                 handle_errors(
                     "ELC tuning failed, ELC is not set up to work with the GPU P3M")
 
@@ -167,6 +176,13 @@ IF ELECTROSTATICS and P3M:
             change of any of the interface particle's charge.
         relaxation : :obj:`float`, optional
             SOR relaxation parameter.
+        anderson_depth : :obj:`int`, optional
+            Number of previous iterates used to accelerate the iteration by
+            Anderson mixing (default is 0, i.e. plain relaxation).
+        extrapolation_order : :obj:`int`, optional
+            Order of the polynomial extrapolation of the induced charges
+            from the previous time steps, which is used as initial guess
+            (default is 0, i.e. start from the charges of the last step).
         ext_field : :obj:`float`, optional
             Homogeneous electric field added to the calculation of dielectric boundary forces.
         max_iterations : :obj:`int`, optional
@@ -210,6 +226,16 @@ IF ELECTROSTATICS and P3M:
             check_range_or_except(
                 self._params, "max_iterations", 0, False, "inf", True)
 
+            check_type_or_throw_except(
+                self._params["anderson_depth"], 1, int, "")
+            check_range_or_except(
+                self._params, "anderson_depth", 0, True, "inf", True)
+
+            check_type_or_throw_except(
+                self._params["extrapolation_order"], 1, int, "")
+            check_range_or_except(
+                self._params, "extrapolation_order", 0, True, "inf", True)
+
             check_type_or_throw_except(
                 self._params["first_id"], 1, int, "")
             check_range_or_except(
@@ -247,7 +273,8 @@ IF ELECTROSTATICS and P3M:
         def valid_keys(self):
             return ["n_icc", "convergence", "relaxation", "ext_field",
                     "max_iterations", "first_id", "eps_out", "normals",
-                    "areas", "sigmas", "epsilons", "check_neutrality"]
+                    "areas", "sigmas", "epsilons", "check_neutrality",
+                    "anderson_depth", "extrapolation_order"]
 
         def required_keys(self):
             return ["n_icc", "normals", "areas"]
@@ -258,6 +285,8 @@ IF ELECTROSTATICS and P3M:
                     "relaxation": 0.7,
                     "ext_field": [0, 0, 0],
                     "max_iterations": 100,
+                    "anderson_depth": 0,
+                    "extrapolation_order": 0,
                     "first_id": 0,
                     "esp_out": 1,
                     "normals": [],
@@ -293,6 +322,8 @@ IF ELECTROSTATICS and P3M:
             params["max_iterations"] = iccp3m_cfg.num_iteration
             params["convergence"] = iccp3m_cfg.convergence
             params["relaxation"] = iccp3m_cfg.relax
+            params["anderson_depth"] = iccp3m_cfg.anderson_depth
+            params["extrapolation_order"] = iccp3m_cfg.extrapolation_order
             params["eps_out"] = iccp3m_cfg.eout
 
             return params
@@ -320,6 +351,9 @@ IF ELECTROSTATICS and P3M:
             iccp3m_cfg.num_iteration = self._params["max_iterations"]
             iccp3m_cfg.convergence = self._params["convergence"]
             iccp3m_cfg.relax = self._params["relaxation"]
+            iccp3m_cfg.anderson_depth = self._params["anderson_depth"]
+            iccp3m_cfg.extrapolation_order = self._params[
+                "extrapolation_order"]
             iccp3m_cfg.eout = self._params["eps_out"]
 
             # Broadcasts vars
@@ -18,9 +18,11 @@
 #
 
 include "myconfig.pxi"
-from .utils import is_valid_type, to_str
+from .utils import is_valid_type, to_str, to_char_pointer
 from .utils cimport handle_errors
 from libcpp cimport bool
+from libcpp.string cimport string
+from libcpp.vector cimport vector
 
 cdef extern from "SystemInterface.hpp":
     cdef cppclass SystemInterface:
@@ -73,6 +75,19 @@ IF ELECTROSTATICS:
             int p3m_set_mesh_offset(double x, double y, double z)
             int p3m_set_eps(double eps)
             int p3m_adaptive_tune(char ** log)
+            void p3m_set_tuning_cache(const string & path)
+
+            ctypedef struct P3MTuningRecord:
+                int mesh[3]
+                int cao
+                double r_cut_iL
+                double alpha_L
+                double accuracy
+                double rs_err
+                double ks_err
+                double time
+
+            const vector[P3MTuningRecord] & p3m_tuning_table()
 
             ctypedef struct p3m_data_struct:
                 P3MParameters params
@@ -107,9 +122,10 @@ IF ELECTROSTATICS:
             return p3m_set_mesh_offset(
                 mesh_offset[0], mesh_offset[1], mesh_offset[2])
 
-        cdef inline python_p3m_adaptive_tune():
+        cdef inline python_p3m_adaptive_tune(tuning_cache):
             cdef char * log = NULL
             cdef int response
+            p3m_set_tuning_cache(to_char_pointer(tuning_cache))
             response = p3m_adaptive_tune( & log)
             handle_errors("Error in p3m_adaptive_tune")
             if log.strip():
@@ -182,10 +198,11 @@ IF ELECTROSTATICS:
             double far_switch_radius_2
             double maxPWerror
             int    bessel_cutoff
+            bool   far_table
 
         cdef extern MMM1D_struct mmm1d_params
 
-        int MMM1D_set_params(double switch_rad, double maxPWerror)
+        int MMM1D_set_params(double switch_rad, double maxPWerror, bool far_table)
         void MMM1D_init()
         int MMM1D_sanity_checks()
         int mmm1d_tune(char ** log)
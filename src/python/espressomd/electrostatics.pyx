@@ -25,7 +25,7 @@ IF SCAFACOS == 1:
     from .scafacos import ScafacosConnector
     from . cimport scafacos
 from .utils cimport handle_errors
-from .utils import is_valid_type, check_type_or_throw_except, to_str
+from .utils import is_valid_type, check_type_or_throw_except, to_str, to_char_pointer
 from . cimport checks
 from .analyze cimport partCfg, PartCfg
 from .particle_data cimport particle
@@ -222,6 +222,13 @@ IF P3M == 1:
         tune : :obj:`bool`, optional
             Used to activate/deactivate the tuning method on activation.
             Defaults to ``True``.
+        tuning_cache : :obj:`str`, optional
+            Path of a file in which the tuning results are stored. The tuning
+            reuses the stored parameters if the system signature (box, number
+            and sum of the charges, accuracy goal, fixed parameters and rank
+            layout) matches. The file starts with a header that identifies the
+            format and the compiled features; a file written by a different
+            build is replaced. Defaults to ``''`` (no cache).
         check_neutrality : :obj:`bool`, optional
             Raise a warning if the system is not electrically neutral when
             set to ``True`` (default).
@@ -260,6 +267,9 @@ IF P3M == 1:
             if self._params["tune"] and not (self._params["accuracy"] >= 0):
                 raise ValueError("P3M accuracy has to be positive")
 
+            check_type_or_throw_except(self._params["tuning_cache"], 1, str,
+                                       "tuning_cache has to be a string")
+
             if self._params["epsilon"] == "metallic":
                 self._params = 0.0
 
@@ -278,7 +288,7 @@ IF P3M == 1:
 
         def valid_keys(self):
             return ["mesh", "cao", "accuracy", "epsilon", "alpha", "r_cut",
-                    "prefactor", "tune", "check_neutrality"]
+                    "prefactor", "tune", "check_neutrality", "tuning_cache"]
 
         def required_keys(self):
             return ["prefactor", "accuracy"]
@@ -292,7 +302,8 @@ IF P3M == 1:
                     "epsilon": 0.0,
                     "mesh_off": [-1, -1, -1],
                     "tune": True,
-                    "check_neutrality": True}
+                    "check_neutrality": True,
+                    "tuning_cache": ""}
 
         def _get_params_from_es_core(self):
             params = {}
@@ -322,12 +333,23 @@ IF P3M == 1:
                                        self._params["cao"],
                                        -1.0,
                                        self._params["accuracy"])
-            resp = python_p3m_adaptive_tune()
+            resp = python_p3m_adaptive_tune(self._params["tuning_cache"])
             if resp:
                 raise Exception(
                     "failed to tune P3M parameters to required accuracy")
             self._params.update(self._get_params_from_es_core())
 
+        def get_tuning_table(self):
+            """
+            Get the parameter sets timed by the last tuning, as a list of
+            dicts with the keys ``mesh``, ``cao``, ``r_cut_iL``, ``alpha_L``,
+            ``accuracy``, ``rs_err``, ``ks_err`` and ``time`` (in ms).
+            If the parameters were taken from the tuning cache, only the
+            cached optimum is listed.
+
+            """
+            return p3m_tuning_table()
+
         def _activate_method(self):
             check_neutrality(self._params)
             if self._params["tune"]:
@@ -365,6 +387,13 @@ IF P3M == 1:
             tune : :obj:`bool`, optional
                 Used to activate/deactivate the tuning method on activation.
                 Defaults to ``True``.
+            tuning_cache : :obj:`str`, optional
+                Path of a file in which the tuning results are stored. The tuning
+                reuses the stored parameters if the system signature (box, number
+                and sum of the charges, accuracy goal, fixed parameters and rank
+                layout) matches. The file starts with a header that identifies the
+                format and the compiled features; a file written by a different
+                build is replaced. Defaults to ``''`` (no cache).
             check_neutrality : :obj:`bool`, optional
                 Raise a warning if the system is not electrically neutral when
                 set to ``True`` (default).
@@ -402,6 +431,9 @@ IF P3M == 1:
                 if not (self._params["accuracy"] >= 0):
                     raise ValueError("P3M accuracy has to be positive")
 
+                check_type_or_throw_except(self._params["tuning_cache"], 1, str,
+                                           "tuning_cache has to be a string")
+
                 # if self._params["epsilon"] == "metallic":
                 #  self._params = 0.0
 
@@ -416,7 +448,7 @@ IF P3M == 1:
 
             def valid_keys(self):
                 return ["mesh", "cao", "accuracy", "epsilon", "alpha", "r_cut",
-                        "prefactor", "tune", "check_neutrality"]
+                        "prefactor", "tune", "check_neutrality", "tuning_cache"]
 
             def required_keys(self):
                 return ["prefactor", "accuracy"]
@@ -430,7 +462,8 @@ IF P3M == 1:
                         "epsilon": 0.0,
                         "mesh_off": [-1, -1, -1],
                         "tune": True,
-                        "check_neutrality": True}
+                        "check_neutrality": True,
+                        "tuning_cache": ""}
 
             def _get_params_from_es_core(self):
                 params = {}
@@ -446,12 +479,20 @@ IF P3M == 1:
                                            self._params["cao"],
                                            -1.0,
                                            self._params["accuracy"])
-                resp = python_p3m_adaptive_tune()
+                resp = python_p3m_adaptive_tune(self._params["tuning_cache"])
                 if resp:
                     raise Exception(
                         "failed to tune P3M parameters to required accuracy")
                 self._params.update(self._get_params_from_es_core())
 
+            def get_tuning_table(self):
+                """
+                Get the parameter sets timed by the last tuning, see
+                :meth:`P3M.get_tuning_table`.
+
+                """
+                return p3m_tuning_table()
+
             def _activate_method(self):
                 check_neutrality(self._params)
                 python_p3m_gpu_init(self._params)
@@ -487,6 +528,9 @@ IF ELECTROSTATICS:
         far_switch_radius : :obj:`float`, optional
             Radius where near-field and far-field calculation are switched.
         bessel_cutoff : :obj:`int`, optional
+        far_table : :obj:`bool`, optional
+            Interpolate the far formula from a precomputed table.
+            Defaults to ``True``.
         tune : :obj:`bool`, optional
             Specify whether to automatically tune or not. Defaults to ``True``.
 
@@ -508,12 +552,13 @@ IF ELECTROSTATICS:
                     "maxPWerror": -1,
                     "far_switch_radius": -1,
                     "bessel_cutoff": -1,
+                    "far_table": True,
                     "tune": True,
                     "check_neutrality": True}
 
         def valid_keys(self):
             return ["prefactor", "maxPWerror", "far_switch_radius",
-                    "bessel_cutoff", "tune", "check_neutrality"]
+                    "bessel_cutoff", "far_table", "tune", "check_neutrality"]
 
         def required_keys(self):
             return ["prefactor", "maxPWerror"]
@@ -531,7 +576,8 @@ IF ELECTROSTATICS:
         def _set_params_in_es_core(self):
             set_prefactor(self._params["prefactor"])
             MMM1D_set_params(
-                self._params["far_switch_radius"], self._params["maxPWerror"])
+                self._params["far_switch_radius"], self._params["maxPWerror"],
+                self._params["far_table"])
 
         def _tune(self):
             cdef int resp
@@ -40,6 +40,7 @@ cdef extern from "global.hpp":
         int FIELD_NPTISO_G0
         int FIELD_NPTISO_GV
     int FIELD_MAX_OIF_OBJECTS
+    int FIELD_N_THREADS
 
     void mpi_bcast_parameter(int p)
 
@@ -62,6 +63,9 @@ cdef extern from "nonbonded_interactions/nonbonded_interaction_data.hpp":
 cdef extern from "rattle.hpp":
     extern int n_rigidbonds
 
+cdef extern from "threads.hpp":
+    extern int n_threads
+
 cdef extern from "tuning.hpp":
     extern int timing_samples
 
@@ -15,11 +15,13 @@
 # You should have received a copy of the GNU General Public License
 # along with this program.  If not, see <http://www.gnu.org/licenses/>.
 from libcpp cimport bool
+from libcpp.vector cimport vector
 
 from .utils cimport Vector3i, Vector3d
 
 cdef extern from "grid.hpp":
     Vector3i node_grid
+    vector[double] node_boundaries[3]
 
     cppclass BoxGeometry:
         void set_periodic(unsigned coord, bool value)
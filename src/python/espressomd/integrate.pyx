@@ -70,21 +70,21 @@ cdef class IntegratorHandle:
         """
         self._integrator = SteepestDescent(*args, **kwargs)
 
-    def set_vv(self):
+    def set_vv(self, *args, **kwargs):
         """
         Set the integration method to velocity Verlet, which is suitable for
         simulations in the NVT ensemble (:class:`VelocityVerlet`).
 
         """
-        self._integrator = VelocityVerlet()
+        self._integrator = VelocityVerlet(*args, **kwargs)
 
-    def set_nvt(self):
+    def set_nvt(self, *args, **kwargs):
         """
         Set the integration method to velocity Verlet, which is suitable for
         simulations in the NVT ensemble (:class:`VelocityVerlet`).
 
         """
-        self._integrator = VelocityVerlet()
+        self._integrator = VelocityVerlet(*args, **kwargs)
 
     def set_isotropic_npt(self, *args, **kwargs):
         """
@@ -300,16 +300,32 @@ cdef class VelocityVerlet(Integrator):
     """
     Velocity Verlet integrator, suitable for simulations in the NVT ensemble.
 
+    Parameters
+    ----------
+    long_range_interval : :obj:`int`, optional
+        Number of time steps between two evaluations of the long-range
+        forces (electrostatic and magnetostatic k-space and far-field
+        contributions). For values larger than 1, the long-range forces
+        are applied as an impulse for all these time steps (r-RESPA
+        multiple time stepping). Defaults to 1.
+
+        With an interval ``n > 1``, the particle forces ``f`` hold the
+        short-range forces plus ``n`` times the long-range forces after
+        a step in which the long-range forces are evaluated, and only the
+        short-range forces after the other steps. ``run(0,
+        recalc_forces=True)`` restarts the cycle with an evaluation. The
+        GPU and actor based long-range methods are not supported.
+
     """
 
     def default_params(self):
-        return {}
+        return {"long_range_interval": 1}
 
     def valid_keys(self):
         """All parameters that can be set.
 
         """
-        return {}
+        return {"long_range_interval"}
 
     def required_keys(self):
         """Parameters that have to be set.
@@ -318,10 +334,16 @@ cdef class VelocityVerlet(Integrator):
         return {}
 
     def validate_params(self):
-        return True
+        check_type_or_throw_except(
+            self._params["long_range_interval"], 1, int,
+            "long_range_interval must be an int")
+        if self._params["long_range_interval"] < 1:
+            raise ValueError("long_range_interval must be positive")
 
     def _set_params_in_es_core(self):
-        integrate_set_nvt()
+        if integrate_set_nvt(self._params["long_range_interval"]):
+            handle_errors(
+                "Encountered errors setting up the velocity Verlet integrator")
 
 
 IF NPT:
@@ -45,6 +45,10 @@ IF DIPOLES == 1:
         int mdds_set_params(int n_cut)
         int Ncut_off_magnetic_dipolar_direct_sum
 
+    cdef extern from "actor/DipolarBarnesHutCpu.hpp":
+        int activate_dipolar_barnes_hut_cpu(double opening_angle)
+        double dipolar_barnes_hut_cpu_opening_angle()
+
     IF(CUDA == 1) and (ROTATION == 1):
         cdef extern from "actor/DipolarDirectSum.hpp":
             void activate_dipolar_direct_sum_gpu()
@@ -322,6 +322,53 @@ IF DIPOLES == 1:
             handle_errors("Could not activate magnetostatics method "
                           + self.__class__.__name__)
 
+    cdef class DipolarBarnesHutCpu(MagnetostaticInteraction):
+        """
+        Approximate the magnetostatic interactions of all pairs by a
+        Barnes-Hut octree on the CPU. See :ref:`Barnes-Hut octree sum on CPU`
+        for more details.
+
+        If the system has periodic boundaries, the minimum image convention is
+        applied in the respective directions.
+
+        Parameters
+        ----------
+        prefactor : :obj:`float`
+            Magnetostatics prefactor (:math:`\\mu_0/(4\\pi)`)
+        opening_angle : :obj:`float`, optional
+            Ratio of the size of a tree node and its distance below which
+            the node is not opened (default is 0.5). A value of 0 gives the
+            result of :class:`DipolarDirectSumCpu`.
+
+        """
+
+        def validate_params(self):
+            super().validate_params()
+            if not self._params["opening_angle"] >= 0:
+                raise ValueError("opening_angle should be a positive float")
+
+        def default_params(self):
+            return {"opening_angle": 0.5}
+
+        def required_keys(self):
+            return ()
+
+        def valid_keys(self):
+            return ("prefactor", "opening_angle")
+
+        def _get_params_from_es_core(self):
+            return {"prefactor": dipole.prefactor,
+                    "opening_angle": dipolar_barnes_hut_cpu_opening_angle()}
+
+        def _activate_method(self):
+            self._set_params_in_es_core()
+
+        def _set_params_in_es_core(self):
+            self.set_magnetostatics_prefactor()
+            activate_dipolar_barnes_hut_cpu(self._params["opening_angle"])
+            handle_errors("Could not activate magnetostatics method "
+                          + self.__class__.__name__)
+
     IF SCAFACOS_DIPOLES == 1:
         class Scafacos(ScafacosConnector, MagnetostaticInteraction):
 
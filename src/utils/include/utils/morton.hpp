@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2020 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef UTILS_MORTON_HPP
+#define UTILS_MORTON_HPP
+
+#include <cstdint>
+
+namespace Utils {
+namespace detail {
+/** Spread the lowest 21 bits of @p x to every third bit. */
+inline uint64_t spread_bits_3d(uint64_t x) {
+  x &= 0x1fffff;
+  x = (x | (x << 32)) & 0x1f00000000ffff;
+  x = (x | (x << 16)) & 0x1f0000ff0000ff;
+  x = (x | (x << 8)) & 0x100f00f00f00f00f;
+  x = (x | (x << 4)) & 0x10c30c30c30c30c3;
+  x = (x | (x << 2)) & 0x1249249249249249;
+  return x;
+}
+} // namespace detail
+
+/**
+ * @brief Position of a point of a 3d grid on the Morton (Z-order) curve.
+ *
+ * Points that are close on the curve are close in space, so sorting by
+ * this key improves the locality of spatial data. Only the lowest 21 bits
+ * of every coordinate are used.
+ *
+ * @param x, y, z Grid coordinates.
+ * @return Interleaved bits of the coordinates, x in the lowest bit.
+ */
+inline uint64_t morton_code(uint32_t x, uint32_t y, uint32_t z) {
+  return detail::spread_bits_3d(x) | (detail::spread_bits_3d(y) << 1) |
+         (detail::spread_bits_3d(z) << 2);
+}
+} // namespace Utils
+
+#endif
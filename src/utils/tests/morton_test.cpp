@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2020 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE Utils::morton_code test
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <utils/morton.hpp>
+
+#include <cstdint>
+
+/* Reference implementation, one bit at a time */
+static uint64_t morton_ref(uint32_t x, uint32_t y, uint32_t z) {
+  uint64_t code = 0;
+  for (int bit = 0; bit < 21; bit++) {
+    code |= static_cast<uint64_t>((x >> bit) & 1u) << (3 * bit);
+    code |= static_cast<uint64_t>((y >> bit) & 1u) << (3 * bit + 1);
+    code |= static_cast<uint64_t>((z >> bit) & 1u) << (3 * bit + 2);
+  }
+  return code;
+}
+
+BOOST_AUTO_TEST_CASE(small) {
+  BOOST_CHECK_EQUAL(Utils::morton_code(0, 0, 0), 0u);
+  BOOST_CHECK_EQUAL(Utils::morton_code(1, 0, 0), 1u);
+  BOOST_CHECK_EQUAL(Utils::morton_code(0, 1, 0), 2u);
+  BOOST_CHECK_EQUAL(Utils::morton_code(0, 0, 1), 4u);
+  BOOST_CHECK_EQUAL(Utils::morton_code(1, 1, 1), 7u);
+  BOOST_CHECK_EQUAL(Utils::morton_code(2, 0, 0), 8u);
+}
+
+BOOST_AUTO_TEST_CASE(reference) {
+  uint32_t const values[] = {3u, 17u, 1000u, 123456u, 0x1fffffu, 0xffffffffu};
+  for (auto x : values)
+    for (auto y : values)
+      for (auto z : values) {
+        BOOST_CHECK_EQUAL(Utils::morton_code(x, y, z), morton_ref(x, y, z));
+      }
+}
@@ -0,0 +1,40 @@
+#
+# Copyright (C) 2020 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+import espressomd
+import unittest as ut
+import unittest_decorators as utx
+
+from cell_system_common import CellSystemOptionCommon
+
+
+@utx.skipIfMissingFeatures(["LENNARD_JONES"])
+class AsyncGhosts(CellSystemOptionCommon, ut.TestCase):
+
+    """Compare trajectories with the ghost positions sent without
+       blocking to trajectories with the blocking ghost communication.
+
+    """
+    system = espressomd.System(box_l=3 * [10.])
+    system.time_step = 0.005
+    system.cell_system.skin = 0.4
+    option = "use_async_ghosts"
+
+
+if __name__ == '__main__':
+    ut.main()
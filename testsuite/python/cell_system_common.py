@@ -0,0 +1,115 @@
+#
+# Copyright (C) 2020 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+import espressomd
+import espressomd.interactions
+import numpy as np
+import unittest_decorators as utx
+
+
+class TrajectoryCommon:
+
+    """Run a trajectory from stored initial conditions. Derived classes
+       store the initial positions and velocities in ``pos0`` and ``v0``.
+
+    """
+    n_steps = 100
+
+    def trajectory(self):
+        self.system.part[:].pos = self.pos0
+        self.system.part[:].v = self.v0
+        self.system.integrator.run(0, recalc_forces=True)
+        self.system.integrator.run(self.n_steps)
+        return (np.copy(self.system.part[:].pos),
+                np.copy(self.system.part[:].f))
+
+    def assert_trajectories_equal(self, traj, traj_ref):
+        np.testing.assert_allclose(traj[0], traj_ref[0], atol=1e-8)
+        np.testing.assert_allclose(traj[1], traj_ref[1], atol=1e-6)
+
+
+class LatticeCommon(TrajectoryCommon):
+
+    """Lennard-Jones particles on a perturbed lattice with random
+       velocities. If ``bonds`` is set, the particles are connected to
+       chains by harmonic bonds. Derived classes provide the ``system``
+       with a cubic box of length 10.
+
+    """
+    bonds = True
+
+    def setUp(self):
+        np.random.seed(42)
+        pos = np.mgrid[0:10, 0:10, 0:10].reshape(3, -1).T + \
+            0.05 * np.random.random((1000, 3))
+        self.system.part.add(pos=pos, v=np.random.normal(size=(1000, 3)))
+        self.system.non_bonded_inter[0, 0].lennard_jones.set_params(
+            epsilon=1.0, sigma=0.9, cutoff=1.5, shift="auto")
+        if self.bonds:
+            harmonic = espressomd.interactions.HarmonicBond(k=10., r_0=1.)
+            self.system.bonded_inter.add(harmonic)
+            for i in range(0, 1000, 10):
+                for j in range(i, i + 9):
+                    self.system.part[j].add_bond((harmonic, j + 1))
+        self.pos0 = np.copy(self.system.part[:].pos)
+        self.v0 = np.copy(self.system.part[:].v)
+
+    def tearDown(self):
+        self.system.part.clear()
+        self.system.cell_system.set_domain_decomposition()
+        self.system.cell_system.n_threads = 1
+
+
+class CellSystemOptionCommon(LatticeCommon):
+
+    """Compare trajectories with the cell system option ``option``
+       switched on to trajectories with the option switched off.
+
+    """
+    option = None
+    threaded_options = ({"use_verlet_lists": True}, {"use_soa": True})
+
+    def set_cell_system(self, value, set_cell_system=None, **kwargs):
+        if set_cell_system is None:
+            set_cell_system = self.system.cell_system.set_domain_decomposition
+        kwargs[self.option] = value
+        set_cell_system(**kwargs)
+        self.assertEqual(self.system.cell_system.get_state()[self.option],
+                         value)
+
+    def check(self, set_cell_system=None, **kwargs):
+        self.set_cell_system(False, set_cell_system, **kwargs)
+        traj_ref = self.trajectory()
+        self.set_cell_system(True, set_cell_system, **kwargs)
+        traj = self.trajectory()
+        self.assert_trajectories_equal(traj, traj_ref)
+
+    def test_dd(self):
+        self.check(use_verlet_lists=False)
+
+    def test_dd_vl(self):
+        self.check(use_verlet_lists=True)
+
+    def test_dd_soa(self):
+        self.check(use_soa=True)
+
+    @utx.skipIfMissingFeatures(["OPENMP"])
+    def test_dd_threaded(self):
+        self.system.cell_system.n_threads = 4
+        for options in self.threaded_options:
+            self.check(**options)
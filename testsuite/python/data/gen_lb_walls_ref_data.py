@@ -0,0 +1,61 @@
+#
+# Copyright (C) 2020 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+"""
+Reference fluid for lb_streaming_reference.py and lb_single_precision.py:
+the populations, velocities and densities of a thermalized CPU LB fluid
+between two walls after 50 time steps. The data was generated in double
+precision with the two-lattice streaming (pre- and post-collision arrays)
+of the CPU LB, which the in-place streaming has to reproduce exactly and
+the single-precision populations within float accuracy.
+
+"""
+import espressomd
+import espressomd.lb
+import espressomd.lbboundaries
+import espressomd.shapes
+import numpy as np
+
+LB_PARAMS = {'agrid': 1.,
+             'dens': 0.8,
+             'visc': 1.1,
+             'tau': 0.01,
+             'kT': 0.5,
+             'seed': 17,
+             'ext_force_density': [0.01, -0.02, 0.005]}
+
+system = espressomd.System(box_l=[6., 8., 10.])
+system.time_step = 0.01
+system.cell_system.skin = 0.4
+lbf = espressomd.lb.LBFluid(**LB_PARAMS)
+system.actors.add(lbf)
+system.lbboundaries.add(espressomd.lbboundaries.LBBoundary(
+    shape=espressomd.shapes.Wall(normal=[0, 0, 1], dist=1.5),
+    velocity=[0.01, 0., 0.]))
+system.lbboundaries.add(espressomd.lbboundaries.LBBoundary(
+    shape=espressomd.shapes.Wall(normal=[0, 0.3, -1], dist=-7.5)))
+system.integrator.run(50)
+
+nodes = [lbf[i, j, k] for i in range(lbf.shape[0])
+         for j in range(lbf.shape[1]) for k in range(lbf.shape[2])]
+np.savez_compressed(
+    "lb_walls_system.npz",
+    population=np.array([n.population for n in nodes]),
+    velocity=np.array([n.velocity for n in nodes]),
+    density=np.array([n.density for n in nodes]),
+    boundary=np.array([n.boundary for n in nodes]))
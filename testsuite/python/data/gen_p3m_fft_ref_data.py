@@ -0,0 +1,78 @@
+#
+# Copyright (C) 2020 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+"""
+Reference data for p3m_fft.py: energies, pressures, forces and torques of
+P3M and dipolar P3M for random charges and dipoles. The data was generated
+with the complex-to-complex FFT of the P3M meshes, which the
+real-to-complex FFT has to reproduce. The cases ``*_mesh_z`` have a
+minimal mesh along the direction of the real-to-complex FFT: with 2 mesh
+points, only the zero and the Nyquist mode are stored, with 4 mesh points
+also the single mode in between, which counts twice.
+
+"""
+import espressomd
+import espressomd.electrostatics
+import espressomd.magnetostatics
+import numpy as np
+
+system = espressomd.System(box_l=[10., 12., 8.])
+system.time_step = 0.01
+system.cell_system.skin = 0.4
+
+P3M_PARAMS = {'prefactor': 1.3, 'accuracy': 1e-3, 'alpha': 1.1,
+              'r_cut': 2.5, 'tune': False}
+P3M_MESHES = {'p3m': ([16, 20, 14], 5), 'p3m_mesh_z': ([16, 20, 2], 1)}
+DP3M_PARAMS = {'prefactor': 1.7, 'accuracy': 1e-3, 'alpha': 0.9,
+               'r_cut': 3., 'tune': False}
+DP3M_MESHES = {'dp3m': (16, 4), 'dp3m_mesh_z': (4, 3)}
+
+np.random.seed(42)
+n_part = 40
+data = {'pos': np.random.random((n_part, 3)) * system.box_l,
+        'q': np.resize([1., -1.], n_part),
+        'dp3m_pos': np.random.random((n_part, 3)) * 10.,
+        'dip': np.random.uniform(-1., 1., (n_part, 3))}
+
+for name, (mesh, cao) in P3M_MESHES.items():
+    system.part.add(pos=data['pos'], q=data['q'])
+    system.actors.add(espressomd.electrostatics.P3M(
+        mesh=mesh, cao=cao, **P3M_PARAMS))
+    system.integrator.run(0)
+    data[name + '_energy'] = system.analysis.energy()['coulomb']
+    data[name + '_energy_kspace'] = system.analysis.energy()['coulomb', 1]
+    data[name + '_pressure'] = system.analysis.pressure()['coulomb']
+    data[name + '_pressure_tensor'] = \
+        system.analysis.pressure_tensor()['coulomb']
+    data[name + '_forces'] = np.copy(system.part[:].f)
+    system.actors.clear()
+    system.part.clear()
+
+system.box_l = [10., 10., 10.]
+for name, (mesh, cao) in DP3M_MESHES.items():
+    system.part.add(pos=data['dp3m_pos'], dip=data['dip'])
+    system.actors.add(espressomd.magnetostatics.DipolarP3M(
+        mesh=mesh, cao=cao, **DP3M_PARAMS))
+    system.integrator.run(0)
+    data[name + '_energy'] = system.analysis.energy()['dipolar']
+    data[name + '_forces'] = np.copy(system.part[:].f)
+    data[name + '_torques'] = np.copy(system.part[:].torque_lab)
+    system.actors.clear()
+    system.part.clear()
+
+np.savez_compressed("p3m_fft_system.npz", **data)
@@ -0,0 +1,109 @@
+#
+# Copyright (C) 2020 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+import espressomd
+import espressomd.magnetostatics
+import numpy as np
+import unittest as ut
+import unittest_decorators as utx
+
+
+@utx.skipIfMissingFeatures(["DIPOLES", "ROTATION"])
+class DipolarBarnesHutCpu(ut.TestCase):
+
+    """Compare the energy, forces and torques of the CPU Barnes-Hut tree
+       code to the dipolar direct sum.
+
+    """
+    system = espressomd.System(box_l=[10., 12., 14.])
+    system.time_step = 0.01
+    system.cell_system.skin = 0.4
+    prefactor = 1.7
+
+    def setUp(self):
+        np.random.seed(42)
+        n_part = 300
+        self.system.part.add(
+            pos=np.random.random((n_part, 3)) * self.system.box_l,
+            rotation=n_part * [(1, 1, 1)],
+            dip=np.random.random((n_part, 3)) - 0.5)
+
+    def tearDown(self):
+        self.system.actors.clear()
+        self.system.part.clear()
+        self.system.periodicity = [True, True, True]
+        self.system.cell_system.n_threads = 1
+
+    def calc(self, actor):
+        self.system.actors.add(actor)
+        self.system.integrator.run(0, recalc_forces=True)
+        result = (self.system.analysis.energy()["dipolar"],
+                  np.copy(self.system.part[:].f),
+                  np.copy(self.system.part[:].torque_lab))
+        self.system.actors.remove(actor)
+        return result
+
+    def compare(self, opening_angle, tol):
+        energy_ref, forces_ref, torques_ref = self.calc(
+            espressomd.magnetostatics.DipolarDirectSumCpu(
+                prefactor=self.prefactor))
+        bh = espressomd.magnetostatics.DipolarBarnesHutCpu(
+            prefactor=self.prefactor, opening_angle=opening_angle)
+        energy, forces, torques = self.calc(bh)
+        self.assertAlmostEqual(bh.get_params()["opening_angle"],
+                               opening_angle, delta=1e-12)
+
+        def rel_rms(a, b):
+            return np.sqrt(np.sum((a - b)**2) / np.sum(b**2))
+
+        self.assertLess(rel_rms(forces, forces_ref), tol)
+        self.assertLess(rel_rms(torques, torques_ref), tol)
+        self.assertAlmostEqual(energy, energy_ref,
+                               delta=10. * tol * abs(energy_ref))
+
+    def test_exact(self):
+        self.compare(0., 1e-12)
+        if espressomd.has_features("OPENMP"):
+            self.system.cell_system.n_threads = 3
+            self.compare(0., 1e-12)
+
+    def test_approximation(self):
+        self.compare(0.3, 1e-2)
+        if espressomd.has_features("OPENMP"):
+            self.system.cell_system.n_threads = 3
+            self.compare(0.3, 1e-2)
+
+    def test_open_boundaries(self):
+        self.system.periodicity = [False, True, False]
+        self.compare(0., 1e-12)
+        self.compare(0.3, 1e-2)
+
+    def test_deactivation(self):
+        bh = espressomd.magnetostatics.DipolarBarnesHutCpu(
+            prefactor=self.prefactor)
+        self.system.actors.add(bh)
+        self.system.actors.remove(bh)
+        self.system.integrator.run(0, recalc_forces=True)
+        np.testing.assert_array_equal(np.copy(self.system.part[:].f), 0.)
+        with self.assertRaises(ValueError):
+            espressomd.magnetostatics.DipolarBarnesHutCpu(
+                prefactor=self.prefactor, opening_angle=-1.).validate_params()
+
+
+if __name__ == '__main__':
+    ut.main()
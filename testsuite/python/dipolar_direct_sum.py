@@ -0,0 +1,144 @@
+#
+# Copyright (C) 2020 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+import espressomd
+import espressomd.magnetostatics
+import itertools
+import numpy as np
+import unittest as ut
+import unittest_decorators as utx
+
+
+@utx.skipIfMissingFeatures(["DIPOLES", "ROTATION"])
+class DipolarDirectSum(ut.TestCase):
+
+    """Compare the energy, forces and torques of the parallel dipolar direct
+       sums to a reference calculation with the minimum image convention or
+       with periodic images.
+
+    """
+    system = espressomd.System(box_l=[10., 12., 14.])
+    system.time_step = 0.01
+    system.cell_system.skin = 0.4
+    prefactor = 1.7
+
+    def setUp(self):
+        np.random.seed(42)
+        n_part = 60
+        self.system.part.add(
+            pos=np.random.random((n_part, 3)) * self.system.box_l,
+            rotation=n_part * [(1, 1, 1)],
+            dip=np.random.random((n_part, 3)) - 0.5)
+        # particles without dipole moment are skipped
+        self.system.part.add(pos=[1., 1., 1.], rotation=(1, 1, 1))
+
+    def tearDown(self):
+        self.system.actors.clear()
+        self.system.part.clear()
+        self.system.periodicity = [True, True, True]
+        self.system.cell_system.n_threads = 1
+
+    def reference(self, n_replica=None):
+        """Sum over the pairs with the minimum image convention or, if
+           ``n_replica`` is given, over the periodic images within a
+           sphere of ``n_replica`` box lengths.
+
+        """
+        pos = np.copy(self.system.part[:].pos)
+        dip = np.copy(self.system.part[:].dip)
+        box_l = np.copy(self.system.box_l)
+        periodic = np.array(self.system.periodicity)
+        if n_replica is None:
+            shifts = [np.zeros(3)]
+        else:
+            n_range = [range(-n_replica, n_replica + 1) if p else [0]
+                       for p in periodic]
+            shifts = [np.array(n) * box_l for n in itertools.product(*n_range)
+                      if np.dot(n, n) <= n_replica**2]
+        energy = 0.
+        forces = np.zeros_like(pos)
+        torques = np.zeros_like(pos)
+        for i in range(len(pos)):
+            for j in range(len(pos)):
+                for shift in shifts:
+                    if i == j and not np.any(shift):
+                        continue
+                    r = pos[i] + shift - pos[j]
+                    if n_replica is None:
+                        r -= periodic * np.round(r / box_l) * box_l
+                    d = np.linalg.norm(r)
+                    pe1 = np.dot(dip[i], dip[j])
+                    pe2 = np.dot(dip[i], r)
+                    pe3 = np.dot(dip[j], r)
+                    energy += 0.5 * (pe1 / d**3 - 3. * pe2 * pe3 / d**5)
+                    forces[i] += (3. * pe1 / d**5 - 15. * pe2 * pe3 / d**7) \
+                        * r + 3. * pe3 / d**5 * dip[i] \
+                        + 3. * pe2 / d**5 * dip[j]
+                    torques[i] += -np.cross(dip[i], dip[j]) / d**3 \
+                        + 3. * pe3 / d**5 * np.cross(dip[i], r)
+        return (self.prefactor * energy, self.prefactor * forces,
+                self.prefactor * torques)
+
+    def check(self, n_threads, n_replica=None):
+        self.system.cell_system.n_threads = n_threads
+        self.system.integrator.run(0, recalc_forces=True)
+        energy_ref, forces_ref, torques_ref = self.reference(n_replica)
+        np.testing.assert_allclose(
+            np.copy(self.system.part[:].f), forces_ref, atol=1e-10)
+        np.testing.assert_allclose(
+            np.copy(self.system.part[:].torque_lab), torques_ref, atol=1e-10)
+        self.assertAlmostEqual(
+            self.system.analysis.energy()["dipolar"], energy_ref, delta=1e-10)
+
+    def test_dawaanr(self):
+        dds = espressomd.magnetostatics.DipolarDirectSumCpu(
+            prefactor=self.prefactor)
+        self.system.actors.add(dds)
+        self.check(1)
+        if espressomd.has_features("OPENMP"):
+            self.check(3)
+
+    def test_dawaanr_open_boundaries(self):
+        self.system.periodicity = [False, True, False]
+        dds = espressomd.magnetostatics.DipolarDirectSumCpu(
+            prefactor=self.prefactor)
+        self.system.actors.add(dds)
+        self.check(1)
+
+    def test_replica(self):
+        for n_replica in (0, 1):
+            dds = espressomd.magnetostatics.DipolarDirectSumWithReplicaCpu(
+                prefactor=self.prefactor, n_replica=n_replica)
+            self.system.actors.add(dds)
+            self.check(1, n_replica)
+            if espressomd.has_features("OPENMP"):
+                self.check(3, n_replica)
+            self.system.actors.clear()
+
+    def test_replica_open_boundaries(self):
+        self.system.periodicity = [True, False, True]
+        for n_replica in (0, 1):
+            dds = espressomd.magnetostatics.DipolarDirectSumWithReplicaCpu(
+                prefactor=self.prefactor, n_replica=n_replica)
+            self.system.actors.add(dds)
+            self.check(1, n_replica)
+            self.system.actors.clear()
+
+
+if __name__ == '__main__':
+    ut.main()
@@ -0,0 +1,82 @@
+#
+# Copyright (C) 2020 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+import espressomd
+import espressomd.interactions
+import numpy as np
+import unittest as ut
+import unittest_decorators as utx
+
+from cell_system_common import CellSystemOptionCommon
+
+
+@utx.skipIfMissingFeatures(["LENNARD_JONES"])
+class EighthShell(CellSystemOptionCommon, ut.TestCase):
+
+    """Compare trajectories with the eighth-shell scheme to trajectories
+       with the default half-shell scheme of the domain decomposition.
+
+    """
+    system = espressomd.System(box_l=3 * [10.])
+    system.time_step = 0.005
+    system.cell_system.skin = 0.4
+    option = "use_eighth_shell"
+    bonds = False
+    threaded_options = ({"use_verlet_lists": True},)
+
+    def test_dd_async_ghosts(self):
+        self.check(use_async_ghosts=True)
+
+    def test_pairs(self):
+        cutoff = 1.5
+        self.system.cell_system.set_domain_decomposition()
+        pairs_ref = self.system.cell_system.get_pairs_(cutoff)
+        self.set_cell_system(True)
+        pairs = self.system.cell_system.get_pairs_(cutoff)
+        # every pair is visited exactly once
+        self.assertEqual(len(pairs), len(set(pairs)))
+        self.assertEqual(len(pairs), len(pairs_ref))
+        self.assertEqual(sorted(pairs), sorted(pairs_ref))
+
+        # the pairs of the full shell, from all particle distances
+        box_l = np.copy(self.system.box_l)
+        pos = self.system.part[:].pos
+        dist = pos[:, np.newaxis, :] - pos[np.newaxis, :, :]
+        dist -= box_l * np.round(dist / box_l)
+        in_range = np.sum(dist**2, axis=-1) < cutoff**2
+        pairs_full = list(zip(*np.nonzero(np.triu(in_range, k=1))))
+        self.assertEqual(sorted(pairs), [(int(i), int(j))
+                                         for i, j in pairs_full])
+
+    def test_bonds_unsupported(self):
+        harmonic = espressomd.interactions.HarmonicBond(k=10., r_0=1.)
+        self.system.bonded_inter.add(harmonic)
+        self.system.part[0].add_bond((harmonic, 1))
+        self.set_cell_system(True)
+        with self.assertRaises(Exception):
+            self.system.integrator.run(0)
+        with self.assertRaises(Exception):
+            self.system.analysis.energy()
+        with self.assertRaises(Exception):
+            self.system.analysis.pressure()
+        with self.assertRaises(Exception):
+            self.system.cell_system.get_pairs_(1.5)
+
+
+if __name__ == '__main__':
+    ut.main()
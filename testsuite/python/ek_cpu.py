@@ -0,0 +1,244 @@
+#
+# Copyright (C) 2020 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+import itertools
+import numpy as np
+import unittest as ut
+import unittest_decorators as utx
+
+import espressomd
+import espressomd.electrokinetics
+import espressomd.lbboundaries
+import espressomd.shapes
+
+EK_PARAMS = {'agrid': 1.,
+             'dens': 1.,
+             'visc': 1.,
+             'tau': 0.1,
+             'T': 1.,
+             'prefactor': 0.7}
+
+
+@utx.skipIfMissingFeatures(["ELECTROKINETICS_CPU"])
+class EKCPU(ut.TestCase):
+
+    """Check the CPU electrokinetics against the exact solutions of its
+       discretization.
+
+    """
+    system = espressomd.System(box_l=[2., 2., 12.])
+    system.time_step = 0.1
+    system.cell_system.skin = 0.4
+
+    def tearDown(self):
+        self.system.actors.clear()
+        if espressomd.has_features(["LB_BOUNDARIES"]):
+            self.system.lbboundaries.clear()
+
+    def nodes(self):
+        return itertools.product(*map(range, self.system.box_l.astype(int)))
+
+    def test_diffusion(self):
+        # a density wave along z decays by the factor
+        # 1 + 2 D tau (cos(k) - 1) per step
+        D = 0.5
+        ek = espressomd.electrokinetics.ElectrokineticsCPU(
+            species=[{'density': 1., 'D': D}], advection=False, **EK_PARAMS)
+        self.system.actors.add(ek)
+        k = 2. * np.pi / self.system.box_l[2]
+        for node in self.nodes():
+            ek.set_density(0, 1. + 0.2 * np.cos(k * node[2]), node)
+        n_steps = 50
+        self.system.integrator.run(n_steps)
+        decay = (1. + 2. * D * self.system.time_step * (np.cos(k) - 1.))**n_steps
+        for node in self.nodes():
+            np.testing.assert_allclose(
+                ek.get_density(0, node),
+                1. + 0.2 * decay * np.cos(k * node[2]), rtol=1e-12)
+
+    def test_poisson(self):
+        # potential of a charge wave from the discrete Laplacian
+        ek = espressomd.electrokinetics.ElectrokineticsCPU(
+            species=[{'density': 1., 'valency': 1.}], advection=False,
+            **EK_PARAMS)
+        self.system.actors.add(ek)
+        k = 2. * np.pi / self.system.box_l[2]
+        for node in self.nodes():
+            ek.set_density(0, 1. + 0.3 * np.cos(k * node[2]), node)
+        self.system.integrator.run(1)
+        for node in self.nodes():
+            ref = -2. * np.pi * EK_PARAMS['prefactor'] * 0.3 * \
+                np.cos(k * node[2]) / (np.cos(k) - 1.)
+            self.assertAlmostEqual(ek.get_potential(node), ref, delta=1e-10)
+
+    @utx.skipIfMissingFeatures(["LB_BOUNDARIES"])
+    def test_sedimentation(self):
+        # without flux the densities of neighboring nodes have the ratio
+        # (1 + F a / 2 T) / (1 - F a / 2 T)
+        force = 0.1
+        ek = espressomd.electrokinetics.ElectrokineticsCPU(
+            species=[{'density': 1., 'D': 1.,
+                      'ext_force_density': [0., 0., -force]}],
+            **EK_PARAMS)
+        self.system.actors.add(ek)
+        self.system.lbboundaries.add(espressomd.lbboundaries.LBBoundary(
+            shape=espressomd.shapes.Wall(normal=[0, 0, 1], dist=1.)))
+        self.system.lbboundaries.add(espressomd.lbboundaries.LBBoundary(
+            shape=espressomd.shapes.Wall(normal=[0, 0, -1], dist=-11.)))
+        self.system.integrator.run(1500)
+
+        densities = np.array([ek.get_density(0, node)
+                              for node in self.nodes()])
+        self.assertAlmostEqual(np.sum(densities), 48., delta=1e-9)
+        ratio = (1. - 0.5 * force) / (1. + 0.5 * force)
+        for z in range(1, 10):
+            np.testing.assert_allclose(
+                ek.get_density(0, [1, 0, z + 1]) /
+                ek.get_density(0, [1, 0, z]), ratio, rtol=1e-5)
+
+    @utx.skipIfMissingFeatures(["LB_BOUNDARIES"])
+    def test_boundary_periodic_image(self):
+        # a boundary layer at the edge of the box also closes the links to
+        # its periodic image
+        ek = espressomd.electrokinetics.ElectrokineticsCPU(
+            species=[{'density': 1., 'D': 1.,
+                      'ext_force_density': [0., 0., 0.1]}],
+            **EK_PARAMS)
+        self.system.actors.add(ek)
+        self.system.lbboundaries.add(espressomd.lbboundaries.LBBoundary(
+            shape=espressomd.shapes.Wall(normal=[0, 0, 1], dist=1.)))
+        self.system.integrator.run(100)
+        densities = np.array([ek.get_density(0, node)
+                              for node in self.nodes()])
+        self.assertAlmostEqual(np.sum(densities), 48., delta=1e-9)
+
+    def test_friction_coupling(self):
+        # the fluxes give the fluid the momentum of the external force on
+        # the species, the diffusive fluxes cancel
+        force = np.array([0.02, -0.01, 0.03])
+        ek = espressomd.electrokinetics.ElectrokineticsCPU(
+            species=[{'density': 0.5, 'D': 0.4, 'ext_force_density': force}],
+            fluid_coupling="friction", **EK_PARAMS)
+        self.system.actors.add(ek)
+        k = 2. * np.pi / self.system.box_l[2]
+        for node in self.nodes():
+            ek.set_density(0, 0.5 + 0.2 * np.cos(k * node[2]), node)
+        n_steps = 20
+        self.system.integrator.run(n_steps)
+        n_ions = 0.5 * np.prod(np.copy(self.system.box_l))
+        np.testing.assert_allclose(
+            self.system.analysis.linear_momentum(include_particles=False),
+            n_ions * force * n_steps * self.system.time_step, rtol=1e-10)
+
+    @utx.skipIfMissingFeatures(["LB_BOUNDARIES"])
+    def test_electroosmotic_flow(self):
+        # counterions between two charged walls, made of a frozen species in
+        # the boundary nodes, are driven along x and drag the fluid with the
+        # estatics coupling
+        sigma = -0.05
+        force = 0.1
+        width = self.system.box_l[2] - 2.
+        bjerrum_length = EK_PARAMS['prefactor'] / EK_PARAMS['T']
+        ek = espressomd.electrokinetics.ElectrokineticsCPU(
+            species=[{'density': 0., 'D': 1., 'valency': 1.,
+                      'ext_force_density': [force, 0., 0.]},
+                     {'density': 0., 'D': 0., 'valency': -1.}],
+            fluid_coupling="estatics", **EK_PARAMS)
+        self.system.actors.add(ek)
+        self.system.lbboundaries.add(espressomd.lbboundaries.LBBoundary(
+            shape=espressomd.shapes.Wall(normal=[0, 0, 1], dist=1.)))
+        self.system.lbboundaries.add(espressomd.lbboundaries.LBBoundary(
+            shape=espressomd.shapes.Wall(normal=[0, 0, -1], dist=-11.)))
+        for node in self.nodes():
+            if node[2] in (0, 11):
+                ek.set_density(1, -sigma, node)
+            else:
+                ek.set_density(0, -2. * sigma / width, node)
+        self.system.integrator.run(2000)
+
+        xi = self.eof_xi(width, bjerrum_length, sigma)
+        x = np.arange(1, 11) - 0.5 - 0.5 * width
+        density = xi**2 / (2. * np.pi * bjerrum_length * np.cos(xi * x)**2)
+        viscosity = EK_PARAMS['visc'] * EK_PARAMS['dens']
+        velocity = force * np.log(np.cos(xi * x) / np.cos(0.5 * xi * width)) \
+            / (2. * np.pi * bjerrum_length * viscosity)
+        np.testing.assert_allclose(
+            [ek.get_density(0, [0, 1, z]) for z in range(1, 11)], density,
+            rtol=2e-2)
+        np.testing.assert_allclose(
+            [ek[0, 1, z].velocity[0] for z in range(1, 11)], velocity,
+            atol=2e-4)
+
+    def eof_xi(self, width, bjerrum_length, sigma):
+        # root of xi tan(xi width / 2) = -2 pi bjerrum_length sigma
+        rhs = -2. * np.pi * bjerrum_length * sigma
+        lower, upper = 0., np.pi / width
+        for _ in range(60):
+            xi = 0.5 * (lower + upper)
+            if xi * np.tan(0.5 * xi * width) < rhs:
+                lower = xi
+            else:
+                upper = xi
+        return xi
+
+
+@utx.skipIfMissingGPU()
+@utx.skipIfMissingFeatures(["ELECTROKINETICS_CPU", "ELECTROKINETICS"])
+class EKCPUGPUReference(ut.TestCase):
+
+    """Compare the diffusion of the CPU electrokinetics to the GPU
+       implementation.
+
+    """
+    system = EKCPU.system
+
+    def profile(self, ek, set_density, get_density):
+        self.system.actors.add(ek)
+        k = 2. * np.pi / self.system.box_l[2]
+        nodes = list(itertools.product(
+            *map(range, self.system.box_l.astype(int))))
+        for node in nodes:
+            set_density(node, 1. + 0.2 * np.cos(k * node[2]))
+        self.system.integrator.run(50)
+        densities = np.array([get_density(node) for node in nodes])
+        self.system.actors.clear()
+        return densities
+
+    def test_diffusion(self):
+        ek = espressomd.electrokinetics.ElectrokineticsCPU(
+            species=[{'density': 1., 'D': 0.5}], advection=False,
+            **EK_PARAMS)
+        cpu = self.profile(
+            ek, lambda node, rho: ek.set_density(0, rho, node),
+            lambda node: ek.get_density(0, node))
+
+        ek_gpu = espressomd.electrokinetics.Electrokinetics(
+            agrid=1., lb_density=1., viscosity=1., friction=1., T=1.,
+            prefactor=0.7, advection=False)
+        species = espressomd.electrokinetics.Species(density=1., D=0.5)
+        ek_gpu.add_species(species)
+
+        def set_density(node, rho):
+            species[node].density = rho
+        gpu = self.profile(ek_gpu, set_density,
+                           lambda node: species[node].density)
+        np.testing.assert_allclose(cpu, gpu, rtol=1e-5)
+
+
+if __name__ == '__main__':
+    ut.main()
@@ -47,29 +47,36 @@ class ElcTest(ut.TestCase):
                 accuracy=1e-3,
             ))
 
-        s.actors.add(
-            electrostatic_extensions.ELC(
-                gap_size=GAP[2],
-                maxPWerror=1e-3,
-                delta_mid_top=-1,
-                delta_mid_bot=-1,
-                const_pot=1,
-                pot_diff=POTENTIAL_DIFFERENCE,
-            ))
-
-        # Calculated energy
-        U_elc = s.analysis.energy()['coulomb']
+        elc = electrostatic_extensions.ELC(
+            gap_size=GAP[2],
+            maxPWerror=1e-3,
+            delta_mid_top=-1,
+            delta_mid_bot=-1,
+            const_pot=1,
+            pot_diff=POTENTIAL_DIFFERENCE,
+        )
+        s.actors.add(elc)
 
         # Expected E-Field is voltage drop over the box
         E_expected = POTENTIAL_DIFFERENCE / (BOX_L[2] - GAP[2])
         # Expected potential is -E_expected * z, so
         U_expected = -E_expected * (p1.pos[2] * p1.q + p2.pos[2] * p2.q)
 
-        self.assertAlmostEqual(U_elc, U_expected)
+        # also with one far formula mode per batch and on several threads
+        options = [(1, -1), (1, 1)]
+        if espressomd.has_features("OPENMP"):
+            options += [(2, -1), (2, 1)]
+        for n_threads, max_block_size in options:
+            s.cell_system.n_threads = n_threads
+            elc.set_params(max_block_size=max_block_size)
+
+            # Calculated energy
+            U_elc = s.analysis.energy()['coulomb']
+            self.assertAlmostEqual(U_elc, U_expected)
 
-        s.integrator.run(0)
-        self.assertAlmostEqual(E_expected, p1.f[2] / p1.q)
-        self.assertAlmostEqual(E_expected, p2.f[2] / p2.q)
+            s.integrator.run(0, recalc_forces=True)
+            self.assertAlmostEqual(E_expected, p1.f[2] / p1.q)
+            self.assertAlmostEqual(E_expected, p2.f[2] / p2.q)
 
 
 if __name__ == "__main__":
@@ -0,0 +1,85 @@
+#
+# Copyright (C) 2020 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+import espressomd
+import espressomd.electrostatics
+import espressomd.electrostatic_extensions
+import numpy as np
+import unittest as ut
+import unittest_decorators as utx
+
+GAP = 3.
+
+
+@utx.skipIfMissingFeatures(["P3M"])
+class ElcBatches(ut.TestCase):
+
+    """Compare the ELC forces and energies with the far formula modes split
+       into several batches and evaluated on several threads to a single
+       batch on one thread, with and without dielectric contrast.
+
+    """
+    system = espressomd.System(box_l=[10., 12., 10. + GAP])
+    system.time_step = 0.01
+    system.cell_system.skin = 0.
+
+    def forces_energy(self, elc, n_threads, max_block_size):
+        elc.set_params(max_block_size=max_block_size)
+        self.assertEqual(elc.get_params()["max_block_size"],
+                         max_block_size if max_block_size > 0 else 2**21)
+        self.system.cell_system.n_threads = n_threads
+        self.system.integrator.run(0, recalc_forces=True)
+        return (np.copy(self.system.part[:].f),
+                self.system.analysis.energy()["coulomb"])
+
+    def check(self, elc):
+        forces_ref, energy_ref = self.forces_energy(elc, 1, -1)
+        self.assertGreater(np.max(np.abs(forces_ref)), 0.1)
+        # one mode per batch, and a few modes per batch
+        options = [(1, 1), (1, 3000), (2, -1), (2, 3000)]
+        if not espressomd.has_features("OPENMP"):
+            options = options[:2]
+        for n_threads, max_block_size in options:
+            forces, energy = self.forces_energy(elc, n_threads,
+                                                max_block_size)
+            np.testing.assert_allclose(forces, forces_ref, atol=1e-10)
+            self.assertAlmostEqual(energy, energy_ref, delta=1e-10)
+
+    def test_batches(self):
+        np.random.seed(42)
+        n_part = 100
+        self.system.part.add(
+            pos=np.random.random((n_part, 3)) * [10., 12., 8.] + [0, 0, 1],
+            q=np.resize([1., -1.], n_part))
+
+        self.system.actors.add(espressomd.electrostatics.P3M(
+            prefactor=1.2, accuracy=1e-4, mesh=[16, 20, 24], cao=5,
+            alpha=1.1, r_cut=2.5, tune=False))
+        elc = espressomd.electrostatic_extensions.ELC(
+            gap_size=GAP, maxPWerror=1e-6)
+        self.system.actors.add(elc)
+        self.check(elc)
+
+        # ELC cannot be removed, so the dielectric contrast is switched on
+        # in the active actor
+        elc.set_params(delta_mid_top=0.6, delta_mid_bot=-0.4)
+        self.check(elc)
+
+
+if __name__ == "__main__":
+    ut.main()
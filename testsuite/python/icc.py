@@ -16,22 +16,38 @@
 # along with this program.  If not, see <http://www.gnu.org/licenses/>.
 import unittest as ut
 import unittest_decorators as utx
+import numpy as np
 import espressomd
 
 
 @utx.skipIfMissingFeatures(["P3M", "EXTERNAL_FORCES"])
 class test_icc(ut.TestCase):
 
-    def runTest(self):
+    S = espressomd.System(box_l=[1.0, 1.0, 1.0])
+    # Parameters
+    box_l = 20.0
+    nicc = 10
+    q_test = 10.0
+    q_dist = 5.0
+    nicc_per_electrode = nicc * nicc
+    nicc_tot = 2 * nicc_per_electrode
+
+    def tearDown(self):
+        # remove ICC before P3M, actors.clear() would skip the ICC actor
+        while len(self.S.actors):
+            self.S.actors.remove(self.S.actors[-1])
+        self.S.part.clear()
+        self.S.time = 0.
+
+    def setup_system(self, fix_dipole=True, **icc_params):
         from espressomd.electrostatics import P3M
         from espressomd.electrostatic_extensions import ICC
 
-        S = espressomd.System(box_l=[1.0, 1.0, 1.0])
-        # Parameters
-        box_l = 20.0
-        nicc = 10
-        q_test = 10.0
-        q_dist = 5.0
+        S = self.S
+        box_l = self.box_l
+        nicc = self.nicc
+        nicc_per_electrode = self.nicc_per_electrode
+        nicc_tot = self.nicc_tot
 
         # System
         S.box_l = [box_l, box_l, box_l + 5.0]
@@ -39,8 +55,6 @@ class test_icc(ut.TestCase):
         S.time_step = 0.01
 
         # ICC particles
-        nicc_per_electrode = nicc * nicc
-        nicc_tot = 2 * nicc_per_electrode
         iccArea = box_l * box_l / nicc_per_electrode
 
         iccNormals = []
@@ -66,8 +80,11 @@ class test_icc(ut.TestCase):
 
         # Test Dipole
         b2 = box_l * 0.5
-        S.part.add(pos=[b2, b2, b2 - q_dist / 2], q=q_test, fix=[1, 1, 1])
-        S.part.add(pos=[b2, b2, b2 + q_dist / 2], q=-q_test, fix=[1, 1, 1])
+        fix = 3 * [fix_dipole]
+        S.part.add(pos=[b2, b2, b2 - self.q_dist / 2], q=self.q_test,
+                   fix=fix, v=[0.5, 0., 0.])
+        S.part.add(pos=[b2, b2, b2 + self.q_dist / 2], q=-self.q_test,
+                   fix=fix, v=[0., 0.5, 0.])
 
         # Actors
         p3m = P3M(prefactor=1, mesh=32, cao=7, accuracy=1e-5)
@@ -82,10 +99,18 @@ class test_icc(ut.TestCase):
             normals=iccNormals,
             areas=iccAreas,
             sigmas=iccSigmas,
-            epsilons=iccEpsilons)
+            epsilons=iccEpsilons,
+            **icc_params)
 
         S.actors.add(p3m)
         S.actors.add(icc)
+        return icc
+
+    def test_dipole(self):
+        S = self.S
+        nicc_per_electrode = self.nicc_per_electrode
+        nicc_tot = self.nicc_tot
+        icc = self.setup_system()
 
         # Run
         S.integrator.run(0)
@@ -94,8 +119,8 @@ class test_icc(ut.TestCase):
         QL = sum(S.part[:nicc_per_electrode].q)
         QR = sum(S.part[nicc_per_electrode:nicc_tot].q)
 
-        testcharge_dipole = q_test * q_dist
-        induced_dipole = 0.5 * (abs(QL) + abs(QR)) * box_l
+        testcharge_dipole = self.q_test * self.q_dist
+        induced_dipole = 0.5 * (abs(QL) + abs(QR)) * self.box_l
 
         # Result
         self.assertAlmostEqual(1, induced_dipole / testcharge_dipole, places=4)
@@ -110,6 +135,26 @@ class test_icc(ut.TestCase):
         self.assertNotAlmostEqual(enegry_pre_change, enegry_post_change)
         self.assertNotAlmostEqual(pressure_pre_change, pressure_post_change)
 
+    def run_moving_dipole(self, **icc_params):
+        icc = self.setup_system(fix_dipole=False, **icc_params)
+        self.S.integrator.run(0)
+        iterations = 0
+        for _ in range(10):
+            self.S.integrator.run(1)
+            iterations += icc.last_iterations()
+        charges = np.copy(self.S.part[:self.nicc_tot].q)
+        self.tearDown()
+        return charges, iterations
+
+    def test_anderson_extrapolation(self):
+        charges_ref, iterations_ref = self.run_moving_dipole()
+        for params in ({"anderson_depth": 5},
+                       {"anderson_depth": 5, "extrapolation_order": 2}):
+            charges, iterations = self.run_moving_dipole(**params)
+            np.testing.assert_allclose(
+                charges, charges_ref, atol=1e-4 * np.max(np.abs(charges_ref)))
+            self.assertLess(iterations, iterations_ref)
+
 
 if __name__ == "__main__":
     ut.main()
@@ -0,0 +1,126 @@
+#
+# Copyright (C) 2020 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+import espressomd
+import espressomd.electrostatics
+import espressomd.magnetostatics
+import numpy as np
+import unittest as ut
+import unittest_decorators as utx
+
+
+@utx.skipIfMissingFeatures(["P3M", "EXTERNAL_FORCES"])
+class IntegratorRESPA(ut.TestCase):
+
+    """Check that the velocity Verlet integrator with multiple time stepping
+       evaluates the long-range forces every ``long_range_interval`` steps
+       and applies them as an impulse.
+
+    """
+    system = espressomd.System(box_l=[10., 10., 10.])
+    system.time_step = 0.01
+    system.cell_system.skin = 0.4
+
+    def setUp(self):
+        np.random.seed(42)
+        n_part = 100
+        # fixed particles keep the positions, and thus the forces, constant
+        self.system.part.add(
+            pos=np.random.random((n_part, 3)) * self.system.box_l,
+            q=np.resize([1., -1.], n_part), fix=n_part * [[1, 1, 1]])
+        p3m = espressomd.electrostatics.P3M(
+            prefactor=1., accuracy=1e-4, mesh=16, cao=5, alpha=1.5,
+            r_cut=2., tune=False)
+        self.system.actors.add(p3m)
+
+    def tearDown(self):
+        self.system.actors.clear()
+        self.system.part.clear()
+        self.system.integrator.set_vv()
+
+    def forces(self, interval, steps=0):
+        self.system.integrator.set_vv(long_range_interval=interval)
+        self.system.integrator.run(0, recalc_forces=True)
+        self.system.integrator.run(steps)
+        return np.copy(self.system.part[:].f)
+
+    def test_weight(self):
+        f_1 = self.forces(1)
+        f_2 = self.forces(2)
+        f_3 = self.forces(3)
+        f_long = f_2 - f_1
+        f_short = f_1 - f_long
+        self.assertGreater(np.max(np.abs(f_long)), 1e-3)
+        np.testing.assert_allclose(f_3, f_short + 3. * f_long, atol=1e-10)
+
+        # the long-range forces are skipped between the evaluations
+        for steps in range(1, 7):
+            f_ref = f_short + 3. * f_long if steps % 3 == 0 else f_short
+            np.testing.assert_allclose(self.forces(3, steps), f_ref,
+                                       atol=1e-10)
+
+    def test_run_0(self):
+        f_1 = self.forces(1)
+        f_long = self.forces(2) - f_1
+        f_short = f_1 - f_long
+
+        # a run without steps keeps the forces and the cycle
+        np.testing.assert_allclose(self.forces(3, 1), f_short, atol=1e-10)
+        self.system.integrator.run(0)
+        np.testing.assert_allclose(self.system.part[:].f, f_short,
+                                   atol=1e-10)
+        self.system.integrator.run(2)
+        np.testing.assert_allclose(self.system.part[:].f,
+                                   f_short + 3. * f_long, atol=1e-10)
+        self.system.integrator.run(1)
+        self.system.integrator.run(0)
+        np.testing.assert_allclose(self.system.part[:].f, f_short,
+                                   atol=1e-10)
+
+        # recalculating the forces restarts the cycle
+        self.system.integrator.run(0, recalc_forces=True)
+        np.testing.assert_allclose(self.system.part[:].f,
+                                   f_short + 3. * f_long, atol=1e-10)
+
+        # changing the interval invalidates the weighted forces
+        self.system.integrator.set_vv()
+        self.system.integrator.run(0)
+        np.testing.assert_allclose(self.system.part[:].f, f_1, atol=1e-10)
+
+    @utx.skipIfMissingFeatures(["DIPOLES", "ROTATION"])
+    def test_force_actors_unsupported(self):
+        self.system.actors.clear()
+        self.system.part[:].q = 0.
+        self.system.part[:].dip = np.random.random((100, 3))
+        self.system.actors.add(
+            espressomd.magnetostatics.DipolarBarnesHutCpu(prefactor=1.))
+        self.system.integrator.set_vv(long_range_interval=2)
+        with self.assertRaises(Exception):
+            self.system.integrator.run(0, recalc_forces=True)
+        self.system.integrator.set_vv()
+        self.system.integrator.run(0, recalc_forces=True)
+
+    def test_exceptions(self):
+        with self.assertRaises(ValueError):
+            self.system.integrator.set_vv(long_range_interval=0)
+        with self.assertRaises(ValueError):
+            self.system.integrator.set_vv(long_range_interval=2.5)
+
+
+if __name__ == '__main__':
+    ut.main()
@@ -0,0 +1,98 @@
+#
+# Copyright (C) 2020 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+import espressomd
+import espressomd.lb
+import espressomd.lbboundaries
+import espressomd.shapes
+import numpy as np
+import unittest as ut
+import unittest_decorators as utx
+import tests_common
+
+LB_PARAMS = {'agrid': 1.,
+             'dens': 0.8,
+             'visc': 1.1,
+             'tau': 0.01,
+             'kT': 0.5,
+             'seed': 17}
+
+
+class LBSinglePrecision(ut.TestCase):
+
+    """Check the CPU lattice-Boltzmann fluid with the accuracy of
+       single-precision populations (feature ``LB_SINGLE_PRECISION``).
+       In double precision, the checks hold to much higher accuracy.
+
+    """
+    system = espressomd.System(box_l=[6., 8., 10.])
+    system.time_step = 0.01
+    system.cell_system.skin = 0.4
+
+    def tearDown(self):
+        self.system.actors.clear()
+        if espressomd.has_features(["LB_BOUNDARIES"]):
+            self.system.lbboundaries.clear()
+
+    def nodes(self, lbf):
+        return [lbf[i, j, k] for i in range(lbf.shape[0])
+                for j in range(lbf.shape[1]) for k in range(lbf.shape[2])]
+
+    def test_conservation(self):
+        lbf = espressomd.lb.LBFluid(**LB_PARAMS)
+        self.system.actors.add(lbf)
+        np.random.seed(42)
+        for node in self.nodes(lbf):
+            node.velocity = np.random.uniform(-0.05, 0.05, 3)
+        mass = np.sum([node.density for node in self.nodes(lbf)])
+        momentum = self.system.analysis.linear_momentum()
+        self.assertGreater(np.linalg.norm(momentum), 0.1)
+        for _ in range(5):
+            self.system.integrator.run(40)
+            np.testing.assert_allclose(
+                np.sum([node.density for node in self.nodes(lbf)]), mass,
+                rtol=1e-8)
+            np.testing.assert_allclose(
+                self.system.analysis.linear_momentum(), momentum, atol=1e-4)
+
+    @utx.skipIfMissingFeatures(["LB_BOUNDARIES"])
+    def test_double_precision_reference(self):
+        """Compare the fluid between walls to the double-precision fluid
+           of ``data/lb_walls_system.npz``, see
+           ``data/gen_lb_walls_ref_data.py``.
+
+        """
+        ref = np.load(tests_common.abspath("data/lb_walls_system.npz"))
+        lbf = espressomd.lb.LBFluid(
+            ext_force_density=[0.01, -0.02, 0.005], **LB_PARAMS)
+        self.system.actors.add(lbf)
+        self.system.lbboundaries.add(espressomd.lbboundaries.LBBoundary(
+            shape=espressomd.shapes.Wall(normal=[0, 0, 1], dist=1.5),
+            velocity=[0.01, 0., 0.]))
+        self.system.lbboundaries.add(espressomd.lbboundaries.LBBoundary(
+            shape=espressomd.shapes.Wall(normal=[0, 0.3, -1], dist=-7.5)))
+        self.system.integrator.run(50)
+        nodes = self.nodes(lbf)
+        np.testing.assert_allclose(
+            [n.velocity for n in nodes], ref['velocity'], atol=2e-6)
+        np.testing.assert_allclose(
+            [n.density for n in nodes], ref['density'], rtol=1e-7)
+
+
+if __name__ == "__main__":
+    ut.main()
@@ -60,6 +60,8 @@ LB_PARAMETERS = {
     'gamma_odd': 1.0,
     'gamma_even': 1.0
 }
+# populations are stored as float with LB_SINGLE_PRECISION
+DECIMAL = 5 if espressomd.has_features(["LB_SINGLE_PRECISION"]) else 7
 
 
 class LBStreamingCommon:
@@ -105,7 +107,8 @@ class LBStreamingCommon:
                 target_node_index = np.mod(
                     grid_index + VELOCITY_VECTORS[n_v], self.grid)
                 np.testing.assert_almost_equal(
-                    self.lbf[target_node_index].population[n_v], float(n_v + 1))
+                    self.lbf[target_node_index].population[n_v],
+                    float(n_v + 1), decimal=DECIMAL)
                 self.lbf[target_node_index].population = np.zeros(19)
 
 
@@ -0,0 +1,88 @@
+#
+# Copyright (C) 2020 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+import espressomd
+import espressomd.lb
+import espressomd.lbboundaries
+import espressomd.shapes
+import numpy as np
+import unittest as ut
+import unittest_decorators as utx
+import tests_common
+
+LB_PARAMS = {'agrid': 1.,
+             'dens': 0.8,
+             'visc': 1.1,
+             'tau': 0.01,
+             'kT': 0.5,
+             'seed': 17,
+             'ext_force_density': [0.01, -0.02, 0.005]}
+
+
+@utx.skipIfMissingFeatures(["LB_BOUNDARIES"])
+@ut.skipIf(espressomd.has_features(["LB_SINGLE_PRECISION"]),
+           "Skipping test due to the single-precision populations.")
+class LBStreamingReference(ut.TestCase):
+
+    """Compare the populations of a thermalized fluid between walls after
+       50 time steps to those of the two-lattice streaming, which stored
+       the pre- and post-collision populations in separate arrays.
+       The data is generated by ``data/gen_lb_walls_ref_data.py``.
+
+    """
+    system = espressomd.System(box_l=[6., 8., 10.])
+    system.time_step = 0.01
+    system.cell_system.skin = 0.4
+
+    def tearDown(self):
+        self.system.actors.clear()
+        self.system.lbboundaries.clear()
+        self.system.cell_system.n_threads = 1
+
+    def check(self, n_threads):
+        ref = np.load(tests_common.abspath("data/lb_walls_system.npz"))
+        self.system.cell_system.n_threads = n_threads
+        lbf = espressomd.lb.LBFluid(**LB_PARAMS)
+        self.system.actors.add(lbf)
+        self.system.lbboundaries.add(espressomd.lbboundaries.LBBoundary(
+            shape=espressomd.shapes.Wall(normal=[0, 0, 1], dist=1.5),
+            velocity=[0.01, 0., 0.]))
+        self.system.lbboundaries.add(espressomd.lbboundaries.LBBoundary(
+            shape=espressomd.shapes.Wall(normal=[0, 0.3, -1], dist=-7.5)))
+        self.system.integrator.run(50)
+        nodes = [lbf[i, j, k] for i in range(lbf.shape[0])
+                 for j in range(lbf.shape[1]) for k in range(lbf.shape[2])]
+        np.testing.assert_array_equal(
+            [n.boundary for n in nodes], ref['boundary'])
+        np.testing.assert_allclose(
+            [n.population for n in nodes], ref['population'], atol=1e-14)
+        np.testing.assert_allclose(
+            [n.velocity for n in nodes], ref['velocity'], atol=1e-14)
+        np.testing.assert_allclose(
+            [n.density for n in nodes], ref['density'], atol=1e-14)
+
+    def test_serial(self):
+        self.check(1)
+
+    @utx.skipIfMissingFeatures(["OPENMP"])
+    def test_threaded(self):
+        self.check(3)
+
+
+if __name__ == "__main__":
+    ut.main()
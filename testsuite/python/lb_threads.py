@@ -0,0 +1,87 @@
+#
+# Copyright (C) 2020 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+import espressomd
+import espressomd.lb
+import espressomd.lbboundaries
+import espressomd.shapes
+import numpy as np
+import unittest as ut
+import unittest_decorators as utx
+
+LB_PARAMS = {'agrid': 1.,
+             'dens': 0.8,
+             'visc': 1.1,
+             'tau': 0.01,
+             'kT': 0.5,
+             'seed': 17,
+             'ext_force_density': [0.01, -0.02, 0.005]}
+
+
+@utx.skipIfMissingFeatures(["OPENMP"])
+class LBThreads(ut.TestCase):
+
+    """Compare the fluid from the threaded CPU lattice-Boltzmann update
+       to the fluid from the serial update.
+
+    """
+    system = espressomd.System(box_l=[6., 8., 10.])
+    system.time_step = 0.01
+    system.cell_system.skin = 0.4
+
+    def tearDown(self):
+        self.system.actors.clear()
+        self.system.cell_system.n_threads = 1
+        if espressomd.has_features(["LB_BOUNDARIES"]):
+            self.system.lbboundaries.clear()
+
+    def fluid(self, n_threads, walls=False):
+        self.system.cell_system.n_threads = n_threads
+        self.system.actors.clear()
+        lbf = espressomd.lb.LBFluid(**LB_PARAMS)
+        self.system.actors.add(lbf)
+        if walls:
+            self.system.lbboundaries.clear()
+            self.system.lbboundaries.add(espressomd.lbboundaries.LBBoundary(
+                shape=espressomd.shapes.Wall(normal=[0, 0, 1], dist=1.5),
+                velocity=[0.01, 0., 0.]))
+            self.system.lbboundaries.add(espressomd.lbboundaries.LBBoundary(
+                shape=espressomd.shapes.Wall(normal=[0, 0.3, -1], dist=-7.5)))
+        self.system.integrator.run(20)
+        shape = lbf.shape
+        nodes = [lbf[i, j, k] for i in range(shape[0])
+                 for j in range(shape[1]) for k in range(shape[2])]
+        return (np.array([n.velocity for n in nodes]),
+                np.array([n.density for n in nodes]))
+
+    def test_threaded_update(self):
+        v_serial, rho_serial = self.fluid(1)
+        v_threaded, rho_threaded = self.fluid(3)
+        np.testing.assert_allclose(v_threaded, v_serial, atol=1e-14)
+        np.testing.assert_allclose(rho_threaded, rho_serial, atol=1e-14)
+
+    @utx.skipIfMissingFeatures(["LB_BOUNDARIES"])
+    def test_threaded_update_with_boundaries(self):
+        v_serial, rho_serial = self.fluid(1, walls=True)
+        v_threaded, rho_threaded = self.fluid(3, walls=True)
+        np.testing.assert_allclose(v_threaded, v_serial, atol=1e-14)
+        np.testing.assert_allclose(rho_threaded, rho_serial, atol=1e-14)
+
+
+if __name__ == '__main__':
+    ut.main()
@@ -0,0 +1,100 @@
+#
+# Copyright (C) 2020 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+import espressomd
+import numpy as np
+import unittest as ut
+import unittest_decorators as utx
+
+from cell_system_common import TrajectoryCommon
+
+
+@utx.skipIfMissingFeatures(["LENNARD_JONES"])
+class LoadBalancing(TrajectoryCommon, ut.TestCase):
+
+    """Compare trajectories of an inhomogeneous system with the node
+       boundaries shifted by the load balancing to trajectories with
+       the regular domain decomposition.
+
+    """
+    box_l = 16.
+    system = espressomd.System(box_l=3 * [box_l])
+    system.time_step = 0.002
+    system.cell_system.skin = 0.4
+    n_steps = 200
+
+    def setUp(self):
+        np.random.seed(42)
+        # dense slab at small x, dilute gas elsewhere
+        xs = np.concatenate((np.arange(0., 4., 1.), np.arange(4., 16., 3.)))
+        pos = np.array(np.meshgrid(xs, np.arange(16.), np.arange(16.)))
+        pos = pos.reshape(3, -1).T
+        pos += 0.05 * np.random.random(pos.shape)
+        self.system.part.add(pos=pos, v=np.random.normal(size=pos.shape))
+        self.system.non_bonded_inter[0, 0].lennard_jones.set_params(
+            epsilon=1.0, sigma=0.9, cutoff=2.5, shift="auto")
+        self.pos0 = np.copy(self.system.part[:].pos)
+        self.v0 = np.copy(self.system.part[:].v)
+
+    def tearDown(self):
+        self.system.part.clear()
+        self.system.cell_system.set_load_balancing(interval=0)
+
+    def test_trajectory(self):
+        state = self.system.cell_system.get_state()
+        regular = [np.linspace(0., 1., n + 1) for n in state["node_grid"]]
+
+        traj_ref = self.trajectory()
+        self.system.cell_system.set_load_balancing(
+            interval=10, threshold=0., damping=0.5)
+        self.assertEqual(self.system.cell_system.get_load_balancing(),
+                         {"interval": 10, "threshold": 0., "damping": 0.5})
+        self.assert_trajectories_equal(self.trajectory(), traj_ref)
+
+        state = self.system.cell_system.get_state()
+        min_width = (2.5 + self.system.cell_system.skin) / self.box_l
+        for b in state["node_boundaries"]:
+            self.assertEqual(b[0], 0.)
+            self.assertEqual(b[-1], 1.)
+            self.assertTrue(np.all(np.diff(b) >= min_width - 1e-12))
+        if state["node_grid"][0] > 1:
+            self.assertGreaterEqual(state["load_imbalance"], 0.)
+            self.assertFalse(np.allclose(
+                state["node_boundaries"][0], regular[0]))
+
+        # switching the load balancing off restores the regular grid
+        self.system.cell_system.set_load_balancing(interval=0)
+        state = self.system.cell_system.get_state()
+        for b, b_ref in zip(state["node_boundaries"], regular):
+            np.testing.assert_allclose(b, b_ref)
+
+    def test_exceptions(self):
+        with self.assertRaises(ValueError):
+            self.system.cell_system.set_load_balancing(interval=-1)
+        with self.assertRaises(ValueError):
+            self.system.cell_system.set_load_balancing(
+                interval=10, threshold=-0.1)
+        with self.assertRaises(ValueError):
+            self.system.cell_system.set_load_balancing(interval=10, damping=0.)
+        with self.assertRaises(ValueError):
+            self.system.cell_system.set_load_balancing(
+                interval=10, damping=1.5)
+
+
+if __name__ == '__main__':
+    ut.main()
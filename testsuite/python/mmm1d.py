@@ -119,6 +119,25 @@ class MMM1D_GPU_Test(ElectrostaticInteractionsTests, ut.TestCase):
 class MMM1D_Test(ElectrostaticInteractionsTests, ut.TestCase):
     from espressomd.electrostatics import MMM1D
 
+    def test_far_table(self):
+        def forces_and_energy(far_table):
+            self.system.actors.clear()
+            mmm1d = self.MMM1D(prefactor=1.0, maxPWerror=1e-6,
+                               far_switch_radius=3.0, tune=False,
+                               far_table=far_table)
+            self.system.actors.add(mmm1d)
+            self.assertEqual(mmm1d.get_params()["far_table"], far_table)
+            self.system.integrator.run(steps=0)
+            return (np.copy(self.system.part[:].f),
+                    self.system.analysis.energy()["coulomb"])
+
+        f_table, energy_table = forces_and_energy(True)
+        f_direct, energy_direct = forces_and_energy(False)
+        np.testing.assert_allclose(f_table, f_direct, rtol=0, atol=1e-5)
+        self.assertAlmostEqual(energy_table, energy_direct, delta=1e-5)
+        np.testing.assert_allclose(f_table, self.vec_f_target, rtol=0,
+                                   atol=self.allowed_error)
+
 
 if __name__ == "__main__":
     ut.main()
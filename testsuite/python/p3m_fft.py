@@ -0,0 +1,126 @@
+#
+# Copyright (C) 2020 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+import espressomd
+import espressomd.electrostatics
+import espressomd.magnetostatics
+import numpy as np
+import unittest as ut
+import unittest_decorators as utx
+import tests_common
+
+P3M_PARAMS = {'prefactor': 1.3, 'accuracy': 1e-3, 'alpha': 1.1,
+              'r_cut': 2.5, 'tune': False}
+P3M_MESHES = {'p3m': ([16, 20, 14], 5), 'p3m_mesh_z': ([16, 20, 2], 1)}
+DP3M_PARAMS = {'prefactor': 1.7, 'accuracy': 1e-3, 'alpha': 0.9,
+               'r_cut': 3., 'tune': False}
+DP3M_MESHES = {'dp3m': (16, 4), 'dp3m_mesh_z': (4, 3)}
+
+
+class P3MFFT(ut.TestCase):
+
+    """Compare the P3M and dipolar P3M results with the real-to-complex FFT
+       of the meshes to reference results of the complex-to-complex FFT.
+       The data is generated by ``data/gen_p3m_fft_ref_data.py``.
+
+    """
+    system = espressomd.System(box_l=[10., 12., 8.])
+    system.time_step = 0.01
+    system.cell_system.skin = 0.4
+    data = np.load(tests_common.abspath("data/p3m_fft_system.npz"))
+
+    def tearDown(self):
+        self.system.actors.clear()
+        self.system.part.clear()
+
+    def check_p3m(self, name):
+        mesh, cao = P3M_MESHES[name]
+        self.system.box_l = [10., 12., 8.]
+        self.system.part.add(pos=self.data['pos'], q=self.data['q'])
+        self.system.actors.add(espressomd.electrostatics.P3M(
+            mesh=mesh, cao=cao, **P3M_PARAMS))
+        self.system.integrator.run(0)
+        energy = self.system.analysis.energy()
+        self.assertAlmostEqual(energy['coulomb'],
+                               self.data[name + '_energy'], delta=1e-10)
+        self.assertAlmostEqual(energy['coulomb', 1],
+                               self.data[name + '_energy_kspace'],
+                               delta=1e-10)
+        self.assertAlmostEqual(self.system.analysis.pressure()['coulomb'],
+                               self.data[name + '_pressure'], delta=1e-12)
+        np.testing.assert_allclose(
+            self.system.analysis.pressure_tensor()['coulomb'],
+            self.data[name + '_pressure_tensor'], atol=1e-12)
+        np.testing.assert_allclose(np.copy(self.system.part[:].f),
+                                   self.data[name + '_forces'], atol=1e-10)
+
+    def check_dp3m(self, name):
+        mesh, cao = DP3M_MESHES[name]
+        self.system.box_l = [10., 10., 10.]
+        self.system.part.add(pos=self.data['dp3m_pos'],
+                             dip=self.data['dip'])
+        self.system.actors.add(espressomd.magnetostatics.DipolarP3M(
+            mesh=mesh, cao=cao, **DP3M_PARAMS))
+        self.system.integrator.run(0)
+        self.assertAlmostEqual(self.system.analysis.energy()['dipolar'],
+                               self.data[name + '_energy'], delta=1e-10)
+        np.testing.assert_allclose(np.copy(self.system.part[:].f),
+                                   self.data[name + '_forces'], atol=1e-10)
+        np.testing.assert_allclose(np.copy(self.system.part[:].torque_lab),
+                                   self.data[name + '_torques'], atol=1e-10)
+
+    @utx.skipIfMissingFeatures(["P3M"])
+    def test_p3m(self):
+        self.check_p3m('p3m')
+
+    @utx.skipIfMissingFeatures(["P3M"])
+    def test_p3m_mesh_z(self):
+        self.check_p3m('p3m_mesh_z')
+
+    @utx.skipIfMissingFeatures(["DP3M"])
+    def test_dp3m(self):
+        self.check_dp3m('dp3m')
+
+    @utx.skipIfMissingFeatures(["DP3M"])
+    def test_dp3m_mesh_z(self):
+        self.check_dp3m('dp3m_mesh_z')
+
+    @utx.skipIfMissingFeatures(["P3M"])
+    def test_p3m_odd_mesh(self):
+        for mesh in (15, [16, 20, 15], [15, 20, 16]):
+            with self.assertRaisesRegex(ValueError, "even number of mesh"):
+                espressomd.electrostatics.P3M(
+                    mesh=mesh, cao=5, **P3M_PARAMS).validate_params()
+
+    @utx.skipIfMissingFeatures(["DP3M"])
+    def test_dp3m_odd_mesh(self):
+        with self.assertRaisesRegex(ValueError, "even number of mesh"):
+            espressomd.magnetostatics.DipolarP3M(
+                mesh=15, cao=4, **DP3M_PARAMS).validate_params()
+        # the tuning of fewer than 8 dipoles used to try odd meshes only
+        self.system.box_l = [10., 10., 10.]
+        self.system.part.add(pos=self.data['dp3m_pos'][:4],
+                             dip=self.data['dip'][:4])
+        dp3m = espressomd.magnetostatics.DipolarP3M(
+            prefactor=1.7, accuracy=1e-3)
+        self.system.actors.add(dp3m)
+        self.assertEqual(dp3m.get_params()['mesh'][0] % 2, 0)
+        self.system.integrator.run(0)
+
+if __name__ == "__main__":
+    ut.main()
@@ -0,0 +1,82 @@
+#
+# Copyright (C) 2020 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+import itertools
+import espressomd
+import espressomd.electrostatics
+import espressomd.magnetostatics
+import numpy as np
+import unittest as ut
+import unittest_decorators as utx
+
+
+class P3MNodeGrid(ut.TestCase):
+
+    """Compare the P3M forces for all node grids of the MPI ranks. The
+       node grid determines the decomposition of the distributed FFT.
+
+    """
+    system = espressomd.System(box_l=[10., 10., 10.])
+    system.time_step = 0.01
+    system.cell_system.skin = 0.4
+    n_nodes = system.cell_system.get_state()["n_nodes"]
+    default_node_grid = np.copy(system.cell_system.node_grid)
+
+    def setUp(self):
+        np.random.seed(42)
+        n_part = 200
+        self.system.part.add(
+            pos=np.random.random((n_part, 3)) * self.system.box_l)
+
+    def tearDown(self):
+        self.system.actors.clear()
+        self.system.part.clear()
+        self.system.cell_system.node_grid = self.default_node_grid
+
+    def node_grids(self):
+        n = self.n_nodes
+        return [(a, b, n // (a * b)) for a, b in itertools.product(
+            range(1, n + 1), repeat=2) if n % (a * b) == 0]
+
+    def check_node_grids(self, actor):
+        self.system.actors.add(actor)
+        forces = []
+        for node_grid in self.node_grids():
+            self.system.cell_system.node_grid = node_grid
+            self.system.integrator.run(0, recalc_forces=True)
+            forces.append(np.copy(self.system.part[:].f))
+        for f in forces[1:]:
+            np.testing.assert_allclose(f, forces[0], atol=1e-12)
+
+    @utx.skipIfMissingFeatures(["P3M"])
+    def test_p3m(self):
+        self.system.part[:].q = np.resize([1., -1.], len(self.system.part))
+        self.check_node_grids(espressomd.electrostatics.P3M(
+            prefactor=1., accuracy=1e-4, mesh=24, cao=3, alpha=1.5,
+            r_cut=2., tune=False))
+
+    @utx.skipIfMissingFeatures(["DP3M"])
+    def test_dp3m(self):
+        self.system.part[:].dip = np.random.random((len(self.system.part), 3))
+        self.check_node_grids(espressomd.magnetostatics.DipolarP3M(
+            prefactor=1., accuracy=1e-4, mesh=24, cao=3, alpha=1.5,
+            r_cut=2., tune=False))
+
+
+if __name__ == '__main__':
+    ut.main()
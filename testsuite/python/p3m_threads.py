@@ -0,0 +1,73 @@
+#
+# Copyright (C) 2020 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+import espressomd
+import espressomd.electrostatics
+import numpy as np
+import unittest as ut
+import unittest_decorators as utx
+
+
+@utx.skipIfMissingFeatures(["OPENMP", "P3M"])
+class P3MThreads(ut.TestCase):
+
+    """Compare the P3M forces from the threaded charge assignment and force
+       interpolation to the forces from the serial ones.
+
+    """
+    system = espressomd.System(box_l=[10., 10., 10.])
+    system.time_step = 0.01
+    system.cell_system.skin = 0.4
+
+    def setUp(self):
+        np.random.seed(42)
+        n_part = 300
+        self.system.part.add(
+            pos=np.random.random((n_part, 3)) * self.system.box_l,
+            q=np.resize([1., -1.], n_part))
+
+    def tearDown(self):
+        self.system.actors.clear()
+        self.system.part.clear()
+        self.system.cell_system.n_threads = 1
+
+    def forces(self, n_threads):
+        self.system.cell_system.n_threads = n_threads
+        self.system.integrator.run(0, recalc_forces=True)
+        return (np.copy(self.system.part[:].f),
+                self.system.analysis.energy()["coulomb"])
+
+    def check_threaded_forces(self, cao):
+        p3m = espressomd.electrostatics.P3M(
+            prefactor=1., accuracy=1e-4, mesh=16, cao=cao, alpha=1.5,
+            r_cut=2., tune=False)
+        self.system.actors.add(p3m)
+        f_serial, e_serial = self.forces(1)
+        f_threaded, e_threaded = self.forces(3)
+        np.testing.assert_allclose(f_threaded, f_serial, atol=1e-12)
+        self.assertAlmostEqual(e_threaded, e_serial, delta=1e-10)
+
+    def test_threaded_forces(self):
+        for cao in [1, 3, 4, 7]:
+            with self.subTest(cao=cao):
+                self.check_threaded_forces(cao)
+                self.system.actors.clear()
+
+
+if __name__ == '__main__':
+    ut.main()
@@ -0,0 +1,139 @@
+#
+# Copyright (C) 2020 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+import espressomd
+import espressomd.electrostatics
+import numpy as np
+import os
+import tempfile
+import unittest as ut
+import unittest_decorators as utx
+
+
+@utx.skipIfMissingFeatures(["P3M"])
+class P3MTuningCache(ut.TestCase):
+
+    """Check that the P3M tuning stores its results in the tuning cache
+       and reuses them for the same system.
+
+    """
+    system = espressomd.System(box_l=[10., 10., 10.])
+    system.time_step = 0.01
+    system.cell_system.skin = 0.4
+    tuned_keys = ["mesh", "cao", "r_cut", "alpha"]
+
+    def setUp(self):
+        np.random.seed(42)
+        n_part = 200
+        self.system.part.add(
+            pos=np.random.random((n_part, 3)) * self.system.box_l,
+            q=np.resize([1., -1.], n_part))
+        self.tmp_dir = tempfile.TemporaryDirectory()
+        self.cache = os.path.join(self.tmp_dir.name, "p3m_tuning.dat")
+
+    def tearDown(self):
+        self.system.actors.clear()
+        self.system.part.clear()
+        self.system.cell_system.set_domain_decomposition()
+        self.tmp_dir.cleanup()
+
+    def tune(self, accuracy):
+        self.system.actors.clear()
+        p3m = espressomd.electrostatics.P3M(
+            prefactor=1., accuracy=accuracy, tuning_cache=self.cache)
+        self.system.actors.add(p3m)
+        params = p3m.get_params()
+        return {key: params[key] for key in self.tuned_keys}, \
+            p3m.get_tuning_table()
+
+    def cache_lines(self):
+        with open(self.cache) as f:
+            return f.readlines()
+
+    def cache_entries(self):
+        header, *entries = self.cache_lines()
+        self.assertTrue(header.startswith(
+            "# ESPResSo P3M tuning cache, format 2, features:"))
+        self.assertIn(" P3M", header)
+        return len(entries)
+
+    def test_cache(self):
+        params, table = self.tune(1e-3)
+        self.assertGreater(len(table), 0)
+        self.assertEqual(self.cache_entries(), 1)
+        times = [row["time"] for row in table]
+        best = table[times.index(min(times))]
+        self.assertEqual(list(best["mesh"]), list(params["mesh"]))
+        self.assertEqual(best["cao"], params["cao"])
+
+        # the same system is not timed again
+        params_cached, table_cached = self.tune(1e-3)
+        self.assertEqual(len(table_cached), 1)
+        self.assertEqual(self.cache_entries(), 1)
+        for key in self.tuned_keys:
+            np.testing.assert_array_equal(params_cached[key], params[key])
+
+        # a different accuracy goal is a different signature
+        _, table = self.tune(1e-4)
+        self.assertGreater(len(table), 0)
+        self.assertEqual(self.cache_entries(), 2)
+
+        # so are different charges
+        self.system.part[0].q = 2.
+        self.system.part[1].q = -2.
+        self.tune(1e-3)
+        self.assertEqual(self.cache_entries(), 3)
+
+        # and different cell system options
+        self.system.cell_system.set_domain_decomposition(use_soa=True)
+        self.tune(1e-3)
+        self.assertEqual(self.cache_entries(), 4)
+        self.system.cell_system.set_domain_decomposition(
+            use_verlet_lists=False)
+        self.tune(1e-3)
+        self.assertEqual(self.cache_entries(), 5)
+
+    def test_other_build(self):
+        self.tune(1e-3)
+        header, entry = self.cache_lines()
+
+        # entries written by another build are not used
+        with open(self.cache, "w") as f:
+            f.write(header.replace("features:", "features: OTHER"))
+            f.write(entry)
+        _, table = self.tune(1e-3)
+        self.assertGreater(len(table), 1)
+        self.assertEqual(self.cache_lines()[0], header)
+        self.assertEqual(self.cache_entries(), 1)
+
+        # neither are files without a header
+        with open(self.cache, "w") as f:
+            f.write(entry)
+        _, table = self.tune(1e-3)
+        self.assertGreater(len(table), 1)
+        self.assertEqual(self.cache_lines()[0], header)
+        self.assertEqual(self.cache_entries(), 1)
+
+    def test_exceptions(self):
+        with self.assertRaises(ValueError):
+            espressomd.electrostatics.P3M(
+                prefactor=1., accuracy=1e-3, tuning_cache=1).validate_params()
+
+
+if __name__ == '__main__':
+    ut.main()
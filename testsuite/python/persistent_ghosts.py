@@ -0,0 +1,77 @@
+#
+# Copyright (C) 2020 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+import espressomd
+import numpy as np
+import unittest as ut
+import unittest_decorators as utx
+
+from cell_system_common import LatticeCommon
+
+
+@utx.skipIfMissingFeatures(["LENNARD_JONES"])
+class PersistentGhosts(LatticeCommon, ut.TestCase):
+
+    """Compare trajectories in which the ghosts are updated through the
+       persistent requests between the resorts to trajectories without
+       skin, in which the particles are resorted in every step and all
+       ghost data is sent by the full exchange. The cell system is
+       re-initialized several times during the trajectories, which has
+       to recreate the persistent requests.
+
+    """
+    system = espressomd.System(box_l=3 * [10.])
+    system.time_step = 0.005
+    system.cell_system.skin = 0.4
+
+    def tearDown(self):
+        super().tearDown()
+        self.system.cell_system.skin = 0.4
+
+    def trajectory_with_reinits(self, skin):
+        cs = self.system.cell_system
+        reinits = [lambda: cs.set_domain_decomposition(use_verlet_lists=False),
+                   lambda: cs.set_n_square(),
+                   lambda: cs.set_domain_decomposition(use_async_ghosts=True),
+                   lambda: cs.set_domain_decomposition(use_soa=True)]
+
+        cs.set_domain_decomposition()
+        cs.skin = skin
+        self.system.part[:].pos = self.pos0
+        self.system.part[:].v = self.v0
+        self.system.integrator.run(0, recalc_forces=True)
+        for reinit in reinits:
+            self.system.integrator.run(25)
+            reinit()
+        self.system.integrator.run(25)
+        return (np.copy(self.system.part[:].pos),
+                np.copy(self.system.part[:].f),
+                cs.get_state()["verlet_reuse"])
+
+    def test_reinit(self):
+        *traj_ref, reuse_ref = self.trajectory_with_reinits(0.)
+        *traj, reuse = self.trajectory_with_reinits(0.4)
+        # without skin, every step resorts; otherwise the ghost
+        # updates between the resorts use the persistent requests
+        self.assertLessEqual(reuse_ref, 1.)
+        self.assertGreater(reuse, 1.)
+        self.assert_trajectories_equal(traj, traj_ref)
+
+
+if __name__ == '__main__':
+    ut.main()
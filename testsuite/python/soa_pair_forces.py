@@ -0,0 +1,111 @@
+#
+# Copyright (C) 2020 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+import espressomd
+import espressomd.electrostatics
+import numpy as np
+import unittest as ut
+import unittest_decorators as utx
+
+
+@utx.skipIfMissingFeatures(["LENNARD_JONES", "WCA", "ELECTROSTATICS"])
+class SoAPairForces(ut.TestCase):
+
+    """Compare the non-bonded forces calculated on the structure-of-arrays
+       particle copies to the forces from the regular pair loop.
+
+    """
+    system = espressomd.System(box_l=3 * [8.])
+    system.time_step = 0.001
+    system.cell_system.skin = 0.3
+
+    def setUp(self):
+        np.random.seed(42)
+        grid = np.mgrid[0:8, 0:8, 0:8].reshape(3, -1).T
+        pos = grid + 0.5 + 0.1 * (np.random.random(grid.shape) - 0.5)
+        n_part = len(pos)
+        self.system.part.add(
+            pos=pos, type=np.random.randint(3, size=n_part),
+            q=np.random.permutation(np.resize([-1., 1., 0., 0.], n_part)),
+            v=np.random.normal(size=(n_part, 3)))
+
+        self.system.non_bonded_inter[0, 0].lennard_jones.set_params(
+            epsilon=1.0, sigma=1.0, cutoff=2.5, shift="auto")
+        self.system.non_bonded_inter[0, 1].wca.set_params(
+            epsilon=1.0, sigma=0.9)
+        self.system.non_bonded_inter[1, 1].lennard_jones.set_params(
+            epsilon=0.5, sigma=0.8, cutoff=2.0, shift=0.1, offset=0.1)
+        self.system.non_bonded_inter[1, 1].wca.set_params(
+            epsilon=0.2, sigma=1.0)
+        if espressomd.has_features(["SOFT_SPHERE"]):
+            # not evaluated in batches
+            self.system.non_bonded_inter[2, 2].soft_sphere.set_params(
+                a=1.0, n=3.0, cutoff=1.5)
+        if espressomd.has_features(["EXCLUSIONS"]):
+            for i in range(0, n_part, 7):
+                self.system.part[i].add_exclusion((i + 1) % n_part)
+
+    def tearDown(self):
+        self.system.actors.clear()
+        self.system.part.clear()
+        self.system.non_bonded_inter.reset()
+        self.system.cell_system.set_domain_decomposition()
+
+    def forces(self, use_soa):
+        self.system.cell_system.set_domain_decomposition(use_soa=use_soa)
+        self.assertEqual(
+            self.system.cell_system.get_state()["use_soa"], use_soa)
+        self.system.integrator.run(0, recalc_forces=True)
+        return np.copy(self.system.part[:].f)
+
+    def check(self):
+        f_ref = self.forces(False)
+        f_soa = self.forces(True)
+        np.testing.assert_allclose(f_soa, f_ref, rtol=1e-8, atol=1e-8)
+
+        # during the integration, only the positions in the copies are
+        # updated, compare the forces before the copies are rebuilt
+        self.system.integrator.run(20)
+        self.assertTrue(self.system.cell_system.get_state()["use_soa"])
+        f_soa = np.copy(self.system.part[:].f)
+        f_ref = self.forces(False)
+        np.testing.assert_allclose(f_soa, f_ref, rtol=1e-8, atol=1e-8)
+
+    def test_no_coulomb(self):
+        self.check()
+
+    def test_dh(self):
+        self.system.actors.add(espressomd.electrostatics.DH(
+            prefactor=1.2, kappa=0.8, r_cut=2.0))
+        self.check()
+
+    @utx.skipIfMissingFeatures(["P3M"])
+    def test_p3m(self):
+        self.system.actors.add(espressomd.electrostatics.P3M(
+            prefactor=1.2, accuracy=1e-3, mesh=16, cao=4, alpha=1.5,
+            r_cut=2.0, tune=False))
+        self.check()
+
+    def test_coulomb(self):
+        self.system.actors.add(espressomd.electrostatics.DH(
+            prefactor=1.2, kappa=0., r_cut=2.0))
+        self.check()
+
+
+if __name__ == '__main__':
+    ut.main()
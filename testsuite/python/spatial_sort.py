@@ -0,0 +1,89 @@
+#
+# Copyright (C) 2020 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+import espressomd
+import numpy as np
+import unittest as ut
+import unittest_decorators as utx
+
+from cell_system_common import CellSystemOptionCommon
+
+
+def morton_keys(pos):
+    """Keys of the positions on the Morton curve through their bounding
+       box, with 10 bits per direction as in the core.
+
+    """
+    lower = np.min(pos, axis=0)
+    upper = np.max(pos, axis=0)
+    scale = np.zeros(3)
+    extent = upper - lower
+    scale[extent > 0.] = 1023. / extent[extent > 0.]
+    q = ((pos - lower) * scale).astype(np.uint64)
+    keys = np.zeros(len(pos), dtype=np.uint64)
+    for bit in range(10):
+        for i in range(3):
+            keys |= ((q[:, i] >> np.uint64(bit)) & np.uint64(1)) \
+                << np.uint64(3 * bit + i)
+    return keys
+
+
+@utx.skipIfMissingFeatures(["LENNARD_JONES"])
+class SpatialSort(CellSystemOptionCommon, ut.TestCase):
+
+    """Compare trajectories with the particles and cells ordered along
+       a space-filling curve to trajectories in the insertion order.
+
+    """
+    system = espressomd.System(box_l=3 * [10.])
+    system.time_step = 0.005
+    system.cell_system.skin = 0.4
+    option = "use_spatial_sort"
+
+    def trajectory(self):
+        traj = super().trajectory()
+        # particles are found by id after the reordering
+        np.testing.assert_array_equal(self.system.part[:].id,
+                                      np.arange(1000))
+        return traj
+
+    def test_nsquare(self):
+        self.check(self.system.cell_system.set_n_square)
+
+    def check_cell_order(self):
+        self.system.integrator.run(50)
+        self.system.cell_system.resort()
+        pos = self.system.part[:].pos_folded
+        cells = self.system.cell_system.get_cell_particle_ids_()
+        self.assertEqual(sorted(i for ids in cells for i in ids),
+                         list(range(1000)))
+        for ids in filter(lambda ids: len(ids) > 1, cells):
+            keys = morton_keys(pos[ids])
+            self.assertTrue(np.all(np.diff(keys.astype(np.int64)) >= 0))
+
+    def test_cell_order_dd(self):
+        self.set_cell_system(True)
+        self.check_cell_order()
+
+    def test_cell_order_nsquare(self):
+        self.set_cell_system(True, self.system.cell_system.set_n_square)
+        self.check_cell_order()
+
+
+if __name__ == '__main__':
+    ut.main()
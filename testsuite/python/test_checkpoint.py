@@ -233,14 +233,14 @@ class CheckpointTest(ut.TestCase):
         integ = system.integrator.get_state()
         self.assertIsInstance(integ, espressomd.integrate.VelocityVerlet)
         params = integ.get_params()
-        self.assertEqual(params, {})
+        self.assertEqual(params, {'long_range_interval': 1})
 
     @ut.skipIf('INT' in modes, 'VV integrator not the default')
     def test_integrator_VV(self):
         integ = system.integrator.get_state()
         self.assertIsInstance(integ, espressomd.integrate.VelocityVerlet)
         params = integ.get_params()
-        self.assertEqual(params, {})
+        self.assertEqual(params, {'long_range_interval': 1})
 
     @ut.skipIf('INT.BD' not in modes, 'BD integrator not in modes')
     def test_integrator_BD(self):
@@ -0,0 +1,80 @@
+#
+# Copyright (C) 2020 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+import espressomd
+import numpy as np
+import unittest as ut
+import unittest_decorators as utx
+
+
+@utx.skipIfMissingFeatures(["LENNARD_JONES", "OPENMP"])
+class ThreadedShortRangeLoop(ut.TestCase):
+
+    """Compare the forces from the threaded short-range loop
+       to the forces from the serial loop for all cell systems.
+
+    """
+    system = espressomd.System(box_l=3 * [12.])
+    system.time_step = 0.01
+    system.cell_system.skin = 0.3
+
+    def setUp(self):
+        np.random.seed(42)
+        self.system.part.add(pos=self.system.box_l *
+                             np.random.random((1000, 3)))
+        self.system.non_bonded_inter[0, 0].lennard_jones.set_params(
+            epsilon=1.0, sigma=0.5, cutoff=1.2, shift="auto")
+
+    def tearDown(self):
+        self.system.part.clear()
+        self.system.cell_system.n_threads = 1
+
+    def forces(self, n_threads):
+        self.system.cell_system.n_threads = n_threads
+        self.assertEqual(self.system.cell_system.n_threads, n_threads)
+        self.system.integrator.run(0, recalc_forces=True)
+        # second evaluation re-uses the Verlet lists
+        self.system.integrator.run(0, recalc_forces=True)
+        return np.copy(self.system.part[:].f)
+
+    def check(self):
+        f_serial = self.forces(1)
+        f_threaded = self.forces(4)
+        np.testing.assert_allclose(f_threaded, f_serial, atol=1e-10)
+
+    def test_dd(self):
+        self.system.cell_system.set_domain_decomposition(
+            use_verlet_lists=False)
+        self.check()
+
+    def test_dd_vl(self):
+        self.system.cell_system.set_domain_decomposition(
+            use_verlet_lists=True)
+        self.check()
+
+    def test_n_square(self):
+        self.system.cell_system.set_n_square(use_verlet_lists=True)
+        self.check()
+
+    def test_invalid(self):
+        with self.assertRaises(ValueError):
+            self.system.cell_system.n_threads = 0
+
+
+if __name__ == '__main__':
+    ut.main()
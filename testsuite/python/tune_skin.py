@@ -17,6 +17,7 @@
 
 import unittest as ut
 import unittest_decorators as utx
+import numpy as np
 import espressomd
 
 
@@ -32,6 +33,10 @@ class TuneSkin(ut.TestCase):
             cutoff=0.3,
             shift="auto")
 
+    def tearDown(self):
+        self.system.cell_system.set_adaptive_skin(interval=0)
+        self.system.part.clear()
+
     def test_fails_without_adjustment(self):
         with self.assertRaisesRegex(Exception, 'Error during tune_skin'):
             self.system.cell_system.tune_skin(
@@ -48,6 +53,55 @@ class TuneSkin(ut.TestCase):
             int_steps=3,
             adjust_max_skin=True)
 
+    def test_adaptive_skin(self):
+        system = self.system
+        np.random.seed(42)
+        pos = np.mgrid[0:3, 0:4, 0:2].reshape(3, -1).T * [0.45, 0.6, 0.85]
+        system.part.add(pos=pos, v=np.random.normal(size=pos.shape))
+        system.cell_system.skin = 0.2
+        system.integrator.run(0)
+
+        # disabled by default, the skin is untouched
+        system.integrator.run(50)
+        self.assertEqual(system.cell_system.skin, 0.2)
+
+        system.cell_system.set_adaptive_skin(
+            interval=5, min_skin=0.1, max_skin=0.3, tol=0.01)
+        params = system.cell_system.get_adaptive_skin()
+        self.assertEqual(params["interval"], 5)
+        self.assertEqual(params["min_skin"], 0.1)
+        self.assertEqual(params["max_skin"], 0.3)
+        self.assertEqual(params["tol"], 0.01)
+
+        skins = []
+        for _ in range(20):
+            system.integrator.run(5)
+            skins.append(system.cell_system.skin)
+        # every window changes the skin by at least the tolerance
+        self.assertGreater(len(set(skins)), 1)
+        self.assertGreaterEqual(min(skins), 0.1)
+        self.assertLessEqual(max(skins), 0.3)
+
+        # the skin is capped at the maximal permissible skin
+        system.cell_system.set_adaptive_skin(interval=1, min_skin=0.3)
+        system.integrator.run(10)
+        self.assertLessEqual(system.cell_system.skin,
+                             0.5 * min(system.box_l) - 0.3 + 1e-12)
+
+        system.cell_system.set_adaptive_skin(interval=0)
+        skin = system.cell_system.skin
+        system.integrator.run(20)
+        self.assertEqual(system.cell_system.skin, skin)
+
+    def test_adaptive_skin_exceptions(self):
+        cs = self.system.cell_system
+        with self.assertRaises(ValueError):
+            cs.set_adaptive_skin(interval=-1)
+        with self.assertRaises(ValueError):
+            cs.set_adaptive_skin(interval=10, tol=0.)
+        with self.assertRaises(ValueError):
+            cs.set_adaptive_skin(interval=10, min_skin=0.3, max_skin=0.2)
+
 
 if __name__ == "__main__":
     ut.main()